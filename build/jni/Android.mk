@@ -25,6 +25,7 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/assets/CueLoader.cpp \
 	../../ouzel/assets/GltfLoader.cpp \
     ../../ouzel/assets/ImageLoader.cpp \
+    ../../ouzel/assets/LoadTask.cpp \
     ../../ouzel/assets/MtlLoader.cpp \
     ../../ouzel/assets/ObjLoader.cpp \
     ../../ouzel/assets/ParticleSystemLoader.cpp \
@@ -33,15 +34,24 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/assets/VorbisLoader.cpp \
     ../../ouzel/assets/WaveLoader.cpp \
     ../../ouzel/audio/empty/EmptyAudioDevice.cpp \
+    ../../ouzel/audio/offline/OfflineAudioDevice.cpp \
     ../../ouzel/audio/mixer/Bus.cpp \
+    ../../ouzel/audio/mixer/DecodedStream.cpp \
+    ../../ouzel/audio/mixer/DecoderPool.cpp \
 	../../ouzel/audio/mixer/Mixer.cpp \
+	../../ouzel/audio/mixer/MixPool.cpp \
+    ../../ouzel/audio/mixer/Resampler.cpp \
+    ../../ouzel/audio/mixer/Spatializer.cpp \
+    ../../ouzel/audio/mixer/VoiceManager.cpp \
     ../../ouzel/audio/opensl/OSLAudioDevice.cpp \
     ../../ouzel/audio/Audio.cpp \
     ../../ouzel/audio/AudioDevice.cpp \
 	../../ouzel/audio/Containers.cpp \
     ../../ouzel/audio/Cue.cpp \
+    ../../ouzel/audio/Dsp.cpp \
 	../../ouzel/audio/Effect.cpp \
 	../../ouzel/audio/Effects.cpp \
+    ../../ouzel/audio/Fft.cpp \
     ../../ouzel/audio/Listener.cpp \
 	../../ouzel/audio/Mix.cpp \
     ../../ouzel/audio/Node.cpp \
@@ -69,6 +79,14 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
 	../../ouzel/graphics/opengl/OGLRenderTarget.cpp \
     ../../ouzel/graphics/opengl/OGLShader.cpp \
     ../../ouzel/graphics/opengl/OGLTexture.cpp \
+    ../../ouzel/graphics/software/SoftwareBlendState.cpp \
+    ../../ouzel/graphics/software/SoftwareBuffer.cpp \
+    ../../ouzel/graphics/software/SoftwareDepthStencilState.cpp \
+    ../../ouzel/graphics/software/SoftwareRasterizer.cpp \
+    ../../ouzel/graphics/software/SoftwareRenderDevice.cpp \
+    ../../ouzel/graphics/software/SoftwareRenderTarget.cpp \
+    ../../ouzel/graphics/software/SoftwareShader.cpp \
+    ../../ouzel/graphics/software/SoftwareTexture.cpp \
     ../../ouzel/graphics/BlendState.cpp \
     ../../ouzel/graphics/Buffer.cpp \
 	../../ouzel/graphics/DepthStencilState.cpp \
@@ -104,6 +122,7 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/scene/Actor.cpp \
     ../../ouzel/scene/Animator.cpp \
 	../../ouzel/scene/Animators.cpp \
+	../../ouzel/scene/Batcher.cpp \
     ../../ouzel/scene/Camera.cpp \
     ../../ouzel/scene/Component.cpp \
     ../../ouzel/scene/Layer.cpp \
@@ -113,12 +132,15 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeRenderer.cpp \
     ../../ouzel/scene/SkinnedMeshRenderer.cpp \
+    ../../ouzel/scene/SpatialIndex.cpp \
     ../../ouzel/scene/SpriteRenderer.cpp \
     ../../ouzel/scene/StaticMeshRenderer.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
     ../../ouzel/storage/FileSystem.cpp \
+    ../../ouzel/storage/Inflate.cpp \
     ../../ouzel/utils/Log.cpp \
     ../../ouzel/utils/Obf.cpp \
+    ../../ouzel/utils/ThreadPool.cpp \
     ../../ouzel/utils/Utils.cpp
 
 include $(BUILD_STATIC_LIBRARY)
@@ -15,7 +15,7 @@ namespace ouzel
 
         bool BmfLoader::loadAsset(Bundle& bundle,
                                   const std::string& name,
-                                  const std::vector<uint8_t>& data,
+                                  const storage::FileData& data,
                                   bool)
         {
             try
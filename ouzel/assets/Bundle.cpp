@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
+#include "LoadTask.hpp"
 #include "Loader.hpp"
 #include "utils/Json.hpp"
 #include "utils/Utils.hpp"
@@ -26,38 +27,86 @@ namespace ouzel
         void Bundle::loadAsset(uint32_t loaderType, const std::string& name,
                                const std::string& filename, bool mipmaps)
         {
-            const std::vector<uint8_t> data = fileSystem.readFile(filename);
+            loadAsset(loaderType, name, filename, fileSystem.mapFile(filename), mipmaps);
+        }
 
+        void Bundle::loadAsset(uint32_t loaderType, const std::string& name, const std::string& filename,
+                               const storage::FileData& data, bool mipmaps)
+        {
             const auto& loaders = cache.getLoaders();
 
             for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
             {
                 Loader* loader = i->get();
-                if (loader->getType() == loaderType &&
-                    loader->loadAsset(*this, name, data, mipmaps))
+                if (loader->getType() != loaderType) continue;
+
+                if (auto decoded = loader->decode(name, data, mipmaps))
+                {
+                    loadDependencies(*decoded, mipmaps);
+                    if (loader->createAsset(*this, name, *decoded, mipmaps))
+                        return;
+                }
+                else if (loader->loadAsset(*this, name, data, mipmaps))
                     return;
             }
 
             throw std::runtime_error("Failed to load asset " + filename);
         }
 
+        void Bundle::loadDependencies(const Loader::Decoded& decoded, bool mipmaps)
+        {
+            for (const Loader::Dependency& dependency : decoded.dependencies)
+                if (!isLoaded(dependency.type, dependency.filename))
+                    loadAsset(dependency.type, dependency.filename, dependency.filename, mipmaps);
+        }
+
+        bool Bundle::isLoaded(uint32_t loaderType, const std::string& name) const
+        {
+            switch (loaderType)
+            {
+                case Loader::Font: return cache.getFont(name) != nullptr;
+                case Loader::StaticMesh: return cache.getStaticMeshData(name) != nullptr;
+                case Loader::SkinnedMesh: return cache.getSkinnedMeshData(name) != nullptr;
+                case Loader::Image: return cache.getTexture(name) != nullptr;
+                case Loader::Material: return cache.getMaterial(name) != nullptr;
+                case Loader::ParticleSystem: return cache.getParticleSystemData(name) != nullptr;
+                case Loader::Sprite: return cache.getSpriteData(name) != nullptr;
+                case Loader::Sound: return cache.getSound(name) != nullptr;
+                case Loader::Cue: return cache.getCue(name) != nullptr;
+                default: return false;
+            }
+        }
+
         void Bundle::loadAssets(const std::string& filename)
         {
-            const json::Data data(fileSystem.readFile(filename));
+            loadAssetsAsync(filename)->wait();
+        }
+
+        void Bundle::loadAssets(const std::vector<Asset>& assets)
+        {
+            loadAssetsAsync(assets)->wait();
+        }
+
+        std::unique_ptr<LoadTask> Bundle::loadAssetsAsync(const std::string& filename)
+        {
+            const json::Data data(fileSystem.mapFile(filename));
+
+            std::vector<Asset> assets;
 
             for (const json::Value& asset : data["assets"])
             {
                 const auto file = asset["filename"].as<std::string>();
                 const auto name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
                 const auto mipmaps = asset.hasMember("mipmaps") ? asset["mipmaps"].as<bool>() : true;
-                loadAsset(asset["type"].as<uint32_t>(), name, file, mipmaps);
+                assets.emplace_back(asset["type"].as<uint32_t>(), name, file, mipmaps);
             }
+
+            return loadAssetsAsync(assets);
         }
 
-        void Bundle::loadAssets(const std::vector<Asset>& assets)
+        std::unique_ptr<LoadTask> Bundle::loadAssetsAsync(const std::vector<Asset>& assets)
         {
-            for (const Asset& asset : assets)
-                loadAsset(asset.type, asset.name, asset.filename, asset.mipmaps);
+            return std::make_unique<LoadTask>(*this, assets);
         }
 
         std::shared_ptr<graphics::Texture> Bundle::getTexture(const std::string& name) const
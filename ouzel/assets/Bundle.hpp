@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include "assets/Loader.hpp"
 #include "audio/Cue.hpp"
 #include "audio/Sound.hpp"
 #include "graphics/BlendState.hpp"
@@ -25,6 +26,7 @@ namespace ouzel
     namespace assets
     {
         class Cache;
+        class LoadTask;
 
         class Asset final
         {
@@ -49,6 +51,7 @@ namespace ouzel
         class Bundle final
         {
             friend Cache;
+            friend LoadTask;
         public:
             Bundle(Cache& initCache, storage::FileSystem& initFileSystem);
             ~Bundle();
@@ -64,6 +67,10 @@ namespace ouzel
             void loadAssets(const std::string& filename);
             void loadAssets(const std::vector<Asset>& assets);
 
+            // the bundle has to outlive the returned task, which creates the assets when it is updated
+            std::unique_ptr<LoadTask> loadAssetsAsync(const std::string& filename);
+            std::unique_ptr<LoadTask> loadAssetsAsync(const std::vector<Asset>& assets);
+
             std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
             void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture);
             void releaseTextures();
@@ -116,6 +123,11 @@ namespace ouzel
             void releaseStaticMeshData();
 
         private:
+            void loadAsset(uint32_t loaderType, const std::string& name, const std::string& filename,
+                           const storage::FileData& data, bool mipmaps);
+            void loadDependencies(const Loader::Decoded& decoded, bool mipmaps);
+            bool isLoaded(uint32_t loaderType, const std::string& name) const;
+
             Cache& cache;
             storage::FileSystem& fileSystem;
 
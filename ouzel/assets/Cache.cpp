@@ -1,6 +1,7 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <thread>
 #include "Cache.hpp"
 #include "BmfLoader.hpp"
 #include "ColladaLoader.hpp"
@@ -22,7 +23,22 @@ namespace ouzel
 {
     namespace assets
     {
-        Cache::Cache()
+        namespace
+        {
+            uint32_t getLoadWorkerCount()
+            {
+#if defined(__EMSCRIPTEN__)
+                return 0;
+#else
+                // the thread of the load task decodes too
+                const uint32_t cpuCount = std::thread::hardware_concurrency();
+                return cpuCount > 1 ? cpuCount - 1 : 0;
+#endif
+            }
+        }
+
+        Cache::Cache():
+            loadPool(getLoadWorkerCount())
         {
             addLoader(std::make_unique<BmfLoader>(*this));
             addLoader(std::make_unique<ColladaLoader>(*this));
@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include "assets/Bundle.hpp"
+#include "utils/ThreadPool.hpp"
 
 namespace ouzel
 {
@@ -13,10 +14,12 @@ namespace ouzel
     {
         class Bundle;
         class Loader;
+        class LoadTask;
 
         class Cache final
         {
             friend Bundle;
+            friend LoadTask;
         public:
             Cache();
 
@@ -51,6 +54,10 @@ namespace ouzel
 
             std::vector<const Bundle*> bundles;
             std::vector<std::unique_ptr<Loader>> loaders;
+
+            // reads and decodes the assets of the load tasks, separate from the engine's thread pool,
+            // so that the loading does not hold up the jobs of the update thread
+            ThreadPool loadPool;
         };
     } // namespace assets
 } // namespace ouzel
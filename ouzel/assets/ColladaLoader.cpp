@@ -17,7 +17,7 @@ namespace ouzel
 
         bool ColladaLoader::loadAsset(Bundle& bundle,
                                       const std::string& name,
-                                      const std::vector<uint8_t>& data,
+                                      const storage::FileData& data,
                                       bool)
         {
             xml::Data colladaData(data);
@@ -5,6 +5,7 @@
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "audio/Cue.hpp"
+#include "audio/Sound.hpp"
 #include "utils/Json.hpp"
 
 namespace ouzel
@@ -18,6 +19,34 @@ namespace ouzel
 
         namespace
         {
+            class DecodedCue final: public Loader::Decoded
+            {
+            public:
+                explicit DecodedCue(const storage::FileData& initData):
+                    data(initData)
+                {
+                }
+
+                json::Data data;
+            };
+
+            // the sounds of the wave players and the impulse responses are loaded before the cue
+            void addDependencies(const json::Value& value, std::vector<Loader::Dependency>& dependencies)
+            {
+                if (value["type"].as<std::string>() == "WavePlayer" && value.hasMember("source"))
+                    dependencies.emplace_back(Loader::Sound, value["source"].as<std::string>());
+
+                if (value.hasMember("effects"))
+                    for (const json::Value& effectValue : value["effects"])
+                        if (effectValue["type"].as<std::string>() == "ConvolutionReverb" &&
+                            effectValue.hasMember("impulseResponse"))
+                            dependencies.emplace_back(Loader::Sound, effectValue["impulseResponse"].as<std::string>());
+
+                if (value.hasMember("sources"))
+                    for (const json::Value& sourceValue : value["sources"])
+                        addDependencies(sourceValue, dependencies);
+            }
+
             audio::SourceDefinition parseSourceDefinition(const json::Value& value, Cache& cache)
             {
                 audio::SourceDefinition sourceDefinition;
@@ -88,6 +117,8 @@ namespace ouzel
                             effectDefinition.type = audio::EffectDefinition::Type::PitchShift;
                         else if (effectType == "Reverb")
                             effectDefinition.type = audio::EffectDefinition::Type::Reverb;
+                        else if (effectType == "ConvolutionReverb")
+                            effectDefinition.type = audio::EffectDefinition::Type::ConvolutionReverb;
                         else if (effectType == "LowPass")
                             effectDefinition.type = audio::EffectDefinition::Type::LowPass;
                         else if (effectType == "HighPass")
@@ -100,6 +131,17 @@ namespace ouzel
                         if (effectValue.hasMember("scale")) effectDefinition.scale = effectValue["scale"].as<float>();
                         if (effectValue.hasMember("shift")) effectDefinition.shift = effectValue["shift"].as<float>();
                         if (effectValue.hasMember("decay")) effectDefinition.decay = effectValue["decay"].as<float>();
+                        if (effectValue.hasMember("mix")) effectDefinition.mix = effectValue["mix"].as<float>();
+
+                        if (effectDefinition.type == audio::EffectDefinition::Type::ConvolutionReverb)
+                        {
+                            if (effectValue.hasMember("impulseResponse"))
+                                effectDefinition.impulseResponse = cache.getSound(effectValue["impulseResponse"].as<std::string>());
+
+                            if (!effectDefinition.impulseResponse ||
+                                effectDefinition.impulseResponse->getFormat() != audio::Sound::Format::Pcm)
+                                throw std::runtime_error("Convolution reverb needs a PCM impulse response");
+                        }
 
                         sourceDefinition.effectDefinitions.push_back(effectDefinition);
                     }
@@ -112,13 +154,26 @@ namespace ouzel
             }
         }
 
-        bool CueLoader::loadAsset(Bundle& bundle,
-                                  const std::string& name,
-                                  const std::vector<uint8_t>& data,
-                                  bool)
+        std::unique_ptr<Loader::Decoded> CueLoader::decode(const std::string&,
+                                                           const storage::FileData& data,
+                                                           bool)
         {
+            auto decoded = std::make_unique<DecodedCue>(data);
+
+            if (decoded->data.hasMember("source"))
+                addDependencies(decoded->data["source"], decoded->dependencies);
+
+            return decoded;
+        }
+
+        bool CueLoader::createAsset(Bundle& bundle,
+                                    const std::string& name,
+                                    const Decoded& decoded,
+                                    bool)
+        {
+            const json::Data& d = static_cast<const DecodedCue&>(decoded).data;
+
             audio::SourceDefinition sourceDefinition;
-            const json::Data d(data);
 
             if (d.hasMember("source"))
                 sourceDefinition = parseSourceDefinition(d["source"], cache);
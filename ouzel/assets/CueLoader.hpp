@@ -13,10 +13,13 @@ namespace ouzel
         {
         public:
             explicit CueLoader(Cache& initCache);
-            bool loadAsset(Bundle& bundle,
-                           const std::string& name,
-                           const std::vector<uint8_t>& data,
-                           bool mipmaps = true) final;
+            std::unique_ptr<Decoded> decode(const std::string& name,
+                                            const storage::FileData& data,
+                                            bool mipmaps = true) final;
+            bool createAsset(Bundle& bundle,
+                             const std::string& name,
+                             const Decoded& decoded,
+                             bool mipmaps = true) final;
         };
     } // namespace assets
 } // namespace ouzel
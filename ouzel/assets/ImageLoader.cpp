@@ -31,6 +31,8 @@
 #define STBI_NO_PIC
 #define STBI_NO_GIF
 #define STBI_NO_PNM
+// the failure reason of stb_image is a global, which the loading threads would race on
+#define STBI_NO_FAILURE_STRINGS
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -46,15 +48,25 @@ namespace ouzel
 {
     namespace assets
     {
+        namespace
+        {
+            class DecodedImage final: public Loader::Decoded
+            {
+            public:
+                Size2U size;
+                graphics::PixelFormat pixelFormat;
+                std::vector<std::pair<Size2U, std::vector<uint8_t>>> levels;
+            };
+        }
+
         ImageLoader::ImageLoader(Cache& initCache):
             Loader(initCache, Loader::Image)
         {
         }
 
-        bool ImageLoader::loadAsset(Bundle& bundle,
-                                    const std::string& name,
-                                    const std::vector<uint8_t>& data,
-                                    bool mipmaps)
+        std::unique_ptr<Loader::Decoded> ImageLoader::decode(const std::string& name,
+                                                             const storage::FileData& data,
+                                                             bool mipmaps)
         {
             int width;
             int height;
@@ -63,7 +75,7 @@ namespace ouzel
             stbi_uc* tempData = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &comp, STBI_default);
 
             if (!tempData)
-                throw std::runtime_error("Failed to load texture, reason: " + std::string(stbi_failure_reason()));
+                throw std::runtime_error("Failed to decode image " + name);
 
             graphics::PixelFormat pixelFormat;
             std::vector<uint8_t> imageData;
@@ -151,11 +163,29 @@ namespace ouzel
                                          static_cast<uint32_t>(height)),
                                   imageData);
 
+            // the mip maps are generated here, so that the loading threads do it instead of the thread of the bundle
+            auto decoded = std::make_unique<DecodedImage>();
+            decoded->size = image.getSize();
+            decoded->pixelFormat = image.getPixelFormat();
+            decoded->levels = graphics::Texture::generateLevels(image.getData(),
+                                                                image.getSize(),
+                                                                mipmaps ? 0 : 1,
+                                                                image.getPixelFormat());
+
+            return decoded;
+        }
+
+        bool ImageLoader::createAsset(Bundle& bundle,
+                                      const std::string& name,
+                                      const Decoded& decoded,
+                                      bool)
+        {
+            const auto& image = static_cast<const DecodedImage&>(decoded);
+
             auto texture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
-                                                               image.getData(),
-                                                               image.getSize(), 0,
-                                                               mipmaps ? 0 : 1,
-                                                               image.getPixelFormat());
+                                                               image.levels,
+                                                               image.size, 0,
+                                                               image.pixelFormat);
 
             bundle.setTexture(name, texture);
 
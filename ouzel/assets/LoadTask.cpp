@@ -0,0 +1,259 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <stdexcept>
+#include "LoadTask.hpp"
+#include "Cache.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        LoadTask::LoadTask(Bundle& initBundle, const std::vector<Asset>& assets):
+            bundle(initBundle)
+        {
+            entries.reserve(assets.size());
+
+            for (const Asset& asset : assets)
+                addEntry(asset, false);
+
+#if !defined(__EMSCRIPTEN__)
+            loadingThread = Thread(&LoadTask::loadingMain, this);
+#endif
+        }
+
+        LoadTask::~LoadTask()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            running = false;
+            lock.unlock();
+            pendingCondition.notify_all();
+
+#if !defined(__EMSCRIPTEN__)
+            if (loadingThread.isJoinable()) loadingThread.join();
+#endif
+        }
+
+        bool LoadTask::update()
+        {
+            if (exception) std::rethrow_exception(exception);
+
+            try
+            {
+                std::vector<Entry*> newEntries;
+
+                std::unique_lock<std::mutex> lock(mutex);
+#if defined(__EMSCRIPTEN__)
+                if (!pending.empty()) decodeEntries(lock);
+#endif
+                newEntries.swap(decoded);
+                lock.unlock();
+
+                processDecoded(newEntries);
+                createEntries(false);
+
+                if (!waiting.empty())
+                {
+                    lock.lock();
+                    const bool idle = !decodingCount && decoded.empty();
+                    lock.unlock();
+
+                    // the remaining entries depend on each other, so they are created in the order they were decoded
+                    if (idle) createEntries(true);
+                }
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+
+                std::unique_lock<std::mutex> lock(mutex);
+                running = false;
+                lock.unlock();
+                pendingCondition.notify_all();
+
+                throw;
+            }
+
+            return isDone();
+        }
+
+        void LoadTask::wait()
+        {
+            while (!update())
+            {
+#if !defined(__EMSCRIPTEN__)
+                std::unique_lock<std::mutex> lock(mutex);
+                while (decoded.empty() && decodingCount) decodedCondition.wait(lock);
+#endif
+            }
+        }
+
+        LoadTask::Entry* LoadTask::addEntry(const Asset& asset, bool dependency)
+        {
+            entries.push_back(std::make_unique<Entry>(asset, dependency));
+            Entry* entry = entries.back().get();
+            entryMap.emplace(std::make_pair(asset.type, asset.name), entry);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            pending.push_back(entry);
+            ++decodingCount;
+            lock.unlock();
+            pendingCondition.notify_all();
+
+            return entry;
+        }
+
+        void LoadTask::decode(Entry& entry) const
+        {
+            try
+            {
+                entry.data = bundle.fileSystem.mapFile(entry.asset.filename);
+
+                // in the order of Bundle::loadAsset, the data is kept for loadAsset if none of the loaders decodes it
+                const auto& loaders = bundle.cache.getLoaders();
+
+                for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                {
+                    Loader* loader = i->get();
+                    if (loader->getType() != entry.asset.type) continue;
+
+                    entry.decoded = loader->decode(entry.asset.name, entry.data, entry.asset.mipmaps);
+
+                    if (entry.decoded)
+                    {
+                        entry.loader = loader;
+                        entry.data = storage::FileData();
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                entry.exception = std::current_exception();
+            }
+        }
+
+        void LoadTask::decodeEntries(std::unique_lock<std::mutex>& lock)
+        {
+            std::vector<Entry*> batch;
+            batch.swap(pending);
+            lock.unlock();
+
+            // every entry is handed over as soon as it is decoded, so that the progress follows the decoding
+            bundle.cache.loadPool.run(batch.size(), [this, &batch](size_t index) {
+                decode(*batch[index]);
+
+                std::unique_lock<std::mutex> entryLock(mutex);
+                decoded.push_back(batch[index]);
+                --decodingCount;
+                entryLock.unlock();
+                decodedCondition.notify_all();
+            });
+
+            lock.lock();
+        }
+
+        void LoadTask::loadingMain()
+        {
+            Thread::setCurrentThreadName("Asset loading");
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            for (;;)
+            {
+                while (running && pending.empty()) pendingCondition.wait(lock);
+                if (!running) break;
+
+                decodeEntries(lock);
+            }
+        }
+
+        void LoadTask::processDecoded(std::vector<Entry*>& newEntries)
+        {
+            for (Entry* entry : newEntries)
+            {
+                if (entry->exception) std::rethrow_exception(entry->exception);
+
+                if (entry->decoded)
+                    for (const Loader::Dependency& dependency : entry->decoded->dependencies)
+                    {
+                        auto i = entryMap.find(std::make_pair(dependency.type, dependency.filename));
+
+                        if (i != entryMap.end())
+                        {
+                            if (i->second != entry)
+                                entry->dependencies.push_back(i->second);
+                        }
+                        else if (!bundle.isLoaded(dependency.type, dependency.filename))
+                            entry->dependencies.push_back(addEntry(Asset(dependency.type,
+                                                                         dependency.filename,
+                                                                         dependency.filename,
+                                                                         entry->asset.mipmaps), true));
+                    }
+
+                waiting.push_back(entry);
+            }
+        }
+
+        void LoadTask::createEntries(bool ignoreDependencies)
+        {
+            for (bool created = true; created;)
+            {
+                created = false;
+
+                for (auto i = waiting.begin(); i != waiting.end();)
+                {
+                    Entry* entry = *i;
+
+                    if (ignoreDependencies ||
+                        std::all_of(entry->dependencies.begin(), entry->dependencies.end(), [](const Entry* dependency) noexcept {
+                            return dependency->loaded;
+                        }))
+                    {
+                        i = waiting.erase(i);
+                        create(*entry);
+                        created = true;
+                    }
+                    else
+                        ++i;
+                }
+            }
+        }
+
+        bool LoadTask::loadAsset(Entry& entry)
+        {
+            // the data has already been rejected by the decoders, so only the loaders without a decode step are left
+            const auto& loaders = bundle.cache.getLoaders();
+
+            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+            {
+                Loader* loader = i->get();
+                if (loader->getType() == entry.asset.type &&
+                    loader->loadAsset(bundle, entry.asset.name, entry.data, entry.asset.mipmaps))
+                    return true;
+            }
+
+            return false;
+        }
+
+        void LoadTask::create(Entry& entry)
+        {
+            // another asset of the task or another bundle may have loaded the dependency in the meantime
+            if (!entry.dependency || !bundle.isLoaded(entry.asset.type, entry.asset.name))
+            {
+                if (entry.decoded)
+                {
+                    if (!entry.loader->createAsset(bundle, entry.asset.name, *entry.decoded, entry.asset.mipmaps))
+                        throw std::runtime_error("Failed to load asset " + entry.asset.filename);
+                }
+                else if (!loadAsset(entry))
+                    throw std::runtime_error("Failed to load asset " + entry.asset.filename);
+            }
+
+            entry.decoded.reset();
+            entry.data = storage::FileData();
+            entry.loaded = true;
+            ++loadedCount;
+        }
+    } // namespace assets
+} // namespace ouzel
@@ -0,0 +1,111 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_LOADTASK_HPP
+#define OUZEL_ASSETS_LOADTASK_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "assets/Bundle.hpp"
+#include "assets/Loader.hpp"
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Loads a list of assets into a bundle. The files are read and decoded in parallel on the load pool of the cache,
+        // the assets are created in the order of their dependencies on the thread that calls update or wait,
+        // so the renderer and the audio are only used from the thread that owns the bundle.
+        class LoadTask final
+        {
+        public:
+            LoadTask(Bundle& initBundle, const std::vector<Asset>& assets);
+            ~LoadTask();
+
+            LoadTask(const LoadTask&) = delete;
+            LoadTask& operator=(const LoadTask&) = delete;
+
+            LoadTask(LoadTask&&) = delete;
+            LoadTask& operator=(LoadTask&&) = delete;
+
+            // creates the assets that have been decoded, returns true once all of them are loaded,
+            // the exception of an asset that failed to load is rethrown
+            bool update();
+
+            // creates the assets as they are decoded until all of them are loaded
+            void wait();
+
+            // the dependencies are counted after the asset that refers to them has been decoded
+            inline auto getAssetCount() const noexcept { return entries.size(); }
+            inline auto getLoadedCount() const noexcept { return loadedCount; }
+            inline auto isDone() const noexcept { return loadedCount == entries.size(); }
+            inline float getProgress() const noexcept
+            {
+                return entries.empty() ? 1.0F : static_cast<float>(loadedCount) / static_cast<float>(entries.size());
+            }
+
+        private:
+            class Entry final
+            {
+            public:
+                Entry(const Asset& initAsset, bool initDependency):
+                    asset(initAsset), dependency(initDependency)
+                {
+                }
+
+                Asset asset;
+                bool dependency; // skipped if another bundle already has it
+
+                // set by the loading threads
+                storage::FileData data; // kept only if none of the loaders decoded it
+                Loader* loader = nullptr;
+                std::unique_ptr<Loader::Decoded> decoded;
+                std::exception_ptr exception;
+
+                std::vector<const Entry*> dependencies;
+                bool loaded = false;
+            };
+
+            Entry* addEntry(const Asset& asset, bool dependency);
+            void decode(Entry& entry) const;
+            void decodeEntries(std::unique_lock<std::mutex>& lock);
+            void loadingMain();
+
+            void processDecoded(std::vector<Entry*>& newEntries);
+            void createEntries(bool ignoreDependencies);
+            bool loadAsset(Entry& entry);
+            void create(Entry& entry);
+
+            Bundle& bundle;
+
+            // owned by the thread that calls update
+            std::vector<std::unique_ptr<Entry>> entries;
+            std::map<std::pair<uint32_t, std::string>, Entry*> entryMap;
+            std::vector<Entry*> waiting; // decoded, but waiting for the dependencies
+            size_t loadedCount = 0;
+            std::exception_ptr exception;
+
+            std::mutex mutex;
+            std::condition_variable pendingCondition;
+            std::condition_variable decodedCondition;
+            std::vector<Entry*> pending;
+            std::vector<Entry*> decoded;
+            size_t decodingCount = 0; // pending entries and entries that are being decoded
+            bool running = true;
+
+#if !defined(__EMSCRIPTEN__)
+            Thread loadingThread;
+#endif
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_LOADTASK_HPP
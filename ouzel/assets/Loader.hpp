@@ -3,8 +3,11 @@
 #ifndef OUZEL_ASSETS_LOADER_HPP
 #define OUZEL_ASSETS_LOADER_HPP
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "storage/FileData.hpp"
 
 namespace ouzel
 {
@@ -30,6 +33,35 @@ namespace ouzel
                 Cue
             };
 
+            // An asset that has to be loaded before the asset that refers to it
+            class Dependency final
+            {
+            public:
+                Dependency(uint32_t initType, const std::string& initFilename):
+                    type(initType), filename(initFilename)
+                {
+                }
+
+                uint32_t type;
+                std::string filename;
+            };
+
+            // The result of decode, loaders derive from it to pass the parsed data to createAsset
+            class Decoded
+            {
+            public:
+                Decoded() = default;
+                virtual ~Decoded() = default;
+
+                Decoded(const Decoded&) = delete;
+                Decoded& operator=(const Decoded&) = delete;
+
+                Decoded(Decoded&&) = delete;
+                Decoded& operator=(Decoded&&) = delete;
+
+                std::vector<Dependency> dependencies;
+            };
+
             Loader(Cache& initCache, uint32_t initType):
                 cache(initCache), type(initType)
             {
@@ -45,10 +77,34 @@ namespace ouzel
 
             inline auto getType() const noexcept { return type; }
 
-            virtual bool loadAsset(Bundle& bundle,
-                                   const std::string& name,
-                                   const std::vector<uint8_t>& data,
-                                   bool mipmaps = true) = 0;
+            // Parses the data without using the bundle, the cache, the renderer or the audio, so that it can be called from
+            // a loading thread. Returns nullptr if the data is not in the format of the loader or if the loader does all the
+            // work in loadAsset.
+            virtual std::unique_ptr<Decoded> decode(const std::string&,
+                                                    const storage::FileData&,
+                                                    bool = true)
+            {
+                return nullptr;
+            }
+
+            // Creates the asset from the result of decode on the thread that owns the bundle,
+            // the dependencies have already been loaded
+            virtual bool createAsset(Bundle&,
+                                     const std::string&,
+                                     const Decoded&,
+                                     bool = true)
+            {
+                return false;
+            }
+
+            // Loads the asset on the thread that owns the bundle, for the loaders that don't implement decode
+            virtual bool loadAsset(Bundle&,
+                                   const std::string&,
+                                   const storage::FileData&,
+                                   bool = true)
+            {
+                return false;
+            }
 
         protected:
             Cache& cache;
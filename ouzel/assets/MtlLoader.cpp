@@ -29,8 +29,8 @@ namespace ouzel
                 return c <= 0x1F;
             }
 
-            void skipWhitespaces(std::vector<uint8_t>::const_iterator& iterator,
-                                 std::vector<uint8_t>::const_iterator end)
+            void skipWhitespaces(const uint8_t*& iterator,
+                                 const uint8_t* end)
             {
                 while (iterator != end)
                     if (isWhitespace(*iterator))
@@ -39,8 +39,8 @@ namespace ouzel
                         break;
             }
 
-            void skipLine(std::vector<uint8_t>::const_iterator& iterator,
-                          std::vector<uint8_t>::const_iterator end)
+            void skipLine(const uint8_t*& iterator,
+                          const uint8_t* end)
             {
                 while (iterator != end)
                 {
@@ -54,8 +54,8 @@ namespace ouzel
                 }
             }
 
-            std::string parseString(std::vector<uint8_t>::const_iterator& iterator,
-                                    std::vector<uint8_t>::const_iterator end)
+            std::string parseString(const uint8_t*& iterator,
+                                    const uint8_t* end)
             {
                 std::string result;
 
@@ -71,8 +71,8 @@ namespace ouzel
                 return result;
             }
 
-            float parseFloat(std::vector<uint8_t>::const_iterator& iterator,
-                             std::vector<uint8_t>::const_iterator end)
+            float parseFloat(const uint8_t*& iterator,
+                             const uint8_t* end)
             {
                 std::string value;
                 uint32_t length = 1;
@@ -111,25 +111,45 @@ namespace ouzel
             }
         }
 
+        namespace
+        {
+            class DecodedMaterials final: public Loader::Decoded
+            {
+            public:
+                class Material final
+                {
+                public:
+                    std::string name;
+                    std::string diffuseTexture;
+                    std::string ambientTexture;
+                    Color diffuseColor;
+                    float opacity;
+                };
+
+                std::vector<Material> materials;
+            };
+        }
+
         MtlLoader::MtlLoader(Cache& initCache):
             Loader(initCache, Loader::Material)
         {
         }
 
-        bool MtlLoader::loadAsset(Bundle& bundle,
-                                  const std::string& name,
-                                  const std::vector<uint8_t>& data,
-                                  bool mipmaps)
+        std::unique_ptr<Loader::Decoded> MtlLoader::decode(const std::string& name,
+                                                           const storage::FileData& data,
+                                                           bool)
         {
+            auto decoded = std::make_unique<DecodedMaterials>();
+
             std::string materialName = name;
-            std::shared_ptr<graphics::Texture> diffuseTexture;
-            std::shared_ptr<graphics::Texture> ambientTexture;
+            std::string diffuseTexture;
+            std::string ambientTexture;
             Color diffuseColor = Color::white();
             float opacity = 1.0F;
 
             uint32_t materialCount = 0;
 
-            auto iterator = data.cbegin();
+            auto iterator = data.begin();
 
             std::string keyword;
             std::string value;
@@ -155,16 +175,7 @@ namespace ouzel
                     {
                         if (materialCount)
                         {
-                            auto material = std::make_unique<graphics::Material>();
-                            material->blendState = cache.getBlendState(BLEND_ALPHA);
-                            material->shader = cache.getShader(SHADER_TEXTURE);
-                            material->textures[0] = diffuseTexture;
-                            material->textures[1] = ambientTexture;
-                            material->diffuseColor = diffuseColor;
-                            material->opacity = opacity;
-                            material->cullMode = graphics::CullMode::Back;
-
-                            bundle.setMaterial(materialName, std::move(material));
+                            decoded->materials.push_back({materialName, diffuseTexture, ambientTexture, diffuseColor, opacity});
                         }
 
                         skipWhitespaces(iterator, data.end());
@@ -172,8 +183,8 @@ namespace ouzel
 
                         skipLine(iterator, data.end());
 
-                        diffuseTexture.reset();
-                        ambientTexture.reset();
+                        diffuseTexture.clear();
+                        ambientTexture.clear();
                         diffuseColor = Color::white();
                         opacity = 1.0F;
                     }
@@ -184,7 +195,7 @@ namespace ouzel
 
                         skipLine(iterator, data.end());
 
-                        ambientTexture = cache.getTexture(value);
+                        ambientTexture = value;
                     }
                     else if (keyword == "map_Kd") // diffuse texture map
                     {
@@ -193,13 +204,8 @@ namespace ouzel
 
                         skipLine(iterator, data.end());
 
-                        diffuseTexture = cache.getTexture(value);
-
-                        if (!diffuseTexture)
-                        {
-                            bundle.loadAsset(Loader::Image, value, value, mipmaps);
-                            diffuseTexture = cache.getTexture(value);
-                        }
+                        diffuseTexture = value;
+                        decoded->dependencies.emplace_back(Loader::Image, value);
                     }
                     else if (keyword == "Ka") // ambient color
                         skipLine(iterator, data.end());
@@ -253,17 +259,30 @@ namespace ouzel
             }
 
             if (materialCount)
+                decoded->materials.push_back({materialName, diffuseTexture, ambientTexture, diffuseColor, opacity});
+
+            return decoded;
+        }
+
+        bool MtlLoader::createAsset(Bundle& bundle,
+                                    const std::string&,
+                                    const Decoded& decoded,
+                                    bool)
+        {
+            for (const auto& materialData : static_cast<const DecodedMaterials&>(decoded).materials)
             {
                 auto material = std::make_unique<graphics::Material>();
                 material->blendState = cache.getBlendState(BLEND_ALPHA);
                 material->shader = cache.getShader(SHADER_TEXTURE);
-                material->textures[0] = diffuseTexture;
-                material->textures[1] = ambientTexture;
-                material->diffuseColor = diffuseColor;
-                material->opacity = opacity;
+                if (!materialData.diffuseTexture.empty())
+                    material->textures[0] = cache.getTexture(materialData.diffuseTexture);
+                if (!materialData.ambientTexture.empty())
+                    material->textures[1] = cache.getTexture(materialData.ambientTexture);
+                material->diffuseColor = materialData.diffuseColor;
+                material->opacity = materialData.opacity;
                 material->cullMode = graphics::CullMode::Back;
 
-                bundle.setMaterial(materialName, std::move(material));
+                bundle.setMaterial(materialData.name, std::move(material));
             }
 
             return true;
@@ -31,8 +31,8 @@ namespace ouzel
                 return c <= 0x1F;
             }
 
-            void skipWhitespaces(std::vector<uint8_t>::const_iterator& iterator,
-                                 std::vector<uint8_t>::const_iterator end)
+            void skipWhitespaces(const uint8_t*& iterator,
+                                 const uint8_t* end)
             {
                 while (iterator != end)
                     if (isWhitespace(*iterator))
@@ -41,8 +41,8 @@ namespace ouzel
                         break;
             }
 
-            void skipLine(std::vector<uint8_t>::const_iterator& iterator,
-                          std::vector<uint8_t>::const_iterator end)
+            void skipLine(const uint8_t*& iterator,
+                          const uint8_t* end)
             {
                 while (iterator != end)
                 {
@@ -56,8 +56,8 @@ namespace ouzel
                 }
             }
 
-            std::string parseString(std::vector<uint8_t>::const_iterator& iterator,
-                                    std::vector<uint8_t>::const_iterator end)
+            std::string parseString(const uint8_t*& iterator,
+                                    const uint8_t* end)
             {
                 std::string result;
 
@@ -74,8 +74,8 @@ namespace ouzel
                 return result;
             }
 
-            int32_t parseInt32(std::vector<uint8_t>::const_iterator& iterator,
-                               std::vector<uint8_t>::const_iterator end)
+            int32_t parseInt32(const uint8_t*& iterator,
+                               const uint8_t* end)
             {
                 std::string value;
                 uint32_t length = 1;
@@ -99,8 +99,8 @@ namespace ouzel
                 return std::stoi(value);
             }
 
-            float parseFloat(std::vector<uint8_t>::const_iterator& iterator,
-                             std::vector<uint8_t>::const_iterator end)
+            float parseFloat(const uint8_t*& iterator,
+                             const uint8_t* end)
             {
                 std::string value;
                 uint32_t length = 1;
@@ -138,8 +138,8 @@ namespace ouzel
                 return std::stof(value);
             }
 
-            bool parseToken(const std::vector<uint8_t>& str,
-                            std::vector<uint8_t>::const_iterator& iterator,
+            bool parseToken(const storage::FileData& str,
+                            const uint8_t*& iterator,
                             char token)
             {
                 if (iterator == str.end() || *iterator != static_cast<uint8_t>(token)) return false;
@@ -150,18 +150,38 @@ namespace ouzel
             }
         }
 
+        namespace
+        {
+            class DecodedMeshes final: public Loader::Decoded
+            {
+            public:
+                class Mesh final
+                {
+                public:
+                    std::string name;
+                    std::string material;
+                    Box3F boundingBox;
+                    std::vector<uint32_t> indices;
+                    std::vector<graphics::Vertex> vertices;
+                };
+
+                std::vector<Mesh> meshes;
+            };
+        }
+
         ObjLoader::ObjLoader(Cache& initCache):
             Loader(initCache, Loader::StaticMesh)
         {
         }
 
-        bool ObjLoader::loadAsset(Bundle& bundle,
-                                  const std::string& name,
-                                  const std::vector<uint8_t>& data,
-                                  bool mipmaps)
+        std::unique_ptr<Loader::Decoded> ObjLoader::decode(const std::string& name,
+                                                           const storage::FileData& data,
+                                                           bool)
         {
+            auto decoded = std::make_unique<DecodedMeshes>();
+
             std::string objectName = name;
-            const graphics::Material* material = nullptr;
+            std::string material;
             std::vector<Vector3F> positions;
             std::vector<Vector2F> texCoords;
             std::vector<Vector3F> normals;
@@ -172,7 +192,7 @@ namespace ouzel
 
             uint32_t objectCount = 0;
 
-            auto iterator = data.cbegin();
+            auto iterator = data.begin();
 
             std::string keyword;
             std::string value;
@@ -201,9 +221,7 @@ namespace ouzel
 
                         skipLine(iterator, data.end());
 
-                        //if (!cache.getMaterial(filename))
-                        // TODO don't load material lib every time
-                        bundle.loadAsset(Loader::Material, value, value, mipmaps);
+                        decoded->dependencies.emplace_back(Loader::Material, value);
                     }
                     else if (keyword == "usemtl")
                     {
@@ -212,22 +230,19 @@ namespace ouzel
 
                         skipLine(iterator, data.end());
 
-                        material = cache.getMaterial(value);
+                        material = value;
                     }
                     else if (keyword == "o")
                     {
                         if (objectCount)
-                        {
-                            scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
-                            bundle.setStaticMeshData(objectName, std::move(meshData));
-                        }
+                            decoded->meshes.push_back({objectName, material, boundingBox, std::move(indices), std::move(vertices)});
 
                         skipWhitespaces(iterator, data.end());
                         objectName = parseString(iterator, data.end());
 
                         skipLine(iterator, data.end());
 
-                        material = nullptr;
+                        material.clear();
                         vertices.clear();
                         indices.clear();
                         vertexMap.clear();
@@ -379,9 +394,21 @@ namespace ouzel
             }
 
             if (objectCount)
+                decoded->meshes.push_back({objectName, material, boundingBox, std::move(indices), std::move(vertices)});
+
+            return decoded;
+        }
+
+        bool ObjLoader::createAsset(Bundle& bundle,
+                                    const std::string&,
+                                    const Decoded& decoded,
+                                    bool)
+        {
+            for (const auto& mesh : static_cast<const DecodedMeshes&>(decoded).meshes)
             {
-                scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
-                bundle.setStaticMeshData(objectName, std::move(meshData));
+                const graphics::Material* material = mesh.material.empty() ? nullptr : cache.getMaterial(mesh.material);
+                scene::StaticMeshData meshData(mesh.boundingBox, mesh.indices, mesh.vertices, material);
+                bundle.setStaticMeshData(mesh.name, std::move(meshData));
             }
 
             return true;
@@ -10,23 +10,33 @@ namespace ouzel
 {
     namespace assets
     {
+        namespace
+        {
+            class DecodedParticleSystem final: public Loader::Decoded
+            {
+            public:
+                scene::ParticleSystemData particleSystemData;
+                std::string textureFileName;
+            };
+        }
+
         ParticleSystemLoader::ParticleSystemLoader(Cache& initCache):
             Loader(initCache, Loader::ParticleSystem)
         {
         }
 
-        bool ParticleSystemLoader::loadAsset(Bundle& bundle,
-                                             const std::string& name,
-                                             const std::vector<uint8_t>& data,
-                                             bool mipmaps)
+        std::unique_ptr<Loader::Decoded> ParticleSystemLoader::decode(const std::string&,
+                                                                      const storage::FileData& data,
+                                                                      bool)
         {
-            scene::ParticleSystemData particleSystemData;
+            auto decoded = std::make_unique<DecodedParticleSystem>();
+            scene::ParticleSystemData& particleSystemData = decoded->particleSystemData;
 
             const json::Data d(data);
 
             if (!d.hasMember("textureFileName") ||
                 !d.hasMember("configName"))
-                return false;
+                return nullptr;
 
             particleSystemData.name = d["configName"].as<std::string>();
 
@@ -39,7 +49,7 @@ namespace ouzel
                 {
                     case 0: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::Gravity; break;
                     case 1: particleSystemData.emitterType = scene::ParticleSystemData::EmitterType::Radius; break;
-                    default: return false;
+                    default: return nullptr;
                 }
             }
 
@@ -110,18 +120,26 @@ namespace ouzel
 
             if (d.hasMember("textureFileName"))
             {
-                auto textureFileName = d["textureFileName"].as<std::string>();
-                particleSystemData.texture = cache.getTexture(textureFileName);
-
-                if (!particleSystemData.texture)
-                {
-                    bundle.loadAsset(Loader::Image, textureFileName, textureFileName, mipmaps);
-                    particleSystemData.texture = cache.getTexture(textureFileName);
-                }
+                decoded->textureFileName = d["textureFileName"].as<std::string>();
+                decoded->dependencies.emplace_back(Loader::Image, decoded->textureFileName);
             }
 
             particleSystemData.emissionRate = static_cast<float>(particleSystemData.maxParticles) / particleSystemData.particleLifespan;
 
+            return decoded;
+        }
+
+        bool ParticleSystemLoader::createAsset(Bundle& bundle,
+                                               const std::string& name,
+                                               const Decoded& decoded,
+                                               bool)
+        {
+            const auto& particleSystem = static_cast<const DecodedParticleSystem&>(decoded);
+
+            scene::ParticleSystemData particleSystemData = particleSystem.particleSystemData;
+            if (!particleSystem.textureFileName.empty())
+                particleSystemData.texture = cache.getTexture(particleSystem.textureFileName);
+
             bundle.setParticleSystemData(name, particleSystemData);
 
             return true;
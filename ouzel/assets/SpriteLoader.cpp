@@ -11,33 +11,54 @@ namespace ouzel
 {
     namespace assets
     {
+        namespace
+        {
+            class DecodedSprite final: public Loader::Decoded
+            {
+            public:
+                explicit DecodedSprite(const storage::FileData& initData):
+                    data(initData)
+                {
+                }
+
+                json::Data data;
+                std::string imageFilename;
+            };
+        }
+
         SpriteLoader::SpriteLoader(Cache& initCache):
             Loader(initCache, Loader::Sprite)
         {
         }
 
-        bool SpriteLoader::loadAsset(Bundle& bundle,
-                                     const std::string& name,
-                                     const std::vector<uint8_t>& data,
-                                     bool mipmaps)
+        std::unique_ptr<Loader::Decoded> SpriteLoader::decode(const std::string&,
+                                                              const storage::FileData& data,
+                                                              bool)
         {
-            scene::SpriteData spriteData;
+            auto decoded = std::make_unique<DecodedSprite>(data);
 
-            const json::Data d(data);
+            if (!decoded->data.hasMember("meta") ||
+                !decoded->data.hasMember("frames"))
+                return nullptr;
 
-            if (!d.hasMember("meta") ||
-                !d.hasMember("frames"))
-                return false;
+            const json::Value& metaObject = decoded->data["meta"];
 
-            const json::Value& metaObject = d["meta"];
+            decoded->imageFilename = metaObject["image"].as<std::string>();
+            decoded->dependencies.emplace_back(Loader::Image, decoded->imageFilename);
 
-            auto imageFilename = metaObject["image"].as<std::string>();
-            spriteData.texture = cache.getTexture(imageFilename);
-            if (!spriteData.texture)
-            {
-                bundle.loadAsset(Loader::Image, imageFilename, imageFilename, mipmaps);
-                spriteData.texture = cache.getTexture(imageFilename);
-            }
+            return decoded;
+        }
+
+        bool SpriteLoader::createAsset(Bundle& bundle,
+                                       const std::string& name,
+                                       const Decoded& decoded,
+                                       bool)
+        {
+            const auto& sprite = static_cast<const DecodedSprite&>(decoded);
+            const json::Data& d = sprite.data;
+
+            scene::SpriteData spriteData;
+            spriteData.texture = cache.getTexture(sprite.imageFilename);
 
             if (!spriteData.texture)
                 return false;
@@ -15,7 +15,7 @@ namespace ouzel
             explicit TtfLoader(Cache& initCache);
             bool loadAsset(Bundle& bundle,
                            const std::string& name,
-                           const std::vector<uint8_t>& data,
+                           const storage::FileData& data,
                            bool mipmaps = true) final;
         };
     } // namespace assets
@@ -5,26 +5,36 @@
 #include "Bundle.hpp"
 #include "audio/PcmClip.hpp"
 #include "core/Engine.hpp"
+#include "math/Fnv.hpp"
 
 enum WaveFormat
 {
     PCM = 1,
-    IEEE_FLOAT = 3
+    IEEE_FLOAT = 3,
+    IMA_ADPCM = 0x11
 };
 
 namespace ouzel
 {
     namespace assets
     {
+        namespace
+        {
+            class DecodedSound final: public Loader::Decoded
+            {
+            public:
+                std::shared_ptr<const audio::PcmBuffer> buffer;
+            };
+        }
+
         WaveLoader::WaveLoader(Cache& initCache):
             Loader(initCache, Loader::Sound)
         {
         }
 
-        bool WaveLoader::loadAsset(Bundle& bundle,
-                                   const std::string& name,
-                                   const std::vector<uint8_t>& data,
-                                   bool)
+        std::unique_ptr<Loader::Decoded> WaveLoader::decode(const std::string&,
+                                                            const storage::FileData& data,
+                                                            bool)
         {
             try
             {
@@ -63,6 +73,8 @@ namespace ouzel
 
                 uint16_t bitsPerSample = 0;
                 uint16_t formatTag = 0;
+                uint16_t blockAlign = 0;
+                uint32_t frameCount = 0;
                 std::vector<uint8_t> soundData;
 
                 for (uint32_t offset = typeOffset + 4; offset < data.size();)
@@ -98,7 +110,7 @@ namespace ouzel
                         formatTag = static_cast<uint16_t>(data[formatTagOffset + 0] |
                                                           (data[formatTagOffset + 1] << 8));
 
-                        if (formatTag != PCM && formatTag != IEEE_FLOAT)
+                        if (formatTag != PCM && formatTag != IEEE_FLOAT && formatTag != IMA_ADPCM)
                             throw std::runtime_error("Failed to load sound file, unsupported format");
 
                         const uint32_t channelsOffset = formatTagOffset + 2;
@@ -119,14 +131,27 @@ namespace ouzel
 
                         const uint32_t byteRateOffset = sampleRateOffset + 4;
                         const uint32_t blockAlignOffset = byteRateOffset + 4;
+                        blockAlign = static_cast<uint16_t>(data[blockAlignOffset + 0] |
+                                                           (data[blockAlignOffset + 1] << 8));
+
                         const uint32_t bitsPerSampleOffset = blockAlignOffset + 2;
                         bitsPerSample = static_cast<uint16_t>(data[bitsPerSampleOffset + 0] |
                                                               (data[bitsPerSampleOffset + 1] << 8));
 
-                        if (bitsPerSample != 8 && bitsPerSample != 16 &&
-                            bitsPerSample != 24 && bitsPerSample != 32)
+                        if (formatTag == IMA_ADPCM ? bitsPerSample != 4 :
+                            (bitsPerSample != 8 && bitsPerSample != 16 &&
+                             bitsPerSample != 24 && bitsPerSample != 32))
                             throw std::runtime_error("Failed to load sound file, unsupported bit depth");
                     }
+                    else if (chunkHeader[0] == 'f' && chunkHeader[1] == 'a' && chunkHeader[2] == 'c' && chunkHeader[3] == 't')
+                    {
+                        // the number of frames of compressed formats
+                        if (chunkSize >= 4)
+                            frameCount = static_cast<uint32_t>(data[offset + 0] |
+                                                               (data[offset + 1] << 8) |
+                                                               (data[offset + 2] << 16) |
+                                                               (data[offset + 3] << 24));
+                    }
                     else if (chunkHeader[0] == 'd' && chunkHeader[1] == 'a' && chunkHeader[2] == 't' && chunkHeader[3] == 'a')
                         soundData.assign(data.begin() + static_cast<int>(offset), data.begin() + static_cast<int>(offset + chunkSize));
 
@@ -137,63 +162,89 @@ namespace ouzel
                 if (!formatTag)
                     throw std::runtime_error("Failed to load sound file, failed to find a format chunk");
 
-                if (data.empty())
+                if (soundData.empty())
                     throw std::runtime_error("Failed to load sound file, failed to find a data chunk");
 
-                const auto sampleCount = static_cast<uint32_t>(soundData.size() / (bitsPerSample / 8));
-                const auto frames = sampleCount / channels;
-                std::vector<float> samples(sampleCount);
+                // 8 and 16-bit samples and compressed blocks are kept in their own encoding and converted when they are mixed
+                std::shared_ptr<const audio::PcmBuffer> buffer;
 
-                if (formatTag == PCM)
+                if (formatTag == IMA_ADPCM)
+                    buffer = std::make_shared<audio::PcmBuffer>(channels, sampleRate, frameCount, blockAlign, std::move(soundData));
+                else if (formatTag == PCM && bitsPerSample == 8)
                 {
-                    switch (bitsPerSample)
-                    {
-                        case 8:
-                        {
-                            for (uint32_t channel = 0; channel < channels; ++channel)
-                            {
-                                float* outputChannel = &samples[channel * frames];
+                    const auto frames = static_cast<uint32_t>(soundData.size() / channels);
+                    std::vector<int8_t> samples(frames * channels);
 
-                                for (uint32_t frame = 0; frame < frames; ++frame)
-                                {
-                                    uint8_t* sourceData = &soundData[frame * channels + channel];
-                                    outputChannel[frame] = 2.0F * sourceData[0] / 255.0F - 1.0F;
-                                }
-                            }
-                            break;
+                    // unsigned samples are centered at zero by flipping the sign bit
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                        for (uint32_t frame = 0; frame < frames; ++frame)
+                            samples[channel * frames + frame] = static_cast<int8_t>(soundData[frame * channels + channel] ^ 0x80);
+
+                    buffer = std::make_shared<audio::PcmBuffer>(channels, sampleRate, std::move(samples));
+                }
+                else if (formatTag == PCM && bitsPerSample == 16)
+                {
+                    const auto frames = static_cast<uint32_t>(soundData.size() / 2 / channels);
+                    std::vector<int16_t> samples(frames * channels);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                        for (uint32_t frame = 0; frame < frames; ++frame)
+                        {
+                            const uint8_t* sourceData = &soundData[(frame * channels + channel) * 2];
+                            samples[channel * frames + frame] = static_cast<int16_t>(sourceData[0] | (sourceData[1] << 8));
                         }
-                        case 16:
+
+                    buffer = std::make_shared<audio::PcmBuffer>(channels, sampleRate, std::move(samples));
+                }
+                else
+                {
+                    const auto frames = static_cast<uint32_t>(soundData.size() / (bitsPerSample / 8) / channels);
+                    std::vector<float> samples(frames * channels);
+
+                    if (formatTag == PCM)
+                    {
+                        switch (bitsPerSample)
                         {
-                            for (uint32_t channel = 0; channel < channels; ++channel)
+                            case 24:
                             {
-                                float* outputChannel = &samples[channel * frames];
-
-                                for (uint32_t frame = 0; frame < frames; ++frame)
+                                for (uint32_t channel = 0; channel < channels; ++channel)
                                 {
-                                    uint8_t* sourceData = &soundData[(frame * channels + channel) * 2];
-                                    outputChannel[frame] = static_cast<int16_t>(sourceData[0] |
-                                                                                (sourceData[1] << 8)) / 32767.0F;
+                                    float* outputChannel = &samples[channel * frames];
+
+                                    for (uint32_t frame = 0; frame < frames; ++frame)
+                                    {
+                                        const uint8_t* sourceData = &soundData[(frame * channels + channel) * 3];
+                                        outputChannel[frame] = static_cast<float>(static_cast<int32_t>((sourceData[0] << 8) |
+                                                                                                       (sourceData[1] << 16) |
+                                                                                                       (sourceData[2] << 24)) / 2147483648.0);
+                                    }
                                 }
+                                break;
                             }
-                            break;
-                        }
-                        case 24:
-                        {
-                            for (uint32_t channel = 0; channel < channels; ++channel)
+                            case 32:
                             {
-                                float* outputChannel = &samples[channel * frames];
-
-                                for (uint32_t frame = 0; frame < frames; ++frame)
+                                for (uint32_t channel = 0; channel < channels; ++channel)
                                 {
-                                    const uint8_t* sourceData = &soundData[(frame * channels + channel) * 3];
-                                    outputChannel[frame] = static_cast<float>(static_cast<int32_t>((sourceData[0] << 8) |
-                                                                                                   (sourceData[1] << 16) |
-                                                                                                   (sourceData[2] << 24)) / 2147483648.0);
+                                    float* outputChannel = &samples[channel * frames];
+
+                                    for (uint32_t frame = 0; frame < frames; ++frame)
+                                    {
+                                        const uint8_t* sourceData = &soundData[(frame * channels + channel) * 4];
+                                        outputChannel[frame] = static_cast<float>(static_cast<int32_t>(sourceData[0] |
+                                                                                                       (sourceData[1] << 8) |
+                                                                                                       (sourceData[2] << 16) |
+                                                                                                       (sourceData[3] << 24)) / 2147483648.0);
+                                    }
                                 }
+                                break;
                             }
-                            break;
+                            default:
+                                throw std::runtime_error("Failed to load sound file, unsupported bit depth");
                         }
-                        case 32:
+                    }
+                    else if (formatTag == IEEE_FLOAT)
+                    {
+                        if (bitsPerSample == 32)
                         {
                             for (uint32_t channel = 0; channel < channels; ++channel)
                             {
@@ -201,46 +252,63 @@ namespace ouzel
 
                                 for (uint32_t frame = 0; frame < frames; ++frame)
                                 {
-                                    const uint8_t* sourceData = &soundData[(frame * channels + channel) * 4];
-                                    outputChannel[frame] = static_cast<float>(static_cast<int32_t>(sourceData[0] |
-                                                                                                   (sourceData[1] << 8) |
-                                                                                                   (sourceData[2] << 16) |
-                                                                                                   (sourceData[3] << 24)) / 2147483648.0);
+                                    uint8_t* sourceData = &soundData[(frame * channels + channel) * 4];
+                                    memcpy(&outputChannel[frame], sourceData, sizeof(float));
                                 }
                             }
-                            break;
                         }
-                        default:
+                        else
                             throw std::runtime_error("Failed to load sound file, unsupported bit depth");
                     }
+
+                    buffer = std::make_shared<audio::PcmBuffer>(channels, sampleRate, std::move(samples));
                 }
-                else if (formatTag == IEEE_FLOAT)
+
+                // FNV-1 hash of the file, the buffers with the same hash are compared sample by sample
+                const uint64_t hash = fnv::hash<uint64_t>(data.begin(), data.end());
+
+                auto decoded = std::make_unique<DecodedSound>();
+
+                std::lock_guard<std::mutex> lock(buffersMutex);
+
+                const auto range = buffers.equal_range(hash);
+                for (auto i = range.first; i != range.second; ++i)
                 {
-                    if (bitsPerSample == 32)
+                    std::shared_ptr<const audio::PcmBuffer> sharedBuffer = i->second.lock();
+                    if (sharedBuffer && *sharedBuffer == *buffer)
                     {
-                        for (uint32_t channel = 0; channel < channels; ++channel)
-                        {
-                            float* outputChannel = &samples[channel * frames];
-
-                            for (uint32_t frame = 0; frame < frames; ++frame)
-                            {
-                                uint8_t* sourceData = &soundData[(frame * channels + channel) * 4];
-                                memcpy(&outputChannel[frame], sourceData, sizeof(float));
-                            }
-                        }
+                        decoded->buffer = std::move(sharedBuffer);
+                        return decoded;
                     }
+                }
+
+                // the buffers of the released sounds are not kept
+                for (auto i = buffers.begin(); i != buffers.end();)
+                {
+                    if (i->second.expired())
+                        i = buffers.erase(i);
                     else
-                        throw std::runtime_error("Failed to load sound file, unsupported bit depth");
+                        ++i;
                 }
 
-                auto sound = std::make_unique<audio::PcmClip>(*engine->getAudio(), channels, sampleRate, samples);
-                bundle.setSound(name, std::move(sound));
+                buffers.emplace(hash, buffer);
+
+                decoded->buffer = std::move(buffer);
+                return decoded;
             }
             catch (const std::exception&)
             {
-                return false;
+                return nullptr;
             }
+        }
 
+        bool WaveLoader::createAsset(Bundle& bundle,
+                                     const std::string& name,
+                                     const Decoded& decoded,
+                                     bool)
+        {
+            const auto& sound = static_cast<const DecodedSound&>(decoded);
+            bundle.setSound(name, std::make_unique<audio::PcmClip>(*engine->getAudio(), sound.buffer));
             return true;
         }
     } // namespace assets
@@ -3,20 +3,38 @@
 #ifndef OUZEL_ASSETS_WAVELOADER_HPP
 #define OUZEL_ASSETS_WAVELOADER_HPP
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "assets/Loader.hpp"
 
 namespace ouzel
 {
+    namespace audio
+    {
+        class PcmBuffer;
+    }
+
     namespace assets
     {
         class WaveLoader final: public Loader
         {
         public:
             explicit WaveLoader(Cache& initCache);
-            bool loadAsset(Bundle& bundle,
-                           const std::string& name,
-                           const std::vector<uint8_t>& data,
-                           bool mipmaps = true) final;
+            std::unique_ptr<Decoded> decode(const std::string& name,
+                                            const storage::FileData& data,
+                                            bool mipmaps = true) final;
+            bool createAsset(Bundle& bundle,
+                             const std::string& name,
+                             const Decoded& decoded,
+                             bool mipmaps = true) final;
+
+        private:
+            // samples of the loaded files by the hash of the file data, so that identical files share them,
+            // different files can have the same hash
+            std::mutex buffersMutex; // decode is called from the loading threads
+            std::unordered_multimap<uint64_t, std::weak_ptr<const audio::PcmBuffer>> buffers;
         };
     } // namespace assets
 } // namespace ouzel
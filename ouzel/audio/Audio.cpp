@@ -5,11 +5,13 @@
 #include "Audio.hpp"
 #include "AudioDevice.hpp"
 #include "Listener.hpp"
+#include "Voice.hpp"
 #include "alsa/ALSAAudioDevice.hpp"
 #include "core/Engine.hpp"
 #include "coreaudio/CAAudioDevice.hpp"
 #include "dsound/DSAudioDevice.hpp"
 #include "empty/EmptyAudioDevice.hpp"
+#include "offline/OfflineAudioDevice.hpp"
 #include "openal/OALAudioDevice.hpp"
 #include "opensl/OSLAudioDevice.hpp"
 #include "xaudio2/XA2AudioDevice.hpp"
@@ -45,6 +47,8 @@ namespace ouzel
             }
             else if (driver == "empty")
                 return Driver::Empty;
+            else if (driver == "offline")
+                return Driver::Offline;
             else if (driver == "openal")
                 return Driver::OpenAL;
             else if (driver == "directsound")
@@ -63,6 +67,16 @@ namespace ouzel
                 throw std::runtime_error("Invalid audio driver");
         }
 
+        mixer::Resampler::Quality Audio::getResamplerQuality(const std::string& quality)
+        {
+            if (quality.empty() || quality == "default" || quality == "polyphase")
+                return mixer::Resampler::Quality::Polyphase;
+            else if (quality == "linear")
+                return mixer::Resampler::Quality::Linear;
+            else
+                throw std::runtime_error("Invalid resampler quality");
+        }
+
         std::set<Driver> Audio::getAvailableAudioDrivers()
         {
             static std::set<Driver> availableDrivers;
@@ -70,6 +84,7 @@ namespace ouzel
             if (availableDrivers.empty())
             {
                 availableDrivers.insert(Driver::Empty);
+                availableDrivers.insert(Driver::Offline);
 
 #if OUZEL_COMPILE_OPENAL
                 availableDrivers.insert(Driver::OpenAL);
@@ -105,6 +120,9 @@ namespace ouzel
             {
                 switch (driver)
                 {
+                    case Driver::Offline:
+                        engine->log(Log::Level::Info) << "Using offline audio driver";
+                        return std::make_unique<offline::AudioDevice>(512, 44100, 0, dataGetter);
 #if OUZEL_COMPILE_OPENAL
                     case Driver::OpenAL:
                         engine->log(Log::Level::Info) << "Using OpenAL audio driver";
@@ -148,12 +166,18 @@ namespace ouzel
             }
         }
 
-        Audio::Audio(Driver driver, bool debugAudio):
+        Audio::Audio(Driver driver, bool debugAudio, uint32_t lookahead, uint32_t maxVoices,
+                     uint32_t mixThreads, uint32_t decoderThreads, uint32_t decodeAhead,
+                     mixer::Resampler::Quality initResamplerQuality):
+            // the offline device pulls faster than real time, so nothing is rendered or decoded ahead of it
+            decoderPool((driver == Driver::Offline) ? 0 : decoderThreads, decodeAhead),
             device(createAudioDevice(driver,
                                      std::bind(&Audio::getSamples, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
                                      debugAudio)),
-            mixer(device->getBufferSize(), device->getChannels(),
+            mixer(device->getBufferSize(), device->getChannels(), device->getSampleRate(),
+                  (driver == Driver::Offline) ? 0 : lookahead, maxVoices, mixThreads,
                   std::bind(&Audio::eventCallback, this, std::placeholders::_1)),
+            resamplerQuality(initResamplerQuality),
             masterMix(*this),
             rootNode(*this) // mixer.getRootObjectId()
         {
@@ -163,14 +187,23 @@ namespace ouzel
 
         void Audio::update()
         {
-            // TODO: handle events from the audio device
+            mixer::Mixer::Event event;
+            while (mixer.getEvent(event))
+                if (event.type == mixer::Mixer::Event::Type::StreamStopped)
+                {
+                    auto i = voices.find(event.objectId);
+                    if (i != voices.end()) i->second->finish();
+                }
 
-            mixer.submitCommandBuffer(std::move(commandBuffer));
-            commandBuffer = mixer::CommandBuffer();
+            // if the mixer is behind, the commands are kept and submitted together with the next ones
+            if (mixer.submitCommandBuffer(std::move(commandBuffer)))
+                commandBuffer = mixer::CommandBuffer();
         }
 
         void Audio::deleteObject(uintptr_t objectId)
         {
+            dataObjects.erase(objectId);
+            voices.erase(objectId);
             addCommand(std::make_unique<mixer::DeleteObjectCommand>(objectId));
         }
 
@@ -181,16 +214,27 @@ namespace ouzel
             return busId;
         }
 
-        uintptr_t Audio::initStream(uintptr_t sourceId)
+        uintptr_t Audio::initStream(uintptr_t sourceId, int32_t priority, uint32_t maxInstances, Voice* voice)
         {
+            auto i = dataObjects.find(sourceId);
+            if (i == dataObjects.end())
+                throw std::runtime_error("Invalid data object");
+
+            std::unique_ptr<mixer::Stream> stream = i->second->createStream();
+            stream->initResampler(device->getSampleRate(), resamplerQuality);
+            stream->setPriority(priority);
+            stream->setMaxInstances(maxInstances);
+
             uintptr_t streamId = mixer.getObjectId();
-            addCommand(std::make_unique<mixer::InitStreamCommand>(streamId, sourceId));
+            voices[streamId] = voice;
+            addCommand(std::make_unique<mixer::InitStreamCommand>(streamId, std::move(stream)));
             return streamId;
         }
 
         uintptr_t Audio::initData(std::unique_ptr<mixer::Data> data)
         {
             uintptr_t dataId = mixer.getObjectId();
+            dataObjects[dataId] = data.get();
             addCommand(std::make_unique<mixer::InitDataCommand>(dataId, std::move(data)));
             return dataId;
         }
@@ -209,7 +253,10 @@ namespace ouzel
 
         void Audio::getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate, std::vector<float>& samples)
         {
-            mixer.getSamples(frames, channels, sampleRate, samples);
+            // the mixer was created with the channel count and sample rate of the device
+            static_cast<void>(channels);
+            static_cast<void>(sampleRate);
+            mixer.getSamples(frames, samples);
         }
 
         void Audio::eventCallback(const mixer::Mixer::Event& event)
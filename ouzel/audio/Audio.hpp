@@ -7,14 +7,17 @@
 #include <functional>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include "audio/AudioDevice.hpp"
 #include "audio/Driver.hpp"
 #include "audio/Mix.hpp"
 #include "audio/Node.hpp"
 #include "audio/mixer/Commands.hpp"
+#include "audio/mixer/DecoderPool.hpp"
 #include "audio/mixer/Processor.hpp"
 #include "audio/mixer/Mixer.hpp"
+#include "audio/mixer/Resampler.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector.hpp"
 
@@ -23,18 +26,24 @@ namespace ouzel
     namespace audio
     {
         class Listener;
+        class Voice;
 
         class Audio final
         {
         public:
-            Audio(Driver driver, bool debugAudio);
+            Audio(Driver driver, bool debugAudio, uint32_t lookahead, uint32_t maxVoices,
+                  uint32_t mixThreads, uint32_t decoderThreads, uint32_t decodeAhead,
+                  mixer::Resampler::Quality initResamplerQuality);
 
             static Driver getDriver(const std::string& driver);
+            static mixer::Resampler::Quality getResamplerQuality(const std::string& quality);
             static std::set<Driver> getAvailableAudioDrivers();
 
             inline auto getDevice() const noexcept { return device.get(); }
             inline mixer::Mixer& getMixer() { return mixer; }
+            inline mixer::DecoderPool& getDecoderPool() { return decoderPool; }
             inline Mix& getMasterMix() { return masterMix; }
+            inline auto getResamplerQuality() const noexcept { return resamplerQuality; }
 
             void update();
 
@@ -45,7 +54,8 @@ namespace ouzel
 
             void deleteObject(uintptr_t objectId);
             uintptr_t initBus();
-            uintptr_t initStream(uintptr_t sourceId);
+            // the voice is notified when the stream reaches its end
+            uintptr_t initStream(uintptr_t sourceId, int32_t priority, uint32_t maxInstances, Voice* voice);
             uintptr_t initData(std::unique_ptr<mixer::Data> data);
             uintptr_t initProcessor(std::unique_ptr<mixer::Processor> processor);
             void updateProcessor(uintptr_t processorId, const std::function<void(mixer::Processor*)>& updateFunction);
@@ -56,9 +66,15 @@ namespace ouzel
             void getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate, std::vector<float>& samples);
             void eventCallback(const mixer::Mixer::Event& event);
 
+            // destroyed last, because the streams of the mixer and the command buffers are registered in it
+            mixer::DecoderPool decoderPool;
             std::unique_ptr<AudioDevice> device;
             mixer::Mixer mixer;
             mixer::CommandBuffer commandBuffer;
+            mixer::Resampler::Quality resamplerQuality;
+            // streams are created on this thread, so the data objects are tracked here as well
+            std::unordered_map<uintptr_t, mixer::Data*> dataObjects;
+            std::unordered_map<uintptr_t, Voice*> voices;
             Mix masterMix;
             Node rootNode;
         };
@@ -1,6 +1,7 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include "AudioDevice.hpp"
+#include "Dsp.hpp"
 
 namespace ouzel
 {
@@ -30,30 +31,18 @@ namespace ouzel
             {
                 case SampleFormat::SignedInt16:
                 {
-                    result.resize(frames * channels * sizeof(int16_t));
-                    int16_t* resultPtr = reinterpret_cast<int16_t*>(result.data());
-
-                    for (uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        float* bufferChannel = &buffer[channel * frames];
+                    interleavedBuffer.resize(frames * channels);
+                    dsp::interleave(buffer.data(), channels, frames, interleavedBuffer.data());
 
-                        for (uint32_t frame = 0; frame < frames; ++frame)
-                            resultPtr[frame * channels + channel] = static_cast<int16_t>(bufferChannel[frame] * 32767.0F);
-                    }
+                    result.resize(frames * channels * sizeof(int16_t));
+                    dsp::floatToInt16(interleavedBuffer.data(), interleavedBuffer.size(),
+                                      reinterpret_cast<int16_t*>(result.data()));
                     break;
                 }
                 case SampleFormat::Float32:
                 {
                     result.resize(frames * channels * sizeof(float));
-                    float* resultPtr = reinterpret_cast<float*>(result.data());
-
-                    for (uint32_t channel = 0; channel < channels; ++channel)
-                    {
-                        float* bufferChannel = &buffer[channel * frames];
-
-                        for (uint32_t frame = 0; frame < frames; ++frame)
-                            resultPtr[frame * channels + channel] = bufferChannel[frame];
-                    }
+                    dsp::interleave(buffer.data(), channels, frames, reinterpret_cast<float*>(result.data()));
                     break;
                 }
                 default:
@@ -59,6 +59,7 @@ namespace ouzel
         private:
             std::function<void(uint32_t frames, uint32_t channels, uint32_t sampleRate, std::vector<float>& samples)> dataGetter;
             std::vector<float> buffer;
+            std::vector<float> interleavedBuffer;
         };
     } // namespace audio
 } // namespace ouzel
@@ -30,6 +30,7 @@ namespace ouzel
                 PitchScale,
                 PitchShift,
                 Reverb,
+                ConvolutionReverb,
                 LowPass,
                 HighPass
             };
@@ -41,6 +42,8 @@ namespace ouzel
             float scale = 1.0F;
             float shift = 1.0f;
             float decay = 0.0F;
+            float mix = 0.5F;
+            const Sound* impulseResponse = nullptr;
             std::pair<float, float> delayRandom{0.0F, 0.0F};
             std::pair<float, float> gainRandom{0.0F, 0.0F};
             std::pair<float, float> scaleRandom{0.0F, 0.0F};
@@ -10,6 +10,7 @@ namespace ouzel
         enum class Driver
         {
             Empty,
+            Offline,
             OpenAL,
             DirectSound,
             XAudio2,
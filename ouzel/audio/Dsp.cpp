@@ -0,0 +1,515 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <algorithm>
+#include "Dsp.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace dsp
+        {
+            namespace
+            {
+                constexpr float INT16_SCALE = 32767.0F;
+                constexpr float INT8_SCALE = 127.0F;
+                constexpr float S = 0.7071F; // -3 dB
+
+                struct ChannelMatrix final
+                {
+                    uint32_t sourceChannels;
+                    uint32_t channels;
+                    float gains[64];
+                };
+
+                const ChannelMatrix channelMatrices[] = {
+                    {1, 2, {1.0F,
+                            1.0F}},
+                    {1, 4, {1.0F,
+                            1.0F,
+                            0.0F,
+                            0.0F}},
+                    {1, 6, {0.0F,
+                            0.0F,
+                            1.0F,
+                            0.0F,
+                            0.0F,
+                            0.0F}},
+                    {1, 8, {0.0F,
+                            0.0F,
+                            1.0F,
+                            0.0F,
+                            0.0F,
+                            0.0F,
+                            0.0F,
+                            0.0F}},
+                    {2, 1, {0.5F, 0.5F}},
+                    {2, 4, {1.0F, 0.0F,
+                            0.0F, 1.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F}},
+                    {2, 6, {1.0F, 0.0F,
+                            0.0F, 1.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F}},
+                    {2, 8, {1.0F, 0.0F,
+                            0.0F, 1.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F,
+                            0.0F, 0.0F}},
+                    {4, 1, {0.25F, 0.25F, 0.25F, 0.25F}},
+                    {4, 2, {0.5F, 0.0F, 0.5F, 0.0F,
+                            0.0F, 0.5F, 0.0F, 0.5F}},
+                    {4, 6, {1.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 1.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 1.0F}},
+                    {4, 8, {1.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 1.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 1.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F}},
+                    {6, 1, {S, S, 1.0F, 0.0F, 0.5F, 0.5F}},
+                    {6, 2, {1.0F, 0.0F, S, 0.0F, S, 0.0F,
+                            0.0F, 1.0F, S, 0.0F, 0.0F, S}},
+                    {6, 4, {1.0F, 0.0F, S, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, S, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F}},
+                    {6, 8, {1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F}},
+                    {8, 1, {S, S, 1.0F, 0.0F, 0.5F, 0.5F, 0.5F, 0.5F}},
+                    {8, 2, {1.0F, 0.0F, S, 0.0F, S, 0.0F, S, 0.0F,
+                            0.0F, 1.0F, S, 0.0F, 0.0F, S, 0.0F, S}},
+                    {8, 4, {1.0F, 0.0F, S, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, S, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, S, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, S}},
+                    {8, 6, {1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, S, 0.0F,
+                            0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, S}}
+                };
+            }
+
+            void scale(const float* input, size_t count, float gain, float* output) noexcept
+            {
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                    for (; i + 4 <= count; i += 4)
+                        vst1q_f32(output + i, vmulq_n_f32(vld1q_f32(input + i), gain));
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 g = _mm_set1_ps(gain);
+                    for (; i + 4 <= count; i += 4)
+                        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), g));
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] = input[i] * gain;
+            }
+
+            void accumulate(const float* input, size_t count, float gain, float* output) noexcept
+            {
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                    for (; i + 4 <= count; i += 4)
+                        vst1q_f32(output + i, vmlaq_n_f32(vld1q_f32(output + i), vld1q_f32(input + i), gain));
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 g = _mm_set1_ps(gain);
+                    for (; i + 4 <= count; i += 4)
+                        _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i),
+                                                             _mm_mul_ps(_mm_loadu_ps(input + i), g)));
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] += input[i] * gain;
+            }
+
+            void accumulateRamp(const float* input, size_t count, float startGain, float endGain, float* output) noexcept
+            {
+                if (startGain == endGain)
+                {
+                    accumulate(input, count, endGain, output);
+                    return;
+                }
+
+                const float step = (endGain - startGain) / static_cast<float>(count);
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    const float initialGains[4] = {startGain, startGain + step, startGain + 2.0F * step, startGain + 3.0F * step};
+                    float32x4_t g = vld1q_f32(initialGains);
+                    const float32x4_t s = vdupq_n_f32(4.0F * step);
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        vst1q_f32(output + i, vmlaq_f32(vld1q_f32(output + i), vld1q_f32(input + i), g));
+                        g = vaddq_f32(g, s);
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    __m128 g = _mm_setr_ps(startGain, startGain + step, startGain + 2.0F * step, startGain + 3.0F * step);
+                    const __m128 s = _mm_set1_ps(4.0F * step);
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i),
+                                                             _mm_mul_ps(_mm_loadu_ps(input + i), g)));
+                        g = _mm_add_ps(g, s);
+                    }
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] += input[i] * (startGain + step * static_cast<float>(i));
+            }
+
+            void clip(float* samples, size_t count) noexcept
+            {
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    const float32x4_t minimum = vdupq_n_f32(-1.0F);
+                    const float32x4_t maximum = vdupq_n_f32(1.0F);
+                    for (; i + 4 <= count; i += 4)
+                        vst1q_f32(samples + i, vminq_f32(vmaxq_f32(vld1q_f32(samples + i), minimum), maximum));
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 minimum = _mm_set1_ps(-1.0F);
+                    const __m128 maximum = _mm_set1_ps(1.0F);
+                    for (; i + 4 <= count; i += 4)
+                        _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), minimum), maximum));
+                }
+#endif
+
+                for (; i < count; ++i)
+                    samples[i] = clamp(samples[i], -1.0F, 1.0F);
+            }
+
+            void interleave(const float* input, uint32_t channels, size_t frames, float* output) noexcept
+            {
+                size_t frame = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable && channels == 2)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        float32x4x2_t values;
+                        values.val[0] = vld1q_f32(input + frame);
+                        values.val[1] = vld1q_f32(input + frames + frame);
+                        vst2q_f32(output + frame * 2, values);
+                    }
+                }
+                else if (isSimdAvailable && channels == 4)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        float32x4x4_t values;
+                        for (uint32_t channel = 0; channel < 4; ++channel)
+                            values.val[channel] = vld1q_f32(input + channel * frames + frame);
+                        vst4q_f32(output + frame * 4, values);
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable && channels == 2)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const __m128 left = _mm_loadu_ps(input + frame);
+                        const __m128 right = _mm_loadu_ps(input + frames + frame);
+                        _mm_storeu_ps(output + frame * 2, _mm_unpacklo_ps(left, right));
+                        _mm_storeu_ps(output + frame * 2 + 4, _mm_unpackhi_ps(left, right));
+                    }
+                }
+                else if (isSimdAvailable && channels >= 4)
+                {
+                    // transposes blocks of four channels by four frames, the rest of the channels are copied one by one
+                    const uint32_t blockChannels = channels & ~3U;
+
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        for (uint32_t channel = 0; channel < blockChannels; channel += 4)
+                        {
+                            __m128 row0 = _mm_loadu_ps(input + (channel + 0) * frames + frame);
+                            __m128 row1 = _mm_loadu_ps(input + (channel + 1) * frames + frame);
+                            __m128 row2 = _mm_loadu_ps(input + (channel + 2) * frames + frame);
+                            __m128 row3 = _mm_loadu_ps(input + (channel + 3) * frames + frame);
+                            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                            _mm_storeu_ps(output + (frame + 0) * channels + channel, row0);
+                            _mm_storeu_ps(output + (frame + 1) * channels + channel, row1);
+                            _mm_storeu_ps(output + (frame + 2) * channels + channel, row2);
+                            _mm_storeu_ps(output + (frame + 3) * channels + channel, row3);
+                        }
+
+                        for (uint32_t channel = blockChannels; channel < channels; ++channel)
+                            for (size_t i = frame; i < frame + 4; ++i)
+                                output[i * channels + channel] = input[channel * frames + i];
+                    }
+                }
+#endif
+
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                    for (size_t i = frame; i < frames; ++i)
+                        output[i * channels + channel] = input[channel * frames + i];
+            }
+
+            void deinterleave(const float* input, uint32_t channels, size_t frames, float* output) noexcept
+            {
+                size_t frame = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable && channels == 2)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const float32x4x2_t values = vld2q_f32(input + frame * 2);
+                        vst1q_f32(output + frame, values.val[0]);
+                        vst1q_f32(output + frames + frame, values.val[1]);
+                    }
+                }
+                else if (isSimdAvailable && channels == 4)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const float32x4x4_t values = vld4q_f32(input + frame * 4);
+                        for (uint32_t channel = 0; channel < 4; ++channel)
+                            vst1q_f32(output + channel * frames + frame, values.val[channel]);
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable && channels == 2)
+                {
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        const __m128 first = _mm_loadu_ps(input + frame * 2);
+                        const __m128 second = _mm_loadu_ps(input + frame * 2 + 4);
+                        _mm_storeu_ps(output + frame, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+                        _mm_storeu_ps(output + frames + frame, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+                    }
+                }
+                else if (isSimdAvailable && channels >= 4)
+                {
+                    const uint32_t blockChannels = channels & ~3U;
+
+                    for (; frame + 4 <= frames; frame += 4)
+                    {
+                        for (uint32_t channel = 0; channel < blockChannels; channel += 4)
+                        {
+                            __m128 row0 = _mm_loadu_ps(input + (frame + 0) * channels + channel);
+                            __m128 row1 = _mm_loadu_ps(input + (frame + 1) * channels + channel);
+                            __m128 row2 = _mm_loadu_ps(input + (frame + 2) * channels + channel);
+                            __m128 row3 = _mm_loadu_ps(input + (frame + 3) * channels + channel);
+                            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                            _mm_storeu_ps(output + (channel + 0) * frames + frame, row0);
+                            _mm_storeu_ps(output + (channel + 1) * frames + frame, row1);
+                            _mm_storeu_ps(output + (channel + 2) * frames + frame, row2);
+                            _mm_storeu_ps(output + (channel + 3) * frames + frame, row3);
+                        }
+
+                        for (uint32_t channel = blockChannels; channel < channels; ++channel)
+                            for (size_t i = frame; i < frame + 4; ++i)
+                                output[channel * frames + i] = input[i * channels + channel];
+                    }
+                }
+#endif
+
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                    for (size_t i = frame; i < frames; ++i)
+                        output[channel * frames + i] = input[i * channels + channel];
+            }
+
+            void floatToInt16(const float* input, size_t count, int16_t* output) noexcept
+            {
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    const float32x4_t minimum = vdupq_n_f32(-1.0F);
+                    const float32x4_t maximum = vdupq_n_f32(1.0F);
+
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const float32x4_t low = vminq_f32(vmaxq_f32(vld1q_f32(input + i), minimum), maximum);
+                        const float32x4_t high = vminq_f32(vmaxq_f32(vld1q_f32(input + i + 4), minimum), maximum);
+                        const int32x4_t lowInt = vcvtq_s32_f32(vmulq_n_f32(low, INT16_SCALE));
+                        const int32x4_t highInt = vcvtq_s32_f32(vmulq_n_f32(high, INT16_SCALE));
+                        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(lowInt), vqmovn_s32(highInt)));
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 minimum = _mm_set1_ps(-1.0F);
+                    const __m128 maximum = _mm_set1_ps(1.0F);
+                    const __m128 factor = _mm_set1_ps(INT16_SCALE);
+
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), minimum), maximum);
+                        const __m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), minimum), maximum);
+                        const __m128i lowInt = _mm_cvttps_epi32(_mm_mul_ps(low, factor));
+                        const __m128i highInt = _mm_cvttps_epi32(_mm_mul_ps(high, factor));
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(lowInt, highInt));
+                    }
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] = static_cast<int16_t>(clamp(input[i], -1.0F, 1.0F) * INT16_SCALE);
+            }
+
+            void int16ToFloat(const int16_t* input, size_t count, float* output) noexcept
+            {
+                constexpr float factor = 1.0F / INT16_SCALE;
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const int16x8_t values = vld1q_s16(input + i);
+                        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))), factor));
+                        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))), factor));
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 factorVector = _mm_set1_ps(factor);
+
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+                        // sign extend by moving every value to the upper half of a 32-bit lane and shifting it back
+                        const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+                        const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+                        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), factorVector));
+                        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), factorVector));
+                    }
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] = input[i] * factor;
+            }
+
+            void int8ToFloat(const int8_t* input, size_t count, float* output) noexcept
+            {
+                constexpr float factor = 1.0F / INT8_SCALE;
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                {
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const int16x8_t values = vmovl_s8(vld1_s8(input + i));
+                        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))), factor));
+                        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))), factor));
+                    }
+                }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                {
+                    const __m128 factorVector = _mm_set1_ps(factor);
+
+                    for (; i + 16 <= count; i += 16)
+                    {
+                        const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+                        // sign extend to 16 and then to 32 bits the same way as in int16ToFloat
+                        const __m128i low = _mm_srai_epi16(_mm_unpacklo_epi8(values, values), 8);
+                        const __m128i high = _mm_srai_epi16(_mm_unpackhi_epi8(values, values), 8);
+                        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(low, low), 16)), factorVector));
+                        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(low, low), 16)), factorVector));
+                        _mm_storeu_ps(output + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(high, high), 16)), factorVector));
+                        _mm_storeu_ps(output + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(high, high), 16)), factorVector));
+                    }
+                }
+#endif
+
+                for (; i < count; ++i)
+                    output[i] = input[i] * factor;
+            }
+
+            const float* getChannelMatrix(uint32_t sourceChannels, uint32_t channels) noexcept
+            {
+                for (const ChannelMatrix& channelMatrix : channelMatrices)
+                    if (channelMatrix.sourceChannels == sourceChannels && channelMatrix.channels == channels)
+                        return channelMatrix.gains;
+
+                return nullptr;
+            }
+
+            void mixChannels(const float* input, uint32_t sourceChannels, size_t frames,
+                             const float* matrix, uint32_t channels, float* output) noexcept
+            {
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    const float* gains = matrix + channel * sourceChannels;
+                    float* outputChannel = output + channel * frames;
+                    bool written = false;
+
+                    // only the source channels that contribute to this channel are read
+                    for (uint32_t sourceChannel = 0; sourceChannel < sourceChannels; ++sourceChannel)
+                    {
+                        if (gains[sourceChannel] == 0.0F) continue;
+
+                        if (written)
+                            accumulate(input + sourceChannel * frames, frames, gains[sourceChannel], outputChannel);
+                        else
+                        {
+                            scale(input + sourceChannel * frames, frames, gains[sourceChannel], outputChannel);
+                            written = true;
+                        }
+                    }
+
+                    if (!written)
+                        std::fill(outputChannel, outputChannel + frames, 0.0F);
+                }
+            }
+        } // namespace dsp
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,49 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_DSP_HPP
+#define OUZEL_AUDIO_DSP_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // Sample processing kernels, vectorized with SSE2 or NEON when available.
+        // Planar buffers store every channel separately, interleaved buffers store the channels of each frame together.
+        namespace dsp
+        {
+            // output[i] = input[i] * gain
+            void scale(const float* input, size_t count, float gain, float* output) noexcept;
+
+            // output[i] += input[i] * gain
+            void accumulate(const float* input, size_t count, float gain, float* output) noexcept;
+
+            // output[i] += input[i] * gain, where gain changes linearly from startGain to endGain over the samples
+            void accumulateRamp(const float* input, size_t count, float startGain, float endGain, float* output) noexcept;
+
+            // clamps the samples to [-1, 1]
+            void clip(float* samples, size_t count) noexcept;
+
+            void interleave(const float* input, uint32_t channels, size_t frames, float* output) noexcept;
+            void deinterleave(const float* input, uint32_t channels, size_t frames, float* output) noexcept;
+
+            // the samples are clipped to [-1, 1] before the conversion
+            void floatToInt16(const float* input, size_t count, int16_t* output) noexcept;
+            void int16ToFloat(const int16_t* input, size_t count, float* output) noexcept;
+            void int8ToFloat(const int8_t* input, size_t count, float* output) noexcept;
+
+            // Returns a row-major matrix with a row of source channel gains for every output channel,
+            // or nullptr if there is no mapping between the layouts.
+            // Layouts: 1 - M, 2 - L R, 4 - L R SL SR, 6 - L R C LFE SL SR, 8 - L R C LFE SL SR BL BR
+            const float* getChannelMatrix(uint32_t sourceChannels, uint32_t channels) noexcept;
+
+            // converts planar samples between channel layouts with a matrix from getChannelMatrix
+            void mixChannels(const float* input, uint32_t sourceChannels, size_t frames,
+                             const float* matrix, uint32_t channels, float* output) noexcept;
+        } // namespace dsp
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_DSP_HPP
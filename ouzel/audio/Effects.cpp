@@ -1,11 +1,18 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
 #include "Effects.hpp"
 #include "Audio.hpp"
+#include "Dsp.hpp"
+#include "Fft.hpp"
+#include "PcmClip.hpp"
+#include "mixer/Resampler.hpp"
+#include "mixer/Spatializer.hpp"
 #include "scene/Actor.hpp"
+#include "math/Constants.hpp"
 #include "math/MathUtils.hpp"
-#include "smbPitchShift.hpp"
 
 namespace ouzel
 {
@@ -145,9 +152,48 @@ namespace ouzel
             {
             }
 
-            void process(uint32_t frames, uint32_t channels, uint32_t sampleRate,
+            // the bus is mixed down to mono and panned as a single emitter for the listener of the bus
+            void process(uint32_t frames, uint32_t channels, uint32_t,
                          std::vector<float>& samples) final
             {
+                const mixer::Bus* listenerBus = getBus() ? getBus()->getListenerBus() : nullptr;
+
+                spatializer.clear();
+                spatializer.addEmitter(position, minDistance, maxDistance, rolloffFactor);
+                spatializer.update(listenerBus ? listenerBus->getListenerPosition() : Vector3F(),
+                                   listenerBus ? listenerBus->getListenerRotation() : QuaternionF::identity(),
+                                   channels);
+
+                if (gains.size() != channels) gains.assign(channels, 1.0F);
+
+                if (const float* matrix = dsp::getChannelMatrix(channels, 1))
+                {
+                    monoSamples.resize(frames);
+                    dsp::mixChannels(samples.data(), channels, frames, matrix, 1, monoSamples.data());
+                    std::fill(samples.begin(), samples.end(), 0.0F);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float gain = spatializer.getGains(channel)[0];
+                        dsp::accumulateRamp(monoSamples.data(), frames, gains[channel], gain,
+                                            samples.data() + channel * frames);
+                        gains[channel] = gain;
+                    }
+                }
+                else
+                {
+                    // layouts without a downmix are only attenuated
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        float* channelSamples = samples.data() + channel * frames;
+                        monoSamples.assign(channelSamples, channelSamples + frames);
+                        std::fill(channelSamples, channelSamples + frames, 0.0F);
+
+                        const float gain = spatializer.getGains(channel)[0];
+                        dsp::accumulateRamp(monoSamples.data(), frames, gains[channel], gain, channelSamples);
+                        gains[channel] = gain;
+                    }
+                }
             }
 
             void setPosition(const Vector3F& newPosition)
@@ -175,6 +221,10 @@ namespace ouzel
             float rolloffFactor = 1.0F;
             float minDistance = 1.0F;
             float maxDistance = FLT_MAX;
+
+            mixer::Spatializer spatializer;
+            std::vector<float> gains;
+            std::vector<float> monoSamples;
         };
 
         Panner::Panner(Audio& initAudio):
@@ -236,6 +286,150 @@ namespace ouzel
         {
             constexpr float MIN_PITCH = 0.5F;
             constexpr float MAX_PITCH = 2.0F;
+
+            // Changes the pitch of one channel without changing its duration with the short-time Fourier transform,
+            // based on smbPitchShift by Stephan M. Bernsee (The Wide Open License)
+            class PhaseVocoder final
+            {
+            public:
+                static constexpr uint32_t FRAME_SIZE = 1024;
+                static constexpr uint32_t OVERSAMPLING = 4;
+                static constexpr uint32_t STEP_SIZE = FRAME_SIZE / OVERSAMPLING;
+                static constexpr uint32_t LATENCY = FRAME_SIZE - STEP_SIZE;
+                static constexpr uint32_t BIN_COUNT = FRAME_SIZE / 2 + 1;
+
+                PhaseVocoder():
+                    fft(FRAME_SIZE),
+                    window(FRAME_SIZE),
+                    inputFifo(FRAME_SIZE),
+                    outputFifo(FRAME_SIZE),
+                    outputAccumulator(FRAME_SIZE),
+                    frame(FRAME_SIZE),
+                    real(BIN_COUNT),
+                    imag(BIN_COUNT),
+                    lastPhase(BIN_COUNT),
+                    sumPhase(BIN_COUNT),
+                    analysisMagnitude(BIN_COUNT),
+                    analysisFrequency(BIN_COUNT),
+                    synthesisMagnitude(BIN_COUNT),
+                    synthesisFrequency(BIN_COUNT)
+                {
+                    // Hann window
+                    for (uint32_t k = 0; k < FRAME_SIZE; ++k)
+                        window[k] = 0.5F * (1.0F - std::cos(2.0F * pi<float> * static_cast<float>(k) / static_cast<float>(FRAME_SIZE)));
+                }
+
+                PhaseVocoder(const PhaseVocoder&) = delete;
+                PhaseVocoder& operator=(const PhaseVocoder&) = delete;
+
+                PhaseVocoder(PhaseVocoder&&) = delete;
+                PhaseVocoder& operator=(PhaseVocoder&&) = delete;
+
+                // the output is delayed by LATENCY frames
+                void process(float scale, uint32_t frames, uint32_t sampleRate, float* samples)
+                {
+                    for (uint32_t i = 0; i < frames; ++i)
+                    {
+                        inputFifo[rover] = samples[i];
+                        samples[i] = outputFifo[rover - LATENCY];
+                        ++rover;
+
+                        if (rover >= FRAME_SIZE)
+                        {
+                            rover = LATENCY;
+                            processFrame(scale, sampleRate);
+                        }
+                    }
+                }
+
+            private:
+                void processFrame(float scale, uint32_t sampleRate)
+                {
+                    const float frequencyPerBin = static_cast<float>(sampleRate) / static_cast<float>(FRAME_SIZE);
+                    constexpr float expected = 2.0F * pi<float> * static_cast<float>(STEP_SIZE) / static_cast<float>(FRAME_SIZE);
+
+                    for (uint32_t k = 0; k < FRAME_SIZE; ++k)
+                        frame[k] = inputFifo[k] * window[k];
+
+                    fft.forward(frame.data(), real.data(), imag.data());
+
+                    // analysis
+                    for (uint32_t k = 0; k < BIN_COUNT; ++k)
+                    {
+                        const float magnitude = 2.0F * std::sqrt(real[k] * real[k] + imag[k] * imag[k]);
+                        const float phase = (imag[k] == 0.0F) ? 0.0F :
+                            (real[k] == 0.0F) ? ((imag[k] > 0.0F) ? pi<float> / 2.0F : -pi<float> / 2.0F) :
+                            std::atan2(imag[k], real[k]);
+
+                        // the phase difference from the previous frame without the expected one
+                        float delta = phase - lastPhase[k] - static_cast<float>(k) * expected;
+                        lastPhase[k] = phase;
+
+                        // map the delta phase into the +/- pi interval
+                        auto qpd = static_cast<int32_t>(delta / pi<float>);
+                        if (qpd >= 0) qpd += qpd & 1;
+                        else qpd -= qpd & 1;
+                        delta -= pi<float> * static_cast<float>(qpd);
+
+                        // the true frequency of the partial from its deviation from the bin frequency
+                        const float deviation = OVERSAMPLING * delta / (2.0F * pi<float>);
+                        analysisMagnitude[k] = magnitude;
+                        analysisFrequency[k] = (static_cast<float>(k) + deviation) * frequencyPerBin;
+                    }
+
+                    // pitch shifting
+                    std::fill(synthesisMagnitude.begin(), synthesisMagnitude.end(), 0.0F);
+                    std::fill(synthesisFrequency.begin(), synthesisFrequency.end(), 0.0F);
+                    for (uint32_t k = 0; k < BIN_COUNT; ++k)
+                    {
+                        const auto index = static_cast<uint32_t>(static_cast<float>(k) * scale);
+                        if (index >= BIN_COUNT) break;
+                        synthesisMagnitude[index] += analysisMagnitude[k];
+                        synthesisFrequency[index] = analysisFrequency[k] * scale;
+                    }
+
+                    // synthesis
+                    for (uint32_t k = 0; k < BIN_COUNT; ++k)
+                    {
+                        const float deviation = synthesisFrequency[k] / frequencyPerBin - static_cast<float>(k);
+
+                        // accumulate the phase advance of the frame
+                        sumPhase[k] += 2.0F * pi<float> * deviation / OVERSAMPLING + static_cast<float>(k) * expected;
+
+                        real[k] = synthesisMagnitude[k] * std::cos(sumPhase[k]);
+                        imag[k] = synthesisMagnitude[k] * std::sin(sumPhase[k]);
+                    }
+
+                    fft.inverse(real.data(), imag.data(), frame.data());
+
+                    // the inverse transform of the full spectrum sums both halves, so it is twice as loud as the original
+                    const float gain = 1.0F / (static_cast<float>(FRAME_SIZE / 2) * OVERSAMPLING);
+                    for (uint32_t k = 0; k < FRAME_SIZE; ++k)
+                        outputAccumulator[k] += window[k] * frame[k] * gain;
+
+                    std::copy(outputAccumulator.begin(), outputAccumulator.begin() + STEP_SIZE, outputFifo.begin());
+                    std::copy(outputAccumulator.begin() + STEP_SIZE, outputAccumulator.end(), outputAccumulator.begin());
+                    std::fill(outputAccumulator.end() - STEP_SIZE, outputAccumulator.end(), 0.0F);
+
+                    std::copy(inputFifo.begin() + STEP_SIZE, inputFifo.end(), inputFifo.begin());
+                }
+
+                dsp::Fft fft;
+                std::vector<float> window;
+                std::vector<float> inputFifo;
+                std::vector<float> outputFifo;
+                std::vector<float> outputAccumulator;
+                std::vector<float> frame;
+                std::vector<float> real;
+                std::vector<float> imag;
+                std::vector<float> lastPhase;
+                std::vector<float> sumPhase;
+                std::vector<float> analysisMagnitude;
+                std::vector<float> analysisFrequency;
+                std::vector<float> synthesisMagnitude;
+                std::vector<float> synthesisFrequency;
+                uint32_t rover = LATENCY;
+            };
         }
 
         class PitchScaleProcessor final: public mixer::Processor
@@ -249,12 +443,11 @@ namespace ouzel
             void process(uint32_t frames, uint32_t channels, uint32_t sampleRate,
                          std::vector<float>& samples) final
             {
-                pitchShift.resize(channels);
+                while (phaseVocoders.size() < channels)
+                    phaseVocoders.push_back(std::make_unique<PhaseVocoder>());
 
                 for (uint32_t channel = 0; channel < channels; ++channel)
-                    pitchShift[channel].process(scale, frames, sampleRate,
-                                                &samples[channel * frames],
-                                                &samples[channel * frames]);
+                    phaseVocoders[channel]->process(scale, frames, sampleRate, &samples[channel * frames]);
             }
 
             void setScale(float newScale)
@@ -264,7 +457,7 @@ namespace ouzel
 
         private:
             float scale = 1.0f;
-            std::vector<smb::PitchShift<1024, 4>> pitchShift;
+            std::vector<std::unique_ptr<PhaseVocoder>> phaseVocoders;
         };
 
         PitchScale::PitchScale(Audio& initAudio, float initScale):
@@ -399,6 +592,207 @@ namespace ouzel
         {
         }
 
+        // Uniformly partitioned overlap-save convolution, every block of input is transformed once
+        // and multiplied with the spectra of all the impulse response partitions in the frequency domain
+        class ConvolutionReverbProcessor final: public mixer::Processor
+        {
+        public:
+            static constexpr uint32_t PARTITION_SIZE = 512;
+
+            // the impulse response must have the sample rate of the mixer, its channels are stored one after another
+            ConvolutionReverbProcessor(uint32_t channels, uint32_t impulseChannels,
+                                       const std::vector<float>& impulseResponse, float initMix):
+                mix(initMix),
+                fft(2 * PARTITION_SIZE),
+                binStride((fft.getBinCount() + 3) & ~3U), // keep the spectra aligned for the SIMD kernels
+                filterChannels(impulseChannels)
+            {
+                const auto impulseFrames = static_cast<uint32_t>(impulseResponse.size() / impulseChannels);
+                partitionCount = std::max(1U, (impulseFrames + PARTITION_SIZE - 1) / PARTITION_SIZE);
+
+                filters.resize(filterChannels * partitionCount * 2 * binStride);
+                block.resize(2 * PARTITION_SIZE);
+
+                // the inverse transform is not normalized, so the filters are scaled instead
+                const float scale = 1.0F / static_cast<float>(fft.getSize());
+
+                for (uint32_t channel = 0; channel < filterChannels; ++channel)
+                    for (uint32_t partition = 0; partition < partitionCount; ++partition)
+                    {
+                        const uint32_t start = partition * PARTITION_SIZE;
+                        const uint32_t count = std::min(PARTITION_SIZE, impulseFrames - start);
+
+                        dsp::scale(impulseResponse.data() + channel * impulseFrames + start, count, scale, block.data());
+                        std::fill(block.begin() + count, block.end(), 0.0F);
+
+                        float* filter = &filters[(channel * partitionCount + partition) * 2 * binStride];
+                        fft.forward(block.data(), filter, filter + binStride);
+                    }
+
+                resize(channels);
+            }
+
+            void process(uint32_t frames, uint32_t channels, uint32_t,
+                         std::vector<float>& samples) final
+            {
+                if (channels != channelCount) resize(channels);
+
+                for (uint32_t frame = 0; frame < frames;)
+                {
+                    const uint32_t count = std::min(frames - frame, PARTITION_SIZE - position);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        float* output = &samples[channel * frames + frame];
+
+                        std::copy(output, output + count, &inputs[(2 * channel + 1) * PARTITION_SIZE + position]);
+                        dsp::scale(output, count, 1.0F - mix, output);
+                        dsp::accumulate(&outputs[channel * PARTITION_SIZE + position], count, mix, output);
+                    }
+
+                    frame += count;
+                    position += count;
+
+                    if (position == PARTITION_SIZE)
+                    {
+                        convolve();
+                        position = 0;
+                    }
+                }
+            }
+
+            void setMix(float newMix)
+            {
+                mix = newMix;
+            }
+
+        private:
+            void resize(uint32_t channels)
+            {
+                channelCount = channels;
+                inputs.assign(channels * 2 * PARTITION_SIZE, 0.0F);
+                outputs.assign(channels * PARTITION_SIZE, 0.0F);
+                spectra.assign(channels * partitionCount * 2 * binStride, 0.0F);
+                accumulator.resize(2 * binStride);
+                position = 0;
+                current = 0;
+            }
+
+            void convolve()
+            {
+                const uint32_t binCount = fft.getBinCount();
+
+                for (uint32_t channel = 0; channel < channelCount; ++channel)
+                {
+                    // the last two blocks of input, the first one only provides the overlap
+                    float* input = &inputs[channel * 2 * PARTITION_SIZE];
+                    float* spectrum = &spectra[(channel * partitionCount + current) * 2 * binStride];
+                    fft.forward(input, spectrum, spectrum + binStride);
+                    std::copy(input + PARTITION_SIZE, input + 2 * PARTITION_SIZE, input);
+
+                    std::fill(accumulator.begin(), accumulator.end(), 0.0F);
+
+                    // the newest input spectrum is multiplied with the first partition, the one before it with the second and so on
+                    const uint32_t filterChannel = channel % filterChannels;
+                    uint32_t slot = current;
+
+                    for (uint32_t partition = 0; partition < partitionCount; ++partition)
+                    {
+                        const float* inputSpectrum = &spectra[(channel * partitionCount + slot) * 2 * binStride];
+                        const float* filter = &filters[(filterChannel * partitionCount + partition) * 2 * binStride];
+
+                        dsp::multiplyAccumulate(inputSpectrum, inputSpectrum + binStride,
+                                                filter, filter + binStride,
+                                                binCount, accumulator.data(), accumulator.data() + binStride);
+
+                        slot = slot ? slot - 1 : partitionCount - 1;
+                    }
+
+                    // the first half of the result is wrapped around and is discarded
+                    fft.inverse(accumulator.data(), accumulator.data() + binStride, block.data());
+                    std::copy(block.begin() + PARTITION_SIZE, block.end(), outputs.begin() + channel * PARTITION_SIZE);
+                }
+
+                current = (current + 1) % partitionCount;
+            }
+
+            float mix = 0.5F;
+            dsp::Fft fft;
+            uint32_t binStride;
+            uint32_t filterChannels;
+            uint32_t partitionCount;
+            uint32_t channelCount = 0;
+            std::vector<float> filters; // spectra of the impulse response partitions
+            std::vector<float> spectra; // spectra of the last partitionCount input blocks
+            std::vector<float> inputs;
+            std::vector<float> outputs;
+            std::vector<float> accumulator;
+            std::vector<float> block;
+            uint32_t position = 0; // in the current block
+            uint32_t current = 0; // spectrum slot of the current block
+        };
+
+        constexpr uint32_t ConvolutionReverbProcessor::PARTITION_SIZE;
+
+        namespace
+        {
+            std::unique_ptr<mixer::Processor> createConvolutionReverbProcessor(Audio& audio, const PcmClip& impulseResponse, float mix)
+            {
+                const uint32_t sampleRate = audio.getDevice()->getSampleRate();
+                const uint32_t impulseSampleRate = impulseResponse.getSampleRate();
+                const uint32_t impulseChannels = impulseResponse.getChannels();
+                const std::vector<float> samples = impulseResponse.getSamples();
+
+                if (!impulseChannels || !impulseSampleRate)
+                    throw std::runtime_error("Invalid impulse response");
+
+                if (impulseSampleRate == sampleRate)
+                    return std::make_unique<ConvolutionReverbProcessor>(audio.getDevice()->getChannels(),
+                                                                        impulseChannels, samples, mix);
+
+                // the impulse response is resampled once here instead of on the audio thread
+                const auto impulseFrames = static_cast<uint32_t>(samples.size() / impulseChannels);
+                const auto frames = static_cast<uint32_t>((static_cast<uint64_t>(impulseFrames) * sampleRate + impulseSampleRate - 1) / impulseSampleRate);
+
+                mixer::Resampler resampler(impulseSampleRate, sampleRate, impulseChannels);
+                const uint32_t sourceFrames = resampler.getSourceFrames(frames);
+                const uint32_t copyFrames = std::min(sourceFrames, impulseFrames);
+
+                std::vector<float> sourceSamples(sourceFrames * impulseChannels, 0.0F);
+                for (uint32_t channel = 0; channel < impulseChannels; ++channel)
+                    std::copy(samples.begin() + channel * impulseFrames,
+                              samples.begin() + channel * impulseFrames + copyFrames,
+                              sourceSamples.begin() + channel * sourceFrames);
+
+                std::vector<float> resampledSamples;
+                resampler.process(sourceSamples, sourceFrames, frames, resampledSamples);
+
+                return std::make_unique<ConvolutionReverbProcessor>(audio.getDevice()->getChannels(),
+                                                                    impulseChannels, resampledSamples, mix);
+            }
+        }
+
+        ConvolutionReverb::ConvolutionReverb(Audio& initAudio, const PcmClip& impulseResponse, float initMix):
+            Effect(initAudio,
+                   initAudio.initProcessor(createConvolutionReverbProcessor(initAudio, impulseResponse, initMix))),
+            mix(initMix)
+        {
+        }
+
+        ConvolutionReverb::~ConvolutionReverb()
+        {
+        }
+
+        void ConvolutionReverb::setMix(float newMix)
+        {
+            mix = newMix;
+
+            audio.updateProcessor(processorId, [newMix](mixer::Object* node) {
+                ConvolutionReverbProcessor* convolutionReverbProcessor = static_cast<ConvolutionReverbProcessor*>(node);
+                convolutionReverbProcessor->setMix(newMix);
+            });
+        }
+
         LowPass::LowPass(Audio& initAudio):
             Effect(initAudio,
                    initAudio.initProcessor(std::unique_ptr<mixer::Processor>()))
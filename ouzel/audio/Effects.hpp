@@ -13,6 +13,8 @@ namespace ouzel
 {
     namespace audio
     {
+        class PcmClip;
+
         class Delay final: public Effect
         {
         public:
@@ -152,6 +154,27 @@ namespace ouzel
             float decay = 0.5F;
         };
 
+        // Convolves the signal with an impulse response, which is usually loaded from a wave file,
+        // the reverberated signal lags the dry one by 512 frames
+        class ConvolutionReverb final: public Effect
+        {
+        public:
+            // mix is the share of the reverberated signal in the output
+            ConvolutionReverb(Audio& initAudio, const PcmClip& impulseResponse, float initMix = 0.5F);
+            ~ConvolutionReverb();
+
+            ConvolutionReverb(const ConvolutionReverb&) = delete;
+            ConvolutionReverb& operator=(const ConvolutionReverb&) = delete;
+            ConvolutionReverb(ConvolutionReverb&&) = delete;
+            ConvolutionReverb& operator=(ConvolutionReverb&&) = delete;
+
+            inline auto getMix() const noexcept { return mix; }
+            void setMix(float newMix);
+
+        private:
+            float mix = 0.5F;
+        };
+
         class LowPass final: public Effect
         {
         public:
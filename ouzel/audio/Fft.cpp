@@ -0,0 +1,267 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <cmath>
+#include <stdexcept>
+#include "Fft.hpp"
+#include "math/Constants.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace dsp
+        {
+            namespace
+            {
+                // combines pairs of transforms of length n into transforms of length 2 * n
+                void butterflies(float* real, float* imag, size_t count, size_t n,
+                                 const float* twiddleReal, const float* twiddleImag) noexcept
+                {
+                    for (size_t block = 0; block < count; block += 2 * n)
+                    {
+                        float* aReal = real + block;
+                        float* aImag = imag + block;
+                        float* bReal = aReal + n;
+                        float* bImag = aImag + n;
+
+                        size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                        if (isSimdAvailable)
+                            for (; i + 4 <= n; i += 4)
+                            {
+                                const float32x4_t wr = vld1q_f32(twiddleReal + i);
+                                const float32x4_t wi = vld1q_f32(twiddleImag + i);
+                                const float32x4_t br = vld1q_f32(bReal + i);
+                                const float32x4_t bi = vld1q_f32(bImag + i);
+                                const float32x4_t tr = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+                                const float32x4_t ti = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+                                const float32x4_t ar = vld1q_f32(aReal + i);
+                                const float32x4_t ai = vld1q_f32(aImag + i);
+                                vst1q_f32(bReal + i, vsubq_f32(ar, tr));
+                                vst1q_f32(bImag + i, vsubq_f32(ai, ti));
+                                vst1q_f32(aReal + i, vaddq_f32(ar, tr));
+                                vst1q_f32(aImag + i, vaddq_f32(ai, ti));
+                            }
+#elif defined(__SSE2__)
+                        if (isSimdAvailable)
+                            for (; i + 4 <= n; i += 4)
+                            {
+                                const __m128 wr = _mm_loadu_ps(twiddleReal + i);
+                                const __m128 wi = _mm_loadu_ps(twiddleImag + i);
+                                const __m128 br = _mm_loadu_ps(bReal + i);
+                                const __m128 bi = _mm_loadu_ps(bImag + i);
+                                const __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                                const __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                                const __m128 ar = _mm_loadu_ps(aReal + i);
+                                const __m128 ai = _mm_loadu_ps(aImag + i);
+                                _mm_storeu_ps(bReal + i, _mm_sub_ps(ar, tr));
+                                _mm_storeu_ps(bImag + i, _mm_sub_ps(ai, ti));
+                                _mm_storeu_ps(aReal + i, _mm_add_ps(ar, tr));
+                                _mm_storeu_ps(aImag + i, _mm_add_ps(ai, ti));
+                            }
+#endif
+
+                        for (; i < n; ++i)
+                        {
+                            const float tr = bReal[i] * twiddleReal[i] - bImag[i] * twiddleImag[i];
+                            const float ti = bReal[i] * twiddleImag[i] + bImag[i] * twiddleReal[i];
+                            bReal[i] = aReal[i] - tr;
+                            bImag[i] = aImag[i] - ti;
+                            aReal[i] += tr;
+                            aImag[i] += ti;
+                        }
+                    }
+                }
+            }
+
+            Fft::Fft(uint32_t initSize):
+                size(initSize)
+            {
+                if (size < 4 || (size & (size - 1)))
+                    throw std::runtime_error("FFT size must be a power of two");
+
+                const uint32_t count = size / 2;
+
+                uint32_t bits = 0;
+                while ((1U << bits) < count) ++bits;
+
+                bitReversal.resize(count);
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    uint32_t reversed = 0;
+                    for (uint32_t bit = 0; bit < bits; ++bit)
+                        if (i & (1U << bit)) reversed |= 1U << (bits - 1 - bit);
+                    bitReversal[i] = reversed;
+                }
+
+                twiddleReal.resize(count);
+                twiddleImag.resize(count);
+                for (uint32_t n = 1; n < count; n <<= 1)
+                    for (uint32_t i = 0; i < n; ++i)
+                    {
+                        const double angle = -pi<double> * i / n;
+                        twiddleReal[n + i] = static_cast<float>(std::cos(angle));
+                        twiddleImag[n + i] = static_cast<float>(std::sin(angle));
+                    }
+
+                splitReal.resize(count);
+                splitImag.resize(count);
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const double angle = -2.0 * pi<double> * i / size;
+                    splitReal[i] = static_cast<float>(std::cos(angle));
+                    splitImag[i] = static_cast<float>(std::sin(angle));
+                }
+
+                workReal.resize(count);
+                workImag.resize(count);
+            }
+
+            void Fft::forward(const float* input, float* real, float* imag) noexcept
+            {
+                const uint32_t count = size / 2;
+
+                // the even samples are transformed as the real parts and the odd ones as the imaginary parts
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    workReal[bitReversal[i]] = input[2 * i];
+                    workImag[bitReversal[i]] = input[2 * i + 1];
+                }
+
+                transform();
+
+                real[0] = workReal[0] + workImag[0];
+                imag[0] = 0.0F;
+                real[count] = workReal[0] - workImag[0];
+                imag[count] = 0.0F;
+
+                for (uint32_t i = 1; i < count; ++i)
+                {
+                    // the spectra of the even and odd samples
+                    const float evenReal = 0.5F * (workReal[i] + workReal[count - i]);
+                    const float evenImag = 0.5F * (workImag[i] - workImag[count - i]);
+                    const float oddReal = 0.5F * (workImag[i] + workImag[count - i]);
+                    const float oddImag = -0.5F * (workReal[i] - workReal[count - i]);
+
+                    real[i] = evenReal + splitReal[i] * oddReal - splitImag[i] * oddImag;
+                    imag[i] = evenImag + splitReal[i] * oddImag + splitImag[i] * oddReal;
+                }
+            }
+
+            void Fft::inverse(const float* real, const float* imag, float* output) noexcept
+            {
+                const uint32_t count = size / 2;
+
+                // the real and imaginary parts are swapped, so that the forward transform computes the inverse one
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const float evenReal = real[i] + real[count - i];
+                    const float evenImag = imag[i] - imag[count - i];
+                    const float differenceReal = real[i] - real[count - i];
+                    const float differenceImag = imag[i] + imag[count - i];
+                    const float oddReal = differenceReal * splitReal[i] + differenceImag * splitImag[i];
+                    const float oddImag = differenceImag * splitReal[i] - differenceReal * splitImag[i];
+
+                    workReal[bitReversal[i]] = evenImag + oddReal;
+                    workImag[bitReversal[i]] = evenReal - oddImag;
+                }
+
+                transform();
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    output[2 * i] = workImag[i];
+                    output[2 * i + 1] = workReal[i];
+                }
+            }
+
+            void Fft::transform() noexcept
+            {
+                const size_t count = size / 2;
+                float* real = workReal.data();
+                float* imag = workImag.data();
+
+                // the first two stages have trivial twiddle factors
+                for (size_t i = 0; i < count; i += 2)
+                {
+                    const float ar = real[i];
+                    const float ai = imag[i];
+                    real[i] = ar + real[i + 1];
+                    imag[i] = ai + imag[i + 1];
+                    real[i + 1] = ar - real[i + 1];
+                    imag[i + 1] = ai - imag[i + 1];
+                }
+
+                if (count >= 4)
+                    for (size_t i = 0; i < count; i += 4)
+                    {
+                        float ar = real[i];
+                        float ai = imag[i];
+                        real[i] = ar + real[i + 2];
+                        imag[i] = ai + imag[i + 2];
+                        real[i + 2] = ar - real[i + 2];
+                        imag[i + 2] = ai - imag[i + 2];
+
+                        // multiplied by -i
+                        ar = real[i + 1];
+                        ai = imag[i + 1];
+                        const float tr = imag[i + 3];
+                        const float ti = -real[i + 3];
+                        real[i + 1] = ar + tr;
+                        imag[i + 1] = ai + ti;
+                        real[i + 3] = ar - tr;
+                        imag[i + 3] = ai - ti;
+                    }
+
+                for (size_t n = 4; n < count; n <<= 1)
+                    butterflies(real, imag, count, n, twiddleReal.data() + n, twiddleImag.data() + n);
+            }
+
+            void multiplyAccumulate(const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag,
+                                    size_t count, float* real, float* imag) noexcept
+            {
+                size_t i = 0;
+
+#if defined(__ARM_NEON__)
+                if (isSimdAvailable)
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t ar = vld1q_f32(aReal + i);
+                        const float32x4_t ai = vld1q_f32(aImag + i);
+                        const float32x4_t br = vld1q_f32(bReal + i);
+                        const float32x4_t bi = vld1q_f32(bImag + i);
+                        vst1q_f32(real + i, vmlsq_f32(vmlaq_f32(vld1q_f32(real + i), ar, br), ai, bi));
+                        vst1q_f32(imag + i, vmlaq_f32(vmlaq_f32(vld1q_f32(imag + i), ar, bi), ai, br));
+                    }
+#elif defined(__SSE2__)
+                if (isSimdAvailable)
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 ar = _mm_loadu_ps(aReal + i);
+                        const __m128 ai = _mm_loadu_ps(aImag + i);
+                        const __m128 br = _mm_loadu_ps(bReal + i);
+                        const __m128 bi = _mm_loadu_ps(bImag + i);
+                        _mm_storeu_ps(real + i, _mm_add_ps(_mm_loadu_ps(real + i),
+                                                           _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi))));
+                        _mm_storeu_ps(imag + i, _mm_add_ps(_mm_loadu_ps(imag + i),
+                                                           _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br))));
+                    }
+#endif
+
+                for (; i < count; ++i)
+                {
+                    real[i] += aReal[i] * bReal[i] - aImag[i] * bImag[i];
+                    imag[i] += aReal[i] * bImag[i] + aImag[i] * bReal[i];
+                }
+            }
+        } // namespace dsp
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,66 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_FFT_HPP
+#define OUZEL_AUDIO_FFT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace dsp
+        {
+            // Fast Fourier transform of real signals, the butterflies are vectorized with SSE2 or NEON when available.
+            // A spectrum has size / 2 + 1 bins, their real and imaginary parts are stored in separate arrays.
+            // An instance keeps its own work buffers, so it must not be used by several threads at once.
+            class Fft final
+            {
+            public:
+                // size must be a power of two and at least 4
+                explicit Fft(uint32_t initSize);
+
+                Fft(const Fft&) = delete;
+                Fft& operator=(const Fft&) = delete;
+
+                Fft(Fft&&) = delete;
+                Fft& operator=(Fft&&) = delete;
+
+                inline auto getSize() const noexcept { return size; }
+                inline auto getBinCount() const noexcept { return size / 2 + 1; }
+
+                void forward(const float* input, float* real, float* imag) noexcept;
+
+                // the output is not normalized, inverse(forward(x)) is x multiplied by size
+                void inverse(const float* real, const float* imag, float* output) noexcept;
+
+            private:
+                // complex transform of the work buffers, which must be in bit-reversed order
+                void transform() noexcept;
+
+                uint32_t size;
+                std::vector<uint32_t> bitReversal;
+
+                // twiddle factors of the stage that combines transforms of length n start at index n
+                std::vector<float> twiddleReal;
+                std::vector<float> twiddleImag;
+
+                // factors that split the half-length complex transform into the real one
+                std::vector<float> splitReal;
+                std::vector<float> splitImag;
+
+                std::vector<float> workReal;
+                std::vector<float> workImag;
+            };
+
+            // multiplies the complex numbers a and b and adds the products to the output
+            void multiplyAccumulate(const float* aReal, const float* aImag,
+                                    const float* bReal, const float* bImag,
+                                    size_t count, float* real, float* imag) noexcept;
+        } // namespace dsp
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_FFT_HPP
@@ -28,9 +28,31 @@ namespace ouzel
             if (mix) mix->addListener(this);
         }
 
+        void Listener::setPosition(const Vector3F& newPosition)
+        {
+            position = newPosition;
+            if (mix) mix->updateListener(this);
+        }
+
+        void Listener::setRotation(const QuaternionF& newRotation)
+        {
+            rotation = newRotation;
+            if (mix) mix->updateListener(this);
+        }
+
         void Listener::updateTransform()
         {
-            transformDirty = true;
+            if (mix) mix->updateListener(this);
+        }
+
+        Vector3F Listener::getWorldPosition() const
+        {
+            return actor ? actor->convertLocalToWorld(position) : position;
+        }
+
+        QuaternionF Listener::getWorldRotation() const
+        {
+            return actor ? actor->getTransform().getRotation() * rotation : rotation;
         }
     } // namespace audio
 } // namespace ouzel
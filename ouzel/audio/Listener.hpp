@@ -16,6 +16,8 @@ namespace ouzel
         class Audio;
         class Mix;
 
+        // A mix spatializes its voices for its first listener, or for the one of the mix it outputs to.
+        // The position and the rotation are relative to the actor the listener is attached to.
         class Listener final: public scene::Component
         {
             friend Mix;
@@ -31,24 +33,25 @@ namespace ouzel
             void setMix(Mix* newMix);
 
             inline auto& getPosition() const noexcept { return position; }
-            inline void setPosition(const Vector3F& newPosition) { position = newPosition; }
+            void setPosition(const Vector3F& newPosition);
 
             inline auto& getVelocity() const noexcept { return velocity; }
             inline void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
 
             inline auto& getRotation() const noexcept { return rotation; }
-            inline void setRotation(const QuaternionF& newRotation) { rotation = newRotation; }
+            void setRotation(const QuaternionF& newRotation);
 
         private:
             void updateTransform() final;
+            Vector3F getWorldPosition() const;
+            QuaternionF getWorldRotation() const;
 
             Audio& audio;
 
             Mix* mix = nullptr;
             Vector3F position;
             Vector3F velocity;
-            QuaternionF rotation;
-            bool transformDirty = true;
+            QuaternionF rotation = QuaternionF::identity();
         };
     } // namespace audio
 } // namespace ouzel
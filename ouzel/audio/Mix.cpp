@@ -92,6 +92,8 @@ namespace ouzel
                 if (listener->mix) listener->mix->removeListener(listener);
                 listener->mix = this;
                 listeners.push_back(listener);
+
+                if (listeners.front() == listener) updateListener(listener);
             }
         }
 
@@ -102,8 +104,23 @@ namespace ouzel
             if (i != listeners.end())
             {
                 listener->mix = nullptr;
+                const bool first = (i == listeners.begin());
                 listeners.erase(i);
+
+                if (listeners.empty())
+                    audio.addCommand(std::make_unique<mixer::RemoveBusListenerCommand>(busId));
+                else if (first)
+                    updateListener(listeners.front());
             }
         }
+
+        void Mix::updateListener(const Listener* listener)
+        {
+            // only the first listener is sent to the bus
+            if (listeners.front() == listener)
+                audio.addCommand(std::make_unique<mixer::SetBusListenerCommand>(busId,
+                                                                                listener->getWorldPosition(),
+                                                                                listener->getWorldRotation()));
+        }
     } // namespace audio
 } // namespace ouzel
@@ -42,6 +42,7 @@ namespace ouzel
             void removeInput(Voice* voice);
             void addListener(Listener* listener);
             void removeListener(Listener* listener);
+            void updateListener(const Listener* listener);
 
             Audio& audio;
             uintptr_t busId;
@@ -23,6 +23,7 @@ namespace ouzel
             }
 
             void getSamples(uint32_t frames, std::vector<float>& samples) final;
+            void skip(uint32_t frames) final;
 
         private:
             uint32_t position = 0;
@@ -135,10 +136,7 @@ namespace ouzel
                 }
 
                 if ((frameCount - position) == 0)
-                {
-                    playing = false; // TODO: fire event
-                    reset();
-                }
+                    finish();
 
                 std::fill(samples.begin() + totalSize, samples.end(), 0.0F); // TODO: remove
             }
@@ -152,6 +150,22 @@ namespace ouzel
             }
         }
 
+        void OscillatorStream::skip(uint32_t frames)
+        {
+            const auto length = static_cast<OscillatorData&>(data).getLength();
+
+            if (length > 0.0F)
+            {
+                const auto frameCount = static_cast<uint32_t>(length * data.getSampleRate());
+                position += (frames > frameCount - position) ? frameCount - position : frames;
+
+                if ((frameCount - position) == 0)
+                    finish();
+            }
+            else
+                position += frames;
+        }
+
         Oscillator::Oscillator(Audio& initAudio, float initFrequency,
                                Type initType, float initAmplitude, float initLength):
             Sound(initAudio,
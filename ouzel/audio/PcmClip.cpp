@@ -1,17 +1,200 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
 #include "PcmClip.hpp"
 #include "Audio.hpp"
+#include "Dsp.hpp"
 #include "mixer/Data.hpp"
 #include "mixer/Stream.hpp"
+#include "math/MathUtils.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
-        class PcmData;
+        namespace
+        {
+            constexpr int32_t IMA_ADPCM_STEPS[89] = {
+                7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+                50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+                253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+                1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+                3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+                12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+            };
+
+            constexpr int32_t IMA_ADPCM_INDEX_CHANGES[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+            // a four byte header of the first sample and the step index for every channel
+            constexpr uint32_t IMA_ADPCM_HEADER_SIZE = 4;
+
+            class ImaAdpcmDecoder final
+            {
+            public:
+                ImaAdpcmDecoder(int32_t initPredictor, int32_t initIndex) noexcept:
+                    predictor(initPredictor), index(clamp(initIndex, 0, 88))
+                {
+                }
+
+                inline auto getPredictor() const noexcept { return predictor; }
+
+                int32_t decode(uint8_t nibble) noexcept
+                {
+                    const int32_t step = IMA_ADPCM_STEPS[index];
+                    int32_t difference = step >> 3;
+                    if (nibble & 1) difference += step >> 2;
+                    if (nibble & 2) difference += step >> 1;
+                    if (nibble & 4) difference += step;
+                    if (nibble & 8) difference = -difference;
+
+                    predictor = clamp(predictor + difference, -32768, 32767);
+                    index = clamp(index + IMA_ADPCM_INDEX_CHANGES[nibble & 7], 0, 88);
+                    return predictor;
+                }
+
+            private:
+                int32_t predictor;
+                int32_t index;
+            };
+        }
+
+        PcmBuffer::PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<float> initSamples):
+            encoding(Encoding::Float32),
+            channels(initChannels),
+            sampleRate(initSampleRate),
+            frames(initChannels ? static_cast<uint32_t>(initSamples.size() / initChannels) : 0),
+            floatSamples(std::move(initSamples))
+        {
+        }
+
+        PcmBuffer::PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<int16_t> initSamples):
+            encoding(Encoding::SignedInt16),
+            channels(initChannels),
+            sampleRate(initSampleRate),
+            frames(initChannels ? static_cast<uint32_t>(initSamples.size() / initChannels) : 0),
+            int16Samples(std::move(initSamples))
+        {
+        }
+
+        PcmBuffer::PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<int8_t> initSamples):
+            encoding(Encoding::SignedInt8),
+            channels(initChannels),
+            sampleRate(initSampleRate),
+            frames(initChannels ? static_cast<uint32_t>(initSamples.size() / initChannels) : 0),
+            int8Samples(std::move(initSamples))
+        {
+        }
+
+        PcmBuffer::PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, uint32_t initFrames,
+                             uint32_t initBlockSize, std::vector<uint8_t> initBlocks):
+            encoding(Encoding::ImaAdpcm),
+            channels(initChannels),
+            sampleRate(initSampleRate),
+            frames(initFrames),
+            blockSize(initBlockSize),
+            blocks(std::move(initBlocks))
+        {
+            if (!channels || blockSize % (IMA_ADPCM_HEADER_SIZE * channels) || blockSize <= IMA_ADPCM_HEADER_SIZE * channels)
+                throw std::runtime_error("Invalid IMA ADPCM block size");
+
+            // every byte after the headers holds two samples
+            blockFrames = (blockSize / channels - IMA_ADPCM_HEADER_SIZE) * 2 + 1;
+
+            // a partial block only has the frames of its complete groups of eight samples per channel
+            const uint32_t groupSize = IMA_ADPCM_HEADER_SIZE * channels;
+            const auto blockCount = static_cast<uint32_t>(blocks.size() / blockSize);
+            const auto lastBlockSize = static_cast<uint32_t>(blocks.size() % blockSize);
+            uint32_t availableFrames = blockCount * blockFrames;
+            if (lastBlockSize >= groupSize)
+                availableFrames += (lastBlockSize - groupSize) / groupSize * 8 + 1;
+
+            if (!frames || frames > availableFrames) frames = availableFrames;
+        }
+
+        size_t PcmBuffer::getSize() const noexcept
+        {
+            return floatSamples.size() * sizeof(float) +
+                int16Samples.size() * sizeof(int16_t) +
+                int8Samples.size() * sizeof(int8_t) +
+                blocks.size();
+        }
+
+        bool PcmBuffer::operator==(const PcmBuffer& other) const noexcept
+        {
+            // the float samples are compared by their bits, so that the negative zeros and NaNs match only themselves
+            return encoding == other.encoding &&
+                channels == other.channels &&
+                sampleRate == other.sampleRate &&
+                frames == other.frames &&
+                blockFrames == other.blockFrames &&
+                blockSize == other.blockSize &&
+                floatSamples.size() == other.floatSamples.size() &&
+                (floatSamples.empty() || std::memcmp(floatSamples.data(), other.floatSamples.data(),
+                                                     floatSamples.size() * sizeof(float)) == 0) &&
+                int16Samples == other.int16Samples &&
+                int8Samples == other.int8Samples &&
+                blocks == other.blocks;
+        }
+
+        void PcmBuffer::convert(uint32_t channel, uint32_t frame, uint32_t count, float* output) const noexcept
+        {
+            const size_t offset = channel * frames + frame;
+
+            switch (encoding)
+            {
+                case Encoding::Float32:
+                    std::copy(floatSamples.begin() + offset, floatSamples.begin() + offset + count, output);
+                    break;
+                case Encoding::SignedInt16:
+                    dsp::int16ToFloat(int16Samples.data() + offset, count, output);
+                    break;
+                case Encoding::SignedInt8:
+                    dsp::int8ToFloat(int8Samples.data() + offset, count, output);
+                    break;
+                default:
+                    std::fill(output, output + count, 0.0F);
+                    break;
+            }
+        }
+
+        void PcmBuffer::decodeBlock(uint32_t block, float* output) const noexcept
+        {
+            constexpr float factor = 1.0F / 32768.0F;
+
+            const size_t blockStart = static_cast<size_t>(block) * blockSize;
+            const size_t size = std::min(static_cast<size_t>(blockSize), blocks.size() - std::min(blocks.size(), blockStart));
+            const uint8_t* blockData = blocks.data() + blockStart;
+
+            std::fill(output, output + blockFrames * channels, 0.0F);
+            if (size < IMA_ADPCM_HEADER_SIZE * channels) return;
+
+            // after the headers every channel has four bytes of eight samples in turn
+            const size_t groupSize = IMA_ADPCM_HEADER_SIZE * channels;
+            const size_t groups = (size - groupSize) / groupSize;
+
+            for (uint32_t channel = 0; channel < channels; ++channel)
+            {
+                const uint8_t* header = blockData + channel * IMA_ADPCM_HEADER_SIZE;
+                ImaAdpcmDecoder decoder(static_cast<int16_t>(header[0] | (header[1] << 8)), header[2]);
+
+                float* outputChannel = output + channel * blockFrames;
+                *outputChannel++ = decoder.getPredictor() * factor;
+
+                for (size_t group = 0; group < groups; ++group)
+                {
+                    const uint8_t* groupData = blockData + groupSize * (group + 1) + channel * IMA_ADPCM_HEADER_SIZE;
+
+                    for (uint32_t i = 0; i < IMA_ADPCM_HEADER_SIZE; ++i)
+                    {
+                        *outputChannel++ = decoder.decode(groupData[i] & 0x0F) * factor;
+                        *outputChannel++ = decoder.decode(groupData[i] >> 4) * factor;
+                    }
+                }
+            }
+        }
 
         class PcmStream final: public mixer::Stream
         {
@@ -24,23 +207,27 @@ namespace ouzel
             }
 
             void getSamples(uint32_t frames, std::vector<float>& samples) final;
+            void skip(uint32_t frames) final;
 
         private:
             uint32_t position = 0;
+
+            // the last decoded block, because the mixer reads less than a block at a time
+            uint32_t decodedBlock = UINT32_MAX;
+            std::vector<float> decodedSamples;
         };
 
         class PcmData final: public mixer::Data
         {
         public:
-            PcmData(uint32_t initChannels, uint32_t initSampleRate,
-                    const std::vector<float>& initSamples):
-                samples(initSamples)
+            explicit PcmData(std::shared_ptr<const PcmBuffer> initBuffer):
+                buffer(std::move(initBuffer))
             {
-                channels = initChannels;
-                sampleRate = initSampleRate;
+                channels = buffer->getChannels();
+                sampleRate = buffer->getSampleRate();
             }
 
-            auto& getSamples() const noexcept { return samples; }
+            auto& getBuffer() const noexcept { return buffer; }
 
             std::unique_ptr<mixer::Stream> createStream() final
             {
@@ -48,57 +235,126 @@ namespace ouzel
             }
 
         private:
-            std::vector<float> samples;
+            std::shared_ptr<const PcmBuffer> buffer;
         };
 
+        // streams are created on the producer thread, so the block is allocated here and not in getSamples
         PcmStream::PcmStream(PcmData& pcmData):
-            Stream(pcmData)
+            Stream(pcmData),
+            decodedSamples(pcmData.getBuffer()->getBlockFrames() * pcmData.getChannels())
         {
         }
 
         void PcmStream::getSamples(uint32_t frames, std::vector<float>& samples)
         {
-            const uint32_t neededSize = frames * data.getChannels();
-            samples.resize(neededSize);
+            const uint32_t channels = data.getChannels();
+            samples.resize(frames * channels);
 
-            PcmData& pcmData = static_cast<PcmData&>(data);
-            const std::vector<float>& data = pcmData.getSamples();
+            const PcmBuffer& buffer = *static_cast<PcmData&>(data).getBuffer();
 
-            const auto sourceFrames = static_cast<uint32_t>(data.size() / pcmData.getChannels());
+            const uint32_t sourceFrames = buffer.getFrames();
             const uint32_t copyFrames = (frames > sourceFrames - position) ? sourceFrames - position : frames;
 
-            for (uint32_t channel = 0; channel < pcmData.getChannels(); ++channel)
+            if (const uint32_t blockFrames = buffer.getBlockFrames())
             {
-                const float* sourceChannel = &data[channel * sourceFrames];
-                float* outputChannel = &samples[channel * frames];
+                for (uint32_t frame = 0; frame < copyFrames;)
+                {
+                    const uint32_t block = (position + frame) / blockFrames;
+                    const uint32_t offset = (position + frame) % blockFrames;
+                    const uint32_t count = std::min(blockFrames - offset, copyFrames - frame);
+
+                    if (block != decodedBlock)
+                    {
+                        buffer.decodeBlock(block, decodedSamples.data());
+                        decodedBlock = block;
+                    }
 
-                for (uint32_t frame = 0; frame < copyFrames; ++frame)
-                    outputChannel[frame] = sourceChannel[frame + position];
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                        std::copy(decodedSamples.begin() + channel * blockFrames + offset,
+                                  decodedSamples.begin() + channel * blockFrames + offset + count,
+                                  samples.begin() + channel * frames + frame);
+
+                    frame += count;
+                }
             }
+            else
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                    buffer.convert(channel, position, copyFrames, &samples[channel * frames]);
 
             position += copyFrames;
 
-            for (uint32_t channel = 0; channel < pcmData.getChannels(); ++channel)
-            {
-                float* outputChannel = &samples[channel * frames];
+            for (uint32_t channel = 0; channel < channels; ++channel)
+                std::fill(samples.begin() + channel * frames + copyFrames,
+                          samples.begin() + (channel + 1) * frames, 0.0F);
 
-                for (uint32_t frame = copyFrames; frame < frames; ++frame)
-                    outputChannel[frame] = 0.0F;
-            }
+            if ((sourceFrames - position) == 0)
+                finish();
+        }
+
+        void PcmStream::skip(uint32_t frames)
+        {
+            const uint32_t sourceFrames = static_cast<PcmData&>(data).getBuffer()->getFrames();
+            position += (frames > sourceFrames - position) ? sourceFrames - position : frames;
 
             if ((sourceFrames - position) == 0)
-            {
-                playing = false; // TODO: fire event
-                reset();
-            }
+                finish();
         }
 
         PcmClip::PcmClip(Audio& initAudio, uint32_t channels, uint32_t sampleRate,
-                          const std::vector<float>& samples):
+                         const std::vector<float>& samples):
+            PcmClip(initAudio, std::make_shared<PcmBuffer>(channels, sampleRate, samples))
+        {
+        }
+
+        PcmClip::PcmClip(Audio& initAudio, std::shared_ptr<const PcmBuffer> buffer):
             Sound(initAudio,
-                  initAudio.initData(std::unique_ptr<mixer::Data>(data = new PcmData(channels, sampleRate, samples))),
+                  initAudio.initData(std::unique_ptr<mixer::Data>(data = new PcmData(std::move(buffer)))),
                   Sound::Format::Pcm)
         {
         }
+
+        // the data is not modified after it has been created, so it can be read while the mixer uses it
+        uint32_t PcmClip::getChannels() const noexcept
+        {
+            return data->getChannels();
+        }
+
+        uint32_t PcmClip::getSampleRate() const noexcept
+        {
+            return data->getSampleRate();
+        }
+
+        const std::shared_ptr<const PcmBuffer>& PcmClip::getBuffer() const noexcept
+        {
+            return data->getBuffer();
+        }
+
+        std::vector<float> PcmClip::getSamples() const
+        {
+            const PcmBuffer& buffer = *data->getBuffer();
+            const uint32_t frames = buffer.getFrames();
+            std::vector<float> samples(frames * buffer.getChannels());
+
+            if (const uint32_t blockFrames = buffer.getBlockFrames())
+            {
+                std::vector<float> blockSamples(blockFrames * buffer.getChannels());
+
+                for (uint32_t block = 0; block * blockFrames < frames; ++block)
+                {
+                    buffer.decodeBlock(block, blockSamples.data());
+                    const uint32_t count = std::min(blockFrames, frames - block * blockFrames);
+
+                    for (uint32_t channel = 0; channel < buffer.getChannels(); ++channel)
+                        std::copy(blockSamples.begin() + channel * blockFrames,
+                                  blockSamples.begin() + channel * blockFrames + count,
+                                  samples.begin() + channel * frames + block * blockFrames);
+                }
+            }
+            else
+                for (uint32_t channel = 0; channel < buffer.getChannels(); ++channel)
+                    buffer.convert(channel, 0, frames, &samples[channel * frames]);
+
+            return samples;
+        }
     } // namespace audio
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #define OUZEL_AUDIO_PCMCLIP_HPP
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "audio/Sound.hpp"
 
@@ -13,11 +14,79 @@ namespace ouzel
     {
         class PcmData;
 
+        // Samples in the encoding they are stored in, they are converted to float only when they are mixed.
+        // The buffer is never modified, so it can be shared by all the clips that are created from the same data.
+        class PcmBuffer final
+        {
+        public:
+            enum class Encoding
+            {
+                Float32,
+                SignedInt16,
+                SignedInt8,
+                ImaAdpcm // 4 bits per sample in the blocks of the IMA ADPCM WAV format
+            };
+
+            // the channels are stored one after another
+            PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<float> initSamples);
+            PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<int16_t> initSamples);
+            PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, std::vector<int8_t> initSamples);
+
+            // blocks of blockSize bytes with the interleaved channels, the last block can be shorter
+            PcmBuffer(uint32_t initChannels, uint32_t initSampleRate, uint32_t initFrames,
+                      uint32_t initBlockSize, std::vector<uint8_t> initBlocks);
+
+            PcmBuffer(const PcmBuffer&) = delete;
+            PcmBuffer& operator=(const PcmBuffer&) = delete;
+
+            PcmBuffer(PcmBuffer&&) = delete;
+            PcmBuffer& operator=(PcmBuffer&&) = delete;
+
+            inline auto getEncoding() const noexcept { return encoding; }
+            inline auto getChannels() const noexcept { return channels; }
+            inline auto getSampleRate() const noexcept { return sampleRate; }
+            inline auto getFrames() const noexcept { return frames; }
+            // zero for the linear encodings
+            inline auto getBlockFrames() const noexcept { return blockFrames; }
+            // the memory used by the samples in bytes
+            size_t getSize() const noexcept;
+
+            // same format and bitwise identical samples
+            bool operator==(const PcmBuffer& other) const noexcept;
+            inline bool operator!=(const PcmBuffer& other) const noexcept { return !(*this == other); }
+
+            // converts count frames of the channel starting from the frame, for the linear encodings
+            void convert(uint32_t channel, uint32_t frame, uint32_t count, float* output) const noexcept;
+
+            // decodes all the channels of the block to blockFrames samples each, for the block encodings
+            void decodeBlock(uint32_t block, float* output) const noexcept;
+
+        private:
+            Encoding encoding;
+            uint32_t channels;
+            uint32_t sampleRate;
+            uint32_t frames;
+            uint32_t blockFrames = 0;
+            uint32_t blockSize = 0;
+
+            std::vector<float> floatSamples;
+            std::vector<int16_t> int16Samples;
+            std::vector<int8_t> int8Samples;
+            std::vector<uint8_t> blocks;
+        };
+
         class PcmClip final: public Sound
         {
         public:
             PcmClip(Audio& initAudio, uint32_t channels, uint32_t sampleRate,
                     const std::vector<float>& samples);
+            PcmClip(Audio& initAudio, std::shared_ptr<const PcmBuffer> buffer);
+
+            uint32_t getChannels() const noexcept;
+            uint32_t getSampleRate() const noexcept;
+            const std::shared_ptr<const PcmBuffer>& getBuffer() const noexcept;
+            // converted to float, the channels are stored one after another
+            std::vector<float> getSamples() const;
 
         private:
             PcmData* data;
@@ -22,6 +22,7 @@ namespace ouzel
             }
 
             void getSamples(uint32_t frames, std::vector<float>& samples) final;
+            void skip(uint32_t frames) final;
 
         private:
             uint32_t position = 0;
@@ -82,10 +83,7 @@ namespace ouzel
                 }
 
                 if ((frameCount - position) == 0)
-                {
-                    playing = false; // TODO: fire event
-                    reset();
-                }
+                    finish();
             }
             else
             {
@@ -93,6 +91,22 @@ namespace ouzel
             }
         }
 
+        void SilenceStream::skip(uint32_t frames)
+        {
+            const auto length = static_cast<SilenceData&>(data).getLength();
+
+            if (length > 0.0F)
+            {
+                const auto frameCount = static_cast<uint32_t>(length * data.getSampleRate());
+                position += (frames > frameCount - position) ? frameCount - position : frames;
+
+                if ((frameCount - position) == 0)
+                    finish();
+            }
+            else
+                position += frames;
+        }
+
         SilenceSound::SilenceSound(Audio& initAudio, float initLength):
             Sound(initAudio,
                   initAudio.initData(std::unique_ptr<mixer::Data>(data = new SilenceData(initLength))),
@@ -36,10 +36,20 @@ namespace ouzel
             inline auto getSourceId() const noexcept { return sourceId; }
             inline auto getFormat() const noexcept { return format; }
 
+            // used by the voices created after the change, higher priority voices are mixed first
+            inline auto getPriority() const noexcept { return priority; }
+            inline void setPriority(int32_t newPriority) { priority = newPriority; }
+
+            // maximum number of voices of this sound that are mixed at the same time, zero for no limit
+            inline auto getMaxInstances() const noexcept { return maxInstances; }
+            inline void setMaxInstances(uint32_t newMaxInstances) { maxInstances = newMaxInstances; }
+
         protected:
             Audio& audio;
             uintptr_t sourceId = 0;
             Format format;
+            int32_t priority = 0;
+            uint32_t maxInstances = 0;
         };
     } // namespace audio
 } // namespace ouzel
@@ -5,6 +5,7 @@
 #include "AudioDevice.hpp"
 #include "Effects.hpp"
 #include "Oscillator.hpp"
+#include "PcmClip.hpp"
 #include "SilenceSound.hpp"
 #include "Sound.hpp"
 #include "Source.hpp"
@@ -112,6 +113,11 @@ namespace ouzel
                     case EffectDefinition::Type::Reverb:
                         effects.push_back(std::make_unique<Reverb>(initAudio, effectDefinition.delay, effectDefinition.decay));
                         break;
+                    case EffectDefinition::Type::ConvolutionReverb:
+                        effects.push_back(std::make_unique<ConvolutionReverb>(initAudio,
+                                                                              static_cast<const PcmClip&>(*effectDefinition.impulseResponse),
+                                                                              effectDefinition.mix));
+                        break;
                     case EffectDefinition::Type::LowPass:
                         effects.push_back(std::make_unique<LowPass>(initAudio));
                         break;
@@ -130,13 +136,15 @@ namespace ouzel
         Voice::Voice(Audio& initAudio, const Sound* initSound):
             Node(initAudio),
             audio(initAudio),
-            streamId(audio.initStream(initSound->getSourceId()))
+            streamId(audio.initStream(initSound->getSourceId(), initSound->getPriority(), initSound->getMaxInstances(), this))
         {
             sound = initSound;
         }
 
         Voice::~Voice()
         {
+            if (output) output->removeInput(this);
+
             if (streamId)
                 audio.deleteObject(streamId);
         }
@@ -173,25 +181,31 @@ namespace ouzel
             // TODO: send StopCommand
         }
 
-        // executed on audio thread
-        /*void Voice::onReset()
+        void Voice::finish()
         {
+            playing = false;
+
             auto event = std::make_unique<SoundEvent>();
-            event->type = Event::Type::SoundReset;
+            event->type = Event::Type::SoundFinish;
             event->voice = this;
             engine->getEventDispatcher().postEvent(std::move(event));
         }
 
-        // executed on audio thread
-        void Voice::onStop()
+        void Voice::setPosition(const Vector3F& newPosition)
         {
-            playing = false;
+            position = newPosition;
 
-            auto event = std::make_unique<SoundEvent>();
-            event->type = Event::Type::SoundFinish;
-            event->voice = this;
-            engine->getEventDispatcher().postEvent(std::move(event));
-        }*/
+            if (streamId)
+                audio.addCommand(std::make_unique<mixer::SetStreamPositionCommand>(streamId, position));
+        }
+
+        void Voice::setGain(float newGain)
+        {
+            gain = newGain;
+
+            if (streamId)
+                audio.addCommand(std::make_unique<mixer::SetStreamGainCommand>(streamId, gain));
+        }
 
         void Voice::setOutput(Mix* newOutput)
         {
@@ -18,6 +18,7 @@ namespace ouzel
 
         class Voice final: public Node
         {
+            friend Audio;
             friend Mix;
         public:
             explicit Voice(Audio& initAudio);
@@ -43,7 +44,10 @@ namespace ouzel
             inline auto& getSound() const noexcept { return sound; }
 
             inline auto& getPosition() const noexcept { return position; }
-            inline void setPosition(const Vector3F& newPosition) { position = newPosition; }
+            void setPosition(const Vector3F& newPosition);
+
+            inline auto getGain() const noexcept { return gain; }
+            void setGain(float newGain);
 
             inline auto& getVelocity() const noexcept { return velocity; }
             inline void setVelocity(const Vector3F& newVelocity) { velocity = newVelocity; }
@@ -57,12 +61,16 @@ namespace ouzel
             void setOutput(Mix* newOutput);
 
         private:
+            // called by the audio when the stream has reached its end
+            void finish();
+
             Audio& audio;
-            uintptr_t streamId;
+            uintptr_t streamId = 0;
 
             const Sound* sound = nullptr;
             Vector3F position;
             Vector3F velocity;
+            float gain = 1.0F;
             bool playing = false;
 
             Mix* output = nullptr;
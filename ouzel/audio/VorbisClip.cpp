@@ -4,7 +4,7 @@
 #include "VorbisClip.hpp"
 #include "Audio.hpp"
 #include "mixer/Data.hpp"
-#include "mixer/Stream.hpp"
+#include "mixer/DecodedStream.hpp"
 #include "utils/Utils.hpp"
 
 #if defined(_MSC_VER)
@@ -47,32 +47,41 @@ namespace ouzel
     {
         class VorbisData;
 
-        class VorbisStream final: public mixer::Stream
+        class VorbisDecoder final: public mixer::Decoder
         {
         public:
-            explicit VorbisStream(VorbisData& vorbisData);
+            explicit VorbisDecoder(VorbisData& vorbisData);
 
-            ~VorbisStream()
+            ~VorbisDecoder()
             {
                 if (vorbisStream)
                     stb_vorbis_close(vorbisStream);
             }
 
-            void reset() final
+            uint32_t decode(uint32_t frames, float* samples) final;
+
+            void seek(uint64_t frame) final
             {
-                stb_vorbis_seek_start(vorbisStream);
+                if (frame)
+                    stb_vorbis_seek(vorbisStream, static_cast<unsigned int>(frame));
+                else
+                    stb_vorbis_seek_start(vorbisStream);
             }
 
-            void getSamples(uint32_t frames, std::vector<float>& samples) final;
+            uint64_t getFrames() const final { return frameCount; }
 
         private:
             stb_vorbis* vorbisStream = nullptr;
+            uint64_t frameCount;
+            uint32_t channels;
+            std::vector<float*> channelData;
         };
 
         class VorbisData final: public mixer::Data
         {
         public:
-            explicit VorbisData(const std::vector<uint8_t>& initData):
+            VorbisData(mixer::DecoderPool& initDecoderPool, const storage::FileData& initData):
+                decoderPool(initDecoderPool),
                 data(initData)
             {
                 stb_vorbis* vorbisStream = stb_vorbis_open_memory(data.data(), static_cast<int>(data.size()), nullptr, nullptr);
@@ -84,88 +93,78 @@ namespace ouzel
 
                 channels = static_cast<uint32_t>(info.channels);
                 sampleRate = info.sample_rate;
+                frames = stb_vorbis_stream_length_in_samples(vorbisStream);
 
                 stb_vorbis_close(vorbisStream);
+
+                if (channels != 1 && channels != 2 && channels != 4 && channels != 6)
+                    throw std::runtime_error("Unsupported channel count");
             }
 
             auto& getData() const noexcept { return data; }
+            inline auto getFrames() const noexcept { return frames; }
 
             std::unique_ptr<mixer::Stream> createStream() final
             {
-                return std::make_unique<VorbisStream>(*this);
+                return std::make_unique<mixer::DecodedStream>(*this, decoderPool, std::make_unique<VorbisDecoder>(*this));
             }
 
         private:
-            std::vector<uint8_t> data;
+            mixer::DecoderPool& decoderPool;
+            storage::FileData data; // shared by the decoders of all the streams
+            uint64_t frames;
         };
 
-        VorbisStream::VorbisStream(VorbisData& vorbisData):
-            Stream(vorbisData)
+        VorbisDecoder::VorbisDecoder(VorbisData& vorbisData):
+            frameCount(vorbisData.getFrames()),
+            channels(vorbisData.getChannels()),
+            channelData(vorbisData.getChannels())
         {
             vorbisStream = stb_vorbis_open_memory(vorbisData.getData().data(),
                                                   static_cast<int>(vorbisData.getData().size()),
                                                   nullptr, nullptr);
         }
 
-        void VorbisStream::getSamples(uint32_t frames, std::vector<float>& samples)
+        uint32_t VorbisDecoder::decode(uint32_t frames, float* samples)
         {
-            uint32_t neededSize = frames * data.getChannels();
-            samples.resize(neededSize);
-
-            int resultFrames = 0;
+            if (!frames) return 0;
 
-            if (neededSize > 0)
+            switch (channels)
             {
-                if (vorbisStream->eof)
-                    reset();
-
-                std::vector<float*> channelData(data.getChannels());
-
-                switch (data.getChannels())
-                {
-                    case 1:
-                        channelData[0] = &samples[0];
-                        break;
-                    case 2:
-                        channelData[0] = &samples[0 * frames];
-                        channelData[1] = &samples[1 * frames];
-                        break;
-                    case 4:
-                        channelData[0] = &samples[0 * frames];
-                        channelData[1] = &samples[1 * frames];
-                        channelData[2] = &samples[2 * frames];
-                        channelData[3] = &samples[3 * frames];
-                        break;
-                    case 6:
-                        channelData[0] = &samples[0 * frames];
-                        channelData[1] = &samples[2 * frames];
-                        channelData[2] = &samples[1 * frames];
-                        channelData[3] = &samples[4 * frames];
-                        channelData[4] = &samples[5 * frames];
-                        channelData[5] = &samples[3 * frames];
-                        break;
-                    default:
-                        throw std::runtime_error("Unsupported channel count");
-                }
-
-                resultFrames = stb_vorbis_get_samples_float(vorbisStream, data.getChannels(),
-                                                            channelData.data(), static_cast<int>(frames));
+                case 1:
+                    channelData[0] = &samples[0];
+                    break;
+                case 2:
+                    channelData[0] = &samples[0 * frames];
+                    channelData[1] = &samples[1 * frames];
+                    break;
+                case 4:
+                    channelData[0] = &samples[0 * frames];
+                    channelData[1] = &samples[1 * frames];
+                    channelData[2] = &samples[2 * frames];
+                    channelData[3] = &samples[3 * frames];
+                    break;
+                case 6:
+                    channelData[0] = &samples[0 * frames];
+                    channelData[1] = &samples[2 * frames];
+                    channelData[2] = &samples[1 * frames];
+                    channelData[3] = &samples[4 * frames];
+                    channelData[4] = &samples[5 * frames];
+                    channelData[5] = &samples[3 * frames];
+                    break;
+                default:
+                    throw std::runtime_error("Unsupported channel count");
             }
 
-            if (vorbisStream->eof)
-            {
-                playing = false; // TODO: fire event
-                reset();
-            }
+            const int resultFrames = stb_vorbis_get_samples_float(vorbisStream, static_cast<int>(channels),
+                                                                  channelData.data(), static_cast<int>(frames));
 
-            for (uint32_t channel = 0; channel < data.getChannels(); ++channel)
-                for (uint32_t frame = static_cast<uint32_t>(resultFrames); frame < frames; ++frame)
-                    samples[channel * frames + frame] = 0.0F;
+            return static_cast<uint32_t>(resultFrames);
         }
 
-        VorbisClip::VorbisClip(Audio& initAudio, const std::vector<uint8_t>& initData):
+        VorbisClip::VorbisClip(Audio& initAudio, const storage::FileData& initData):
             Sound(initAudio,
-                  initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(initData))),
+                  initAudio.initData(std::unique_ptr<mixer::Data>(data = new VorbisData(initAudio.getDecoderPool(), initData))),
                   Sound::Format::Vorbis)
         {
         }
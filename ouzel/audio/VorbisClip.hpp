@@ -4,8 +4,8 @@
 #define OUZEL_AUDIO_VORBISCLIP_HPP
 
 #include <cstdint>
-#include <vector>
 #include "audio/Sound.hpp"
+#include "storage/FileData.hpp"
 
 namespace ouzel
 {
@@ -16,7 +16,7 @@ namespace ouzel
         class VorbisClip final: public Sound
         {
         public:
-            VorbisClip(Audio& initAudio, const std::vector<uint8_t>& initData);
+            VorbisClip(Audio& initAudio, const storage::FileData& initData);
 
         private:
             VorbisData* data;
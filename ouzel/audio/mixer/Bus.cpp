@@ -1,10 +1,13 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cfloat>
 #include "Bus.hpp"
 #include "Data.hpp"
 #include "Processor.hpp"
+#include "Resampler.hpp"
 #include "Stream.hpp"
+#include "audio/Dsp.hpp"
 #include "math/MathUtils.hpp"
 
 namespace ouzel
@@ -14,17 +17,28 @@ namespace ouzel
         namespace mixer
         {
             Bus::~Bus()
+            {
+                Bus::detach();
+            }
+
+            void Bus::detach()
             {
                 if (output) output->removeInput(this);
+                output = nullptr;
 
                 for (Bus* inputBus : inputBuses)
                     inputBus->output = nullptr;
+                inputBuses.clear();
 
                 for (Stream* stream : inputStreams)
                     stream->output = nullptr;
+                inputStreams.clear();
 
                 for (Processor* processor : processors)
                     processor->bus = nullptr;
+                processors.clear();
+
+                Object::detach();
             }
 
             void Bus::setOutput(Bus* newOutput)
@@ -83,166 +97,41 @@ namespace ouzel
 
                 if (sourceChannels != channels)
                 {
-                    switch (sourceChannels)
-                    {
-                        case 1:
-                        {
-                            switch (channels)
-                            {
-                                case 2: // upmix 1 to 2
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = sourceSamples[frame]; // L = M
-                                        samples[1 * frames + frame] = sourceSamples[frame]; // R = M
-                                    }
-                                    break;
-                                case 4: // upmix 1 to 4
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = sourceSamples[frame]; // L = M
-                                        samples[1 * frames + frame] = sourceSamples[frame]; // R = M
-                                        samples[2 * frames + frame] = 0.0F; // SL = 0
-                                        samples[3 * frames + frame] = 0.0F; // SR = 0
-                                    }
-                                    break;
-                                case 6: // upmix 1 to 6
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = 0.0F; // L = 0
-                                        samples[1 * frames + frame] = 0.0F; // R = 0
-                                        samples[2 * frames + frame] = sourceSamples[frame]; // C = M
-                                        samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                        samples[4 * frames + frame] = 0.0F; // SL = 0
-                                        samples[5 * frames + frame] = 0.0F; // SR = 0
-                                    }
-                                    break;
-                            }
-                            break;
-                        }
-                        case 2:
-                        {
-                            switch (channels)
-                            {
-                                case 1: // downmix 2 to 1
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                        samples[frame] = (sourceSamples[0 * frames + frame] +
-                                                          sourceSamples[1 * frames + frame]) * 0.5F; // M = (L + R) * 0.5
-                                    break;
-                                case 4: // upmix 2 to 4
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                        samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                        samples[2 * frames + frame] = 0.0F; // SL = 0
-                                        samples[3 * frames + frame] = 0.0F; // SR = 0
-                                    }
-                                    break;
-                                case 6: // upmix 2 to 6
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                        samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                        samples[2 * frames + frame] = 0.0F; // C = 0
-                                        samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                        samples[4 * frames + frame] = 0.0F; // SL = 0
-                                        samples[5 * frames + frame] = 0.0F; // SR = 0
-                                    }
-                                    break;
-                            }
-                            break;
-                        }
-                        case 4:
-                        {
-                            switch (channels)
-                            {
-                                case 1: // downmix 4 to 1
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                        samples[frame] = (sourceSamples[0 * frames + frame] +
-                                                          sourceSamples[1 * frames + frame] +
-                                                          sourceSamples[2 * frames + frame] +
-                                                          sourceSamples[3 * frames + frame]) * 0.25F; // M = (L + R + SL + SR) * 0.25
-                                    break;
-                                case 2: // downmix 4 to 2
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = (sourceSamples[0 * frames + frame] +
-                                                                       sourceSamples[2 * frames + frame]) * 0.5F; // L = (L + SL) * 0.5
-                                        samples[1 * frames + frame] = (sourceSamples[1 * frames + frame] +
-                                                                       sourceSamples[3 * frames + frame]) * 0.5F; // R = (R + RL) * 0.5
-                                    }
-                                    break;
-                                case 6: // upmix 4 to 6
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[0 * frames + frame] = sourceSamples[0 * frames + frame]; // L = L
-                                        samples[1 * frames + frame] = sourceSamples[1 * frames + frame]; // R = R
-                                        samples[2 * frames + frame] = 0.0F; // C = 0
-                                        samples[3 * frames + frame] = 0.0F; // LFE = 0
-                                        samples[4 * frames + frame] = sourceSamples[2 * frames + frame]; // SL = SL
-                                        samples[5 * frames + frame] = sourceSamples[3 * frames + frame]; // SR = SR
-                                    }
-                                    break;
-                            }
-                            break;
-                        }
-                        case 6:
-                        {
-                            switch (channels)
-                            {
-                                case 1: // downmix 6 to 1
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                        samples[frame] = ((sourceSamples[0 * frames + frame] +
-                                                           sourceSamples[1 * frames + frame]) * 0.7071F +
-                                                          sourceSamples[2 * frames + frame] +
-                                                          (sourceSamples[4 * frames + frame] +
-                                                           sourceSamples[5 * frames + frame]) * 0.5F); // M = (L + R) * 0.7071 + C + (SL + SR) * 0.5
-                                    break;
-                                case 2: // downmix 6 to 2
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[frame * channels + 0] = (sourceSamples[0 * frames + frame] +
-                                                                         (sourceSamples[2 * frames + frame] +
-                                                                          sourceSamples[4 * frames + frame]) * 0.7071F); // L = L + (C + SL) * 0.7071
-                                        samples[frame * channels + 1] = (sourceSamples[1 * frames + frame] +
-                                                                         (sourceSamples[2 * frames + frame] +
-                                                                          sourceSamples[5 * frames + frame]) * 0.7071F); // R = R + (C + SR) * 0.7071
-                                    }
-                                    break;
-                                case 4: // downmix 6 to 4
-                                    for (uint32_t frame = 0; frame < frames; ++frame)
-                                    {
-                                        samples[frame * channels + 0] = (sourceSamples[0 * frames + frame] +
-                                                                         sourceSamples[2 * frames + frame] * 0.7071F); // L = L + C * 0.7071
-                                        samples[frame * channels + 1] = (sourceSamples[1 * frames + frame] +
-                                                                         sourceSamples[2 * frames + frame] * 0.7071F); // R = R + C * 0.7071
-                                        samples[frame * channels + 2] = sourceSamples[4 * frames + frame]; // SL = SL
-                                        samples[frame * channels + 3] = sourceSamples[5 * frames + frame]; // SR = SR
-                                    }
-                                    break;
-                            }
-                            break;
-                        }
-                    }
+                    if (const float* matrix = dsp::getChannelMatrix(sourceChannels, channels))
+                        dsp::mixChannels(sourceSamples.data(), sourceChannels, frames, matrix, channels, samples.data());
+                    else
+                        std::fill(samples.begin(), samples.end(), 0.0F);
                 }
                 else
                     samples = sourceSamples;
             }
 
-            void Bus::getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate,
-                                 const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
-                                 std::vector<float>& samples)
+            void Bus::render(uint32_t frames, uint32_t channels, uint32_t sampleRate)
             {
+                std::vector<float>& samples = mixedSamples;
                 samples.resize(frames * channels);
                 std::fill(samples.begin(), samples.end(), 0.0F);
 
-                for (Bus* bus : inputBuses)
-                {
-                    bus->getSamples(frames, channels, sampleRate, listenerPosition, listenerRotation, buffer);
+                for (const Bus* bus : inputBuses)
+                    dsp::accumulate(bus->mixedSamples.data(), samples.size(), 1.0F, samples.data());
 
-                    for (size_t s = 0; s < samples.size(); ++s)
-                        samples[s] += buffer[s];
+                // the gains of all the positional streams are computed in one batch,
+                // with the same attenuation model as in the voice manager
+                spatializer.clear();
+                for (const Stream* stream : inputStreams)
+                    if (stream->isPlaying() && !stream->isVirtual() && stream->isPositional())
+                        spatializer.addEmitter(stream->getPosition(), 1.0F, FLT_MAX, 1.0F);
+
+                if (spatializer.getEmitterCount())
+                {
+                    const Bus* listenerBus = getListenerBus();
+                    spatializer.update(listenerBus ? listenerBus->listenerPosition : Vector3F(),
+                                       listenerBus ? listenerBus->listenerRotation : QuaternionF::identity(),
+                                       channels);
                 }
 
+                size_t emitter = 0;
+
                 for (Stream* stream : inputStreams)
                 {
                     if (stream->isPlaying())
@@ -250,7 +139,31 @@ namespace ouzel
                         const uint32_t sourceSampleRate = stream->getData().getSampleRate();
                         const uint32_t sourceChannels = stream->getData().getChannels();
 
-                        if (sourceSampleRate != sampleRate)
+                        Resampler* resampler = stream->getResampler();
+
+                        // virtual streams keep their playhead moving, but are not decoded or mixed
+                        if (stream->isVirtual())
+                        {
+                            if (resampler && resampler->getSampleRate() == sampleRate)
+                            {
+                                const uint32_t sourceFrames = resampler->getSourceFrames(frames);
+                                stream->skip(sourceFrames);
+                                resampler->skip(sourceFrames, frames);
+                            }
+                            else
+                                stream->skip((sourceSampleRate != sampleRate) ?
+                                             (frames * sourceSampleRate + sampleRate - 1) / sampleRate : // round up, as below
+                                             frames);
+                            continue;
+                        }
+
+                        if (resampler && resampler->getSampleRate() == sampleRate)
+                        {
+                            const uint32_t sourceFrames = resampler->getSourceFrames(frames);
+                            stream->getSamples(sourceFrames, resampleBuffer);
+                            resampler->process(resampleBuffer, sourceFrames, frames, mixBuffer);
+                        }
+                        else if (sourceSampleRate != sampleRate)
                         {
                             uint32_t sourceFrames = (frames * sourceSampleRate + sampleRate - 1) / sampleRate; // round up
                             stream->getSamples(sourceFrames, resampleBuffer);
@@ -259,13 +172,35 @@ namespace ouzel
                         else
                             stream->getSamples(frames, mixBuffer);
 
+                        if (stream->isPositional())
+                        {
+                            // positional streams are mixed down to mono and panned, the gains ramp over the buffer
+                            if (sourceChannels != 1)
+                                convert(frames, sourceChannels, mixBuffer, 1, buffer);
+                            else
+                                buffer = mixBuffer;
+
+                            std::vector<float>& channelGains = stream->getChannelGains();
+                            channelGains.resize(channels);
+
+                            for (uint32_t channel = 0; channel < channels; ++channel)
+                            {
+                                const float channelGain = stream->getGain() * spatializer.getGains(channel)[emitter];
+                                dsp::accumulateRamp(buffer.data(), frames, channelGains[channel], channelGain,
+                                                    samples.data() + channel * frames);
+                                channelGains[channel] = channelGain;
+                            }
+
+                            ++emitter;
+                            continue;
+                        }
+
                         if (sourceChannels != channels)
                             convert(frames, sourceChannels, mixBuffer, channels, buffer);
                         else
                             buffer = mixBuffer;
 
-                        for (size_t s = 0; s < samples.size(); ++s)
-                            samples[s] += buffer[s];
+                        dsp::accumulate(buffer.data(), samples.size(), stream->getAudibility(), samples.data());
                     }
                 }
 
@@ -274,6 +209,25 @@ namespace ouzel
                         processor->process(frames, channels, sampleRate, samples);
             }
 
+            void Bus::setListener(const Vector3F& position, const QuaternionF& rotation)
+            {
+                listener = true;
+                listenerPosition = position;
+                listenerRotation = rotation;
+            }
+
+            void Bus::removeListener()
+            {
+                listener = false;
+            }
+
+            const Bus* Bus::getListenerBus() const noexcept
+            {
+                const Bus* bus = this;
+                while (bus && !bus->listener) bus = bus->output;
+                return bus;
+            }
+
             void Bus::addProcessor(Processor* processor)
             {
                 auto i = std::find(processors.begin(), processors.end(), processor);
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include "audio/mixer/Object.hpp"
+#include "audio/mixer/Spatializer.hpp"
 
 namespace ouzel
 {
@@ -28,11 +29,29 @@ namespace ouzel
                 Bus(Bus&&) = delete;
                 Bus& operator=(Bus&&) = delete;
 
+                void detach() final;
+
                 void setOutput(Bus* newOutput);
 
-                void getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate,
-                                const Vector3F& listenerPosition, const QuaternionF& listenerRotation,
-                                std::vector<float>& samples);
+                inline auto& getInputBuses() const noexcept { return inputBuses; }
+
+                // mixes the inputs and runs the processors, the input buses must have been rendered before,
+                // buses that don't feed each other can be rendered on different threads
+                void render(uint32_t frames, uint32_t channels, uint32_t sampleRate);
+                inline auto& getMixedSamples() const noexcept { return mixedSamples; }
+
+                // the distance from the bus to the farthest bus that feeds it, set by the mixer
+                inline auto getLevel() const noexcept { return level; }
+                inline void setLevel(uint32_t newLevel) noexcept { level = newLevel; }
+
+                inline auto hasListener() const noexcept { return listener; }
+                inline auto& getListenerPosition() const noexcept { return listenerPosition; }
+                inline auto& getListenerRotation() const noexcept { return listenerRotation; }
+                void setListener(const Vector3F& position, const QuaternionF& rotation);
+                void removeListener();
+
+                // the nearest bus with a listener on the way to the master bus, or nullptr
+                const Bus* getListenerBus() const noexcept;
 
                 void addProcessor(Processor* processor);
                 void removeProcessor(Processor* processor);
@@ -51,6 +70,13 @@ namespace ouzel
                 std::vector<float> resampleBuffer;
                 std::vector<float> mixBuffer;
                 std::vector<float> buffer;
+                std::vector<float> mixedSamples;
+                uint32_t level = 0;
+
+                bool listener = false;
+                Vector3F listenerPosition;
+                QuaternionF listenerRotation = QuaternionF::identity();
+                Spatializer spatializer;
             };
         }
     } // namespace audio
@@ -6,7 +6,9 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
-
+#include <string>
+#include <vector>
+#include "audio/mixer/Bus.hpp"
 #include "audio/mixer/Processor.hpp"
 #include "audio/mixer/Source.hpp"
 #include "audio/mixer/Stream.hpp"
@@ -34,13 +36,18 @@ namespace ouzel
                     AddProcessor,
                     RemoveProcessor,
                     SetMasterBus,
+                    SetBusListener,
+                    RemoveBusListener,
                     InitStream,
                     PlayStream,
                     StopStream,
                     SetStreamOutput,
+                    SetStreamGain,
+                    SetStreamPosition,
                     InitData,
                     InitProcessor,
-                    UpdateProcessor
+                    UpdateProcessor,
+                    ResizeObjects
                 };
 
                 explicit constexpr Command(Type initType) noexcept: type(initType) {}
@@ -52,31 +59,34 @@ namespace ouzel
             class InitObjectCommand final: public Command
             {
             public:
-                explicit constexpr InitObjectCommand(uintptr_t initObjectId) noexcept:
+                explicit InitObjectCommand(uintptr_t initObjectId):
                     Command(Command::Type::InitObject),
-                    objectId(initObjectId)
+                    objectId(initObjectId),
+                    object(std::make_unique<Object>())
                 {}
 
                 InitObjectCommand(uintptr_t initObjectId,
-                                  std::unique_ptr<Source> initSource) noexcept:
+                                  std::unique_ptr<Source> initSource):
                     Command(Command::Type::InitObject),
                     objectId(initObjectId),
-                    source(std::move(initSource))
+                    object(std::make_unique<Object>(std::move(initSource)))
                 {}
 
                 const uintptr_t objectId;
-                std::unique_ptr<Source> source;
+                std::unique_ptr<Object> object;
             };
 
             class DeleteObjectCommand final: public Command
             {
             public:
-                explicit constexpr DeleteObjectCommand(uintptr_t initObjectId) noexcept:
+                explicit DeleteObjectCommand(uintptr_t initObjectId) noexcept:
                     Command(Command::Type::DeleteObject),
                     objectId(initObjectId)
                 {}
 
                 const uintptr_t objectId;
+                // the mixer moves the deleted object here, so that it is destroyed together with the command
+                std::unique_ptr<Object> object;
             };
 
             class AddChildCommand final: public Command
@@ -135,12 +145,14 @@ namespace ouzel
             class InitBusCommand final: public Command
             {
             public:
-                explicit constexpr InitBusCommand(uintptr_t initBusId) noexcept:
+                explicit InitBusCommand(uintptr_t initBusId):
                     Command(Command::Type::InitBus),
-                    busId(initBusId)
+                    busId(initBusId),
+                    bus(std::make_unique<Bus>())
                 {}
 
                 const uintptr_t busId;
+                std::unique_ptr<Bus> bus;
             };
 
             class SetBusOutputCommand final: public Command
@@ -196,18 +208,46 @@ namespace ouzel
                 const uintptr_t busId;
             };
 
+            class SetBusListenerCommand final: public Command
+            {
+            public:
+                SetBusListenerCommand(uintptr_t initBusId,
+                                      const Vector3F& initPosition,
+                                      const QuaternionF& initRotation) noexcept:
+                    Command(Command::Type::SetBusListener),
+                    busId(initBusId),
+                    position(initPosition),
+                    rotation(initRotation)
+                {}
+
+                const uintptr_t busId;
+                const Vector3F position;
+                const QuaternionF rotation;
+            };
+
+            class RemoveBusListenerCommand final: public Command
+            {
+            public:
+                explicit constexpr RemoveBusListenerCommand(uintptr_t initBusId) noexcept:
+                    Command(Command::Type::RemoveBusListener),
+                    busId(initBusId)
+                {}
+
+                const uintptr_t busId;
+            };
+
             class InitStreamCommand final: public Command
             {
             public:
-                constexpr InitStreamCommand(uintptr_t initStreamId,
-                                            uintptr_t initDataId) noexcept:
+                InitStreamCommand(uintptr_t initStreamId,
+                                  std::unique_ptr<Stream> initStream) noexcept:
                     Command(Command::Type::InitStream),
                     streamId(initStreamId),
-                    dataId(initDataId)
+                    stream(std::move(initStream))
                 {}
 
                 const uintptr_t streamId;
-                const uintptr_t dataId;
+                std::unique_ptr<Stream> stream;
             };
 
             class PlayStreamCommand final: public Command
@@ -249,6 +289,34 @@ namespace ouzel
                 const uintptr_t busId;
             };
 
+            class SetStreamGainCommand final: public Command
+            {
+            public:
+                constexpr SetStreamGainCommand(uintptr_t initStreamId,
+                                               float initGain) noexcept:
+                    Command(Command::Type::SetStreamGain),
+                    streamId(initStreamId),
+                    gain(initGain)
+                {}
+
+                const uintptr_t streamId;
+                const float gain;
+            };
+
+            class SetStreamPositionCommand final: public Command
+            {
+            public:
+                SetStreamPositionCommand(uintptr_t initStreamId,
+                                         const Vector3F& initPosition) noexcept:
+                    Command(Command::Type::SetStreamPosition),
+                    streamId(initStreamId),
+                    position(initPosition)
+                {}
+
+                const uintptr_t streamId;
+                const Vector3F position;
+            };
+
             class InitDataCommand final: public Command
             {
             public:
@@ -291,6 +359,26 @@ namespace ouzel
                 const std::function<void(Processor*)> updateFunction;
             };
 
+            class ResizeObjectsCommand final: public Command
+            {
+            public:
+                explicit ResizeObjectsCommand(size_t size):
+                    Command(Command::Type::ResizeObjects),
+                    objects(size)
+                {
+                    streams.reserve(size);
+                    buses.reserve(size);
+                }
+
+                // the mixer swaps these with its object table, stream list and bus schedule,
+                // so the old ones are freed with the command
+                std::vector<std::unique_ptr<Object>> objects;
+                std::vector<Stream*> streams;
+                std::vector<Bus*> buses;
+            };
+
+            // Commands stay owned by the buffer after they are popped,
+            // so that they are destroyed on the thread that destroys the buffer
             class CommandBuffer final
             {
             public:
@@ -300,20 +388,39 @@ namespace ouzel
                 {
                 }
 
+                CommandBuffer(CommandBuffer&& other) noexcept:
+                    name(std::move(other.name)),
+                    commands(std::move(other.commands)),
+                    position(other.position)
+                {
+                    other.commands.clear();
+                    other.position = 0;
+                }
+
+                CommandBuffer& operator=(CommandBuffer&& other) noexcept
+                {
+                    if (&other == this) return *this;
+
+                    name = std::move(other.name);
+                    commands = std::move(other.commands);
+                    position = other.position;
+                    other.commands.clear();
+                    other.position = 0;
+                    return *this;
+                }
+
                 inline auto& getName() const noexcept { return name; }
 
-                inline auto isEmpty() const noexcept { return commands.empty(); }
+                inline auto isEmpty() const noexcept { return position == commands.size(); }
 
                 inline void pushCommand(std::unique_ptr<Command> command)
                 {
-                    commands.push(std::move(command));
+                    commands.push_back(std::move(command));
                 }
 
-                inline std::unique_ptr<Command> popCommand()
+                inline Command* popCommand()
                 {
-                    auto result = std::move(commands.front());
-                    commands.pop();
-                    return result;
+                    return commands[position++].get();
                 }
 
                 inline auto& getCommands() const
@@ -323,7 +430,8 @@ namespace ouzel
 
             private:
                 std::string name;
-                std::queue<std::unique_ptr<Command>> commands;
+                std::vector<std::unique_ptr<Command>> commands;
+                size_t position = 0;
             };
         }
     } // namespace audio
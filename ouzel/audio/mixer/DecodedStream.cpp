@@ -0,0 +1,180 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "DecodedStream.hpp"
+#include "Data.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            constexpr uint32_t DecodedStream::DECODE_FRAMES;
+
+            DecodedStream::DecodedStream(Data& initData, DecoderPool& initDecoderPool, std::unique_ptr<Decoder> initDecoder):
+                Stream(initData),
+                decoderPool(initDecoderPool),
+                decoder(std::move(initDecoder)),
+                buffer(std::max(static_cast<uint64_t>(DECODE_FRAMES),
+                                static_cast<uint64_t>(initDecoderPool.getDecodeAhead()) * initData.getSampleRate() / 1000),
+                       initData.getChannels()),
+                decodeBuffer(DECODE_FRAMES * initData.getChannels()),
+                frameCount(decoder->getFrames())
+            {
+                decoderPool.addStream(this);
+            }
+
+            DecodedStream::~DecodedStream()
+            {
+                decoderPool.removeStream(this);
+            }
+
+            void DecodedStream::reset()
+            {
+                position = 0;
+                seekPending = false;
+                requestSeek(0);
+            }
+
+            void DecodedStream::getSamples(uint32_t frames, std::vector<float>& samples)
+            {
+                if (paused.load(std::memory_order_relaxed))
+                {
+                    paused.store(false, std::memory_order_release);
+
+                    if (seekPending)
+                    {
+                        seekPending = false;
+                        requestSeek(position);
+                    }
+                    else
+                        decoderPool.notify();
+                }
+
+                const uint32_t channels = data.getChannels();
+                samples.resize(frames * channels);
+
+                const size_t count = consume(frames, samples.data());
+
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                    std::fill(samples.begin() + channel * frames + count,
+                              samples.begin() + (channel + 1) * frames, 0.0F);
+            }
+
+            void DecodedStream::skip(uint32_t frames)
+            {
+                paused.store(true, std::memory_order_relaxed);
+
+                // the frames that are already decoded are dropped, the rest only move the playhead
+                const size_t count = seekPending ? 0 : consume(frames, nullptr);
+
+                if (playing && count < frames)
+                {
+                    position = std::min(position + frames - count, frameCount);
+                    seekPending = true;
+
+                    if (position == frameCount) finish();
+                }
+            }
+
+            void DecodedStream::requestSeek(uint64_t frame)
+            {
+                seekFrame.store(frame, std::memory_order_relaxed);
+                generation.store(generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                decoderPool.notify();
+            }
+
+            size_t DecodedStream::consume(uint32_t frames, float* samples)
+            {
+                // without decoder threads only the requested frames are decoded, so that the audio callback doesn't fill
+                // the whole buffer at once
+                if (!decoderPool.getThreadCount() && !paused.load(std::memory_order_relaxed))
+                {
+                    const uint64_t bufferedFrames = (generation.load(std::memory_order_relaxed) != decodedGeneration.load(std::memory_order_relaxed)) ?
+                        0 : writtenFrames - readFrames;
+                    if (bufferedFrames < frames)
+                        decode(static_cast<size_t>(frames - bufferedFrames));
+                }
+
+                const uint32_t currentGeneration = generation.load(std::memory_order_relaxed);
+
+                // until the decoder has caught up with a reset or a seek, the stream is silent
+                if (decodedGeneration.load(std::memory_order_acquire) != currentGeneration)
+                    return 0;
+
+                if (flushedGeneration != currentGeneration)
+                {
+                    const uint64_t frame = flushFrame.load(std::memory_order_relaxed);
+                    buffer.skip(static_cast<size_t>(frame - readFrames));
+                    readFrames = frame;
+                    flushedGeneration = currentGeneration;
+                }
+
+                const uint64_t end = endFrame.load(std::memory_order_acquire);
+                const auto remainingFrames = static_cast<size_t>(std::min(static_cast<uint64_t>(frames), end - readFrames));
+
+                const size_t count = samples ?
+                    buffer.read(samples, remainingFrames, frames) :
+                    buffer.skip(remainingFrames);
+                readFrames += count;
+                position += count;
+
+                if (readFrames == end) finish();
+
+                return count;
+            }
+
+            bool DecodedStream::needsDecoding() const
+            {
+                // virtual streams are not decoded until they are mixed again
+                if (paused.load(std::memory_order_acquire))
+                    return false;
+
+                if (generation.load(std::memory_order_acquire) != decodedGeneration.load(std::memory_order_relaxed))
+                    return true;
+
+                return !ended && buffer.getFreeFrames() >= std::min(static_cast<size_t>(DECODE_FRAMES), buffer.getCapacity() / 2);
+            }
+
+            void DecodedStream::decode()
+            {
+                decode(buffer.getCapacity());
+            }
+
+            void DecodedStream::decode(size_t maxFrames)
+            {
+                const uint32_t requestedGeneration = generation.load(std::memory_order_acquire);
+
+                if (requestedGeneration != decodedGeneration.load(std::memory_order_relaxed))
+                {
+                    decoder->seek(seekFrame.load(std::memory_order_relaxed));
+                    ended = false;
+                    endFrame.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+                    flushFrame.store(writtenFrames, std::memory_order_relaxed);
+                    decodedGeneration.store(requestedGeneration, std::memory_order_release);
+                }
+
+                for (size_t decodedFrames = 0; !ended && generation.load(std::memory_order_relaxed) == requestedGeneration;)
+                {
+                    const auto frames = static_cast<uint32_t>(std::min({static_cast<size_t>(DECODE_FRAMES),
+                                                                        buffer.getFreeFrames(),
+                                                                        maxFrames - decodedFrames}));
+                    if (!frames) break;
+
+                    const uint32_t result = decoder->decode(frames, decodeBuffer.data());
+
+                    buffer.write(decodeBuffer.data(), result, frames);
+                    writtenFrames += result;
+                    decodedFrames += result;
+
+                    if (result < frames)
+                    {
+                        ended = true;
+                        endFrame.store(writtenFrames, std::memory_order_release);
+                    }
+                }
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
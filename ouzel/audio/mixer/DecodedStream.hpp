@@ -0,0 +1,105 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_DECODEDSTREAM_HPP
+#define OUZEL_AUDIO_MIXER_DECODEDSTREAM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "audio/mixer/DecoderPool.hpp"
+#include "audio/mixer/RingBuffer.hpp"
+#include "audio/mixer/Stream.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            // Source of compressed samples, used only by one decoder thread at a time
+            class Decoder
+            {
+            public:
+                Decoder() = default;
+                virtual ~Decoder() = default;
+
+                Decoder(const Decoder&) = delete;
+                Decoder& operator=(const Decoder&) = delete;
+
+                Decoder(Decoder&&) = delete;
+                Decoder& operator=(Decoder&&) = delete;
+
+                // writes the channels of up to the given number of frames one after another, each frames samples long,
+                // returns the number of frames decoded, which is less than requested at the end of the stream
+                virtual uint32_t decode(uint32_t frames, float* samples) = 0;
+                // moves to the given frame, zero rewinds the decoder
+                virtual void seek(uint64_t frame) = 0;
+                // the length of the stream in frames, called only when the stream is created
+                virtual uint64_t getFrames() const = 0;
+            };
+
+            // Stream that is decoded ahead by the decoder pool, so that the mixer only copies the samples out
+            class DecodedStream final: public Stream
+            {
+            public:
+                static constexpr uint32_t DECODE_FRAMES = 1024;
+
+                // must be created on the thread that owns the decoder pool
+                DecodedStream(Data& initData, DecoderPool& initDecoderPool, std::unique_ptr<Decoder> initDecoder);
+                ~DecodedStream();
+
+                DecodedStream(const DecodedStream&) = delete;
+                DecodedStream& operator=(const DecodedStream&) = delete;
+
+                DecodedStream(DecodedStream&&) = delete;
+                DecodedStream& operator=(DecodedStream&&) = delete;
+
+                void reset() final;
+                void getSamples(uint32_t frames, std::vector<float>& samples) final;
+                // virtual streams are not decoded, the decoder seeks to the playhead once the stream is mixed again
+                void skip(uint32_t frames) final;
+
+                // called by the decoder pool
+                bool needsDecoding() const;
+                void decode();
+
+            private:
+                // reads the frames from the buffer or drops them if samples is null, returns the number of frames
+                size_t consume(uint32_t frames, float* samples);
+                // called by the mixer, the decoder seeks on its thread
+                void requestSeek(uint64_t frame);
+                // decodes up to the given number of frames or until the buffer is full
+                void decode(size_t maxFrames);
+
+                DecoderPool& decoderPool;
+                std::unique_ptr<Decoder> decoder;
+                RingBuffer buffer;
+
+                // reset and seek requests are counted, the decoder seeks once for the latest one
+                // and the frames it had written before the seek are dropped by the mixer
+                std::atomic<uint32_t> generation{0};
+                std::atomic<uint64_t> seekFrame{0};
+                std::atomic<bool> paused{false}; // set while the stream is virtual
+                std::atomic<uint32_t> decodedGeneration{0};
+                std::atomic<uint64_t> flushFrame{0};
+                std::atomic<uint64_t> endFrame{std::numeric_limits<uint64_t>::max()};
+
+                // used only by the decoder thread
+                std::vector<float> decodeBuffer;
+                uint64_t writtenFrames = 0;
+                bool ended = false;
+
+                // used only by the mixer
+                uint32_t flushedGeneration = 0;
+                uint64_t readFrames = 0;
+                uint64_t position = 0; // the frame of the stream at the playhead
+                bool seekPending = false; // the playhead has moved past the decoded frames
+                uint64_t frameCount;
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_DECODEDSTREAM_HPP
@@ -0,0 +1,103 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include "DecoderPool.hpp"
+#include "DecodedStream.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            DecoderPool::DecoderPool(uint32_t threadCount, uint32_t initDecodeAhead):
+                decodeAhead(initDecodeAhead)
+            {
+                for (uint32_t i = 0; i < threadCount; ++i)
+                    threads.emplace_back(&DecoderPool::decoderMain, this);
+            }
+
+            DecoderPool::~DecoderPool()
+            {
+                std::unique_lock<std::mutex> lock(streamMutex);
+                running = false;
+                lock.unlock();
+                streamCondition.notify_all();
+
+                for (Thread& thread : threads)
+                    thread.join();
+            }
+
+            void DecoderPool::addStream(DecodedStream* stream)
+            {
+                std::unique_lock<std::mutex> lock(streamMutex);
+                streams.push_back(stream);
+                lock.unlock();
+                streamCondition.notify_one();
+            }
+
+            void DecoderPool::removeStream(DecodedStream* stream)
+            {
+                std::unique_lock<std::mutex> lock(streamMutex);
+                releaseCondition.wait(lock, [this, stream]() {
+                    return std::find(busyStreams.begin(), busyStreams.end(), stream) == busyStreams.end();
+                });
+
+                auto i = std::find(streams.begin(), streams.end(), stream);
+                if (i != streams.end()) streams.erase(i);
+            }
+
+            void DecoderPool::notify()
+            {
+                streamCondition.notify_one();
+            }
+
+            void DecoderPool::decoderMain()
+            {
+                Thread::setCurrentThreadName("Decoder");
+
+                // the mixer doesn't notify when it reads from the buffers, so they are polled
+                // a few times during the decode-ahead window
+                const std::chrono::milliseconds pollInterval(std::max(decodeAhead / 4, 1U));
+
+                std::unique_lock<std::mutex> lock(streamMutex);
+
+                while (running)
+                {
+                    DecodedStream* stream = nullptr;
+
+                    // round robin, so that one stream can't keep the others waiting
+                    for (size_t i = 0; i < streams.size(); ++i)
+                    {
+                        DecodedStream* candidate = streams[(nextStream + i) % streams.size()];
+
+                        // the decoder state of a stream may only be read while no other thread decodes it
+                        if (std::find(busyStreams.begin(), busyStreams.end(), candidate) == busyStreams.end() &&
+                            candidate->needsDecoding())
+                        {
+                            stream = candidate;
+                            nextStream = (nextStream + i + 1) % streams.size();
+                            break;
+                        }
+                    }
+
+                    if (!stream)
+                    {
+                        streamCondition.wait_for(lock, pollInterval);
+                        continue;
+                    }
+
+                    busyStreams.push_back(stream);
+                    lock.unlock();
+
+                    stream->decode();
+
+                    lock.lock();
+                    busyStreams.erase(std::find(busyStreams.begin(), busyStreams.end(), stream));
+                    releaseCondition.notify_all();
+                }
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
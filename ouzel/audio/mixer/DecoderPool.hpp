@@ -0,0 +1,63 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_DECODERPOOL_HPP
+#define OUZEL_AUDIO_MIXER_DECODERPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            class DecodedStream;
+
+            // Worker threads that keep the buffers of the decoded streams filled ahead of the mixer
+            class DecoderPool final
+            {
+            public:
+                // decodeAhead is the length of the stream buffers in milliseconds,
+                // with no threads the streams are decoded by the mixer when it reads them
+                DecoderPool(uint32_t threadCount, uint32_t initDecodeAhead);
+                ~DecoderPool();
+
+                DecoderPool(const DecoderPool&) = delete;
+                DecoderPool& operator=(const DecoderPool&) = delete;
+
+                DecoderPool(DecoderPool&&) = delete;
+                DecoderPool& operator=(DecoderPool&&) = delete;
+
+                inline auto getThreadCount() const noexcept { return static_cast<uint32_t>(threads.size()); }
+                inline auto getDecodeAhead() const noexcept { return decodeAhead; }
+
+                void addStream(DecodedStream* stream);
+                // waits for the stream to be released if a decoder thread is working on it
+                void removeStream(DecodedStream* stream);
+
+                // wakes a decoder thread, so that a reset stream doesn't wait for the next poll
+                void notify();
+
+            private:
+                void decoderMain();
+
+                uint32_t decodeAhead;
+                std::vector<Thread> threads;
+
+                std::mutex streamMutex;
+                std::condition_variable streamCondition;
+                std::condition_variable releaseCondition;
+                std::vector<DecodedStream*> streams;
+                std::vector<DecodedStream*> busyStreams;
+                size_t nextStream = 0;
+                bool running = true;
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_DECODERPOOL_HPP
@@ -0,0 +1,169 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include "MixPool.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            constexpr uint32_t MixPool::SPIN_COUNT;
+            constexpr uint32_t MixPool::CLOSED_INDEX;
+
+            MixPool::MixPool(uint32_t workerCount)
+            {
+                // a spinning thread that shares a core with the mixer only slows it down,
+                // so there is at most one worker for every core besides the one of the mixer
+                const uint32_t cores = std::thread::hardware_concurrency();
+                if (cores) workerCount = std::min(workerCount, cores - 1);
+
+                for (uint32_t i = 0; i < workerCount; ++i)
+                {
+                    workers.emplace_back(&MixPool::workerMain, this);
+
+                    try
+                    {
+                        workers.back().setPriority(1.0F, true);
+                    }
+                    catch (const std::system_error&)
+                    {
+                        // real-time scheduling needs privileges, the worker keeps the normal priority without them
+                    }
+                }
+            }
+
+            MixPool::~MixPool()
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                running.store(false);
+                lock.unlock();
+                sleepCondition.notify_all();
+
+                for (Thread& worker : workers)
+                    if (worker.isJoinable()) worker.join();
+            }
+
+            void MixPool::run(size_t count, const std::function<void(size_t)>& job)
+            {
+                if (!count) return;
+
+                if (workers.empty() || count == 1)
+                {
+                    for (size_t i = 0; i < count; ++i) job(i);
+                    return;
+                }
+
+                // workers that are late for the previous batch can still be reading the job and the count,
+                // so the batch is closed first, their claims fail once the state has changed
+                const auto batch = static_cast<uint32_t>(jobState.load(std::memory_order_relaxed) >> 32) + 1;
+                jobState.store((static_cast<uint64_t>(batch) << 32) | CLOSED_INDEX);
+
+                currentJob.store(&job, std::memory_order_release);
+                jobCount.store(count, std::memory_order_release);
+                pendingJobs.store(count, std::memory_order_relaxed);
+
+                jobState.store(static_cast<uint64_t>(batch) << 32);
+
+                // pairs with the check of the batch in workerMain, so that a worker that is about to sleep sees the new batch
+                if (sleepingWorkers.load())
+                {
+                    std::unique_lock<std::mutex> lock(sleepMutex);
+                    lock.unlock();
+                    sleepCondition.notify_all();
+                }
+
+                processJobs(batch);
+
+                while (pendingJobs.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+
+                if (failed.load(std::memory_order_relaxed))
+                {
+                    failed.store(false, std::memory_order_relaxed);
+                    std::exception_ptr jobException = exception;
+                    exception = nullptr;
+                    std::rethrow_exception(jobException);
+                }
+            }
+
+            void MixPool::processJobs(uint32_t batch)
+            {
+                uint64_t state = jobState.load(std::memory_order_acquire);
+
+                for (;;)
+                {
+                    if (static_cast<uint32_t>(state >> 32) != batch) return;
+
+                    const auto index = static_cast<uint32_t>(state);
+
+                    // the job and the count of the batch are being stored
+                    if (index == CLOSED_INDEX)
+                    {
+                        std::this_thread::yield();
+                        state = jobState.load(std::memory_order_acquire);
+                        continue;
+                    }
+
+                    // the count and the job are read before claiming the index, if they belong to a newer batch,
+                    // the state has already been changed by the closing of the batch, so the claim fails
+                    if (index >= jobCount.load(std::memory_order_acquire)) return;
+                    const std::function<void(size_t)>* job = currentJob.load(std::memory_order_acquire);
+
+                    if (!jobState.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_acquire))
+                        continue;
+
+                    try
+                    {
+                        (*job)(index);
+                    }
+                    catch (...)
+                    {
+                        if (!failed.exchange(true, std::memory_order_relaxed))
+                            exception = std::current_exception();
+                    }
+
+                    pendingJobs.fetch_sub(1, std::memory_order_release);
+                    state = jobState.load(std::memory_order_acquire);
+                }
+            }
+
+            void MixPool::workerMain()
+            {
+                Thread::setCurrentThreadName("Mix");
+
+                uint32_t batch = 0;
+
+                while (running.load(std::memory_order_relaxed))
+                {
+                    uint32_t nextBatch = batch;
+
+                    for (uint32_t i = 0; i < SPIN_COUNT && nextBatch == batch; ++i)
+                    {
+                        std::this_thread::yield();
+                        nextBatch = static_cast<uint32_t>(jobState.load(std::memory_order_acquire) >> 32);
+                    }
+
+                    if (nextBatch == batch)
+                    {
+                        std::unique_lock<std::mutex> lock(sleepMutex);
+                        sleepingWorkers.fetch_add(1);
+                        sleepCondition.wait(lock, [this, batch, &nextBatch]() {
+                            nextBatch = static_cast<uint32_t>(jobState.load() >> 32);
+                            return nextBatch != batch || !running.load(std::memory_order_relaxed);
+                        });
+                        sleepingWorkers.fetch_sub(1);
+
+                        if (nextBatch == batch) continue;
+                    }
+
+                    batch = nextBatch;
+                    processJobs(batch);
+                }
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,75 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_MIXPOOL_HPP
+#define OUZEL_AUDIO_MIXER_MIXPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            // Worker threads that render the buses of a mix level in parallel with the mixer thread,
+            // unlike ThreadPool the batches are handed out and joined through atomics, so that the mixer never waits on a mutex,
+            // the workers run at real-time priority if the system allows it and spin for a while after every batch,
+            // because the next level follows right away
+            class MixPool final
+            {
+            public:
+                // the worker count is limited to the number of the other cores
+                explicit MixPool(uint32_t workerCount);
+                ~MixPool();
+
+                MixPool(const MixPool&) = delete;
+                MixPool& operator=(const MixPool&) = delete;
+
+                MixPool(MixPool&&) = delete;
+                MixPool& operator=(MixPool&&) = delete;
+
+                inline auto getWorkerCount() const noexcept { return static_cast<uint32_t>(workers.size()); }
+
+                // calls job with every index in [0, count) and returns once all of them have finished,
+                // must be called only from one thread, the first exception thrown by a job is rethrown
+                void run(size_t count, const std::function<void(size_t)>& job);
+
+            private:
+                static constexpr uint32_t SPIN_COUNT = 4096;
+                // the index of a batch whose job and count are not stored yet
+                static constexpr uint32_t CLOSED_INDEX = 0xFFFFFFFF;
+
+                // returns after the jobs of the batch have all been claimed
+                void processJobs(uint32_t batch);
+                void workerMain();
+
+                std::vector<Thread> workers;
+
+                // the batch number in the upper half and the index of the next job in the lower half,
+                // a job is claimed only if the state has not changed since the job and the count were read
+                std::atomic<uint64_t> jobState{0};
+                std::atomic<const std::function<void(size_t)>*> currentJob{nullptr};
+                std::atomic<size_t> jobCount{0};
+                std::atomic<size_t> pendingJobs{0};
+                std::atomic<bool> failed{false};
+                std::exception_ptr exception;
+
+                // the workers sleep only after spinning, so the mixer locks the mutex only to wake them up
+                std::atomic<uint32_t> sleepingWorkers{0};
+                std::atomic<bool> running{true};
+                std::mutex sleepMutex;
+                std::condition_variable sleepCondition;
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_MIXPOOL_HPP
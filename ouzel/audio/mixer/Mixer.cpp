@@ -1,10 +1,12 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <chrono>
 #include "Mixer.hpp"
 #include "Bus.hpp"
 #include "Data.hpp"
 #include "Stream.hpp"
-#include "math/MathUtils.hpp"
+#include "audio/Dsp.hpp"
 
 namespace ouzel
 {
@@ -12,43 +14,94 @@ namespace ouzel
     {
         namespace mixer
         {
+            constexpr size_t Mixer::COMMAND_QUEUE_SIZE;
+            constexpr size_t Mixer::EVENT_QUEUE_SIZE;
+            constexpr uintptr_t Mixer::INITIAL_OBJECT_CAPACITY;
+            constexpr size_t Mixer::RENDER_HISTOGRAM_SIZE;
+
             Mixer::Mixer(uint32_t initBufferSize,
                          uint32_t initChannels,
+                         uint32_t initSampleRate,
+                         uint32_t initLookahead,
+                         uint32_t initMaxVoices,
+                         uint32_t initMixThreads,
                          const std::function<void(const Event&)>& initCallback):
                 bufferSize(initBufferSize),
                 channels(initChannels),
+                sampleRate(initSampleRate),
+                lookahead(initLookahead),
                 callback(initCallback),
-                mixerThread(&Mixer::mixerMain, this),
-                buffer(initBufferSize * 3, initChannels)
+                voiceManager(initMaxVoices, INITIAL_OBJECT_CAPACITY),
+                mixPool(initMixThreads),
+                buffer(initBufferSize * initLookahead, initChannels)
             {
-                //mixerThread.setPriority(20.0F, true);
+                schedule.reserve(INITIAL_OBJECT_CAPACITY);
+                renderJob = [this](size_t index) {
+                    schedule[levelStart + index]->render(renderFrames, channels, sampleRate);
+                };
 
                 rootObjectId = getObjectId();
-                objects.resize(rootObjectId);
+                objects.resize(objectCapacity);
                 auto object = std::make_unique<RootObject>();
                 rootObject = object.get();
                 objects[rootObjectId - 1] = std::move(object);
+
+                // started last, so that the thread sees a fully constructed mixer
+                if (lookahead)
+                {
+                    mixerThread = Thread(&Mixer::mixerMain, this);
+                    //mixerThread.setPriority(20.0F, true);
+                }
             }
 
             Mixer::~Mixer()
             {
+                std::unique_lock<std::mutex> lock(bufferMutex);
+                running = false;
+                lock.unlock();
+                bufferCondition.notify_all();
+
                 if (mixerThread.isJoinable())
                     mixerThread.join();
             }
 
+            bool Mixer::submitCommandBuffer(CommandBuffer&& commandBuffer)
+            {
+                // destroy the buffers (and the objects deleted by them) that the mixer has finished with
+                CommandBuffer processedBuffer;
+                while (processedQueue.pop(processedBuffer))
+                    --pendingCommandBuffers;
+
+                // the object table is reallocated here and swapped in by the mixer ahead of the buffer
+                const bool resizeObjects = lastObjectId > objectCapacity;
+
+                // the processed queue can never overflow because at most its capacity of buffers is in flight
+                if (pendingCommandBuffers + (resizeObjects ? 2 : 1) > COMMAND_QUEUE_SIZE)
+                    return false;
+
+                if (resizeObjects)
+                {
+                    objectCapacity = std::max(lastObjectId, objectCapacity * 2);
+
+                    CommandBuffer resizeBuffer;
+                    resizeBuffer.pushCommand(std::make_unique<ResizeObjectsCommand>(objectCapacity));
+                    commandQueue.push(std::move(resizeBuffer));
+                    ++pendingCommandBuffers;
+                }
+
+                commandQueue.push(std::move(commandBuffer));
+                ++pendingCommandBuffers;
+
+                return true;
+            }
+
             void Mixer::process()
             {
                 CommandBuffer commandBuffer;
-                std::unique_ptr<Command> command;
+                Command* command;
 
-                for (;;)
+                while (commandQueue.pop(commandBuffer))
                 {
-                    std::unique_lock<std::mutex> lock(commandQueueMutex);
-                    if (commandQueue.empty()) break;
-                    commandBuffer = std::move(commandQueue.front());
-                    commandQueue.pop();
-                    lock.unlock();
-
                     while (!commandBuffer.isEmpty())
                     {
                         command = commandBuffer.popCommand();
@@ -57,67 +110,73 @@ namespace ouzel
                         {
                             case Command::Type::InitObject:
                             {
-                                auto initObjectCommand = static_cast<InitObjectCommand*>(command.get());
-                                objects[initObjectCommand->objectId - 1] = std::make_unique<Object>(std::move(initObjectCommand->source));
+                                auto initObjectCommand = static_cast<InitObjectCommand*>(command);
+                                objects[initObjectCommand->objectId - 1] = std::move(initObjectCommand->object);
                                 break;
                             }
                             case Command::Type::DeleteObject:
                             {
-                                auto deleteObjectCommand = static_cast<const DeleteObjectCommand*>(command.get());
-                                objects[deleteObjectCommand->objectId - 1].reset();
+                                auto deleteObjectCommand = static_cast<DeleteObjectCommand*>(command);
+                                std::unique_ptr<Object>& object = objects[deleteObjectCommand->objectId - 1];
+
+                                if (object)
+                                {
+                                    if (object.get() == masterBus) masterBus = nullptr;
+                                    voiceManager.removeObject(object.get());
+                                    scheduleDirty = true;
+                                    object->detach();
+                                    deleteObjectCommand->object = std::move(object);
+                                }
                                 break;
                             }
                             case Command::Type::AddChild:
                             {
-                                auto addChildCommand = static_cast<const AddChildCommand*>(command.get());
+                                auto addChildCommand = static_cast<const AddChildCommand*>(command);
                                 Object* object = objects[addChildCommand->objectId - 1].get();
-                                Object* child = objects[addChildCommand->objectId - 1].get();
+                                Object* child = objects[addChildCommand->childId - 1].get();
                                 object->addChild(*child);
                                 break;
                             }
                             case Command::Type::RemoveChild:
                             {
-                                auto removeChildCommand = static_cast<const RemoveChildCommand*>(command.get());
+                                auto removeChildCommand = static_cast<const RemoveChildCommand*>(command);
                                 Object* object = objects[removeChildCommand->objectId - 1].get();
-                                Object* child = objects[removeChildCommand->objectId - 1].get();
+                                Object* child = objects[removeChildCommand->childId - 1].get();
                                 object->removeChild(*child);
                                 break;
                             }
                             case Command::Type::Play:
                             {
-                                auto playCommand = static_cast<const PlayCommand*>(command.get());
+                                auto playCommand = static_cast<const PlayCommand*>(command);
                                 Object* object = objects[playCommand->objectId - 1].get();
                                 object->play();
                                 break;
                             }
                             case Command::Type::Stop:
                             {
-                                auto stopCommand = static_cast<const StopCommand*>(command.get());
+                                auto stopCommand = static_cast<const StopCommand*>(command);
                                 Object* object = objects[stopCommand->objectId - 1].get();
                                 object->stop(stopCommand->reset);
                                 break;
                             }
                             case Command::Type::InitBus:
                             {
-                                auto initBusCommand = static_cast<const InitBusCommand*>(command.get());
-
-                                if (initBusCommand->busId > objects.size())
-                                    objects.resize(initBusCommand->busId);
-
-                                objects[initBusCommand->busId - 1] = std::make_unique<Bus>();
+                                auto initBusCommand = static_cast<InitBusCommand*>(command);
+                                objects[initBusCommand->busId - 1] = std::move(initBusCommand->bus);
                                 break;
                             }
                             case Command::Type::SetBusOutput:
                             {
-                                auto setBusOutputCommand = static_cast<const SetBusOutputCommand*>(command.get());
+                                auto setBusOutputCommand = static_cast<const SetBusOutputCommand*>(command);
 
                                 Bus* bus = static_cast<Bus*>(objects[setBusOutputCommand->busId - 1].get());
                                 bus->setOutput(setBusOutputCommand->outputBusId ? static_cast<Bus*>(objects[setBusOutputCommand->outputBusId - 1].get()) : nullptr);
+                                scheduleDirty = true;
                                 break;
                             }
                             case Command::Type::AddProcessor:
                             {
-                                auto addProcessorCommand = static_cast<const AddProcessorCommand*>(command.get());
+                                auto addProcessorCommand = static_cast<const AddProcessorCommand*>(command);
 
                                 Bus* bus = static_cast<Bus*>(objects[addProcessorCommand->busId - 1].get());
                                 Processor* processor = static_cast<Processor*>(objects[addProcessorCommand->processorId - 1].get());
@@ -126,7 +185,7 @@ namespace ouzel
                             }
                             case Command::Type::RemoveProcessor:
                             {
-                                auto removeProcessorCommand = static_cast<const RemoveProcessorCommand*>(command.get());
+                                auto removeProcessorCommand = static_cast<const RemoveProcessorCommand*>(command);
 
                                 Bus* bus = static_cast<Bus*>(objects[removeProcessorCommand->busId - 1].get());
                                 Processor* processor = static_cast<Processor*>(objects[removeProcessorCommand->processorId - 1].get());
@@ -135,25 +194,39 @@ namespace ouzel
                             }
                             case Command::Type::SetMasterBus:
                             {
-                                auto setMasterBusCommand = static_cast<const SetMasterBusCommand*>(command.get());
+                                auto setMasterBusCommand = static_cast<const SetMasterBusCommand*>(command);
 
                                 masterBus = setMasterBusCommand->busId ? static_cast<Bus*>(objects[setMasterBusCommand->busId - 1].get()) : nullptr;
+                                scheduleDirty = true;
                                 break;
                             }
-                            case Command::Type::InitStream:
+                            case Command::Type::SetBusListener:
                             {
-                                auto initStreamCommand = static_cast<const InitStreamCommand*>(command.get());
+                                auto setBusListenerCommand = static_cast<const SetBusListenerCommand*>(command);
 
-                                if (initStreamCommand->streamId > objects.size())
-                                    objects.resize(initStreamCommand->streamId);
+                                Bus* bus = static_cast<Bus*>(objects[setBusListenerCommand->busId - 1].get());
+                                bus->setListener(setBusListenerCommand->position, setBusListenerCommand->rotation);
+                                break;
+                            }
+                            case Command::Type::RemoveBusListener:
+                            {
+                                auto removeBusListenerCommand = static_cast<const RemoveBusListenerCommand*>(command);
 
-                                Data* data = static_cast<Data*>(objects[initStreamCommand->dataId - 1].get());
-                                objects[initStreamCommand->streamId - 1] = data->createStream();
+                                Bus* bus = static_cast<Bus*>(objects[removeBusListenerCommand->busId - 1].get());
+                                bus->removeListener();
+                                break;
+                            }
+                            case Command::Type::InitStream:
+                            {
+                                auto initStreamCommand = static_cast<InitStreamCommand*>(command);
+                                initStreamCommand->stream->setId(initStreamCommand->streamId);
+                                voiceManager.addStream(initStreamCommand->stream.get());
+                                objects[initStreamCommand->streamId - 1] = std::move(initStreamCommand->stream);
                                 break;
                             }
                             case Command::Type::PlayStream:
                             {
-                                auto playStreamCommand = static_cast<const PlayStreamCommand*>(command.get());
+                                auto playStreamCommand = static_cast<const PlayStreamCommand*>(command);
 
                                 Stream* stream = static_cast<Stream*>(objects[playStreamCommand->streamId - 1].get());
                                 stream->play();
@@ -161,7 +234,7 @@ namespace ouzel
                             }
                             case Command::Type::StopStream:
                             {
-                                auto stopStreamCommand = static_cast<const StopStreamCommand*>(command.get());
+                                auto stopStreamCommand = static_cast<const StopStreamCommand*>(command);
 
                                 Stream* stream = static_cast<Stream*>(objects[stopStreamCommand->streamId - 1].get());
                                 stream->stop(stopStreamCommand->reset);
@@ -169,88 +242,203 @@ namespace ouzel
                             }
                             case Command::Type::SetStreamOutput:
                             {
-                                auto setStreamOutputCommand = static_cast<const SetStreamOutputCommand*>(command.get());
+                                auto setStreamOutputCommand = static_cast<const SetStreamOutputCommand*>(command);
 
                                 Stream* stream = static_cast<Stream*>(objects[setStreamOutputCommand->streamId - 1].get());
                                 stream->setOutput(setStreamOutputCommand->busId ? static_cast<Bus*>(objects[setStreamOutputCommand->busId - 1].get()) : nullptr);
                                 break;
                             }
-                            case Command::Type::InitData:
+                            case Command::Type::SetStreamGain:
                             {
-                                auto initDataCommand = static_cast<InitDataCommand*>(command.get());
+                                auto setStreamGainCommand = static_cast<const SetStreamGainCommand*>(command);
 
-                                if (initDataCommand->dataId > objects.size())
-                                    objects.resize(initDataCommand->dataId);
+                                Stream* stream = static_cast<Stream*>(objects[setStreamGainCommand->streamId - 1].get());
+                                stream->setGain(setStreamGainCommand->gain);
+                                break;
+                            }
+                            case Command::Type::SetStreamPosition:
+                            {
+                                auto setStreamPositionCommand = static_cast<const SetStreamPositionCommand*>(command);
 
+                                Stream* stream = static_cast<Stream*>(objects[setStreamPositionCommand->streamId - 1].get());
+                                stream->setPosition(setStreamPositionCommand->position);
+                                break;
+                            }
+                            case Command::Type::InitData:
+                            {
+                                auto initDataCommand = static_cast<InitDataCommand*>(command);
                                 objects[initDataCommand->dataId - 1] = std::move(initDataCommand->data);
                                 break;
                             }
                             case Command::Type::InitProcessor:
                             {
-                                auto initProcessorCommand = static_cast<InitProcessorCommand*>(command.get());
-
-                                if (initProcessorCommand->processorId > objects.size())
-                                    objects.resize(initProcessorCommand->processorId);
-
+                                auto initProcessorCommand = static_cast<InitProcessorCommand*>(command);
                                 objects[initProcessorCommand->processorId - 1] = std::move(initProcessorCommand->processor);
                                 break;
                             }
                             case Command::Type::UpdateProcessor:
                             {
-                                auto updateProcessorCommand = static_cast<const UpdateProcessorCommand*>(command.get());
+                                auto updateProcessorCommand = static_cast<const UpdateProcessorCommand*>(command);
 
                                 Processor* processor = static_cast<Processor*>(objects[updateProcessorCommand->processorId - 1].get());
                                 updateProcessorCommand->updateFunction(processor);
                                 break;
                             }
+                            case Command::Type::ResizeObjects:
+                            {
+                                auto resizeObjectsCommand = static_cast<ResizeObjectsCommand*>(command);
+                                std::move(objects.begin(), objects.end(), resizeObjectsCommand->objects.begin());
+                                objects.swap(resizeObjectsCommand->objects);
+                                voiceManager.swapStreams(resizeObjectsCommand->streams);
+                                schedule.swap(resizeObjectsCommand->buses);
+                                scheduleDirty = true;
+                                break;
+                            }
                             default:
                                 throw std::runtime_error("Invalid command");
                         }
                     }
+
+                    // the producer keeps the number of buffers in flight below the queue size, so this can't fail
+                    processedQueue.push(std::move(commandBuffer));
                 }
             }
 
-            void Mixer::getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate, std::vector<float>& samples)
+            void Mixer::getSamples(uint32_t frames, std::vector<float>& samples)
             {
-                process();
+                if (!lookahead)
+                {
+                    process();
+                    render(frames, samples);
+                    return;
+                }
+
+                samples.resize(frames * channels);
+
+                const size_t count = buffer.read(samples.data(), frames, frames);
+                bufferCondition.notify_one();
+
+                if (count < frames)
+                {
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                        std::fill(samples.begin() + channel * frames + count,
+                                  samples.begin() + (channel + 1) * frames, 0.0F);
+
+                    Event event(Event::Type::Starvation);
+                    event.objectId = 0;
+                    callback(event);
+                }
+            }
+
+            std::vector<uint32_t> Mixer::getRenderHistogram() const
+            {
+                std::vector<uint32_t> result(RENDER_HISTOGRAM_SIZE);
+                for (size_t i = 0; i < RENDER_HISTOGRAM_SIZE; ++i)
+                    result[i] = renderHistogram[i].load(std::memory_order_relaxed);
+                return result;
+            }
+
+            void Mixer::render(uint32_t frames, std::vector<float>& samples)
+            {
+                const auto startTime = std::chrono::steady_clock::now();
 
                 samples.resize(frames * channels);
 
                 if (masterBus)
                 {
+                    // voices are prioritized by their distance to the listener of the master bus
                     Vector3F listenerPosition;
-                    QuaternionF listenerRotation;
+                    if (masterBus && masterBus->hasListener())
+                        listenerPosition = masterBus->getListenerPosition();
+
+                    voiceManager.update(listenerPosition);
+
+                    if (scheduleDirty) updateSchedule();
+
+                    // every level only depends on the ones before it
+                    renderFrames = frames;
+                    for (levelStart = 0; levelStart < schedule.size();)
+                    {
+                        size_t levelEnd = levelStart + 1;
+                        while (levelEnd < schedule.size() && schedule[levelEnd]->getLevel() == schedule[levelStart]->getLevel())
+                            ++levelEnd;
+
+                        mixPool.run(levelEnd - levelStart, renderJob);
+                        levelStart = levelEnd;
+                    }
 
-                    masterBus->getSamples(frames, channels, sampleRate, listenerPosition, listenerRotation, samples);
+                    std::copy(masterBus->getMixedSamples().begin(), masterBus->getMixedSamples().end(), samples.begin());
+
+                    // the streams finish while the buses are rendered in parallel, so they are reported afterwards
+                    for (Stream* stream : voiceManager.getStreams())
+                        if (stream->isFinished())
+                        {
+                            Event event(Event::Type::StreamStopped);
+                            event.objectId = stream->getId();
+                            if (!eventQueue.push(std::move(event))) break;
+                            stream->clearFinished();
+                        }
                 }
+                else
+                    std::fill(samples.begin(), samples.end(), 0.0F);
 
-                for (float& sample : samples)
-                    sample = clamp(sample, -1.0F, 1.0F);
+                dsp::clip(samples.data(), samples.size());
+
+                const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+                size_t bucket = 0;
+                for (auto microseconds = static_cast<uint64_t>(duration.count()); microseconds > 1 && bucket < RENDER_HISTOGRAM_SIZE - 1; microseconds >>= 1)
+                    ++bucket;
+                renderHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void Mixer::updateSchedule()
+            {
+                schedule.clear();
+                if (masterBus) scheduleBus(masterBus);
+
+                // the master bus has the highest level, so it is rendered last
+                std::sort(schedule.begin(), schedule.end(), [](const Bus* a, const Bus* b) {
+                    return a->getLevel() < b->getLevel();
+                });
+
+                scheduleDirty = false;
+            }
+
+            uint32_t Mixer::scheduleBus(Bus* bus)
+            {
+                // every bus has one output, so the buses that feed the master bus form a tree
+                uint32_t level = 0;
+                for (Bus* inputBus : bus->getInputBuses())
+                    level = std::max(level, scheduleBus(inputBus) + 1);
+
+                bus->setLevel(level);
+                schedule.push_back(bus);
+                return level;
             }
 
             void Mixer::mixerMain()
             {
                 Thread::setCurrentThreadName("Mixer");
 
+                // the device notifies without holding the mutex, so a wakeup can be missed,
+                // waiting for at most one buffer duration bounds the delay that causes
+                const std::chrono::microseconds bufferDuration(bufferSize * 1000000ULL / sampleRate);
+                std::vector<float> samples;
+
                 for (;;)
                 {
-                    break; // TODO: remove
-
-                    process();
-
                     std::unique_lock<std::mutex> lock(bufferMutex);
-                    bufferCondition.wait(lock);
+                    bufferCondition.wait_for(lock, bufferDuration, [this]() {
+                        return !running || buffer.getFreeFrames() >= bufferSize;
+                    });
 
-                    if (masterBus)
-                    {
-                        //Vector3F listenerPosition;
-                        //QuaternionF listenerRotation;
-
-                        //masterBus->getData(frames, channels, sampleRate, listenerPosition, listenerRotation, samples);
-                    }
+                    if (!running) break;
+                    if (buffer.getFreeFrames() < bufferSize) continue;
+                    lock.unlock();
 
-                    //for (float& f : samples)
-                    //    f = clamp(f, -1.0F, 1.0F);
+                    process();
+                    render(bufferSize, samples);
+                    buffer.write(samples.data(), bufferSize, bufferSize);
                 }
             }
         }
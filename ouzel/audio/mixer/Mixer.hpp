@@ -3,17 +3,23 @@
 #ifndef OUZEL_AUDIO_MIXER_MIXER_HPP
 #define OUZEL_AUDIO_MIXER_MIXER_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <set>
 #include <thread>
 #include <vector>
 #include "audio/mixer/Commands.hpp"
+#include "audio/mixer/MixPool.hpp"
 #include "audio/mixer/Object.hpp"
 #include "audio/mixer/Processor.hpp"
+#include "audio/mixer/RingBuffer.hpp"
+#include "audio/mixer/VoiceManager.hpp"
+#include "utils/SpscQueue.hpp"
 #include "utils/Thread.hpp"
 
 namespace ouzel
@@ -65,8 +71,16 @@ namespace ouzel
                     uintptr_t objectId;
                 };
 
+                // lookahead is the number of buffers rendered ahead on the mixer thread,
+                // zero renders synchronously in getSamples,
+                // maxVoices is the number of streams that are mixed, zero for no limit,
+                // mixThreads is the number of threads that help the mixer thread to render independent buses
                 Mixer(uint32_t initBufferSize,
                       uint32_t initChannels,
+                      uint32_t initSampleRate,
+                      uint32_t initLookahead,
+                      uint32_t initMaxVoices,
+                      uint32_t initMixThreads,
                       const std::function<void(const Event&)>& initCallback);
 
                 ~Mixer();
@@ -78,7 +92,8 @@ namespace ouzel
                 Mixer& operator=(Mixer&&) = delete;
 
                 void process();
-                void getSamples(uint32_t frames, uint32_t channels, uint32_t sampleRate, std::vector<float>& samples);
+                // called from the audio device, samples are not interleaved
+                void getSamples(uint32_t frames, std::vector<float>& samples);
 
                 uintptr_t getObjectId()
                 {
@@ -99,63 +114,79 @@ namespace ouzel
                     deletedObjectIds.insert(objectId);
                 }
 
-                void submitCommandBuffer(CommandBuffer&& commandBuffer)
-                {
-                    std::unique_lock<std::mutex> lock(commandQueueMutex);
-                    commandQueue.push(std::move(commandBuffer));
-                    lock.unlock();
-                }
+                // must be called from the thread that owns the command buffers,
+                // returns false and leaves the buffer untouched if the mixer has fallen behind
+                bool submitCommandBuffer(CommandBuffer&& commandBuffer);
 
                 inline auto getRootObjectId() const noexcept
                 {
                     return rootObjectId;
                 }
 
+                // number of buffers rendered in [2^i, 2^(i+1)) microseconds for every bucket i,
+                // the first bucket also counts the faster ones and the last one the slower ones
+                static constexpr size_t RENDER_HISTOGRAM_SIZE = 16;
+                std::vector<uint32_t> getRenderHistogram() const;
+
+                inline auto& getVoiceManager() const noexcept { return voiceManager; }
+
+                // must be called from the thread that submits the command buffers, returns false if there are no events,
+                // only StreamStopped events are delivered here, the rest go to the callback
+                bool getEvent(Event& event)
+                {
+                    return eventQueue.pop(event);
+                }
+
             private:
+                static constexpr size_t COMMAND_QUEUE_SIZE = 64;
+                static constexpr size_t EVENT_QUEUE_SIZE = 256;
+                static constexpr uintptr_t INITIAL_OBJECT_CAPACITY = 256;
+
+                void render(uint32_t frames, std::vector<float>& samples);
+                void updateSchedule();
+                uint32_t scheduleBus(Bus* bus);
                 void mixerMain();
 
                 uint32_t bufferSize;
                 uint32_t channels;
+                uint32_t sampleRate;
+                uint32_t lookahead;
                 std::function<void(const Event&)> callback;
 
                 uintptr_t lastObjectId = 0;
                 std::set<uintptr_t> deletedObjectIds;
 
+                // grown only through ResizeObjectsCommand, so that the mixer never allocates it
                 std::vector<std::unique_ptr<Object>> objects;
+                uintptr_t objectCapacity = INITIAL_OBJECT_CAPACITY;
                 uintptr_t rootObjectId = 0;
                 RootObject* rootObject = nullptr;
 
                 Bus* masterBus = nullptr;
+                VoiceManager voiceManager;
 
-                class Buffer final
-                {
-                public:
-                    Buffer(size_t size, uint32_t initChannels):
-                        maxFrames(size),
-                        channels(initChannels),
-                        buffer(size * channels)
-                    {
-                    }
-
-                    bool canRead() const { return frames > 0; }
-                    bool canWrite() const { return frames < maxFrames; }
-
-                private:
-                    size_t frames = 0;
-                    size_t maxFrames;
-                    uint32_t channels;
-                    size_t readPosition = 0;
-                    size_t writePosition = 0;
-                    std::vector<float> buffer;
-                };
+                // buses that feed the master bus ordered by level, buses on the same level are rendered in parallel
+                std::vector<Bus*> schedule;
+                bool scheduleDirty = false;
+                MixPool mixPool;
+                std::function<void(size_t)> renderJob; // created once, so that rendering doesn't allocate
+                size_t levelStart = 0;
+                uint32_t renderFrames = 0;
 
                 Thread mixerThread;
+                bool running = true;
                 std::mutex bufferMutex;
                 std::condition_variable bufferCondition;
-                Buffer buffer;
+                RingBuffer buffer; // rendered frames read by the audio device
+
+                std::array<std::atomic<uint32_t>, RENDER_HISTOGRAM_SIZE> renderHistogram{};
 
-                std::queue<CommandBuffer> commandQueue;
-                std::mutex commandQueueMutex;
+                // processed buffers go back through the second queue to be destroyed on the submitting thread
+                SpscQueue<CommandBuffer> commandQueue{COMMAND_QUEUE_SIZE};
+                SpscQueue<CommandBuffer> processedQueue{COMMAND_QUEUE_SIZE};
+                // the streams that finished, a stream stays finished until its event fits in the queue
+                SpscQueue<Event> eventQueue{EVENT_QUEUE_SIZE};
+                size_t pendingCommandBuffers = 0;
             };
         }
     } // namespace audio
@@ -60,12 +60,24 @@ namespace ouzel
                         auto i = std::find(children.begin(), children.end(), &child);
                         if (i != children.end())
                         {
-                            child.parent = this;
+                            child.parent = nullptr;
                             children.erase(i);
                         }
                     }
                 }
 
+                // unlinks the object from the mix graph, so that it can be destroyed outside of the mixer
+                virtual void detach()
+                {
+                    if (parent)
+                        parent->removeChild(*this);
+
+                    for (Object* child : children)
+                        child->parent = nullptr;
+
+                    children.clear();
+                }
+
                 void play()
                 {
                     if (source)
@@ -28,12 +28,21 @@ namespace ouzel
                 Processor(Processor&&) = delete;
                 Processor& operator=(Processor&&) = delete;
 
+                void detach() override
+                {
+                    if (bus) bus->removeProcessor(this);
+                    Object::detach();
+                }
+
                 virtual void process(uint32_t frames, uint32_t channels, uint32_t sampleRate,
                                      std::vector<float>& samples) = 0;
 
                 inline auto isEnabled() const noexcept { return enabled; }
                 inline void setEnabled(bool newEnabled) { enabled = newEnabled; }
 
+            protected:
+                inline auto getBus() const noexcept { return bus; }
+
             private:
                 Bus* bus = nullptr;
                 bool enabled = true;
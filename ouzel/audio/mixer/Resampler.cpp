@@ -0,0 +1,283 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+#include "Resampler.hpp"
+#include "math/Constants.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            constexpr uint32_t Resampler::TAPS;
+            constexpr uint32_t Resampler::LINEAR_TAPS;
+            constexpr uint32_t Resampler::MAX_PHASES;
+
+            namespace
+            {
+                constexpr double ROLLOFF = 0.9; // of the lower Nyquist frequency
+
+                uint32_t gcd(uint32_t a, uint32_t b) noexcept
+                {
+                    while (b)
+                    {
+                        const uint32_t t = a % b;
+                        a = b;
+                        b = t;
+                    }
+
+                    return a;
+                }
+
+                // Coefficients for an output frame that lies phase / phases source frames after the last but TAPS / 2 tap,
+                // every phase is normalized to unity gain
+                std::vector<float> createFilterBank(uint32_t phases, double cutoff)
+                {
+                    std::vector<float> filterBank(phases * Resampler::TAPS);
+                    constexpr double halfWidth = Resampler::TAPS / 2.0;
+
+                    for (uint32_t phase = 0; phase < phases; ++phase)
+                    {
+                        float* coefficients = &filterBank[phase * Resampler::TAPS];
+                        double sum = 0.0;
+
+                        for (uint32_t tap = 0; tap < Resampler::TAPS; ++tap)
+                        {
+                            const double x = halfWidth - tap + static_cast<double>(phase) / phases;
+                            const double sinc = (x == 0.0) ? 1.0 : std::sin(pi<double> * cutoff * x) / (pi<double> * cutoff * x);
+                            const double u = x / halfWidth;
+                            const double window = (std::fabs(u) < 1.0) ?
+                                0.42 + 0.5 * std::cos(pi<double> * u) + 0.08 * std::cos(2.0 * pi<double> * u) : // Blackman
+                                0.0;
+
+                            const double coefficient = cutoff * sinc * window;
+                            coefficients[tap] = static_cast<float>(coefficient);
+                            sum += coefficient;
+                        }
+
+                        for (uint32_t tap = 0; tap < Resampler::TAPS; ++tap)
+                            coefficients[tap] = static_cast<float>(static_cast<double>(coefficients[tap]) / sum);
+                    }
+
+                    return filterBank;
+                }
+
+                std::shared_ptr<const std::vector<float>> getFilterBank(uint32_t phases, uint32_t interpolation, uint32_t decimation)
+                {
+                    static std::mutex cacheMutex;
+                    static std::map<std::pair<uint32_t, uint32_t>, std::weak_ptr<const std::vector<float>>> cache;
+
+                    std::lock_guard<std::mutex> lock(cacheMutex);
+
+                    std::weak_ptr<const std::vector<float>>& entry = cache[std::make_pair(interpolation, decimation)];
+                    if (auto filterBank = entry.lock()) return filterBank;
+
+                    const double cutoff = ROLLOFF * std::min(1.0, static_cast<double>(interpolation) / decimation);
+                    auto filterBank = std::make_shared<const std::vector<float>>(createFilterBank(phases, cutoff));
+                    entry = filterBank;
+                    return filterBank;
+                }
+
+                // dot products of TAPS samples and coefficients for four output frames
+                inline void filter4(const float* window, const uint32_t* indices, const uint32_t* filters,
+                                    const float* coefficients, float* output) noexcept
+                {
+#if defined(__ARM_NEON__)
+                    if (isSimdAvailable)
+                    {
+                        float32x4_t sums[4];
+                        for (uint32_t i = 0; i < 4; ++i)
+                        {
+                            const float* samples = window + indices[i];
+                            const float* filter = coefficients + filters[i];
+                            float32x4_t sum = vmulq_f32(vld1q_f32(samples), vld1q_f32(filter));
+                            for (uint32_t tap = 4; tap < Resampler::TAPS; tap += 4)
+                                sum = vmlaq_f32(sum, vld1q_f32(samples + tap), vld1q_f32(filter + tap));
+                            sums[i] = sum;
+                        }
+
+                        const float32x4_t sum01 = vcombine_f32(vpadd_f32(vget_low_f32(sums[0]), vget_high_f32(sums[0])),
+                                                               vpadd_f32(vget_low_f32(sums[1]), vget_high_f32(sums[1])));
+                        const float32x4_t sum23 = vcombine_f32(vpadd_f32(vget_low_f32(sums[2]), vget_high_f32(sums[2])),
+                                                               vpadd_f32(vget_low_f32(sums[3]), vget_high_f32(sums[3])));
+                        vst1q_f32(output, vcombine_f32(vpadd_f32(vget_low_f32(sum01), vget_high_f32(sum01)),
+                                                       vpadd_f32(vget_low_f32(sum23), vget_high_f32(sum23))));
+                        return;
+                    }
+#elif defined(__SSE2__)
+                    if (isSimdAvailable)
+                    {
+                        __m128 sums[4];
+                        for (uint32_t i = 0; i < 4; ++i)
+                        {
+                            const float* samples = window + indices[i];
+                            const float* filter = coefficients + filters[i];
+                            __m128 sum = _mm_mul_ps(_mm_loadu_ps(samples), _mm_loadu_ps(filter));
+                            for (uint32_t tap = 4; tap < Resampler::TAPS; tap += 4)
+                                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples + tap), _mm_loadu_ps(filter + tap)));
+                            sums[i] = sum;
+                        }
+
+                        // transpose the partial sums, so that the four totals come out of three vertical additions
+                        _MM_TRANSPOSE4_PS(sums[0], sums[1], sums[2], sums[3]);
+                        _mm_storeu_ps(output, _mm_add_ps(_mm_add_ps(sums[0], sums[1]), _mm_add_ps(sums[2], sums[3])));
+                        return;
+                    }
+#endif
+
+                    for (uint32_t i = 0; i < 4; ++i)
+                    {
+                        const float* samples = window + indices[i];
+                        const float* filter = coefficients + filters[i];
+                        float sum = 0.0F;
+                        for (uint32_t tap = 0; tap < Resampler::TAPS; ++tap)
+                            sum += samples[tap] * filter[tap];
+                        output[i] = sum;
+                    }
+                }
+            }
+
+            Resampler::Resampler(uint32_t initSourceSampleRate, uint32_t initSampleRate, uint32_t initChannels,
+                                 Quality initQuality):
+                sourceSampleRate(initSourceSampleRate),
+                sampleRate(initSampleRate),
+                channels(initChannels),
+                quality(initQuality),
+                taps(initQuality == Quality::Polyphase ? TAPS : LINEAR_TAPS),
+                interpolation(initSampleRate / gcd(initSourceSampleRate, initSampleRate)),
+                decimation(initSourceSampleRate / gcd(initSourceSampleRate, initSampleRate)),
+                phases(std::min(interpolation, MAX_PHASES)),
+                history(initChannels * taps)
+            {
+                if (quality == Quality::Polyphase)
+                    filterBank = getFilterBank(phases, interpolation, decimation);
+            }
+
+            void Resampler::process(const std::vector<float>& sourceSamples, uint32_t sourceFrames,
+                                    uint32_t frames, std::vector<float>& samples)
+            {
+                if (quality == Quality::Linear)
+                    return processLinear(sourceSamples, sourceFrames, frames, samples);
+
+                samples.resize(frames * channels);
+                window.resize(TAPS + sourceFrames);
+
+                // the window offsets and the filters of the output frames are the same for all channels,
+                // the tables are padded to a multiple of four with the last frame
+                const uint32_t paddedFrames = (frames + 3) & ~3U;
+                indices.resize(paddedFrames);
+                filters.resize(paddedFrames);
+                output.resize(paddedFrames);
+
+                const uint32_t step = decimation / interpolation;
+                const uint32_t phaseStep = decimation % interpolation;
+                auto index = static_cast<uint32_t>(position / interpolation);
+                auto phase = static_cast<uint32_t>(position % interpolation);
+
+                for (uint32_t frame = 0; frame < paddedFrames; ++frame)
+                {
+                    const uint32_t filter = (phases == interpolation) ? phase :
+                        static_cast<uint32_t>(static_cast<uint64_t>(phase) * phases / interpolation);
+                    indices[frame] = index;
+                    filters[frame] = filter * TAPS;
+
+                    if (frame + 1 < frames)
+                    {
+                        index += step;
+                        phase += phaseStep;
+                        if (phase >= interpolation)
+                        {
+                            phase -= interpolation;
+                            ++index;
+                        }
+                    }
+                }
+
+                const float* coefficients = filterBank->data();
+
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    // the window starts with the last TAPS frames of the previous block
+                    float* channelHistory = &history[channel * TAPS];
+                    const float* sourceChannel = sourceSamples.data() + channel * sourceFrames;
+                    std::copy(channelHistory, channelHistory + TAPS, window.begin());
+                    std::copy(sourceChannel, sourceChannel + sourceFrames, window.begin() + TAPS);
+
+                    for (uint32_t frame = 0; frame < paddedFrames; frame += 4)
+                        filter4(window.data(), &indices[frame], &filters[frame], coefficients, &output[frame]);
+
+                    std::copy(output.begin(), output.begin() + frames, samples.begin() + channel * frames);
+                    std::copy(window.begin() + sourceFrames, window.begin() + sourceFrames + TAPS, channelHistory);
+                }
+
+                position += static_cast<uint64_t>(frames) * decimation - static_cast<uint64_t>(sourceFrames) * interpolation;
+            }
+
+            void Resampler::processLinear(const std::vector<float>& sourceSamples, uint32_t sourceFrames,
+                                          uint32_t frames, std::vector<float>& samples)
+            {
+                samples.resize(frames * channels);
+
+                // the windows of all the channels one after another, each starts with the last frames of the previous block
+                const uint32_t windowSize = LINEAR_TAPS + sourceFrames;
+                window.resize(windowSize * channels);
+
+                for (uint32_t channel = 0; channel < channels; ++channel)
+                {
+                    float* channelHistory = &history[channel * LINEAR_TAPS];
+                    const float* sourceChannel = sourceSamples.data() + channel * sourceFrames;
+                    float* channelWindow = &window[channel * windowSize];
+                    std::copy(channelHistory, channelHistory + LINEAR_TAPS, channelWindow);
+                    std::copy(sourceChannel, sourceChannel + sourceFrames, channelWindow + LINEAR_TAPS);
+                    std::copy(channelWindow + sourceFrames, channelWindow + windowSize, channelHistory);
+                }
+
+                // every output frame is interpolated between the window frame at its index and the next one,
+                // the position is stepped in double precision, so it doesn't drift within a block
+                const double positionStep = static_cast<double>(decimation) / interpolation;
+                double windowPosition = static_cast<double>(position) / interpolation;
+                const float* windowData = window.data();
+                float* outputData = samples.data();
+
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                {
+                    const auto index = static_cast<uint32_t>(windowPosition);
+                    const auto fraction = static_cast<float>(windowPosition - index);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float* frameSamples = windowData + channel * windowSize + index;
+                        outputData[channel * frames + frame] = frameSamples[0] + (frameSamples[1] - frameSamples[0]) * fraction;
+                    }
+
+                    windowPosition += positionStep;
+                }
+
+                position += static_cast<uint64_t>(frames) * decimation - static_cast<uint64_t>(sourceFrames) * interpolation;
+            }
+
+            void Resampler::skip(uint32_t sourceFrames, uint32_t frames)
+            {
+                position += static_cast<uint64_t>(frames) * decimation - static_cast<uint64_t>(sourceFrames) * interpolation;
+                std::fill(history.begin(), history.end(), 0.0F);
+            }
+
+            void Resampler::reset()
+            {
+                position = 0;
+                std::fill(history.begin(), history.end(), 0.0F);
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
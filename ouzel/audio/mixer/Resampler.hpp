@@ -0,0 +1,79 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_RESAMPLER_HPP
+#define OUZEL_AUDIO_MIXER_RESAMPLER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            // Resampler that keeps its position and filter history between blocks, the polyphase windowed sinc filter
+            // is band-limited, the linear interpolation costs several times less, but aliases,
+            // the filter banks are shared between all the resamplers with the same rate ratio
+            class Resampler final
+            {
+            public:
+                enum class Quality
+                {
+                    Linear,
+                    Polyphase
+                };
+
+                static constexpr uint32_t TAPS = 16;
+                static constexpr uint32_t LINEAR_TAPS = 2;
+                static constexpr uint32_t MAX_PHASES = 1024;
+
+                // allocates, so it should not be created on the audio thread
+                Resampler(uint32_t initSourceSampleRate, uint32_t initSampleRate, uint32_t initChannels,
+                          Quality initQuality = Quality::Polyphase);
+
+                inline auto getSourceSampleRate() const noexcept { return sourceSampleRate; }
+                inline auto getSampleRate() const noexcept { return sampleRate; }
+                inline auto getQuality() const noexcept { return quality; }
+
+                // returns the number of source frames that process consumes to produce the given number of frames
+                inline uint32_t getSourceFrames(uint32_t frames) const noexcept
+                {
+                    return static_cast<uint32_t>((position + static_cast<uint64_t>(frames) * decimation) / interpolation);
+                }
+
+                // the source samples must contain getSourceFrames(frames) frames of every channel
+                void process(const std::vector<float>& sourceSamples, uint32_t sourceFrames,
+                             uint32_t frames, std::vector<float>& samples);
+
+                // advances the position like process, without filtering the skipped source frames
+                void skip(uint32_t sourceFrames, uint32_t frames);
+
+                void reset();
+
+            private:
+                void processLinear(const std::vector<float>& sourceSamples, uint32_t sourceFrames,
+                                   uint32_t frames, std::vector<float>& samples);
+
+                uint32_t sourceSampleRate;
+                uint32_t sampleRate;
+                uint32_t channels;
+                Quality quality;
+                uint32_t taps; // source frames that an output frame is computed from
+                uint32_t interpolation; // output frames per decimation source frames
+                uint32_t decimation;
+                uint32_t phases;
+                uint64_t position = 0; // of the next output frame in 1/interpolation source frames
+                std::shared_ptr<const std::vector<float>> filterBank; // TAPS coefficients for every phase, only for the polyphase filter
+                std::vector<float> history; // last taps source frames of every channel
+                std::vector<float> window;
+                std::vector<uint32_t> indices;
+                std::vector<uint32_t> filters;
+                std::vector<float> output;
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_RESAMPLER_HPP
@@ -0,0 +1,101 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
+#define OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            // Ring of sample frames, written only by one producer thread and read only by one consumer thread,
+            // each channel is stored separately
+            class RingBuffer final
+            {
+            public:
+                RingBuffer(size_t size, uint32_t initChannels):
+                    maxFrames(size),
+                    channels(initChannels),
+                    buffer(size * initChannels)
+                {
+                }
+
+                RingBuffer(const RingBuffer&) = delete;
+                RingBuffer& operator=(const RingBuffer&) = delete;
+
+                RingBuffer(RingBuffer&&) = delete;
+                RingBuffer& operator=(RingBuffer&&) = delete;
+
+                inline auto getCapacity() const noexcept { return maxFrames; }
+
+                bool canRead() const { return frames.load(std::memory_order_acquire) > 0; }
+                bool canWrite() const { return frames.load(std::memory_order_acquire) < maxFrames; }
+                size_t getFreeFrames() const { return maxFrames - frames.load(std::memory_order_acquire); }
+
+                // the caller must make sure that there is room for the frames,
+                // stride is the distance between the channels in samples
+                void write(const float* samples, size_t sampleFrames, size_t stride)
+                {
+                    const size_t first = std::min(sampleFrames, maxFrames - writePosition);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float* source = samples + channel * stride;
+                        float* destination = buffer.data() + channel * maxFrames;
+                        std::copy(source, source + first, destination + writePosition);
+                        std::copy(source + first, source + sampleFrames, destination);
+                    }
+
+                    writePosition = (writePosition + sampleFrames) % maxFrames;
+                    frames.fetch_add(sampleFrames, std::memory_order_release);
+                }
+
+                // returns the number of frames read, which is less than requested if the buffer runs empty
+                size_t read(float* samples, size_t sampleFrames, size_t stride)
+                {
+                    const size_t count = std::min(sampleFrames, frames.load(std::memory_order_acquire));
+                    const size_t first = std::min(count, maxFrames - readPosition);
+
+                    for (uint32_t channel = 0; channel < channels; ++channel)
+                    {
+                        const float* source = buffer.data() + channel * maxFrames;
+                        float* destination = samples + channel * stride;
+                        std::copy(source + readPosition, source + readPosition + first, destination);
+                        std::copy(source, source + count - first, destination + first);
+                    }
+
+                    if (count) readPosition = (readPosition + count) % maxFrames;
+                    frames.fetch_sub(count, std::memory_order_release);
+                    return count;
+                }
+
+                // drops up to the given number of frames, returns the number of frames dropped
+                size_t skip(size_t sampleFrames)
+                {
+                    const size_t count = std::min(sampleFrames, frames.load(std::memory_order_acquire));
+
+                    if (count) readPosition = (readPosition + count) % maxFrames;
+                    frames.fetch_sub(count, std::memory_order_release);
+                    return count;
+                }
+
+            private:
+                std::atomic<size_t> frames{0};
+                size_t maxFrames;
+                uint32_t channels;
+                size_t readPosition = 0;
+                size_t writePosition = 0;
+                std::vector<float> buffer;
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_RINGBUFFER_HPP
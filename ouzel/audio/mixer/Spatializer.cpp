@@ -0,0 +1,337 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include "Spatializer.hpp"
+#include "math/Constants.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            namespace
+            {
+                constexpr uint32_t MAX_RING_CHANNELS = 8;
+                constexpr float EPSILON = 1e-6F;
+
+                struct Speaker final
+                {
+                    uint32_t channel;
+                    float azimuth; // in degrees clockwise from the front
+                };
+
+                // the pair gains are the inverse of the matrix of the speaker directions applied to the emitter direction
+                struct SpeakerPair final
+                {
+                    uint32_t first;
+                    uint32_t second;
+                    float matrix[4];
+                };
+
+                struct Layout final
+                {
+                    uint32_t pairCount = 0;
+                    SpeakerPair pairs[MAX_RING_CHANNELS];
+                    bool speakers[MAX_RING_CHANNELS]{}; // channels that take part in the panning, LFE doesn't
+                    float centerGain = 0.0F; // used when the emitter is above, below or at the listener
+                };
+
+                // the speakers are ordered by azimuth, so that every speaker forms a pair with the next one
+                const Speaker quadSpeakers[] = {{2, -135.0F}, {0, -45.0F}, {1, 45.0F}, {3, 135.0F}};
+                const Speaker surround51Speakers[] = {{4, -110.0F}, {0, -30.0F}, {2, 0.0F}, {1, 30.0F}, {5, 110.0F}};
+                const Speaker surround71Speakers[] = {{6, -150.0F}, {4, -90.0F}, {0, -30.0F}, {2, 0.0F}, {1, 30.0F}, {5, 90.0F}, {7, 150.0F}};
+
+                Layout createLayout(const Speaker* speakers, uint32_t count)
+                {
+                    Layout layout;
+                    layout.pairCount = count;
+                    layout.centerGain = 1.0F / std::sqrt(static_cast<float>(count));
+
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        const Speaker& first = speakers[i];
+                        const Speaker& second = speakers[(i + 1) % count];
+                        const float firstAngle = first.azimuth * pi<float> / 180.0F;
+                        const float secondAngle = second.azimuth * pi<float> / 180.0F;
+
+                        // columns are the directions of the speakers as (right, front)
+                        const float a = std::sin(firstAngle);
+                        const float b = std::sin(secondAngle);
+                        const float c = std::cos(firstAngle);
+                        const float d = std::cos(secondAngle);
+                        const float determinant = a * d - b * c;
+
+                        SpeakerPair& pair = layout.pairs[i];
+                        pair.first = first.channel;
+                        pair.second = second.channel;
+                        pair.matrix[0] = d / determinant;
+                        pair.matrix[1] = -b / determinant;
+                        pair.matrix[2] = -c / determinant;
+                        pair.matrix[3] = a / determinant;
+
+                        layout.speakers[first.channel] = true;
+                    }
+
+                    return layout;
+                }
+
+                const Layout* getLayout(uint32_t channels)
+                {
+                    static const Layout quad = createLayout(quadSpeakers, 4);
+                    static const Layout surround51 = createLayout(surround51Speakers, 5);
+                    static const Layout surround71 = createLayout(surround71Speakers, 7);
+
+                    switch (channels)
+                    {
+                        case 4: return &quad;
+                        case 6: return &surround51;
+                        case 8: return &surround71;
+                        default: return nullptr;
+                    }
+                }
+
+                struct ScalarOperations final
+                {
+                    using Type = float;
+                    using Mask = bool;
+                    static constexpr size_t WIDTH = 1;
+
+                    static inline Type load(const float* p) noexcept { return *p; }
+                    static inline void store(float* p, Type v) noexcept { *p = v; }
+                    static inline Type splat(float f) noexcept { return f; }
+                    static inline Type add(Type a, Type b) noexcept { return a + b; }
+                    static inline Type sub(Type a, Type b) noexcept { return a - b; }
+                    static inline Type mul(Type a, Type b) noexcept { return a * b; }
+                    static inline Type div(Type a, Type b) noexcept { return a / b; }
+                    static inline Type min(Type a, Type b) noexcept { return std::min(a, b); }
+                    static inline Type max(Type a, Type b) noexcept { return std::max(a, b); }
+                    static inline Type squareRoot(Type a) noexcept { return std::sqrt(a); }
+                    static inline Type inverseSquareRoot(Type a) noexcept { return 1.0F / std::sqrt(a); }
+                    static inline Mask greater(Type a, Type b) noexcept { return a > b; }
+                    static inline Mask nonNegative(Type a, Type b) noexcept { return a >= 0.0F && b >= 0.0F; }
+                    static inline Type select(Mask mask, Type a, Type b) noexcept { return mask ? a : b; }
+                };
+
+#if defined(__ARM_NEON__)
+                struct SimdOperations final
+                {
+                    using Type = float32x4_t;
+                    using Mask = uint32x4_t;
+                    static constexpr size_t WIDTH = 4;
+
+                    static inline Type load(const float* p) noexcept { return vld1q_f32(p); }
+                    static inline void store(float* p, Type v) noexcept { vst1q_f32(p, v); }
+                    static inline Type splat(float f) noexcept { return vdupq_n_f32(f); }
+                    static inline Type add(Type a, Type b) noexcept { return vaddq_f32(a, b); }
+                    static inline Type sub(Type a, Type b) noexcept { return vsubq_f32(a, b); }
+                    static inline Type mul(Type a, Type b) noexcept { return vmulq_f32(a, b); }
+                    static inline Type min(Type a, Type b) noexcept { return vminq_f32(a, b); }
+                    static inline Type max(Type a, Type b) noexcept { return vmaxq_f32(a, b); }
+
+                    // NEON has only estimates of the reciprocals, two Newton-Raphson steps refine them to full precision
+                    static inline Type div(Type a, Type b) noexcept
+                    {
+                        Type r = vrecpeq_f32(b);
+                        r = vmulq_f32(vrecpsq_f32(b, r), r);
+                        r = vmulq_f32(vrecpsq_f32(b, r), r);
+                        return vmulq_f32(a, r);
+                    }
+
+                    static inline Type inverseSquareRoot(Type a) noexcept
+                    {
+                        Type r = vrsqrteq_f32(a);
+                        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+                        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+                        return r;
+                    }
+
+                    static inline Type squareRoot(Type a) noexcept
+                    {
+                        return vmulq_f32(a, inverseSquareRoot(vmaxq_f32(a, vdupq_n_f32(EPSILON * EPSILON))));
+                    }
+
+                    static inline Mask greater(Type a, Type b) noexcept { return vcgtq_f32(a, b); }
+                    static inline Mask nonNegative(Type a, Type b) noexcept
+                    {
+                        return vandq_u32(vcgeq_f32(a, vdupq_n_f32(0.0F)), vcgeq_f32(b, vdupq_n_f32(0.0F)));
+                    }
+                    static inline Type select(Mask mask, Type a, Type b) noexcept { return vbslq_f32(mask, a, b); }
+                };
+#elif defined(__SSE2__)
+                struct SimdOperations final
+                {
+                    using Type = __m128;
+                    using Mask = __m128;
+                    static constexpr size_t WIDTH = 4;
+
+                    static inline Type load(const float* p) noexcept { return _mm_loadu_ps(p); }
+                    static inline void store(float* p, Type v) noexcept { _mm_storeu_ps(p, v); }
+                    static inline Type splat(float f) noexcept { return _mm_set1_ps(f); }
+                    static inline Type add(Type a, Type b) noexcept { return _mm_add_ps(a, b); }
+                    static inline Type sub(Type a, Type b) noexcept { return _mm_sub_ps(a, b); }
+                    static inline Type mul(Type a, Type b) noexcept { return _mm_mul_ps(a, b); }
+                    static inline Type div(Type a, Type b) noexcept { return _mm_div_ps(a, b); }
+                    static inline Type min(Type a, Type b) noexcept { return _mm_min_ps(a, b); }
+                    static inline Type max(Type a, Type b) noexcept { return _mm_max_ps(a, b); }
+                    static inline Type squareRoot(Type a) noexcept { return _mm_sqrt_ps(a); }
+                    static inline Type inverseSquareRoot(Type a) noexcept { return _mm_div_ps(_mm_set1_ps(1.0F), _mm_sqrt_ps(a)); }
+                    static inline Mask greater(Type a, Type b) noexcept { return _mm_cmpgt_ps(a, b); }
+                    static inline Mask nonNegative(Type a, Type b) noexcept
+                    {
+                        return _mm_and_ps(_mm_cmpge_ps(a, _mm_setzero_ps()), _mm_cmpge_ps(b, _mm_setzero_ps()));
+                    }
+                    static inline Type select(Mask mask, Type a, Type b) noexcept
+                    {
+                        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+                    }
+                };
+#endif
+
+                struct Emitters final
+                {
+                    const float* positionsX;
+                    const float* positionsY;
+                    const float* positionsZ;
+                    const float* minDistances;
+                    const float* maxDistances;
+                    const float* rolloffFactors;
+                };
+
+                // processes the emitters from begin in steps of the operation width and returns the first one left
+                template <class Operations>
+                size_t spatialize(const Emitters& emitters, size_t begin, size_t count,
+                                  const Vector3F& listenerPosition, const Vector3F& right, const Vector3F& front,
+                                  uint32_t channels, float* gains, size_t stride) noexcept
+                {
+                    using O = Operations;
+                    using T = typename O::Type;
+
+                    const Layout* layout = getLayout(channels);
+                    const T zero = O::splat(0.0F);
+                    const T epsilon = O::splat(EPSILON);
+
+                    size_t i = begin;
+                    for (; i + O::WIDTH <= count; i += O::WIDTH)
+                    {
+                        const T x = O::sub(O::load(emitters.positionsX + i), O::splat(listenerPosition.v[0]));
+                        const T y = O::sub(O::load(emitters.positionsY + i), O::splat(listenerPosition.v[1]));
+                        const T z = O::sub(O::load(emitters.positionsZ + i), O::splat(listenerPosition.v[2]));
+
+                        // inverse distance attenuation clamped to the minimum and maximum distance
+                        const T distance = O::squareRoot(O::add(O::add(O::mul(x, x), O::mul(y, y)), O::mul(z, z)));
+                        const T minDistance = O::max(O::load(emitters.minDistances + i), epsilon);
+                        const T clampedDistance = O::min(O::max(distance, minDistance), O::load(emitters.maxDistances + i));
+                        const T attenuation = O::div(minDistance,
+                                                     O::add(minDistance, O::mul(O::load(emitters.rolloffFactors + i),
+                                                                                O::sub(clampedDistance, minDistance))));
+
+                        // the direction in the space of the listener, projected to the horizontal plane
+                        const T r = O::add(O::add(O::mul(x, O::splat(right.v[0])), O::mul(y, O::splat(right.v[1]))), O::mul(z, O::splat(right.v[2])));
+                        const T f = O::add(O::add(O::mul(x, O::splat(front.v[0])), O::mul(y, O::splat(front.v[1]))), O::mul(z, O::splat(front.v[2])));
+
+                        if (channels == 2)
+                        {
+                            // the gains of the left and right channel are the square roots of the lateral position mapped to [0, 1]
+                            const T lengthSquared = O::add(O::mul(r, r), O::mul(f, f));
+                            const T pan = O::select(O::greater(lengthSquared, epsilon),
+                                                    O::mul(r, O::inverseSquareRoot(O::max(lengthSquared, epsilon))),
+                                                    zero);
+                            const T half = O::splat(0.5F);
+                            O::store(gains + i, O::mul(attenuation, O::squareRoot(O::max(zero, O::sub(half, O::mul(pan, half))))));
+                            O::store(gains + stride + i, O::mul(attenuation, O::squareRoot(O::max(zero, O::add(half, O::mul(pan, half))))));
+                        }
+                        else if (layout)
+                        {
+                            // only the pair of speakers around the emitter has non-negative gains
+                            T speakerGains[MAX_RING_CHANNELS];
+                            for (uint32_t channel = 0; channel < channels; ++channel)
+                                speakerGains[channel] = zero;
+
+                            for (uint32_t p = 0; p < layout->pairCount; ++p)
+                            {
+                                const SpeakerPair& pair = layout->pairs[p];
+                                const T first = O::add(O::mul(r, O::splat(pair.matrix[0])), O::mul(f, O::splat(pair.matrix[1])));
+                                const T second = O::add(O::mul(r, O::splat(pair.matrix[2])), O::mul(f, O::splat(pair.matrix[3])));
+                                const auto inside = O::nonNegative(first, second);
+                                speakerGains[pair.first] = O::max(speakerGains[pair.first], O::select(inside, first, zero));
+                                speakerGains[pair.second] = O::max(speakerGains[pair.second], O::select(inside, second, zero));
+                            }
+
+                            // normalized to constant power
+                            T power = zero;
+                            for (uint32_t channel = 0; channel < channels; ++channel)
+                                power = O::add(power, O::mul(speakerGains[channel], speakerGains[channel]));
+
+                            const auto directional = O::greater(power, epsilon);
+                            const T scale = O::select(directional, O::mul(attenuation, O::inverseSquareRoot(O::max(power, epsilon))), zero);
+                            const T center = O::select(directional, zero, O::mul(attenuation, O::splat(layout->centerGain)));
+
+                            for (uint32_t channel = 0; channel < channels; ++channel)
+                                O::store(gains + channel * stride + i,
+                                         layout->speakers[channel] ? O::add(O::mul(speakerGains[channel], scale), center) : zero);
+                        }
+                        else
+                            for (uint32_t channel = 0; channel < channels; ++channel)
+                                O::store(gains + channel * stride + i, attenuation);
+                    }
+
+                    return i;
+                }
+            }
+
+            void Spatializer::addEmitter(const Vector3F& position, float minDistance, float maxDistance, float rolloffFactor)
+            {
+                if (count == capacity)
+                {
+                    capacity = std::max(static_cast<size_t>(4), capacity * 2);
+                    positionsX.resize(capacity);
+                    positionsY.resize(capacity);
+                    positionsZ.resize(capacity);
+                    minDistances.resize(capacity);
+                    maxDistances.resize(capacity);
+                    rolloffFactors.resize(capacity);
+                    gains.clear();
+                }
+
+                positionsX[count] = position.v[0];
+                positionsY[count] = position.v[1];
+                positionsZ[count] = position.v[2];
+                minDistances[count] = minDistance;
+                maxDistances[count] = maxDistance;
+                rolloffFactors[count] = rolloffFactor;
+                ++count;
+            }
+
+            void Spatializer::update(const Vector3F& listenerPosition, const QuaternionF& listenerRotation, uint32_t channels)
+            {
+                if (gains.size() < channels * capacity)
+                    gains.resize(channels * capacity);
+
+                const Emitters emitters{
+                    positionsX.data(), positionsY.data(), positionsZ.data(),
+                    minDistances.data(), maxDistances.data(), rolloffFactors.data()
+                };
+
+                const Vector3F right = listenerRotation.getRightVector();
+                const Vector3F front = listenerRotation.getForwardVector();
+
+                size_t i = 0;
+
+#if defined(__ARM_NEON__) || defined(__SSE2__)
+                if (isSimdAvailable)
+                    i = spatialize<SimdOperations>(emitters, i, count, listenerPosition, right, front, channels, gains.data(), capacity);
+#endif
+
+                spatialize<ScalarOperations>(emitters, i, count, listenerPosition, right, front, channels, gains.data(), capacity);
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
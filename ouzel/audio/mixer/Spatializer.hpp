@@ -0,0 +1,59 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+#define OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/Quaternion.hpp"
+#include "math/Vector.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            // Computes the distance attenuation and the equal-power panning of a batch of emitters,
+            // the emitters are stored in separate arrays and processed four at a time with SSE2 or NEON when available
+            class Spatializer final
+            {
+            public:
+                Spatializer() = default;
+
+                Spatializer(const Spatializer&) = delete;
+                Spatializer& operator=(const Spatializer&) = delete;
+
+                Spatializer(Spatializer&&) = delete;
+                Spatializer& operator=(Spatializer&&) = delete;
+
+                inline void clear() noexcept { count = 0; }
+                inline auto getEmitterCount() const noexcept { return count; }
+
+                // the arrays grow only when the number of emitters exceeds the highest one so far
+                void addEmitter(const Vector3F& position, float minDistance, float maxDistance, float rolloffFactor);
+
+                // stereo is panned by the lateral position, the 4, 6 and 8 channel layouts of dsp::getChannelMatrix
+                // are panned between the pair of speakers around the emitter, other layouts are only attenuated
+                void update(const Vector3F& listenerPosition, const QuaternionF& listenerRotation, uint32_t channels);
+
+                // the gains of all the emitters for the output channel
+                inline const float* getGains(uint32_t channel) const noexcept { return gains.data() + channel * capacity; }
+
+            private:
+                size_t count = 0;
+                size_t capacity = 0;
+                std::vector<float> positionsX;
+                std::vector<float> positionsY;
+                std::vector<float> positionsZ;
+                std::vector<float> minDistances;
+                std::vector<float> maxDistances;
+                std::vector<float> rolloffFactors;
+                std::vector<float> gains; // capacity gains for every channel
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_SPATIALIZER_HPP
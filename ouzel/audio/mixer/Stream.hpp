@@ -6,6 +6,7 @@
 #include "audio/mixer/Object.hpp"
 #include "audio/mixer/Bus.hpp"
 #include "audio/mixer/Data.hpp"
+#include "audio/mixer/Resampler.hpp"
 
 namespace ouzel
 {
@@ -36,8 +37,19 @@ namespace ouzel
                 Stream(Stream&&) = delete;
                 Stream& operator=(Stream&&) = delete;
 
+                void detach() override
+                {
+                    if (output) output->removeInput(this);
+                    output = nullptr;
+                    Object::detach();
+                }
+
                 auto& getData() const noexcept { return data; }
 
+                // the id of the stream in the mixer, set when the mixer receives the stream
+                inline auto getId() const noexcept { return id; }
+                inline void setId(uintptr_t newId) { id = newId; }
+
                 void setOutput(Bus* newOutput)
                 {
                     if (output) output->removeInput(this);
@@ -48,20 +60,94 @@ namespace ouzel
                 inline auto isPlaying() const noexcept { return playing; }
                 void play() { playing = true; }
 
+                // higher priority streams are kept real when there are more playing streams than voices
+                inline auto getPriority() const noexcept { return priority; }
+                inline void setPriority(int32_t newPriority) { priority = newPriority; }
+
+                // zero for no limit on the real voices of the same data
+                inline auto getMaxInstances() const noexcept { return maxInstances; }
+                inline void setMaxInstances(uint32_t newMaxInstances) { maxInstances = newMaxInstances; }
+
+                inline auto getGain() const noexcept { return gain; }
+                inline void setGain(float newGain) { gain = newGain; }
+
+                // streams become positional once their position is set, the rest are neither attenuated nor panned
+                inline auto& getPosition() const noexcept { return position; }
+                inline void setPosition(const Vector3F& newPosition) { position = newPosition; positional = true; }
+                inline auto isPositional() const noexcept { return positional; }
+
+                // gains of the output channels in the last buffer, the gains of the next one ramp from them
+                inline auto& getChannelGains() noexcept { return channelGains; }
+
+                // gain and distance attenuation, updated by the voice manager before every buffer
+                inline auto getAudibility() const noexcept { return audibility; }
+                inline void setAudibility(float newAudibility) { audibility = newAudibility; }
+
+                // virtual streams are not mixed, they only advance their playhead
+                inline auto isVirtual() const noexcept { return virtualVoice; }
+                inline void setVirtual(bool newVirtual) { virtualVoice = newVirtual; }
+
                 void stop(bool shouldReset)
                 {
                     playing = false;
-                    if (shouldReset) reset();
+                    if (shouldReset)
+                    {
+                        reset();
+                        if (resampler) resampler->reset();
+                    }
                 }
 
+                // set when the stream has reached the end of its data, the mixer reports it after the buffer is rendered
+                inline auto isFinished() const noexcept { return finished; }
+
+                // the resampler still holds the last samples of the buffer in which the stream finished, so it is reset only here
+                void clearFinished()
+                {
+                    finished = false;
+                    if (resampler && !playing) resampler->reset();
+                }
+
+                // creates the resampler on the producer thread if the data sample rate differs from the given one
+                void initResampler(uint32_t sampleRate, Resampler::Quality quality)
+                {
+                    if (data.getSampleRate() != sampleRate)
+                        resampler = std::make_unique<Resampler>(data.getSampleRate(), sampleRate, data.getChannels(), quality);
+                    else
+                        resampler.reset();
+                }
+
+                inline auto getResampler() const noexcept { return resampler.get(); }
+
                 virtual void reset() = 0;
 
                 virtual void getSamples(uint32_t frames, std::vector<float>& samples) = 0;
+                // advances the playhead like getSamples without producing the samples
+                virtual void skip(uint32_t frames) = 0;
 
             protected:
+                // called by the streams from getSamples or skip when they reach the end of the data
+                void finish()
+                {
+                    playing = false;
+                    finished = true;
+                    reset();
+                }
+
                 Data& data;
+                uintptr_t id = 0;
                 Bus* output = nullptr;
                 bool playing = false;
+                bool finished = false;
+                std::unique_ptr<Resampler> resampler;
+
+                int32_t priority = 0;
+                uint32_t maxInstances = 0;
+                float gain = 1.0F;
+                Vector3F position;
+                bool positional = false;
+                std::vector<float> channelGains;
+                float audibility = 1.0F;
+                bool virtualVoice = false;
             };
         }
     } // namespace audio
@@ -0,0 +1,98 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "VoiceManager.hpp"
+#include "Stream.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            constexpr float VoiceManager::MIN_AUDIBILITY;
+
+            VoiceManager::VoiceManager(uint32_t initMaxVoices, size_t capacity):
+                maxVoices(initMaxVoices)
+            {
+                streams.reserve(capacity);
+            }
+
+            void VoiceManager::addStream(Stream* stream)
+            {
+                streams.push_back(stream);
+            }
+
+            void VoiceManager::removeObject(const Object* object)
+            {
+                auto i = std::find(streams.begin(), streams.end(), object);
+
+                if (i != streams.end())
+                {
+                    *i = streams.back();
+                    streams.pop_back();
+                }
+            }
+
+            void VoiceManager::swapStreams(std::vector<Stream*>& newStreams)
+            {
+                newStreams.assign(streams.begin(), streams.end());
+                streams.swap(newStreams);
+            }
+
+            void VoiceManager::update(const Vector3F& listenerPosition)
+            {
+                // the playing streams are moved to the front and ordered by priority and then by audibility
+                auto playingEnd = std::partition(streams.begin(), streams.end(), [](const Stream* stream) {
+                    return stream->isPlaying();
+                });
+
+                for (auto i = streams.begin(); i != playingEnd; ++i)
+                {
+                    Stream* stream = *i;
+
+                    // inverse distance attenuation, clamped to one within the reference distance of one unit
+                    if (stream->isPositional())
+                    {
+                        const float distance = listenerPosition.distance(stream->getPosition());
+                        stream->setAudibility(stream->getGain() / std::max(distance, 1.0F));
+                    }
+                    else
+                        stream->setAudibility(stream->getGain());
+                }
+
+                std::sort(streams.begin(), playingEnd, [](const Stream* a, const Stream* b) {
+                    return (a->getPriority() == b->getPriority()) ?
+                        a->getAudibility() > b->getAudibility() :
+                        a->getPriority() > b->getPriority();
+                });
+
+                // the real streams are gathered in front of the visited streams without changing the order of the rest
+                auto realEnd = streams.begin();
+
+                for (auto i = streams.begin(); i != playingEnd; ++i)
+                {
+                    Stream* stream = *i;
+                    bool real = stream->getAudibility() >= MIN_AUDIBILITY &&
+                        (!maxVoices || static_cast<uint32_t>(realEnd - streams.begin()) < maxVoices);
+
+                    if (real && stream->getMaxInstances())
+                    {
+                        const auto& data = &stream->getData();
+                        const auto instances = std::count_if(streams.begin(), realEnd, [data](const Stream* other) {
+                            return &other->getData() == data;
+                        });
+
+                        real = static_cast<uint32_t>(instances) < stream->getMaxInstances();
+                    }
+
+                    stream->setVirtual(!real);
+                    if (real) std::iter_swap(realEnd++, i);
+                }
+
+                realVoiceCount.store(static_cast<uint32_t>(realEnd - streams.begin()), std::memory_order_relaxed);
+                virtualVoiceCount.store(static_cast<uint32_t>(playingEnd - realEnd), std::memory_order_relaxed);
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
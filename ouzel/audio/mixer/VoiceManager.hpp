@@ -0,0 +1,66 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_MIXER_VOICEMANAGER_HPP
+#define OUZEL_AUDIO_MIXER_VOICEMANAGER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/Vector.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace mixer
+        {
+            class Object;
+            class Stream;
+
+            // Limits the number of streams that are mixed, the rest of the playing streams become virtual
+            class VoiceManager final
+            {
+            public:
+                // streams quieter than this are always virtual
+                static constexpr float MIN_AUDIBILITY = 0.001F; // -60 dB
+
+                // zero maxVoices doesn't limit the number of real voices
+                VoiceManager(uint32_t initMaxVoices, size_t capacity);
+
+                VoiceManager(const VoiceManager&) = delete;
+                VoiceManager& operator=(const VoiceManager&) = delete;
+
+                VoiceManager(VoiceManager&&) = delete;
+                VoiceManager& operator=(VoiceManager&&) = delete;
+
+                inline auto getMaxVoices() const noexcept { return maxVoices; }
+
+                // the number of voices in the last update, can be read from any thread
+                inline uint32_t getRealVoiceCount() const noexcept { return realVoiceCount.load(std::memory_order_relaxed); }
+                inline uint32_t getVirtualVoiceCount() const noexcept { return virtualVoiceCount.load(std::memory_order_relaxed); }
+
+                // the stream list never grows past its capacity, so that the mixer doesn't allocate
+                void addStream(Stream* stream);
+                void removeObject(const Object* object);
+
+                // moves the streams to a list whose capacity was reserved by the producer and returns the old list in it
+                void swapStreams(std::vector<Stream*>& newStreams);
+
+                inline auto& getStreams() const noexcept { return streams; }
+
+                // decides which of the playing streams are mixed in the next buffer
+                void update(const Vector3F& listenerPosition);
+
+            private:
+                uint32_t maxVoices;
+                std::vector<Stream*> streams;
+
+                std::atomic<uint32_t> realVoiceCount{0};
+                std::atomic<uint32_t> virtualVoiceCount{0};
+            };
+        }
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_MIXER_VOICEMANAGER_HPP
@@ -0,0 +1,152 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include "OfflineAudioDevice.hpp"
+#include "storage/FileSystem.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace offline
+        {
+            namespace
+            {
+                constexpr uint32_t WAVE_HEADER_SIZE = 44;
+
+                void encodeUInt16(uint8_t* buffer, uint16_t value) noexcept
+                {
+                    buffer[0] = static_cast<uint8_t>(value);
+                    buffer[1] = static_cast<uint8_t>(value >> 8);
+                }
+
+                void encodeUInt32(uint8_t* buffer, uint32_t value) noexcept
+                {
+                    buffer[0] = static_cast<uint8_t>(value);
+                    buffer[1] = static_cast<uint8_t>(value >> 8);
+                    buffer[2] = static_cast<uint8_t>(value >> 16);
+                    buffer[3] = static_cast<uint8_t>(value >> 24);
+                }
+            }
+
+            AudioDevice::AudioDevice(uint32_t initBufferSize,
+                                     uint32_t initSampleRate,
+                                     uint32_t initChannels,
+                                     const std::function<void(uint32_t frames,
+                                                              uint32_t channels,
+                                                              uint32_t sampleRate,
+                                                              std::vector<float>& samples)>& initDataGetter):
+                audio::AudioDevice(Driver::Offline, initBufferSize, initSampleRate, initChannels, initDataGetter)
+            {
+            }
+
+            AudioDevice::~AudioDevice()
+            {
+                try
+                {
+                    closeFile();
+                }
+                catch (...)
+                {
+                }
+            }
+
+            void AudioDevice::start()
+            {
+                running = true;
+            }
+
+            void AudioDevice::stop()
+            {
+                running = false;
+            }
+
+            void AudioDevice::render(uint32_t frames)
+            {
+                if (!running) return;
+
+                while (frames > 0)
+                {
+                    const uint32_t callbackFrames = std::min(frames, bufferSize);
+
+                    const auto startTime = std::chrono::steady_clock::now();
+                    getData(callbackFrames, data);
+                    const auto callbackTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+                    renderedFrames += callbackFrames;
+                    ++callbackCount;
+                    renderTime += callbackTime;
+                    maxCallbackTime = std::max(maxCallbackTime, callbackTime);
+
+                    if (file.isOpen())
+                    {
+                        file.write(data.data(), static_cast<uint32_t>(data.size()), true);
+                        dataSize += static_cast<uint32_t>(data.size());
+                    }
+
+                    frames -= callbackFrames;
+                }
+            }
+
+            void AudioDevice::openFile(const std::string& filename)
+            {
+                closeFile();
+
+                file = storage::File(filename, storage::File::Mode::Write | storage::File::Mode::Create | storage::File::Mode::Truncate);
+                wave = storage::FileSystem::getExtensionPart(filename) == "wav";
+                dataSize = 0;
+
+                // the sizes are filled in when the file is closed
+                if (wave) writeWaveHeader(0);
+            }
+
+            void AudioDevice::closeFile()
+            {
+                if (!file.isOpen()) return;
+
+                if (wave)
+                {
+                    file.seek(0, storage::File::Seek::Begin);
+                    writeWaveHeader(dataSize);
+                }
+
+                file.close();
+            }
+
+            void AudioDevice::resetStatistics() noexcept
+            {
+                renderedFrames = 0;
+                callbackCount = 0;
+                renderTime = 0;
+                maxCallbackTime = 0;
+            }
+
+            void AudioDevice::writeWaveHeader(uint32_t size)
+            {
+                if (sampleFormat != SampleFormat::SignedInt16)
+                    throw std::runtime_error("Unsupported sample format");
+
+                const uint16_t blockAlign = static_cast<uint16_t>(channels * sizeof(int16_t));
+
+                uint8_t header[WAVE_HEADER_SIZE];
+                std::copy_n("RIFF", 4, header);
+                encodeUInt32(header + 4, WAVE_HEADER_SIZE - 8 + size);
+                std::copy_n("WAVE", 4, header + 8);
+                std::copy_n("fmt ", 4, header + 12);
+                encodeUInt32(header + 16, 16);
+                encodeUInt16(header + 20, 1); // PCM
+                encodeUInt16(header + 22, static_cast<uint16_t>(channels));
+                encodeUInt32(header + 24, sampleRate);
+                encodeUInt32(header + 28, sampleRate * blockAlign);
+                encodeUInt16(header + 32, blockAlign);
+                encodeUInt16(header + 34, 16);
+                std::copy_n("data", 4, header + 36);
+                encodeUInt32(header + 40, size);
+
+                file.write(header, WAVE_HEADER_SIZE, true);
+            }
+        } // namespace offline
+    } // namespace audio
+} // namespace ouzel
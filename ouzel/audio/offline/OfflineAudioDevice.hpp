@@ -0,0 +1,68 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+#define OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "audio/AudioDevice.hpp"
+#include "storage/File.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        namespace offline
+        {
+            // Renders only when render is called and as fast as the mixer can, without waiting for a clock,
+            // optionally writing the rendered samples to a file
+            class AudioDevice final: public audio::AudioDevice
+            {
+            public:
+                AudioDevice(uint32_t initBufferSize,
+                            uint32_t initSampleRate,
+                            uint32_t initChannels,
+                            const std::function<void(uint32_t frames,
+                                                     uint32_t channels,
+                                                     uint32_t sampleRate,
+                                                     std::vector<float>& samples)>& initDataGetter);
+                ~AudioDevice();
+
+                void start() final;
+                void stop() final;
+
+                // pulls the frames in callbacks of the buffer size on the calling thread
+                void render(uint32_t frames);
+
+                // the samples are written as 16-bit PCM, in a WAV file if the extension is "wav" and raw otherwise
+                void openFile(const std::string& filename);
+                void closeFile();
+
+                inline auto getRenderedFrames() const noexcept { return renderedFrames; }
+                inline auto getCallbackCount() const noexcept { return callbackCount; }
+                // in microseconds
+                inline auto getRenderTime() const noexcept { return renderTime; }
+                inline auto getMaxCallbackTime() const noexcept { return maxCallbackTime; }
+                void resetStatistics() noexcept;
+
+            private:
+                void writeWaveHeader(uint32_t size);
+
+                bool running = false;
+                std::vector<uint8_t> data;
+
+                storage::File file;
+                bool wave = false;
+                uint32_t dataSize = 0;
+
+                uint64_t renderedFrames = 0;
+                uint64_t callbackCount = 0;
+                uint64_t renderTime = 0;
+                uint64_t maxCallbackTime = 0;
+            };
+        } // namespace offline
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_OFFLINEAUDIODEVICE_HPP
@@ -127,6 +127,17 @@ namespace ouzel
         bool exclusiveFullscreen = false;
         bool highDpi = true; // should high DPI resolution be used
         bool debugAudio = false;
+#if defined(__EMSCRIPTEN__)
+        uint32_t audioLookahead = 0; // mix in the audio callback, because there are no threads
+        uint32_t audioDecoderThreads = 0; // decode in the audio callback
+        uint32_t audioMixThreads = 0;
+#else
+        uint32_t audioLookahead = 3; // in audio device buffers
+        uint32_t audioDecoderThreads = 1;
+        uint32_t audioMixThreads = 2; // in addition to the mixer thread
+#endif
+        uint32_t audioMaxVoices = 64;
+        uint32_t audioDecodeAhead = 500; // in milliseconds
 
         defaultSettings = ini::Data(fileSystem.readFile("settings.ini"));
 
@@ -200,6 +211,39 @@ namespace ouzel
         std::string debugAudioValue = userEngineSection.getValue("debugAudio", defaultEngineSection.getValue("debugAudio"));
         if (!debugAudioValue.empty()) debugAudio = (debugAudioValue == "true" || debugAudioValue == "1" || debugAudioValue == "yes");
 
+#if !defined(__EMSCRIPTEN__)
+        std::string audioLookaheadValue = userEngineSection.getValue("audioLookahead", defaultEngineSection.getValue("audioLookahead"));
+        if (!audioLookaheadValue.empty()) audioLookahead = static_cast<uint32_t>(std::stoul(audioLookaheadValue));
+
+        std::string audioDecoderThreadsValue = userEngineSection.getValue("audioDecoderThreads", defaultEngineSection.getValue("audioDecoderThreads"));
+        if (!audioDecoderThreadsValue.empty()) audioDecoderThreads = static_cast<uint32_t>(std::stoul(audioDecoderThreadsValue));
+
+        std::string audioMixThreadsValue = userEngineSection.getValue("audioMixThreads", defaultEngineSection.getValue("audioMixThreads"));
+        if (!audioMixThreadsValue.empty()) audioMixThreads = static_cast<uint32_t>(std::stoul(audioMixThreadsValue));
+#endif
+
+        std::string audioMaxVoicesValue = userEngineSection.getValue("audioMaxVoices", defaultEngineSection.getValue("audioMaxVoices"));
+        if (!audioMaxVoicesValue.empty()) audioMaxVoices = static_cast<uint32_t>(std::stoul(audioMaxVoicesValue));
+
+        std::string audioDecodeAheadValue = userEngineSection.getValue("audioDecodeAhead", defaultEngineSection.getValue("audioDecodeAhead"));
+        if (!audioDecodeAheadValue.empty()) audioDecodeAhead = static_cast<uint32_t>(std::stoul(audioDecodeAheadValue));
+
+        // "linear" interpolates the streams that are not at the device sample rate for less CPU time, but aliases
+        std::string audioResamplerValue = userEngineSection.getValue("audioResampler", defaultEngineSection.getValue("audioResampler"));
+
+#if defined(__EMSCRIPTEN__)
+        threadPool = std::make_unique<ThreadPool>(0);
+#else
+        // the update thread runs jobs too
+        const uint32_t cpuCount = std::thread::hardware_concurrency();
+        uint32_t workerCount = cpuCount > 1 ? cpuCount - 1 : 0;
+
+        std::string workerCountValue = userEngineSection.getValue("workerCount", defaultEngineSection.getValue("workerCount"));
+        if (!workerCountValue.empty()) workerCount = static_cast<uint32_t>(std::stoul(workerCountValue));
+
+        threadPool = std::make_unique<ThreadPool>(workerCount);
+#endif
+
         graphics::Driver graphicsDriver = graphics::Renderer::getDriver(graphicsDriverValue);
 
         const uint32_t windowFlags = (resizable ? Window::Flags::Resizable : 0) |
@@ -227,7 +271,8 @@ namespace ouzel
                                                         debugRenderer);
 
         audio::Driver audioDriver = audio::Audio::getDriver(audioDriverValue);
-        audio = std::make_unique<audio::Audio>(audioDriver, debugAudio);
+        audio::mixer::Resampler::Quality audioResamplerQuality = audio::Audio::getResamplerQuality(audioResamplerValue);
+        audio = std::make_unique<audio::Audio>(audioDriver, debugAudio, audioLookahead, audioMaxVoices, audioMixThreads, audioDecoderThreads, audioDecodeAhead, audioResamplerQuality);
 
         inputManager = std::make_unique<input::InputManager>();
 
@@ -722,6 +767,8 @@ namespace ouzel
             updateEvent->type = Event::Type::Update;
             updateEvent->delta = delta;
             eventDispatcher.dispatchEvent(std::move(updateEvent));
+
+            sceneManager.update(delta);
         }
 
         inputManager->update();
@@ -28,6 +28,7 @@
 #include "utils/Ini.hpp"
 #include "utils/Log.hpp"
 #include "utils/Thread.hpp"
+#include "utils/ThreadPool.hpp"
 
 namespace ouzel
 {
@@ -89,6 +90,9 @@ namespace ouzel
         inline auto& getNetwork() { return network; }
         inline auto& getNetwork() const { return network; }
 
+        // shared by the jobs that are run from the update thread
+        inline auto getThreadPool() const noexcept { return threadPool.get(); }
+
         inline auto& getDefaultSettings() const noexcept { return defaultSettings; }
         inline auto& getUserSettings() const noexcept { return userSettings; }
 
@@ -143,6 +147,7 @@ namespace ouzel
         assets::Bundle assetBundle;
         scene::SceneManager sceneManager;
         network::Network network;
+        std::unique_ptr<ThreadPool> threadPool;
 
         ini::Data defaultSettings;
         ini::Data userSettings;
@@ -8,6 +8,7 @@
 #  define OUZEL_SUPPORTS_DIRECT3D 1
 #  define OUZEL_SUPPORTS_DIRECT3D11 1
 #  define OUZEL_SUPPORTS_OPENGL 1
+#  define OUZEL_SUPPORTS_SOFTWARE 1
 #  define OUZEL_SUPPORTS_DIRECTSOUND 1
 #  define OUZEL_SUPPORTS_WASAPI 1
 
@@ -18,6 +19,7 @@
 #elif defined(__APPLE__) // macOS, iOS, tvOS
 #  include <TargetConditionals.h>
 #  define OUZEL_SUPPORTS_OPENGL 1
+#  define OUZEL_SUPPORTS_SOFTWARE 1
 #  define OUZEL_SUPPORTS_OPENAL 1
 #  define OUZEL_SUPPORTS_COREAUDIO 1
 
@@ -43,6 +45,7 @@
 #elif defined(__ANDROID__) // Android (check this before Linux because __unix__ is also defined for Android)
 #  define OUZEL_PLATFORM_ANDROID 1
 #  define OUZEL_SUPPORTS_OPENGL 1
+#  define OUZEL_SUPPORTS_SOFTWARE 1
 #  define OUZEL_SUPPORTS_OPENSL 1
 
 #elif defined(__EMSCRIPTEN__) // Emscripten (check this before Linux because __unix__ is also defined for Emscripten)
@@ -53,6 +56,7 @@
 #elif defined(__unix__) // Linux/BSD/Solaris
 #  define OUZEL_PLATFORM_LINUX 1
 #  define OUZEL_SUPPORTS_OPENGL 1
+#  define OUZEL_SUPPORTS_SOFTWARE 1
 #  define OUZEL_SUPPORTS_OPENAL 1
 #  define OUZEL_SUPPORTS_ALSA 1
 
@@ -38,6 +38,14 @@
 #  define OUZEL_COMPILE_METAL 1
 #endif
 
+// Software
+#ifndef OUZEL_ENABLE_SOFTWARE
+#  define OUZEL_ENABLE_SOFTWARE 1
+#endif
+#if OUZEL_SUPPORTS_SOFTWARE && OUZEL_ENABLE_SOFTWARE
+#  define OUZEL_COMPILE_SOFTWARE 1
+#endif
+
 // OpenAL
 #ifndef OUZEL_ENABLE_OPENAL
 #  define OUZEL_ENABLE_OPENAL 1
@@ -56,6 +56,7 @@ namespace ouzel
         switch (graphicsDriver)
         {
             case graphics::Driver::Empty:
+            case graphics::Driver::Software:
             {
                 XSetWindowAttributes swa;
                 swa.background_pixel = XWhitePixel(display, screenNumber);
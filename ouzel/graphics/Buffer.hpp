@@ -3,6 +3,7 @@
 #ifndef OUZEL_GRAPHICS_BUFFER_HPP
 #define OUZEL_GRAPHICS_BUFFER_HPP
 
+#include <type_traits>
 #include <vector>
 #include "graphics/RenderDevice.hpp"
 #include "graphics/BufferType.hpp"
@@ -38,6 +39,17 @@ namespace ouzel
             void setData(const void* newData, uint32_t newSize);
             void setData(const std::vector<uint8_t>& newData);
 
+            // Returns memory in the command buffer of the current frame that replaces the contents of the buffer.
+            // The caller writes the data straight into it, so it isn't copied again on the way to the device.
+            // The memory is valid until the frame is presented.
+            template <class T>
+            T* map(size_t count)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Data must be trivially copyable");
+
+                return reinterpret_cast<T*>(mapData(static_cast<uint32_t>(sizeof(T) * count)));
+            }
+
             inline auto& getResource() const noexcept { return resource; }
 
             inline auto getType() const noexcept { return type; }
@@ -45,6 +57,8 @@ namespace ouzel
             inline auto getSize() const noexcept { return size; }
 
         private:
+            uint8_t* mapData(uint32_t newSize);
+
             Renderer* renderer = nullptr;
             RenderDevice::Resource resource;
 
@@ -3,8 +3,16 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
-#include <queue>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include "graphics/BlendFactor.hpp"
 #include "graphics/BlendOperation.hpp"
 #include "graphics/BufferType.hpp"
@@ -23,11 +31,14 @@
 #include "graphics/Vertex.hpp"
 #include "math/Color.hpp"
 #include "math/Rect.hpp"
+#include "utils/Span.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        // Commands are constructed in place in the memory of a command buffer,
+        // so they don't have a virtual destructor
         class Command
         {
         public:
@@ -66,8 +77,6 @@ namespace ouzel
             {
             }
 
-            virtual ~Command() = default;
-
             const Type type;
         };
 
@@ -366,13 +375,13 @@ namespace ouzel
         class PushDebugMarkerCommand final: public Command
         {
         public:
-            explicit PushDebugMarkerCommand(const std::string& initName) noexcept:
+            explicit constexpr PushDebugMarkerCommand(const char* initName) noexcept:
                 Command(Command::Type::PushDebugMarker),
                 name(initName)
             {
             }
 
-            const std::string name;
+            const char* const name; // null-terminated
         };
 
         class PopDebugMarkerCommand final: public Command
@@ -447,8 +456,8 @@ namespace ouzel
         class SetBufferDataCommand final: public Command
         {
         public:
-            SetBufferDataCommand(uintptr_t initBuffer,
-                                 const std::vector<uint8_t>& initData) noexcept:
+            constexpr SetBufferDataCommand(uintptr_t initBuffer,
+                                           Span<uint8_t> initData) noexcept:
                 Command(Command::Type::SetBufferData),
                 buffer(initBuffer),
                 data(initData)
@@ -456,7 +465,7 @@ namespace ouzel
             }
 
             const uintptr_t buffer;
-            const std::vector<uint8_t> data;
+            const Span<uint8_t> data;
         };
 
         class InitShaderCommand final: public Command
@@ -501,16 +510,16 @@ namespace ouzel
         class SetShaderConstantsCommand final: public Command
         {
         public:
-            SetShaderConstantsCommand(std::vector<std::vector<float>> initFragmentShaderConstants,
-                                      std::vector<std::vector<float>> initVertexShaderConstants) noexcept:
+            constexpr SetShaderConstantsCommand(Span<Span<float>> initFragmentShaderConstants,
+                                                Span<Span<float>> initVertexShaderConstants) noexcept:
                 Command(Command::Type::SetShaderConstants),
                 fragmentShaderConstants(initFragmentShaderConstants),
                 vertexShaderConstants(initVertexShaderConstants)
             {
             }
 
-            const std::vector<std::vector<float>> fragmentShaderConstants;
-            const std::vector<std::vector<float>> vertexShaderConstants;
+            const Span<Span<float>> fragmentShaderConstants;
+            const Span<Span<float>> vertexShaderConstants;
         };
 
         class InitTextureCommand final: public Command
@@ -600,48 +609,204 @@ namespace ouzel
         class SetTexturesCommand final: public Command
         {
         public:
-            explicit SetTexturesCommand(const std::vector<uintptr_t>& initTextures) noexcept:
+            explicit constexpr SetTexturesCommand(Span<uintptr_t> initTextures) noexcept:
                 Command(Command::Type::SetTextures),
                 textures(initTextures)
             {
             }
 
-            const std::vector<uintptr_t> textures;
+            const Span<uintptr_t> textures;
         };
 
+        // Stores the commands of a frame and their data in a linear memory arena that is reused after
+        // the command buffer is reset, so encoding a frame doesn't allocate once the arena is big enough
         class CommandBuffer final
         {
         public:
+            static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
             CommandBuffer() = default;
             explicit CommandBuffer(const std::string& initName) noexcept:
                 name(initName)
             {
             }
 
+            ~CommandBuffer()
+            {
+                destroyCommands();
+            }
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            CommandBuffer(CommandBuffer&& other) noexcept:
+                name(std::move(other.name)),
+                blocks(std::move(other.blocks)),
+                offset(other.offset),
+                commands(std::move(other.commands)),
+                position(other.position)
+            {
+                other.blocks.clear();
+                other.offset = 0;
+                other.commands.clear();
+                other.position = 0;
+            }
+
+            CommandBuffer& operator=(CommandBuffer&& other) noexcept
+            {
+                if (&other == this) return *this;
+
+                destroyCommands();
+
+                name = std::move(other.name);
+                blocks = std::move(other.blocks);
+                offset = other.offset;
+                commands = std::move(other.commands);
+                position = other.position;
+
+                other.blocks.clear();
+                other.offset = 0;
+                other.commands.clear();
+                other.position = 0;
+
+                return *this;
+            }
+
             inline auto& getName() const noexcept { return name; }
 
-            inline auto isEmpty() const noexcept { return commands.empty(); }
+            inline auto isEmpty() const noexcept { return position == commands.size(); }
+
+            template <class T, class ...Args>
+            void pushCommand(Args&&... args)
+            {
+                static_assert(std::is_base_of<Command, T>::value, "Not a command");
+
+                T* command = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+                try
+                {
+                    commands.push_back(Entry{command, std::is_trivially_destructible<T>::value ? nullptr : &destroy<T>});
+                }
+                catch (...)
+                {
+                    command->~T();
+                    throw;
+                }
+            }
+
+            // copies the data into the arena, the result is valid until the command buffer is reset
+            template <class T>
+            Span<T> pushData(const T* data, size_t size)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Data must be trivially copyable");
+
+                if (!size) return Span<T>();
 
-            inline void pushCommand(std::unique_ptr<Command> command)
+                T* result = static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+                std::copy(data, data + size, result);
+                return Span<T>(result, size);
+            }
+
+            // reserves uninitialized memory in the arena that is aligned for any fundamental type,
+            // it can be filled after a command referencing it was pushed, until the command buffer is submitted
+            uint8_t* reserveData(size_t size)
             {
-                commands.push(std::move(command));
+                if (!size) return nullptr;
+
+                return static_cast<uint8_t*>(allocate(size, alignof(std::max_align_t)));
             }
 
-            inline std::unique_ptr<Command> popCommand()
+            // allocates default constructed objects in the arena, they are valid until the command buffer is reset
+            template <class T>
+            T* allocateData(size_t size)
             {
-                auto result = std::move(commands.front());
-                commands.pop();
+                static_assert(std::is_trivially_destructible<T>::value, "Data must be trivially destructible");
+
+                if (!size) return nullptr;
+
+                T* result = static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+                for (size_t i = 0; i < size; ++i) new (result + i) T();
                 return result;
             }
 
-            inline auto& getCommands() const
+            inline const Command* popCommand()
+            {
+                return commands[position++].command;
+            }
+
+            // destroys the commands and rewinds the arena, the memory is kept for the next frame
+            void reset()
             {
-                return commands;
+                destroyCommands();
+                commands.clear();
+                position = 0;
+                offset = 0;
+
+                // merge the blocks that were added during the frame into one
+                if (blocks.size() > 1)
+                {
+                    size_t size = 0;
+                    for (const Block& block : blocks) size += block.size;
+
+                    blocks.clear();
+                    blocks.push_back(Block{std::make_unique<uint8_t[]>(size), size});
+                }
             }
 
         private:
+            struct Block final
+            {
+                std::unique_ptr<uint8_t[]> data;
+                size_t size;
+            };
+
+            struct Entry final
+            {
+                Command* command;
+                void (*destructor)(Command*); // null for trivially destructible commands
+            };
+
+            template <class T>
+            static void destroy(Command* command) noexcept
+            {
+                static_cast<T*>(command)->~T();
+            }
+
+            void* allocate(size_t size, size_t alignment)
+            {
+                // new[] returns memory aligned for any fundamental type
+                if (alignment > alignof(std::max_align_t))
+                    throw std::runtime_error("Unsupported alignment");
+
+                if (!blocks.empty())
+                {
+                    const size_t start = (offset + alignment - 1) & ~(alignment - 1);
+                    Block& block = blocks.back();
+
+                    if (start + size <= block.size)
+                    {
+                        offset = start + size;
+                        return block.data.get() + start;
+                    }
+                }
+
+                const size_t blockSize = std::max(BLOCK_SIZE, size);
+                blocks.push_back(Block{std::make_unique<uint8_t[]>(blockSize), blockSize});
+                offset = size;
+                return blocks.back().data.get();
+            }
+
+            void destroyCommands() noexcept
+            {
+                for (const Entry& entry : commands)
+                    if (entry.destructor) entry.destructor(entry.command);
+            }
+
             std::string name;
-            std::queue<std::unique_ptr<Command>> commands;
+            std::vector<Block> blocks;
+            size_t offset = 0; // offset in the last block
+            std::vector<Entry> commands;
+            size_t position = 0;
         };
     } // namespace graphics
 } // namespace ouzel
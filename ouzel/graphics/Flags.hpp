@@ -14,7 +14,8 @@ namespace ouzel
             Dynamic = 0x01,
             BindRenderTarget = 0x02,
             BindShader = 0x04,
-            BindShaderMsaa = 0x08
+            BindShaderMsaa = 0x08,
+            Streaming = 0x10 // contents are replaced often, so the render device doesn't keep a copy of them
         };
     } // namespace graphics
 } // namespace ouzel
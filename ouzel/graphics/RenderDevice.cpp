@@ -55,6 +55,9 @@ namespace ouzel
 
         void RenderDevice::process()
         {
+            drawCallCount = currentDrawCallCount;
+            currentDrawCallCount = 0;
+
             Event event;
             event.type = Event::Type::Frame;
             callback(event);
@@ -79,6 +82,37 @@ namespace ouzel
             }
         }
 
+        CommandBuffer RenderDevice::getFreeCommandBuffer()
+        {
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+
+            if (freeCommandBuffers.empty())
+                return CommandBuffer();
+
+            CommandBuffer commandBuffer = std::move(freeCommandBuffers.back());
+            freeCommandBuffers.pop_back();
+            return commandBuffer;
+        }
+
+        CommandBuffer RenderDevice::popCommandBuffer()
+        {
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+            while (commandQueue.empty()) commandQueueCondition.wait(lock);
+
+            CommandBuffer commandBuffer = std::move(commandQueue.front());
+            commandQueue.erase(commandQueue.begin());
+            return commandBuffer;
+        }
+
+        void RenderDevice::recycleCommandBuffer(CommandBuffer&& commandBuffer)
+        {
+            commandBuffer.reset();
+
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+            if (freeCommandBuffers.size() < COMMAND_BUFFER_COUNT)
+                freeCommandBuffers.push_back(std::move(commandBuffer));
+        }
+
         std::vector<Size2U> RenderDevice::getSupportedResolutions() const
         {
             return std::vector<Size2U>();
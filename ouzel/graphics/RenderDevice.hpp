@@ -10,6 +10,7 @@
 #include <mutex>
 #include <queue>
 #include <set>
+#include <vector>
 #include "graphics/Commands.hpp"
 #include "graphics/Driver.hpp"
 #include "graphics/SamplerFilter.hpp"
@@ -30,6 +31,7 @@ namespace ouzel
             friend Renderer;
         public:
             static const std::array<Vertex::Attribute, 5> VERTEX_ATTRIBUTES;
+            static constexpr size_t COMMAND_BUFFER_COUNT = 3; // command buffers kept for reuse
 
             struct Event
             {
@@ -63,12 +65,15 @@ namespace ouzel
             void submitCommandBuffer(CommandBuffer&& commandBuffer)
             {
                 std::unique_lock<std::mutex> lock(commandQueueMutex);
-                commandQueue.push(std::move(commandBuffer));
+                commandQueue.push_back(std::move(commandBuffer));
                 lock.unlock();
                 commandQueueCondition.notify_all();
             }
 
-            inline auto getDrawCallCount() const noexcept { return drawCallCount; }
+            // returns a command buffer that was processed by the device or a new one if there is none
+            CommandBuffer getFreeCommandBuffer();
+
+            inline uint32_t getDrawCallCount() const noexcept { return drawCallCount; }
 
             inline auto getAPIMajorVersion() const noexcept { return apiMajorVersion; }
             inline auto getAPIMinorVersion() const noexcept { return apiMinorVersion; }
@@ -164,6 +169,9 @@ namespace ouzel
 
             void executeAll();
 
+            CommandBuffer popCommandBuffer();
+            void recycleCommandBuffer(CommandBuffer&& commandBuffer);
+
             virtual void generateScreenshot(const std::string& filename);
 
             Driver driver;
@@ -194,9 +202,12 @@ namespace ouzel
             Matrix4F projectionTransform;
             Matrix4F renderTargetProjectionTransform;
 
-            uint32_t drawCallCount = 0;
+            std::atomic<uint32_t> drawCallCount{0}; // draw calls of the previous frame
+            uint32_t currentDrawCallCount = 0;
 
-            std::queue<CommandBuffer> commandQueue;
+            // vectors instead of queues, so that passing the command buffers around doesn't allocate
+            std::vector<CommandBuffer> commandQueue;
+            std::vector<CommandBuffer> freeCommandBuffers;
             std::mutex commandQueueMutex;
             std::condition_variable commandQueueCondition;
 
@@ -20,9 +20,9 @@ namespace ouzel
             for (const auto& colorTexture : colorTextures)
                 colorTextureIds.insert(colorTexture ? colorTexture->getResource() : 0);
 
-            initRenderer.addCommand(std::make_unique<InitRenderTargetCommand>(resource,
-                                                                              colorTextureIds,
-                                                                              depthTexture ? depthTexture->getResource() : uintptr_t(0)));
+            initRenderer.addCommand<InitRenderTargetCommand>(resource,
+                                                             colorTextureIds,
+                                                             depthTexture ? depthTexture->getResource() : uintptr_t(0));
         }
     } // namespace graphics
 } // namespace ouzel
@@ -37,6 +37,7 @@
 #include "graphics/opengl/OGLRenderDevice.hpp"
 #include "graphics/direct3d11/D3D11RenderDevice.hpp"
 #include "graphics/metal/MetalRenderDevice.hpp"
+#include "graphics/software/SoftwareRenderDevice.hpp"
 
 namespace ouzel
 {
@@ -65,6 +66,8 @@ namespace ouzel
                 return Driver::Direct3D11;
             else if (driver == "metal")
                 return Driver::Metal;
+            else if (driver == "software")
+                return Driver::Software;
             else
                 throw std::runtime_error("Invalid graphics driver");
         }
@@ -86,6 +89,9 @@ namespace ouzel
 #if OUZEL_COMPILE_METAL
                 if (metal::RenderDevice::available())
                     availableDrivers.insert(Driver::Metal);
+#endif
+#if OUZEL_COMPILE_SOFTWARE
+                availableDrivers.insert(Driver::Software);
 #endif
             }
 
@@ -145,6 +151,12 @@ namespace ouzel
                     device = std::make_unique<metal::RenderDeviceMacOS>(std::bind(&Renderer::handleEvent, this, std::placeholders::_1));
 #  endif
                     break;
+#endif
+#if OUZEL_COMPILE_SOFTWARE
+                case Driver::Software:
+                    engine->log(Log::Level::Info) << "Using software render driver";
+                    device = std::make_unique<software::RenderDevice>(std::bind(&Renderer::handleEvent, this, std::placeholders::_1));
+                    break;
 #endif
                 default:
                     engine->log(Log::Level::Info) << "Not using render driver";
@@ -178,11 +190,22 @@ namespace ouzel
             }
         }
 
+        Span<Span<float>> Renderer::addShaderConstants(std::initializer_list<Span<float>> shaderConstants)
+        {
+            Span<float>* result = commandBuffer.allocateData<Span<float>>(shaderConstants.size());
+
+            Span<float>* shaderConstant = result;
+            for (const Span<float>& constant : shaderConstants)
+                *shaderConstant++ = addData(constant.data(), constant.size());
+
+            return Span<Span<float>>(result, shaderConstants.size());
+        }
+
         void Renderer::setSize(const Size2U& newSize)
         {
             size = newSize;
 
-            addCommand(std::make_unique<ResizeCommand>(newSize));
+            addCommand<ResizeCommand>(newSize);
         }
 
         void Renderer::saveScreenshot(const std::string& filename)
@@ -192,7 +215,7 @@ namespace ouzel
 
         void Renderer::setRenderTarget(uintptr_t renderTarget)
         {
-            addCommand(std::make_unique<SetRenderTargetCommand>(renderTarget));
+            addCommand<SetRenderTargetCommand>(renderTarget);
         }
 
         void Renderer::clearRenderTarget(bool clearColorBuffer,
@@ -202,29 +225,29 @@ namespace ouzel
                                          float clearDepth,
                                          uint32_t clearStencil)
         {
-            addCommand(std::make_unique<ClearRenderTargetCommand>(clearColorBuffer,
-                                                                  clearDepthBuffer,
-                                                                  clearStencilBuffer,
-                                                                  clearColor,
-                                                                  clearDepth,
-                                                                  clearStencil));
+            addCommand<ClearRenderTargetCommand>(clearColorBuffer,
+                                                 clearDepthBuffer,
+                                                 clearStencilBuffer,
+                                                 clearColor,
+                                                 clearDepth,
+                                                 clearStencil);
         }
 
         void Renderer::setScissorTest(bool enabled, const RectF& rectangle)
         {
-            addCommand(std::make_unique<SetScissorTestCommand>(enabled, rectangle));
+            addCommand<SetScissorTestCommand>(enabled, rectangle);
         }
 
         void Renderer::setViewport(const RectF& viewport)
         {
-            addCommand(std::make_unique<SetViewportCommand>(viewport));
+            addCommand<SetViewportCommand>(viewport);
         }
 
         void Renderer::setDepthStencilState(uintptr_t depthStencilState,
                                             uint32_t stencilReferenceValue)
         {
-            addCommand(std::make_unique<SetDepthStencilStateCommand>(depthStencilState,
-                                                                     stencilReferenceValue));
+            addCommand<SetDepthStencilStateCommand>(depthStencilState,
+                                                    stencilReferenceValue);
         }
 
         void Renderer::setPipelineState(uintptr_t blendState,
@@ -232,10 +255,10 @@ namespace ouzel
                                         CullMode cullMode,
                                         FillMode fillMode)
         {
-            addCommand(std::make_unique<SetPipelineStateCommand>(blendState,
-                                                                 shader,
-                                                                 cullMode,
-                                                                 fillMode));
+            addCommand<SetPipelineStateCommand>(blendState,
+                                                shader,
+                                                cullMode,
+                                                fillMode);
         }
 
         void Renderer::draw(uintptr_t indexBuffer,
@@ -248,42 +271,42 @@ namespace ouzel
             if (!indexBuffer || !vertexBuffer)
                 throw std::runtime_error("Invalid mesh buffer passed to render queue");
 
-            addCommand(std::make_unique<DrawCommand>(indexBuffer,
-                                                     indexCount,
-                                                     indexSize,
-                                                     vertexBuffer,
-                                                     drawMode,
-                                                     startIndex));
+            addCommand<DrawCommand>(indexBuffer,
+                                    indexCount,
+                                    indexSize,
+                                    vertexBuffer,
+                                    drawMode,
+                                    startIndex);
         }
 
         void Renderer::pushDebugMarker(const std::string& name)
         {
-            addCommand(std::make_unique<PushDebugMarkerCommand>(name));
+            addCommand<PushDebugMarkerCommand>(addData(name.c_str(), name.size() + 1).data());
         }
 
         void Renderer::popDebugMarker()
         {
-            addCommand(std::make_unique<PopDebugMarkerCommand>());
+            addCommand<PopDebugMarkerCommand>();
         }
 
-        void Renderer::setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                          std::vector<std::vector<float>> vertexShaderConstants)
+        void Renderer::setShaderConstants(std::initializer_list<Span<float>> fragmentShaderConstants,
+                                          std::initializer_list<Span<float>> vertexShaderConstants)
         {
-            addCommand(std::make_unique<SetShaderConstantsCommand>(fragmentShaderConstants,
-                                                                   vertexShaderConstants));
+            addCommand<SetShaderConstantsCommand>(addShaderConstants(fragmentShaderConstants),
+                                                  addShaderConstants(vertexShaderConstants));
         }
 
-        void Renderer::setTextures(const std::vector<uintptr_t>& textures)
+        void Renderer::setTextures(Span<uintptr_t> textures)
         {
-            addCommand(std::make_unique<SetTexturesCommand>(textures));
+            addCommand<SetTexturesCommand>(addData(textures.data(), textures.size()));
         }
 
         void Renderer::present()
         {
             refillQueue = false;
-            addCommand(std::make_unique<PresentCommand>());
+            addCommand<PresentCommand>();
             device->submitCommandBuffer(std::move(commandBuffer));
-            commandBuffer = CommandBuffer();
+            commandBuffer = device->getFreeCommandBuffer();
         }
 
         void Renderer::waitForNextFrame()
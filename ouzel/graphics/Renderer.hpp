@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -18,6 +19,7 @@
 #include "math/Matrix.hpp"
 #include "math/Size.hpp"
 #include "math/Color.hpp"
+#include "utils/Span.hpp"
 
 namespace ouzel
 {
@@ -71,13 +73,27 @@ namespace ouzel
                       uint32_t startIndex);
             void pushDebugMarker(const std::string& name);
             void popDebugMarker();
-            void setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                    std::vector<std::vector<float>> vertexShaderConstants);
-            void setTextures(const std::vector<uintptr_t>& textures);
+            void setShaderConstants(std::initializer_list<Span<float>> fragmentShaderConstants,
+                                    std::initializer_list<Span<float>> vertexShaderConstants);
+            void setTextures(Span<uintptr_t> textures);
 
-            inline void addCommand(std::unique_ptr<Command> command)
+            template <class T, class ...Args>
+            inline void addCommand(Args&&... args)
             {
-                commandBuffer.pushCommand(std::move(command));
+                commandBuffer.pushCommand<T>(std::forward<Args>(args)...);
+            }
+
+            // copies the data into the current command buffer, the result can be passed to a command
+            template <class T>
+            inline Span<T> addData(const T* data, size_t count)
+            {
+                return commandBuffer.pushData(data, count);
+            }
+
+            // reserves memory in the current command buffer that the caller fills before the frame is presented
+            inline uint8_t* reserveData(size_t dataSize)
+            {
+                return commandBuffer.reserveData(dataSize);
             }
             void present();
 
@@ -98,6 +114,7 @@ namespace ouzel
 
         private:
             void handleEvent(const RenderDevice::Event& event);
+            Span<Span<float>> addShaderConstants(std::initializer_list<Span<float>> shaderConstants);
             void setSize(const Size2U& newSize);
 
             std::unique_ptr<RenderDevice> device;
@@ -25,16 +25,16 @@ namespace ouzel
             resource(initRenderer.getDevice()->createResource()),
             vertexAttributes(initVertexAttributes)
         {
-            initRenderer.addCommand(std::make_unique<InitShaderCommand>(resource,
-                                                                        initFragmentShader,
-                                                                        initVertexShader,
-                                                                        initVertexAttributes,
-                                                                        initFragmentShaderConstantInfo,
-                                                                        initVertexShaderConstantInfo,
-                                                                        initFragmentShaderDataAlignment,
-                                                                        initVertexShaderDataAlignment,
-                                                                        fragmentShaderFunction,
-                                                                        vertexShaderFunction));
+            initRenderer.addCommand<InitShaderCommand>(resource,
+                                                       initFragmentShader,
+                                                       initVertexShader,
+                                                       initVertexAttributes,
+                                                       initFragmentShaderConstantInfo,
+                                                       initVertexShaderConstantInfo,
+                                                       initFragmentShaderDataAlignment,
+                                                       initVertexShaderDataAlignment,
+                                                       fragmentShaderFunction,
+                                                       vertexShaderFunction);
         }
     } // namespace graphics
 } // namespace ouzel
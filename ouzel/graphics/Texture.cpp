@@ -668,12 +668,12 @@ namespace ouzel
 
             std::vector<std::pair<Size2U, std::vector<uint8_t>>> levels = calculateSizes(size, mipmaps, pixelFormat);
 
-            initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                        levels,
-                                                                        TextureType::TwoDimensional,
-                                                                        flags,
-                                                                        sampleCount,
-                                                                        pixelFormat));
+            initRenderer.addCommand<InitTextureCommand>(resource,
+                                                       levels,
+                                                       TextureType::TwoDimensional,
+                                                       flags,
+                                                       sampleCount,
+                                                       pixelFormat);
         }
 
         Texture::Texture(Renderer& initRenderer,
@@ -699,12 +699,12 @@ namespace ouzel
 
             std::vector<std::pair<Size2U, std::vector<uint8_t>>> levels = calculateSizes(size, initData, mipmaps, pixelFormat);
 
-            initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                         levels,
-                                                                         TextureType::TwoDimensional,
-                                                                         flags,
-                                                                         sampleCount,
-                                                                         pixelFormat));
+            initRenderer.addCommand<InitTextureCommand>(resource,
+                                                        levels,
+                                                        TextureType::TwoDimensional,
+                                                        flags,
+                                                        sampleCount,
+                                                        pixelFormat);
         }
 
         Texture::Texture(Renderer& initRenderer,
@@ -732,12 +732,20 @@ namespace ouzel
                 levels.resize(1);
             }
 
-            initRenderer.addCommand(std::make_unique<InitTextureCommand>(resource,
-                                                                         levels,
-                                                                         TextureType::TwoDimensional,
-                                                                         flags,
-                                                                         sampleCount,
-                                                                         pixelFormat));
+            initRenderer.addCommand<InitTextureCommand>(resource,
+                                                        levels,
+                                                        TextureType::TwoDimensional,
+                                                        flags,
+                                                        sampleCount,
+                                                        pixelFormat);
+        }
+
+        std::vector<std::pair<Size2U, std::vector<uint8_t>>> Texture::generateLevels(const std::vector<uint8_t>& data,
+                                                                                     const Size2U& size,
+                                                                                     uint32_t mipmaps,
+                                                                                     PixelFormat pixelFormat)
+        {
+            return calculateSizes(size, data, mipmaps, pixelFormat);
         }
 
         void Texture::setData(const std::vector<uint8_t>& newData, CubeFace face)
@@ -748,9 +756,9 @@ namespace ouzel
             std::vector<std::pair<Size2U, std::vector<uint8_t>>> levels = calculateSizes(size, newData, mipmaps, pixelFormat);
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureDataCommand>(resource,
-                                                                             levels,
-                                                                             face));
+                renderer->addCommand<SetTextureDataCommand>(resource,
+                                                            levels,
+                                                            face);
         }
 
         void Texture::setFilter(SamplerFilter newFilter)
@@ -758,13 +766,13 @@ namespace ouzel
             filter = newFilter;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
 
         void Texture::setAddressX(SamplerAddressMode newAddressX)
@@ -772,13 +780,13 @@ namespace ouzel
             addressX = newAddressX;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
 
         void Texture::setAddressY(SamplerAddressMode newAddressY)
@@ -786,13 +794,13 @@ namespace ouzel
             addressY = newAddressY;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
 
         void Texture::setAddressZ(SamplerAddressMode newAddressZ)
@@ -800,13 +808,13 @@ namespace ouzel
             addressZ = newAddressZ;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
 
         void Texture::setBorderColor(Color newBorderColor)
@@ -814,13 +822,13 @@ namespace ouzel
             borderColor = newBorderColor;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
 
         void Texture::setMaxAnisotropy(uint32_t newMaxAnisotropy)
@@ -828,13 +836,13 @@ namespace ouzel
             maxAnisotropy = newMaxAnisotropy;
 
             if (resource)
-                renderer->addCommand(std::make_unique<SetTextureParametersCommand>(resource,
-                                                                                   filter,
-                                                                                   addressX,
-                                                                                   addressY,
-                                                                                   addressZ,
-                                                                                   borderColor,
-                                                                                   maxAnisotropy));
+                renderer->addCommand<SetTextureParametersCommand>(resource,
+                                                                  filter,
+                                                                  addressX,
+                                                                  addressY,
+                                                                  addressZ,
+                                                                  borderColor,
+                                                                  maxAnisotropy);
         }
     } // namespace graphics
 } // namespace ouzel
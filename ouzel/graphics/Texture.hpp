@@ -45,6 +45,13 @@ namespace ouzel
                     uint32_t initFlags = 0,
                     PixelFormat initPixelFormat = PixelFormat::RGBA8UNorm);
 
+            // the data followed by its mip maps, the count of zero generates all of them,
+            // it does not use the renderer, so it can be called from any thread
+            static std::vector<std::pair<Size2U, std::vector<uint8_t>>> generateLevels(const std::vector<uint8_t>& data,
+                                                                                       const Size2U& size,
+                                                                                       uint32_t mipmaps,
+                                                                                       PixelFormat pixelFormat);
+
             inline auto& getResource() const noexcept { return resource; }
 
             inline auto& getSize() const noexcept { return size; }
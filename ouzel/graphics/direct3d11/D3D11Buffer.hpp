@@ -22,6 +22,7 @@
 #include "graphics/direct3d11/D3D11RenderResource.hpp"
 #include "graphics/direct3d11/D3D11Pointer.hpp"
 #include "graphics/BufferType.hpp"
+#include "utils/Span.hpp"
 
 namespace ouzel
 {
@@ -40,7 +41,7 @@ namespace ouzel
                        const std::vector<uint8_t>& data,
                        uint32_t initSize);
 
-                void setData(const std::vector<uint8_t>& data);
+                void setData(Span<uint8_t> data);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
@@ -49,7 +50,7 @@ namespace ouzel
                 inline auto& getBuffer() const noexcept { return buffer; }
 
             private:
-                void createBuffer(UINT newSize, const std::vector<uint8_t>& data);
+                void createBuffer(UINT newSize, Span<uint8_t> data);
 
                 BufferType type;
                 uint32_t flags = 0;
@@ -113,7 +113,7 @@ namespace ouzel
             {
                 running = false;
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
 
                 if (renderThread.isJoinable()) renderThread.join();
@@ -386,26 +386,19 @@ namespace ouzel
                 std::vector<ID3D11ShaderResourceView*> currentResourceViews;
                 std::vector<ID3D11SamplerState*> currentSamplerStates;
 
-                CommandBuffer commandBuffer;
-                std::unique_ptr<Command> command;
-
                 for (;;)
                 {
-                    std::unique_lock<std::mutex> lock(commandQueueMutex);
-                    while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                    commandBuffer = std::move(commandQueue.front());
-                    commandQueue.pop();
-                    lock.unlock();
+                    CommandBuffer commandBuffer = popCommandBuffer();
 
                     while (!commandBuffer.isEmpty())
                     {
-                        command = commandBuffer.popCommand();
+                        const Command* command = commandBuffer.popCommand();
 
                         switch (command->type)
                         {
                             case Command::Type::Resize:
                             {
-                                auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                                auto resizeCommand = static_cast<const ResizeCommand*>(command);
                                 resizeBackBuffer(static_cast<UINT>(resizeCommand->size.v[0]),
                                                  static_cast<UINT>(resizeCommand->size.v[1]));
                                 break;
@@ -422,14 +415,14 @@ namespace ouzel
 
                             case Command::Type::DeleteResource:
                             {
-                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                                 resources[deleteResourceCommand->resource - 1].reset();
                                 break;
                             }
 
                             case Command::Type::InitRenderTarget:
                             {
-                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                                 std::set<Texture*> colorTextures;
                                 for (const uintptr_t colorTextureId : initRenderTargetCommand->colorTextures)
@@ -447,7 +440,7 @@ namespace ouzel
 
                             case Command::Type::SetRenderTarget:
                             {
-                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                                 if (currentRenderTarget)
                                     currentRenderTarget->resolve();
@@ -470,7 +463,7 @@ namespace ouzel
 
                             case Command::Type::ClearRenderTarget:
                             {
-                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                                 FLOAT frameBufferClearColor[4]{clearCommand->clearColor.normR(),
                                     clearCommand->clearColor.normG(),
@@ -507,7 +500,7 @@ namespace ouzel
 
                             case Command::Type::Blit:
                             {
-                                auto blitCommand = static_cast<const BlitCommand*>(command.get());
+                                auto blitCommand = static_cast<const BlitCommand*>(command);
 
                                 Texture* sourceTexture = getResource<Texture>(blitCommand->sourceTexture);
                                 Texture* destinationTexture = getResource<Texture>(blitCommand->destinationTexture);
@@ -533,7 +526,7 @@ namespace ouzel
 
                             case Command::Type::SetScissorTest:
                             {
-                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                                 if (setScissorTestCommand->enabled)
                                 {
@@ -555,7 +548,7 @@ namespace ouzel
 
                             case Command::Type::SetViewport:
                             {
-                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                                 D3D11_VIEWPORT viewport;
                                 viewport.MinDepth = 0.0F;
@@ -571,7 +564,7 @@ namespace ouzel
 
                             case Command::Type::InitDepthStencilState:
                             {
-                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                                 auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                              initDepthStencilStateCommand->depthTest,
                                                                                              initDepthStencilStateCommand->depthWrite,
@@ -596,7 +589,7 @@ namespace ouzel
 
                             case Command::Type::SetDepthStencilState:
                             {
-                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                                 if (setDepthStencilStateCommand->depthStencilState)
                                 {
@@ -613,7 +606,7 @@ namespace ouzel
 
                             case Command::Type::SetPipelineState:
                             {
-                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                                 BlendState* blendState = getResource<BlendState>(setPipelineStateCommand->blendState);
                                 Shader* shader = getResource<Shader>(setPipelineStateCommand->shader);
@@ -663,7 +656,8 @@ namespace ouzel
 
                             case Command::Type::Draw:
                             {
-                                auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                                auto drawCommand = static_cast<const DrawCommand*>(command);
+                                ++currentDrawCallCount;
 
                                 // draw mesh buffer
                                 Buffer* indexBuffer = getResource<Buffer>(drawCommand->indexBuffer);
@@ -705,7 +699,7 @@ namespace ouzel
 
                             case Command::Type::InitBlendState:
                             {
-                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                                 auto blendState = std::make_unique<BlendState>(*this,
                                                                                initBlendStateCommand->enableBlending,
@@ -725,7 +719,7 @@ namespace ouzel
 
                             case Command::Type::InitBuffer:
                             {
-                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                                 auto buffer = std::make_unique<Buffer>(*this,
                                                                        initBufferCommand->bufferType,
@@ -741,7 +735,7 @@ namespace ouzel
 
                             case Command::Type::SetBufferData:
                             {
-                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                                 Buffer* buffer = getResource<Buffer>(setBufferDataCommand->buffer);
                                 buffer->setData(setBufferDataCommand->data);
@@ -750,7 +744,7 @@ namespace ouzel
 
                             case Command::Type::InitShader:
                             {
-                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                                 auto shader = std::make_unique<Shader>(*this,
                                                                        initShaderCommand->fragmentShader,
@@ -771,7 +765,7 @@ namespace ouzel
 
                             case Command::Type::SetShaderConstants:
                             {
-                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                                 if (!currentShader)
                                     throw std::runtime_error("No shader set");
@@ -787,7 +781,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                    const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                                    const Span<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
 
                                     if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
                                         throw std::runtime_error("Invalid pixel shader constant size");
@@ -813,7 +807,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                    const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                                    const Span<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
 
                                     if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
                                         throw std::runtime_error("Invalid vertex shader constant size");
@@ -833,7 +827,7 @@ namespace ouzel
 
                             case Command::Type::InitTexture:
                             {
-                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                                 auto texture = std::make_unique<Texture>(*this,
                                                                          initTextureCommand->levels,
@@ -850,7 +844,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureData:
                             {
-                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureDataCommand->texture);
                                 texture->setData(setTextureDataCommand->levels);
@@ -860,7 +854,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureParameters:
                             {
-                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureParametersCommand->texture);
                                 texture->setFilter((setTextureParametersCommand->filter == SamplerFilter::Default) ? textureFilter : setTextureParametersCommand->filter);
@@ -874,7 +868,7 @@ namespace ouzel
 
                             case Command::Type::SetTextures:
                             {
-                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                                 currentResourceViews.clear();
                                 currentSamplerStates.clear();
@@ -901,8 +895,14 @@ namespace ouzel
                                 throw std::runtime_error("Invalid command");
                         }
 
-                        if (command->type == Command::Type::Present) return;
+                        if (command->type == Command::Type::Present)
+                        {
+                            recycleCommandBuffer(std::move(commandBuffer));
+                            return;
+                        }
                     }
+
+                    recycleCommandBuffer(std::move(commandBuffer));
                 }
             }
 
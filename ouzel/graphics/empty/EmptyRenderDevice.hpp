@@ -20,7 +20,28 @@ namespace ouzel
                 }
 
             private:
-                void process() final {}
+                // the commands are not executed, the command buffers are only returned to the renderer
+                void process() final
+                {
+                    graphics::RenderDevice::process();
+                    executeAll();
+
+                    for (;;)
+                    {
+                        CommandBuffer commandBuffer = popCommandBuffer();
+
+                        while (!commandBuffer.isEmpty())
+                        {
+                            if (commandBuffer.popCommand()->type == Command::Type::Present)
+                            {
+                                recycleCommandBuffer(std::move(commandBuffer));
+                                return;
+                            }
+                        }
+
+                        recycleCommandBuffer(std::move(commandBuffer));
+                    }
+                }
             };
         } // namespace empty
     } // namespace graphics
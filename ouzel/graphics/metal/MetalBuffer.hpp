@@ -18,6 +18,7 @@ typedef id MTLBufferPtr;
 #include "graphics/metal/MetalRenderResource.hpp"
 #include "graphics/metal/MetalPointer.hpp"
 #include "graphics/BufferType.hpp"
+#include "utils/Span.hpp"
 
 namespace ouzel
 {
@@ -36,7 +37,7 @@ namespace ouzel
                        const std::vector<uint8_t>& initData,
                        uint32_t initSize);
 
-                void setData(const std::vector<uint8_t>& data);
+                void setData(Span<uint8_t> data);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
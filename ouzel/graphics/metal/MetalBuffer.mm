@@ -30,7 +30,7 @@ namespace ouzel
                     std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer.get() contents]));
             }
 
-            void Buffer::setData(const std::vector<uint8_t>& data)
+            void Buffer::setData(Span<uint8_t> data)
             {
                 if (!(flags & Flags::Dynamic))
                     throw std::runtime_error("Buffer is not dynamic");
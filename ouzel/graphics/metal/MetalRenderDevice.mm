@@ -286,26 +286,19 @@ namespace ouzel
                 RenderTarget* currentRenderTarget = nullptr;
                 Shader* currentShader = nullptr;
 
-                CommandBuffer commandBuffer;
-                std::unique_ptr<Command> command;
-
                 for (;;)
                 {
-                    std::unique_lock<std::mutex> lock(commandQueueMutex);
-                    while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                    commandBuffer = std::move(commandQueue.front());
-                    commandQueue.pop();
-                    lock.unlock();
+                    CommandBuffer commandBuffer = popCommandBuffer();
 
                     while (!commandBuffer.isEmpty())
                     {
-                        command = commandBuffer.popCommand();
+                        const Command* command = commandBuffer.popCommand();
 
                         switch (command->type)
                         {
                             case Command::Type::Resize:
                             {
-                                auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                                auto resizeCommand = static_cast<const ResizeCommand*>(command);
                                 const CGSize drawableSize = CGSizeMake(resizeCommand->size.v[0],
                                                                        resizeCommand->size.v[1]);
                                 metalLayer.drawableSize = drawableSize;
@@ -327,14 +320,14 @@ namespace ouzel
 
                             case Command::Type::DeleteResource:
                             {
-                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                                 resources[deleteResourceCommand->resource - 1].reset();
                                 break;
                             }
 
                             case Command::Type::InitRenderTarget:
                             {
-                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                                 std::set<Texture*> colorTextures;
                                 for (const uintptr_t colorTextureId : initRenderTargetCommand->colorTextures)
@@ -352,7 +345,7 @@ namespace ouzel
 
                             case Command::Type::SetRenderTarget:
                             {
-                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                                 MTLRenderPassDescriptorPtr newRenderPassDescriptor;
 
@@ -398,7 +391,7 @@ namespace ouzel
 
                             case Command::Type::ClearRenderTarget:
                             {
-                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                                 if (currentRenderCommandEncoder)
                                     [currentRenderCommandEncoder endEncoding];
@@ -434,14 +427,14 @@ namespace ouzel
 
                             case Command::Type::Blit:
                             {
-                                //auto blitCommand = static_cast<const BlitCommand*>(command.get());
+                                //auto blitCommand = static_cast<const BlitCommand*>(command);
                                 //MTLBlitCommandEncoder
                                 break;
                             }
 
                             case Command::Type::SetScissorTest:
                             {
-                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                                 // create a new render command encoder to set up a new scissor rect
                                 if (currentRenderCommandEncoder)
@@ -463,7 +456,7 @@ namespace ouzel
 
                             case Command::Type::SetViewport:
                             {
-                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -483,7 +476,7 @@ namespace ouzel
 
                             case Command::Type::InitDepthStencilState:
                             {
-                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                                 auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                              initDepthStencilStateCommand->depthTest,
                                                                                              initDepthStencilStateCommand->depthWrite,
@@ -509,7 +502,7 @@ namespace ouzel
 
                             case Command::Type::SetDepthStencilState:
                             {
-                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -530,7 +523,7 @@ namespace ouzel
 
                             case Command::Type::SetPipelineState:
                             {
-                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -553,7 +546,8 @@ namespace ouzel
 
                             case Command::Type::Draw:
                             {
-                                auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                                auto drawCommand = static_cast<const DrawCommand*>(command);
+                                ++currentDrawCallCount;
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -585,12 +579,12 @@ namespace ouzel
 
                             case Command::Type::PushDebugMarker:
                             {
-                                auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
+                                auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
 
-                                [currentRenderCommandEncoder pushDebugGroup:static_cast<NSString* _Nonnull>([NSString stringWithUTF8String:pushDebugMarkerCommand->name.c_str()])];
+                                [currentRenderCommandEncoder pushDebugGroup:static_cast<NSString* _Nonnull>([NSString stringWithUTF8String:pushDebugMarkerCommand->name])];
                                 break;
                             }
 
@@ -607,7 +601,7 @@ namespace ouzel
 
                             case Command::Type::InitBlendState:
                             {
-                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                                 auto blendState = std::make_unique<BlendState>(*this,
                                                                                initBlendStateCommand->enableBlending,
@@ -627,7 +621,7 @@ namespace ouzel
 
                             case Command::Type::InitBuffer:
                             {
-                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                                 auto buffer = std::make_unique<Buffer>(*this,
                                                                         initBufferCommand->bufferType,
@@ -643,7 +637,7 @@ namespace ouzel
 
                             case Command::Type::SetBufferData:
                             {
-                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                                 Buffer* buffer = getResource<Buffer>(setBufferDataCommand->buffer);
                                 buffer->setData(setBufferDataCommand->data);
@@ -652,7 +646,7 @@ namespace ouzel
 
                             case Command::Type::InitShader:
                             {
-                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                                 auto shader = std::make_unique<Shader>(*this,
                                                                        initShaderCommand->fragmentShader,
@@ -673,7 +667,7 @@ namespace ouzel
 
                             case Command::Type::SetShaderConstants:
                             {
-                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -692,7 +686,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                    const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                                    const Span<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
 
                                     if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
                                         throw std::runtime_error("Invalid pixel shader constant size");
@@ -743,7 +737,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                    const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                                    const Span<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
 
                                     if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
                                         throw std::runtime_error("Invalid vertex shader constant size");
@@ -788,7 +782,7 @@ namespace ouzel
 
                             case Command::Type::InitTexture:
                             {
-                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                                 auto texture = std::make_unique<Texture>(*this,
                                                                          initTextureCommand->levels,
@@ -805,7 +799,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureData:
                             {
-                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureDataCommand->texture);
                                 texture->setData(setTextureDataCommand->levels);
@@ -815,7 +809,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureParameters:
                             {
-                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureParametersCommand->texture);
                                 texture->setFilter(setTextureParametersCommand->filter == SamplerFilter::Default ? textureFilter : setTextureParametersCommand->filter);
@@ -829,7 +823,7 @@ namespace ouzel
 
                             case Command::Type::SetTextures:
                             {
-                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                                 if (!currentRenderCommandEncoder)
                                     throw std::runtime_error("Metal render command encoder not initialized");
@@ -854,8 +848,14 @@ namespace ouzel
                             default: throw std::runtime_error("Invalid command");
                         }
 
-                        if (command->type == Command::Type::Present) return;
+                        if (command->type == Command::Type::Present)
+                        {
+                            recycleCommandBuffer(std::move(commandBuffer));
+                            return;
+                        }
                     }
+
+                    recycleCommandBuffer(std::move(commandBuffer));
                 }
             }
 
@@ -43,7 +43,7 @@ namespace ouzel
             {
                 displayLink.stop();
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
             }
 
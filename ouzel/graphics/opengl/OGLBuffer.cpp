@@ -13,6 +13,16 @@ namespace ouzel
     {
         namespace opengl
         {
+            namespace
+            {
+                GLenum getUsage(uint32_t flags) noexcept
+                {
+                    return (flags & Flags::Streaming) ? GL_STREAM_DRAW :
+                        (flags & Flags::Dynamic) ? GL_DYNAMIC_DRAW :
+                        GL_STATIC_DRAW;
+                }
+            }
+
             Buffer::Buffer(RenderDevice& initRenderDevice,
                            BufferType initType,
                            uint32_t initFlags,
@@ -32,10 +42,10 @@ namespace ouzel
 
                     if (data.empty())
                         renderDevice.glBufferDataProc(bufferType, size, nullptr,
-                                                      (flags & Flags::Dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                                                      getUsage(flags));
                     else
                         renderDevice.glBufferDataProc(bufferType, size, data.data(),
-                                                      (flags & Flags::Dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                                                      getUsage(flags));
 
                     GLenum error;
 
@@ -62,10 +72,10 @@ namespace ouzel
 
                     if (data.empty())
                         renderDevice.glBufferDataProc(bufferType, size, nullptr,
-                                                      (flags & Flags::Dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                                                      getUsage(flags));
                     else
                         renderDevice.glBufferDataProc(bufferType, size, data.data(),
-                                                      (flags & Flags::Dynamic) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                                                      getUsage(flags));
 
                     GLenum error;
 
@@ -74,7 +84,7 @@ namespace ouzel
                 }
             }
 
-            void Buffer::setData(const std::vector<uint8_t>& newData)
+            void Buffer::setData(Span<uint8_t> newData)
             {
                 if (!(flags & Flags::Dynamic))
                     throw std::runtime_error("Buffer is not dynamic");
@@ -82,13 +92,31 @@ namespace ouzel
                 if (newData.empty())
                     throw std::invalid_argument("Data is empty");
 
-                data = newData;
-
                 if (!bufferId)
                     throw std::runtime_error("Buffer not initialized");
 
                 renderDevice.bindBuffer(bufferType, bufferId);
 
+                if (flags & Flags::Streaming)
+                {
+                    // the contents are not preserved for reload, they are replaced by the next update anyway
+                    if (static_cast<GLsizeiptr>(newData.size()) > size)
+                        size = static_cast<GLsizeiptr>(newData.size());
+
+                    // orphan the previous storage, so that the driver doesn't wait for the draws that still read it
+                    renderDevice.glBufferDataProc(bufferType, size, nullptr, GL_STREAM_DRAW);
+                    renderDevice.glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(newData.size()), newData.data());
+
+                    GLenum error;
+
+                    if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
+                        throw std::system_error(makeErrorCode(error), "Failed to upload buffer");
+
+                    return;
+                }
+
+                data.assign(newData.begin(), newData.end());
+
                 if (static_cast<GLsizeiptr>(data.size()) > size)
                 {
                     size = static_cast<GLsizeiptr>(data.size());
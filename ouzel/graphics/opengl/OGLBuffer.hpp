@@ -21,6 +21,7 @@
 
 #include "graphics/opengl/OGLRenderResource.hpp"
 #include "graphics/BufferType.hpp"
+#include "utils/Span.hpp"
 
 namespace ouzel
 {
@@ -42,7 +43,7 @@ namespace ouzel
 
                 void reload() final;
 
-                void setData(const std::vector<uint8_t>& newData);
+                void setData(Span<uint8_t> newData);
 
                 inline auto getFlags() const noexcept { return flags; }
                 inline auto getType() const noexcept { return type; }
@@ -844,26 +844,19 @@ namespace ouzel
                 RenderTarget* currentRenderTarget = nullptr;
                 Shader* currentShader = nullptr;
 
-                CommandBuffer commandBuffer;
-                std::unique_ptr<Command> command;
-
                 for (;;)
                 {
-                    std::unique_lock<std::mutex> lock(commandQueueMutex);
-                    while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                    commandBuffer = std::move(commandQueue.front());
-                    commandQueue.pop();
-                    lock.unlock();
+                    CommandBuffer commandBuffer = popCommandBuffer();
 
                     while (!commandBuffer.isEmpty())
                     {
-                        command = commandBuffer.popCommand();
+                        const Command* command = commandBuffer.popCommand();
 
                         switch (command->type)
                         {
                             case Command::Type::Resize:
                             {
-                                auto resizeCommand = static_cast<const ResizeCommand*>(command.get());
+                                auto resizeCommand = static_cast<const ResizeCommand*>(command);
                                 frameBufferWidth = static_cast<GLsizei>(resizeCommand->size.v[0]);
                                 frameBufferHeight = static_cast<GLsizei>(resizeCommand->size.v[1]);
                                 resizeFrameBuffer();
@@ -878,14 +871,14 @@ namespace ouzel
 
                             case Command::Type::DeleteResource:
                             {
-                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                                 resources[deleteResourceCommand->resource - 1].reset();
                                 break;
                             }
 
                             case Command::Type::InitRenderTarget:
                             {
-                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command.get());
+                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
 
                                 std::set<Texture*> colorTextures;
                                 for (const uintptr_t colorTextureId : initRenderTargetCommand->colorTextures)
@@ -903,7 +896,7 @@ namespace ouzel
 
                             case Command::Type::SetRenderTarget:
                             {
-                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                                 if (setRenderTargetCommand->renderTarget)
                                 {
@@ -924,7 +917,7 @@ namespace ouzel
 
                             case Command::Type::ClearRenderTarget:
                             {
-                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                                 const GLbitfield clearMask = (clearCommand->clearColorBuffer ? GL_COLOR_BUFFER_BIT : 0) |
                                     (clearCommand->clearDepthBuffer ? GL_DEPTH_BUFFER_BIT : 0 |
@@ -980,7 +973,7 @@ namespace ouzel
                             case Command::Type::Blit:
                             {
 #if !OUZEL_OPENGLES
-                                auto blitCommand = static_cast<const BlitCommand*>(command.get());
+                                auto blitCommand = static_cast<const BlitCommand*>(command);
 
                                 Texture* sourceTexture = getResource<Texture>(blitCommand->sourceTexture);
                                 Texture* destinationTexture = getResource<Texture>(blitCommand->destinationTexture);
@@ -1008,7 +1001,7 @@ namespace ouzel
 
                             case Command::Type::SetScissorTest:
                             {
-                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                                 setScissorTest(setScissorTestCommand->enabled,
                                                static_cast<GLint>(setScissorTestCommand->rectangle.position.v[0]),
@@ -1021,7 +1014,7 @@ namespace ouzel
 
                             case Command::Type::SetViewport:
                             {
-                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                                 setViewport(static_cast<GLint>(setViewportCommand->viewport.position.v[0]),
                                             static_cast<GLint>(setViewportCommand->viewport.position.v[1]),
@@ -1033,7 +1026,7 @@ namespace ouzel
 
                             case Command::Type::InitDepthStencilState:
                             {
-                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                                 auto depthStencilState = std::make_unique<DepthStencilState>(*this,
                                                                                              initDepthStencilStateCommand->depthTest,
                                                                                              initDepthStencilStateCommand->depthWrite,
@@ -1058,7 +1051,7 @@ namespace ouzel
 
                             case Command::Type::SetDepthStencilState:
                             {
-                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                                 if (setDepthStencilStateCommand->depthStencilState)
                                 {
@@ -1104,7 +1097,7 @@ namespace ouzel
 
                             case Command::Type::SetPipelineState:
                             {
-                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                                 BlendState* blendState = getResource<BlendState>(setPipelineStateCommand->blendState);
                                 Shader* shader = getResource<Shader>(setPipelineStateCommand->shader);
@@ -1154,7 +1147,8 @@ namespace ouzel
 
                             case Command::Type::Draw:
                             {
-                                auto drawCommand = static_cast<const DrawCommand*>(command.get());
+                                auto drawCommand = static_cast<const DrawCommand*>(command);
+                                ++currentDrawCallCount;
 
                                 // mesh buffer
                                 Buffer* indexBuffer = getResource<Buffer>(drawCommand->indexBuffer);
@@ -1207,8 +1201,8 @@ namespace ouzel
 
                             case Command::Type::PushDebugMarker:
                             {
-                                auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
-                                if (glPushGroupMarkerEXTProc) glPushGroupMarkerEXTProc(0, pushDebugMarkerCommand->name.c_str());
+                                auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command);
+                                if (glPushGroupMarkerEXTProc) glPushGroupMarkerEXTProc(0, pushDebugMarkerCommand->name);
                                 break;
                             }
 
@@ -1220,7 +1214,7 @@ namespace ouzel
 
                             case Command::Type::InitBlendState:
                             {
-                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                                 auto blendState = std::make_unique<BlendState>(*this,
                                                                                initBlendStateCommand->enableBlending,
@@ -1240,7 +1234,7 @@ namespace ouzel
 
                             case Command::Type::InitBuffer:
                             {
-                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                                 auto buffer = std::make_unique<Buffer>(*this,
                                                                        initBufferCommand->bufferType,
@@ -1256,7 +1250,7 @@ namespace ouzel
 
                             case Command::Type::SetBufferData:
                             {
-                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                                 Buffer* buffer = getResource<Buffer>(setBufferDataCommand->buffer);
                                 buffer->setData(setBufferDataCommand->data);
@@ -1265,7 +1259,7 @@ namespace ouzel
 
                             case Command::Type::InitShader:
                             {
-                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                                 auto shader = std::make_unique<Shader>(*this,
                                                                        initShaderCommand->fragmentShader,
@@ -1286,7 +1280,7 @@ namespace ouzel
 
                             case Command::Type::SetShaderConstants:
                             {
-                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                                 if (!currentShader)
                                     throw std::runtime_error("No shader set");
@@ -1300,7 +1294,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                    const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                                    const Span<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
 
                                     setUniform(fragmentShaderConstantLocation.location,
                                                fragmentShaderConstantLocation.dataType,
@@ -1316,7 +1310,7 @@ namespace ouzel
                                 for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
                                 {
                                     const Shader::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                    const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                                    const Span<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
 
                                     setUniform(vertexShaderConstantLocation.location,
                                                vertexShaderConstantLocation.dataType,
@@ -1328,7 +1322,7 @@ namespace ouzel
 
                             case Command::Type::InitTexture:
                             {
-                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                                 auto texture = std::make_unique<Texture>(*this,
                                                                          initTextureCommand->levels,
@@ -1345,7 +1339,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureData:
                             {
-                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureDataCommand->texture);
                                 texture->setData(setTextureDataCommand->levels);
@@ -1355,7 +1349,7 @@ namespace ouzel
 
                             case Command::Type::SetTextureParameters:
                             {
-                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                                 Texture* texture = getResource<Texture>(setTextureParametersCommand->texture);
                                 texture->setFilter(setTextureParametersCommand->filter == SamplerFilter::Default ? textureFilter : setTextureParametersCommand->filter);
@@ -1368,7 +1362,7 @@ namespace ouzel
 
                             case Command::Type::SetTextures:
                             {
-                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                                 for (uint32_t layer = 0; layer < setTexturesCommand->textures.size(); ++layer)
                                 {
@@ -1385,8 +1379,14 @@ namespace ouzel
                                 throw std::runtime_error("Invalid command");
                         }
 
-                        if (command->type == Command::Type::Present) return;
+                        if (command->type == Command::Type::Present)
+                        {
+                            recycleCommandBuffer(std::move(commandBuffer));
+                            return;
+                        }
                     }
+
+                    recycleCommandBuffer(std::move(commandBuffer));
                 }
             }
 
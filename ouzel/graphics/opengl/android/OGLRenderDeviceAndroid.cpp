@@ -61,7 +61,7 @@ namespace ouzel
             {
                 running = false;
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
 
                 if (renderThread.isJoinable()) renderThread.join();
@@ -202,7 +202,7 @@ namespace ouzel
             {
                 running = false;
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
 
                 if (renderThread.isJoinable()) renderThread.join();
@@ -314,7 +314,7 @@ namespace ouzel
             {
                 running = false;
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
 
                 if (renderThread.isJoinable()) renderThread.join();
@@ -66,7 +66,7 @@ namespace ouzel
             {
                 running = false;
                 CommandBuffer commandBuffer;
-                commandBuffer.pushCommand(std::make_unique<PresentCommand>());
+                commandBuffer.pushCommand<PresentCommand>();
                 submitCommandBuffer(std::move(commandBuffer));
 
                 if (renderThread.isJoinable()) renderThread.join();
@@ -0,0 +1,40 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include "SoftwareBlendState.hpp"
+#include "SoftwareRenderDevice.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            BlendState::BlendState(RenderDevice& initRenderDevice,
+                                   bool initBlendEnabled,
+                                   BlendFactor initColorBlendSource,
+                                   BlendFactor initColorBlendDest,
+                                   BlendOperation initColorOperation,
+                                   BlendFactor initAlphaBlendSource,
+                                   BlendFactor initAlphaBlendDest,
+                                   BlendOperation initAlphaOperation,
+                                   ColorMask initColorMask):
+                RenderResource(initRenderDevice),
+                blendEnabled(initBlendEnabled),
+                colorBlendSource(initColorBlendSource),
+                colorBlendDest(initColorBlendDest),
+                colorOperation(initColorOperation),
+                alphaBlendSource(initAlphaBlendSource),
+                alphaBlendDest(initAlphaBlendDest),
+                alphaOperation(initAlphaOperation),
+                colorMask(static_cast<uint8_t>(initColorMask))
+            {
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
@@ -0,0 +1,49 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <algorithm>
+#include <stdexcept>
+#include "SoftwareBuffer.hpp"
+#include "SoftwareRenderDevice.hpp"
+#include "graphics/Flags.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            Buffer::Buffer(RenderDevice& initRenderDevice,
+                           BufferType initType,
+                           uint32_t initFlags,
+                           const std::vector<uint8_t>& initData,
+                           uint32_t initSize):
+                RenderResource(initRenderDevice),
+                type(initType),
+                flags(initFlags),
+                data(initData)
+            {
+                if (data.size() < initSize) data.resize(initSize);
+            }
+
+            void Buffer::setData(Span<uint8_t> newData)
+            {
+                if (!(flags & Flags::Dynamic))
+                    throw std::runtime_error("Buffer is not dynamic");
+
+                if (newData.empty())
+                    throw std::invalid_argument("Data is empty");
+
+                // the buffer only grows, so that draws with a smaller data set don't reallocate it
+                if (newData.size() > data.size()) data.resize(newData.size());
+
+                std::copy(newData.begin(), newData.end(), data.begin());
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
@@ -0,0 +1,52 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
+#define OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <cstdint>
+#include <vector>
+#include "graphics/software/SoftwareRenderResource.hpp"
+#include "graphics/BufferType.hpp"
+#include "utils/Span.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+
+            class Buffer final: public RenderResource
+            {
+            public:
+                Buffer(RenderDevice& initRenderDevice,
+                       BufferType initType,
+                       uint32_t initFlags,
+                       const std::vector<uint8_t>& initData,
+                       uint32_t initSize);
+
+                void setData(Span<uint8_t> newData);
+
+                inline auto getFlags() const noexcept { return flags; }
+                inline auto getType() const noexcept { return type; }
+                inline auto getSize() const noexcept { return static_cast<uint32_t>(data.size()); }
+
+                inline auto& getData() const noexcept { return data; }
+
+            private:
+                BufferType type;
+                uint32_t flags = 0;
+                std::vector<uint8_t> data;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWAREBUFFER_HPP
@@ -0,0 +1,52 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include "SoftwareDepthStencilState.hpp"
+#include "SoftwareRenderDevice.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            DepthStencilState::DepthStencilState(RenderDevice& initRenderDevice,
+                                                 bool initDepthTest,
+                                                 bool initDepthWrite,
+                                                 CompareFunction initCompareFunction,
+                                                 bool initStencilEnabled,
+                                                 uint32_t initStencilReadMask,
+                                                 uint32_t initStencilWriteMask,
+                                                 StencilOperation initFrontFaceStencilFailureOperation,
+                                                 StencilOperation initFrontFaceStencilDepthFailureOperation,
+                                                 StencilOperation initFrontFaceStencilPassOperation,
+                                                 CompareFunction initFrontFaceStencilCompareFunction,
+                                                 StencilOperation initBackFaceStencilFailureOperation,
+                                                 StencilOperation initBackFaceStencilDepthFailureOperation,
+                                                 StencilOperation initBackFaceStencilPassOperation,
+                                                 CompareFunction initBackFaceStencilCompareFunction):
+                RenderResource(initRenderDevice),
+                depthTest(initDepthTest),
+                depthWrite(initDepthWrite),
+                compareFunction(initCompareFunction),
+                stencilTest(initStencilEnabled),
+                stencilReadMask(static_cast<uint8_t>(initStencilReadMask)),
+                stencilWriteMask(static_cast<uint8_t>(initStencilWriteMask)),
+                frontFaceFail(initFrontFaceStencilFailureOperation),
+                frontFaceDepthFail(initFrontFaceStencilDepthFailureOperation),
+                frontFacePass(initFrontFaceStencilPassOperation),
+                frontFaceFunction(initFrontFaceStencilCompareFunction),
+                backFaceFail(initBackFaceStencilFailureOperation),
+                backFaceDepthFail(initBackFaceStencilDepthFailureOperation),
+                backFacePass(initBackFaceStencilPassOperation),
+                backFaceFunction(initBackFaceStencilCompareFunction)
+            {
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWAREDEPTHSTENCILSTATE_HPP
+#define OUZEL_GRAPHICS_SOFTWAREDEPTHSTENCILSTATE_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <cstdint>
+#include "graphics/software/SoftwareRenderResource.hpp"
+#include "graphics/CompareFunction.hpp"
+#include "graphics/StencilOperation.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+
+            class DepthStencilState final: public RenderResource
+            {
+            public:
+                DepthStencilState(RenderDevice& initRenderDevice,
+                                  bool initDepthTest,
+                                  bool initDepthWrite,
+                                  CompareFunction initCompareFunction,
+                                  bool initStencilEnabled,
+                                  uint32_t initStencilReadMask,
+                                  uint32_t initStencilWriteMask,
+                                  StencilOperation initFrontFaceStencilFailureOperation,
+                                  StencilOperation initFrontFaceStencilDepthFailureOperation,
+                                  StencilOperation initFrontFaceStencilPassOperation,
+                                  CompareFunction initFrontFaceStencilCompareFunction,
+                                  StencilOperation initBackFaceStencilFailureOperation,
+                                  StencilOperation initBackFaceStencilDepthFailureOperation,
+                                  StencilOperation initBackFaceStencilPassOperation,
+                                  CompareFunction initBackFaceStencilCompareFunction);
+
+                inline auto getDepthTest() const noexcept { return depthTest; }
+                inline auto getDepthWrite() const noexcept { return depthWrite; }
+                inline auto getCompareFunction() const noexcept { return compareFunction; }
+
+                inline auto getStencilTest() const noexcept { return stencilTest; }
+                inline auto getStencilReadMask() const noexcept { return stencilReadMask; }
+                inline auto getStencilWriteMask() const noexcept { return stencilWriteMask; }
+                inline auto getFrontFaceFail() const noexcept { return frontFaceFail; }
+                inline auto getFrontFaceDepthFail() const noexcept { return frontFaceDepthFail; }
+                inline auto getFrontFacePass() const noexcept { return frontFacePass; }
+                inline auto getFrontFaceFunction() const noexcept { return frontFaceFunction; }
+                inline auto getBackFaceFail() const noexcept { return backFaceFail; }
+                inline auto getBackFaceDepthFail() const noexcept { return backFaceDepthFail; }
+                inline auto getBackFacePass() const noexcept { return backFacePass; }
+                inline auto getBackFaceFunction() const noexcept { return backFaceFunction; }
+
+            private:
+                bool depthTest = false;
+                bool depthWrite = false;
+                CompareFunction compareFunction = CompareFunction::AlwaysPass;
+                bool stencilTest = false;
+                uint8_t stencilReadMask = 0xFF;
+                uint8_t stencilWriteMask = 0xFF;
+                StencilOperation frontFaceFail = StencilOperation::Keep;
+                StencilOperation frontFaceDepthFail = StencilOperation::Keep;
+                StencilOperation frontFacePass = StencilOperation::Keep;
+                CompareFunction frontFaceFunction = CompareFunction::AlwaysPass;
+                StencilOperation backFaceFail = StencilOperation::Keep;
+                StencilOperation backFaceDepthFail = StencilOperation::Keep;
+                StencilOperation backFacePass = StencilOperation::Keep;
+                CompareFunction backFaceFunction = CompareFunction::AlwaysPass;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWAREDEPTHSTENCILSTATE_HPP
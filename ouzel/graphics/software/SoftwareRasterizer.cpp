@@ -0,0 +1,934 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "SoftwareRasterizer.hpp"
+#include "SoftwareTexture.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            namespace
+            {
+                // flush the queued primitives when there are too many of them to keep the memory bounded
+                constexpr size_t MAX_QUEUED_PRIMITIVES = 65536;
+
+                constexpr size_t CLIP_PLANE_COUNT = 6;
+                constexpr size_t MAX_POLYGON_SIZE = 3 + CLIP_PLANE_COUNT;
+
+                // distance from the clip volume plane (D3D convention, 0 <= z <= w)
+                inline float getClipDistance(const Rasterizer::Vertex& vertex, size_t plane) noexcept
+                {
+                    const float* position = vertex.position;
+
+                    switch (plane)
+                    {
+                        case 0: return position[3] + position[0];
+                        case 1: return position[3] - position[0];
+                        case 2: return position[3] + position[1];
+                        case 3: return position[3] - position[1];
+                        case 4: return position[2];
+                        case 5: return position[3] - position[2];
+                        default: return 0.0F;
+                    }
+                }
+
+                inline uint32_t getOutCode(const Rasterizer::Vertex& vertex) noexcept
+                {
+                    uint32_t result = 0;
+                    for (size_t plane = 0; plane < CLIP_PLANE_COUNT; ++plane)
+                        if (getClipDistance(vertex, plane) < 0.0F) result |= 1U << plane;
+                    return result;
+                }
+
+                inline Rasterizer::Vertex lerpVertex(const Rasterizer::Vertex& vertex0,
+                                                     const Rasterizer::Vertex& vertex1,
+                                                     float t) noexcept
+                {
+                    Rasterizer::Vertex result;
+                    for (size_t i = 0; i < 4; ++i)
+                        result.position[i] = vertex0.position[i] + (vertex1.position[i] - vertex0.position[i]) * t;
+                    for (size_t i = 0; i < Rasterizer::ATTRIBUTE_COUNT; ++i)
+                        result.attributes[i] = vertex0.attributes[i] + (vertex1.attributes[i] - vertex0.attributes[i]) * t;
+                    return result;
+                }
+
+                inline bool compare(CompareFunction compareFunction, float value, float reference) noexcept
+                {
+                    switch (compareFunction)
+                    {
+                        case CompareFunction::NeverPass: return false;
+                        case CompareFunction::PassIfLess: return value < reference;
+                        case CompareFunction::PassIfEqual: return value == reference;
+                        case CompareFunction::PassIfLessEqual: return value <= reference;
+                        case CompareFunction::PassIfGreater: return value > reference;
+                        case CompareFunction::PassIfNotEqual: return value != reference;
+                        case CompareFunction::PassIfGreaterEqual: return value >= reference;
+                        case CompareFunction::AlwaysPass: return true;
+                        default: return false;
+                    }
+                }
+
+                inline uint8_t applyStencilOperation(StencilOperation operation,
+                                                     uint8_t value,
+                                                     uint8_t reference,
+                                                     uint8_t writeMask) noexcept
+                {
+                    uint8_t result;
+
+                    switch (operation)
+                    {
+                        case StencilOperation::Keep: return value;
+                        case StencilOperation::Zero: result = 0; break;
+                        case StencilOperation::Replace: result = reference; break;
+                        case StencilOperation::IncrementClamp: result = (value == 0xFF) ? value : static_cast<uint8_t>(value + 1); break;
+                        case StencilOperation::DecrementClamp: result = (value == 0) ? value : static_cast<uint8_t>(value - 1); break;
+                        case StencilOperation::Invert: result = static_cast<uint8_t>(~value); break;
+                        case StencilOperation::IncrementWrap: result = static_cast<uint8_t>(value + 1); break;
+                        case StencilOperation::DecrementWrap: result = static_cast<uint8_t>(value - 1); break;
+                        default: return value;
+                    }
+
+                    return static_cast<uint8_t>((value & ~writeMask) | (result & writeMask));
+                }
+
+                inline uint32_t getColorWriteMask(uint8_t colorMask) noexcept
+                {
+                    const uint8_t bytes[4] = {
+                        static_cast<uint8_t>((colorMask & 0x01) ? 0xFF : 0x00),
+                        static_cast<uint8_t>((colorMask & 0x02) ? 0xFF : 0x00),
+                        static_cast<uint8_t>((colorMask & 0x04) ? 0xFF : 0x00),
+                        static_cast<uint8_t>((colorMask & 0x08) ? 0xFF : 0x00)
+                    };
+                    uint32_t result;
+                    std::memcpy(&result, bytes, sizeof(result));
+                    return result;
+                }
+
+                // value = a * x + b * y + c for all of the values
+                inline void evaluatePlanes(const float* a, const float* b, const float* c,
+                                           float x, float y, float* result, size_t count) noexcept
+                {
+#if defined(__SSE2__)
+                    const __m128 vx = _mm_set1_ps(x);
+                    const __m128 vy = _mm_set1_ps(y);
+                    for (size_t i = 0; i < count; i += 4)
+                        _mm_storeu_ps(&result[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&a[i]), vx),
+                                                                        _mm_mul_ps(_mm_loadu_ps(&b[i]), vy)),
+                                                             _mm_loadu_ps(&c[i])));
+#else
+                    for (size_t i = 0; i < count; ++i)
+                        result[i] = a[i] * x + b[i] * y + c[i];
+#endif
+                }
+
+#if defined(__SSE2__)
+                inline __m128 select(__m128 mask, __m128 a, __m128 b) noexcept
+                {
+                    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+                }
+
+                inline __m128 getBlendFactor(BlendFactor blendFactor, __m128 source, __m128 dest) noexcept
+                {
+                    const __m128 one = _mm_set1_ps(1.0F);
+
+                    switch (blendFactor)
+                    {
+                        case BlendFactor::Zero: return _mm_setzero_ps();
+                        case BlendFactor::One: return one;
+                        case BlendFactor::SrcColor: return source;
+                        case BlendFactor::InvSrcColor: return _mm_sub_ps(one, source);
+                        case BlendFactor::SrcAlpha: return _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+                        case BlendFactor::InvSrcAlpha: return _mm_sub_ps(one, _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3)));
+                        case BlendFactor::DestAlpha: return _mm_shuffle_ps(dest, dest, _MM_SHUFFLE(3, 3, 3, 3));
+                        case BlendFactor::InvDestAlpha: return _mm_sub_ps(one, _mm_shuffle_ps(dest, dest, _MM_SHUFFLE(3, 3, 3, 3)));
+                        case BlendFactor::DestColor: return dest;
+                        case BlendFactor::InvDestColor: return _mm_sub_ps(one, dest);
+                        case BlendFactor::SrcAlphaSat:
+                        {
+                            const __m128 sourceAlpha = _mm_shuffle_ps(source, source, _MM_SHUFFLE(3, 3, 3, 3));
+                            const __m128 invDestAlpha = _mm_sub_ps(one, _mm_shuffle_ps(dest, dest, _MM_SHUFFLE(3, 3, 3, 3)));
+                            // the alpha channel is multiplied by one
+                            return select(_mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)), one, _mm_min_ps(sourceAlpha, invDestAlpha));
+                        }
+                        case BlendFactor::BlendFactor: return one; // the blend factor is not settable, so it is always white
+                        case BlendFactor::InvBlendFactor: return _mm_setzero_ps();
+                        default: return _mm_setzero_ps();
+                    }
+                }
+
+                inline __m128 applyBlendOperation(BlendOperation blendOperation,
+                                                  __m128 source, __m128 sourceFactor,
+                                                  __m128 dest, __m128 destFactor) noexcept
+                {
+                    switch (blendOperation)
+                    {
+                        case BlendOperation::Add: return _mm_add_ps(_mm_mul_ps(source, sourceFactor), _mm_mul_ps(dest, destFactor));
+                        case BlendOperation::Subtract: return _mm_sub_ps(_mm_mul_ps(source, sourceFactor), _mm_mul_ps(dest, destFactor));
+                        case BlendOperation::RevSubtract: return _mm_sub_ps(_mm_mul_ps(dest, destFactor), _mm_mul_ps(source, sourceFactor));
+                        case BlendOperation::Min: return _mm_min_ps(source, dest);
+                        case BlendOperation::Max: return _mm_max_ps(source, dest);
+                        default: return source;
+                    }
+                }
+
+                void writeColor(const Rasterizer::State& state, uint8_t* pixel, const float fragment[4]) noexcept
+                {
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 one = _mm_set1_ps(1.0F);
+
+                    uint32_t previous;
+                    std::memcpy(&previous, pixel, sizeof(previous));
+
+                    __m128 result = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(fragment), zero), one);
+
+                    if (state.blendEnabled)
+                    {
+                        const __m128i zeroInt = _mm_setzero_si128();
+                        const __m128i destInt = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(previous)), zeroInt), zeroInt);
+                        const __m128 dest = _mm_mul_ps(_mm_cvtepi32_ps(destInt), _mm_set1_ps(1.0F / 255.0F));
+
+                        // the last lane holds the alpha channel
+                        const __m128 alphaLane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+                        const __m128 sourceFactor = select(alphaLane,
+                                                           getBlendFactor(state.alphaBlendSource, result, dest),
+                                                           getBlendFactor(state.colorBlendSource, result, dest));
+                        const __m128 destFactor = select(alphaLane,
+                                                         getBlendFactor(state.alphaBlendDest, result, dest),
+                                                         getBlendFactor(state.colorBlendDest, result, dest));
+
+                        result = select(alphaLane,
+                                        applyBlendOperation(state.alphaOperation, result, sourceFactor, dest, destFactor),
+                                        applyBlendOperation(state.colorOperation, result, sourceFactor, dest, destFactor));
+                        result = _mm_min_ps(_mm_max_ps(result, zero), one);
+                    }
+
+                    const __m128i resultInt = _mm_cvtps_epi32(_mm_mul_ps(result, _mm_set1_ps(255.0F)));
+                    const __m128i resultShort = _mm_packs_epi32(resultInt, resultInt);
+                    auto color = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(resultShort, resultShort)));
+
+                    const uint32_t writeMask = getColorWriteMask(state.colorMask);
+                    color = (color & writeMask) | (previous & ~writeMask);
+                    std::memcpy(pixel, &color, sizeof(color));
+                }
+#else
+                inline void getBlendFactor(BlendFactor blendFactor, const float source[4], const float dest[4], float result[4]) noexcept
+                {
+                    switch (blendFactor)
+                    {
+                        case BlendFactor::Zero: for (size_t i = 0; i < 4; ++i) result[i] = 0.0F; break;
+                        case BlendFactor::One: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F; break;
+                        case BlendFactor::SrcColor: for (size_t i = 0; i < 4; ++i) result[i] = source[i]; break;
+                        case BlendFactor::InvSrcColor: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F - source[i]; break;
+                        case BlendFactor::SrcAlpha: for (size_t i = 0; i < 4; ++i) result[i] = source[3]; break;
+                        case BlendFactor::InvSrcAlpha: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F - source[3]; break;
+                        case BlendFactor::DestAlpha: for (size_t i = 0; i < 4; ++i) result[i] = dest[3]; break;
+                        case BlendFactor::InvDestAlpha: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F - dest[3]; break;
+                        case BlendFactor::DestColor: for (size_t i = 0; i < 4; ++i) result[i] = dest[i]; break;
+                        case BlendFactor::InvDestColor: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F - dest[i]; break;
+                        case BlendFactor::SrcAlphaSat:
+                        {
+                            const float factor = std::min(source[3], 1.0F - dest[3]);
+                            result[0] = result[1] = result[2] = factor;
+                            result[3] = 1.0F;
+                            break;
+                        }
+                        case BlendFactor::BlendFactor: for (size_t i = 0; i < 4; ++i) result[i] = 1.0F; break; // the blend factor is not settable, so it is always white
+                        case BlendFactor::InvBlendFactor:
+                        default: for (size_t i = 0; i < 4; ++i) result[i] = 0.0F; break;
+                    }
+                }
+
+                inline float applyBlendOperation(BlendOperation blendOperation,
+                                                 float source, float sourceFactor,
+                                                 float dest, float destFactor) noexcept
+                {
+                    switch (blendOperation)
+                    {
+                        case BlendOperation::Add: return source * sourceFactor + dest * destFactor;
+                        case BlendOperation::Subtract: return source * sourceFactor - dest * destFactor;
+                        case BlendOperation::RevSubtract: return dest * destFactor - source * sourceFactor;
+                        case BlendOperation::Min: return std::min(source, dest);
+                        case BlendOperation::Max: return std::max(source, dest);
+                        default: return source;
+                    }
+                }
+
+                void writeColor(const Rasterizer::State& state, uint8_t* pixel, const float fragment[4]) noexcept
+                {
+                    float result[4];
+                    for (size_t i = 0; i < 4; ++i) result[i] = clamp(fragment[i], 0.0F, 1.0F);
+
+                    if (state.blendEnabled)
+                    {
+                        const float dest[4] = {
+                            pixel[0] / 255.0F, pixel[1] / 255.0F, pixel[2] / 255.0F, pixel[3] / 255.0F
+                        };
+
+                        float colorSourceFactor[4];
+                        float colorDestFactor[4];
+                        float alphaSourceFactor[4];
+                        float alphaDestFactor[4];
+                        getBlendFactor(state.colorBlendSource, result, dest, colorSourceFactor);
+                        getBlendFactor(state.colorBlendDest, result, dest, colorDestFactor);
+                        getBlendFactor(state.alphaBlendSource, result, dest, alphaSourceFactor);
+                        getBlendFactor(state.alphaBlendDest, result, dest, alphaDestFactor);
+
+                        const float source[4] = {result[0], result[1], result[2], result[3]};
+                        for (size_t i = 0; i < 3; ++i)
+                            result[i] = clamp(applyBlendOperation(state.colorOperation, source[i], colorSourceFactor[i], dest[i], colorDestFactor[i]), 0.0F, 1.0F);
+                        result[3] = clamp(applyBlendOperation(state.alphaOperation, source[3], alphaSourceFactor[3], dest[3], alphaDestFactor[3]), 0.0F, 1.0F);
+                    }
+
+                    uint8_t bytes[4];
+                    for (size_t i = 0; i < 4; ++i)
+                        bytes[i] = static_cast<uint8_t>(result[i] * 255.0F + 0.5F);
+
+                    uint32_t previous;
+                    uint32_t color;
+                    std::memcpy(&previous, pixel, sizeof(previous));
+                    std::memcpy(&color, bytes, sizeof(color));
+
+                    const uint32_t writeMask = getColorWriteMask(state.colorMask);
+                    color = (color & writeMask) | (previous & ~writeMask);
+                    std::memcpy(pixel, &color, sizeof(color));
+                }
+#endif
+            }
+
+            constexpr int32_t Rasterizer::TILE_SIZE;
+            constexpr size_t Rasterizer::ATTRIBUTE_COUNT;
+            constexpr size_t Rasterizer::VALUE_COUNT;
+
+            Rasterizer::Rasterizer(uint32_t workerCount)
+            {
+                for (uint32_t i = 0; i < workerCount; ++i)
+                    workers.emplace_back(&Rasterizer::workerMain, this);
+            }
+
+            Rasterizer::~Rasterizer()
+            {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                running = false;
+                lock.unlock();
+                jobCondition.notify_all();
+
+                for (Thread& worker : workers)
+                    if (worker.isJoinable()) worker.join();
+            }
+
+            void Rasterizer::setTarget(const Target& newTarget)
+            {
+                if (newTarget.color == target.color &&
+                    newTarget.depth == target.depth &&
+                    newTarget.stencil == target.stencil &&
+                    newTarget.width == target.width &&
+                    newTarget.height == target.height)
+                    return;
+
+                flush();
+
+                target = newTarget;
+                tilesX = (target.width + TILE_SIZE - 1) / TILE_SIZE;
+                tilesY = (target.height + TILE_SIZE - 1) / TILE_SIZE;
+                bins.resize(tilesX * tilesY);
+            }
+
+            void Rasterizer::setState(const State& newState)
+            {
+                states.push_back(newState);
+
+                // the clip rectangle can't be larger than the target
+                State& state = states.back();
+                state.clipRect[0] = std::max(state.clipRect[0], 0);
+                state.clipRect[1] = std::max(state.clipRect[1], 0);
+                state.clipRect[2] = std::min(state.clipRect[2], static_cast<int32_t>(target.width));
+                state.clipRect[3] = std::min(state.clipRect[3], static_cast<int32_t>(target.height));
+            }
+
+            Rasterizer::ScreenVertex Rasterizer::project(const Vertex& vertex) const noexcept
+            {
+                const State& state = states.back();
+                const float invW = 1.0F / vertex.position[3];
+
+                ScreenVertex result;
+                result.x = state.viewport[0] + (vertex.position[0] * invW + 1.0F) * 0.5F * state.viewport[2];
+                result.y = state.viewport[1] + (1.0F - vertex.position[1] * invW) * 0.5F * state.viewport[3];
+                result.values[0] = clamp(vertex.position[2] * invW, 0.0F, 1.0F);
+                result.values[1] = invW;
+                for (size_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+                    result.values[2 + i] = vertex.attributes[i] * invW;
+
+                return result;
+            }
+
+            void Rasterizer::drawPoint(const Vertex& vertex)
+            {
+                if (states.empty() || getOutCode(vertex)) return;
+
+                addPoint(project(vertex));
+            }
+
+            void Rasterizer::drawLine(const Vertex& vertex0, const Vertex& vertex1)
+            {
+                if (states.empty()) return;
+
+                const uint32_t outCode0 = getOutCode(vertex0);
+                const uint32_t outCode1 = getOutCode(vertex1);
+
+                if (outCode0 & outCode1) return; // both of the points are outside of the same plane
+
+                if (!(outCode0 | outCode1))
+                {
+                    addLine(project(vertex0), project(vertex1));
+                    return;
+                }
+
+                float t0 = 0.0F;
+                float t1 = 1.0F;
+
+                for (size_t plane = 0; plane < CLIP_PLANE_COUNT; ++plane)
+                {
+                    const float distance0 = getClipDistance(vertex0, plane);
+                    const float distance1 = getClipDistance(vertex1, plane);
+
+                    if (distance0 < 0.0F && distance1 < 0.0F) return;
+
+                    if (distance0 < 0.0F)
+                        t0 = std::max(t0, distance0 / (distance0 - distance1));
+                    else if (distance1 < 0.0F)
+                        t1 = std::min(t1, distance0 / (distance0 - distance1));
+                }
+
+                if (t0 > t1) return;
+
+                addLine(project(lerpVertex(vertex0, vertex1, t0)),
+                        project(lerpVertex(vertex0, vertex1, t1)));
+            }
+
+            void Rasterizer::drawTriangle(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2)
+            {
+                if (states.empty()) return;
+
+                const uint32_t outCode0 = getOutCode(vertex0);
+                const uint32_t outCode1 = getOutCode(vertex1);
+                const uint32_t outCode2 = getOutCode(vertex2);
+
+                if (outCode0 & outCode1 & outCode2) return; // all of the points are outside of the same plane
+
+                Vertex polygon[MAX_POLYGON_SIZE] = {vertex0, vertex1, vertex2};
+                size_t count = 3;
+
+                if (outCode0 | outCode1 | outCode2)
+                {
+                    // Sutherland-Hodgman clipping against the planes that the triangle crosses
+                    const uint32_t outCode = outCode0 | outCode1 | outCode2;
+                    Vertex clipped[MAX_POLYGON_SIZE];
+
+                    for (size_t plane = 0; plane < CLIP_PLANE_COUNT && count >= 3; ++plane)
+                    {
+                        if (!(outCode & (1U << plane))) continue;
+
+                        size_t clippedCount = 0;
+
+                        for (size_t i = 0; i < count; ++i)
+                        {
+                            const Vertex& current = polygon[i];
+                            const Vertex& next = polygon[(i + 1) % count];
+                            const float currentDistance = getClipDistance(current, plane);
+                            const float nextDistance = getClipDistance(next, plane);
+
+                            if (currentDistance >= 0.0F)
+                                clipped[clippedCount++] = current;
+
+                            if ((currentDistance >= 0.0F) != (nextDistance >= 0.0F))
+                                clipped[clippedCount++] = lerpVertex(current, next, currentDistance / (currentDistance - nextDistance));
+                        }
+
+                        std::copy(clipped, clipped + clippedCount, polygon);
+                        count = clippedCount;
+                    }
+
+                    if (count < 3) return;
+                }
+
+                addPolygon(polygon, count);
+            }
+
+            void Rasterizer::addPolygon(const Vertex* polygon, size_t count)
+            {
+                // copied, because adding a primitive can flush the states
+                const State state = states.back();
+
+                ScreenVertex screenVertices[MAX_POLYGON_SIZE];
+                for (size_t i = 0; i < count; ++i)
+                    screenVertices[i] = project(polygon[i]);
+
+                // the winding is the same for the whole polygon, compute it from the full area
+                float area = 0.0F;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const ScreenVertex& current = screenVertices[i];
+                    const ScreenVertex& next = screenVertices[(i + 1) % count];
+                    area += current.x * next.y - next.x * current.y;
+                }
+
+                if (area == 0.0F || !std::isfinite(area)) return;
+
+                // clockwise triangles in window coordinates (y pointing down) are front facing
+                const bool frontFacing = area > 0.0F;
+
+                if ((state.cullMode == CullMode::Back && !frontFacing) ||
+                    (state.cullMode == CullMode::Front && frontFacing))
+                    return;
+
+                if (state.fillMode == FillMode::Wireframe)
+                {
+                    for (size_t i = 0; i < count; ++i)
+                        addLine(screenVertices[i], screenVertices[(i + 1) % count]);
+                    return;
+                }
+
+                for (size_t i = 1; i + 1 < count; ++i)
+                {
+                    const ScreenVertex* v[3] = {&screenVertices[0], &screenVertices[i], &screenVertices[i + 1]};
+
+                    float triangleArea = (v[1]->x - v[0]->x) * (v[2]->y - v[0]->y) -
+                        (v[2]->x - v[0]->x) * (v[1]->y - v[0]->y);
+
+                    if (triangleArea == 0.0F) continue;
+
+                    // make the triangle clockwise, so that the inside of every edge is positive
+                    if (triangleArea < 0.0F)
+                    {
+                        std::swap(v[1], v[2]);
+                        triangleArea = -triangleArea;
+                    }
+
+                    Primitive primitive;
+                    primitive.type = Primitive::Type::Triangle;
+                    primitive.state = static_cast<uint32_t>(states.size() - 1);
+                    primitive.frontFacing = frontFacing;
+
+                    const float minX = std::min({v[0]->x, v[1]->x, v[2]->x});
+                    const float minY = std::min({v[0]->y, v[1]->y, v[2]->y});
+                    const float maxX = std::max({v[0]->x, v[1]->x, v[2]->x});
+                    const float maxY = std::max({v[0]->y, v[1]->y, v[2]->y});
+
+                    primitive.minX = std::max(static_cast<int32_t>(std::floor(minX)), state.clipRect[0]);
+                    primitive.minY = std::max(static_cast<int32_t>(std::floor(minY)), state.clipRect[1]);
+                    primitive.maxX = std::min(static_cast<int32_t>(std::ceil(maxX)), state.clipRect[2]);
+                    primitive.maxY = std::min(static_cast<int32_t>(std::ceil(maxY)), state.clipRect[3]);
+
+                    if (primitive.minX >= primitive.maxX || primitive.minY >= primitive.maxY) continue;
+
+                    for (size_t edge = 0; edge < 3; ++edge)
+                    {
+                        const ScreenVertex& start = *v[edge];
+                        const ScreenVertex& end = *v[(edge + 1) % 3];
+                        const float dx = end.x - start.x;
+                        const float dy = end.y - start.y;
+
+                        primitive.edgeA[edge] = -dy;
+                        primitive.edgeB[edge] = dx;
+                        primitive.edgeC[edge] = dy * start.x - dx * start.y;
+
+                        // top-left fill rule, pixels exactly on the edge are covered only by left and top edges
+                        primitive.topLeft[edge] = (dy < 0.0F) || (dy == 0.0F && dx > 0.0F);
+                    }
+
+                    // gradients of the values in screen space
+                    const float dx1 = v[1]->x - v[0]->x;
+                    const float dy1 = v[1]->y - v[0]->y;
+                    const float dx2 = v[2]->x - v[0]->x;
+                    const float dy2 = v[2]->y - v[0]->y;
+                    const float invArea = 1.0F / triangleArea;
+
+#if defined(__SSE2__)
+                    for (size_t value = 0; value < VALUE_COUNT; value += 4)
+                    {
+                        const __m128 value0 = _mm_loadu_ps(&v[0]->values[value]);
+                        const __m128 delta1 = _mm_sub_ps(_mm_loadu_ps(&v[1]->values[value]), value0);
+                        const __m128 delta2 = _mm_sub_ps(_mm_loadu_ps(&v[2]->values[value]), value0);
+
+                        const __m128 a = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(delta1, _mm_set1_ps(dy2)),
+                                                               _mm_mul_ps(delta2, _mm_set1_ps(dy1))),
+                                                    _mm_set1_ps(invArea));
+                        const __m128 b = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(delta2, _mm_set1_ps(dx1)),
+                                                               _mm_mul_ps(delta1, _mm_set1_ps(dx2))),
+                                                    _mm_set1_ps(invArea));
+                        const __m128 c = _mm_sub_ps(_mm_sub_ps(value0, _mm_mul_ps(a, _mm_set1_ps(v[0]->x))),
+                                                    _mm_mul_ps(b, _mm_set1_ps(v[0]->y)));
+
+                        _mm_storeu_ps(&primitive.planeA[value], a);
+                        _mm_storeu_ps(&primitive.planeB[value], b);
+                        _mm_storeu_ps(&primitive.planeC[value], c);
+                    }
+#else
+                    for (size_t value = 0; value < VALUE_COUNT; ++value)
+                    {
+                        const float delta1 = v[1]->values[value] - v[0]->values[value];
+                        const float delta2 = v[2]->values[value] - v[0]->values[value];
+
+                        primitive.planeA[value] = (delta1 * dy2 - delta2 * dy1) * invArea;
+                        primitive.planeB[value] = (delta2 * dx1 - delta1 * dx2) * invArea;
+                        primitive.planeC[value] = v[0]->values[value] - primitive.planeA[value] * v[0]->x - primitive.planeB[value] * v[0]->y;
+                    }
+#endif
+
+                    addPrimitive(primitive);
+                }
+            }
+
+            void Rasterizer::addPoint(const ScreenVertex& vertex)
+            {
+                const State& state = states.back();
+
+                Primitive primitive;
+                primitive.type = Primitive::Type::Point;
+                primitive.state = static_cast<uint32_t>(states.size() - 1);
+                primitive.frontFacing = true;
+                primitive.vertices[0] = vertex;
+
+                primitive.minX = std::max(static_cast<int32_t>(std::floor(vertex.x)), state.clipRect[0]);
+                primitive.minY = std::max(static_cast<int32_t>(std::floor(vertex.y)), state.clipRect[1]);
+                primitive.maxX = std::min(static_cast<int32_t>(std::floor(vertex.x)) + 1, state.clipRect[2]);
+                primitive.maxY = std::min(static_cast<int32_t>(std::floor(vertex.y)) + 1, state.clipRect[3]);
+
+                if (primitive.minX >= primitive.maxX || primitive.minY >= primitive.maxY) return;
+
+                addPrimitive(primitive);
+            }
+
+            void Rasterizer::addLine(const ScreenVertex& vertex0, const ScreenVertex& vertex1)
+            {
+                const State& state = states.back();
+
+                Primitive primitive;
+                primitive.type = Primitive::Type::Line;
+                primitive.state = static_cast<uint32_t>(states.size() - 1);
+                primitive.frontFacing = true;
+                primitive.vertices[0] = vertex0;
+                primitive.vertices[1] = vertex1;
+
+                primitive.minX = std::max(static_cast<int32_t>(std::floor(std::min(vertex0.x, vertex1.x))), state.clipRect[0]);
+                primitive.minY = std::max(static_cast<int32_t>(std::floor(std::min(vertex0.y, vertex1.y))), state.clipRect[1]);
+                primitive.maxX = std::min(static_cast<int32_t>(std::floor(std::max(vertex0.x, vertex1.x))) + 1, state.clipRect[2]);
+                primitive.maxY = std::min(static_cast<int32_t>(std::floor(std::max(vertex0.y, vertex1.y))) + 1, state.clipRect[3]);
+
+                if (primitive.minX >= primitive.maxX || primitive.minY >= primitive.maxY) return;
+
+                addPrimitive(primitive);
+            }
+
+            void Rasterizer::addPrimitive(const Primitive& primitive)
+            {
+                const auto index = static_cast<uint32_t>(primitives.size());
+                primitives.push_back(primitive);
+
+                const auto firstTileX = static_cast<uint32_t>(primitive.minX / TILE_SIZE);
+                const auto firstTileY = static_cast<uint32_t>(primitive.minY / TILE_SIZE);
+                const auto lastTileX = static_cast<uint32_t>((primitive.maxX - 1) / TILE_SIZE);
+                const auto lastTileY = static_cast<uint32_t>((primitive.maxY - 1) / TILE_SIZE);
+
+                for (uint32_t tileY = firstTileY; tileY <= lastTileY; ++tileY)
+                    for (uint32_t tileX = firstTileX; tileX <= lastTileX; ++tileX)
+                        bins[tileY * tilesX + tileX].push_back(index);
+
+                if (primitives.size() >= MAX_QUEUED_PRIMITIVES)
+                {
+                    // keep the current state for the primitives that follow
+                    const State state = states.back();
+                    flush();
+                    states.push_back(state);
+                }
+            }
+
+            void Rasterizer::flush()
+            {
+                if (!primitives.empty())
+                {
+                    std::unique_lock<std::mutex> lock(jobMutex);
+                    ++jobGeneration;
+                    activeWorkers = static_cast<uint32_t>(workers.size());
+                    nextTile = 0;
+                    lock.unlock();
+                    jobCondition.notify_all();
+
+                    // the calling thread shades tiles too
+                    processTiles();
+
+                    lock.lock();
+                    while (activeWorkers) doneCondition.wait(lock);
+                    lock.unlock();
+
+                    primitives.clear();
+                    for (auto& bin : bins) bin.clear();
+                }
+
+                states.clear();
+            }
+
+            void Rasterizer::workerMain()
+            {
+                Thread::setCurrentThreadName("Rasterizer");
+
+                uint64_t generation = 0;
+
+                for (;;)
+                {
+                    std::unique_lock<std::mutex> lock(jobMutex);
+                    while (running && jobGeneration == generation) jobCondition.wait(lock);
+                    if (!running) break;
+                    generation = jobGeneration;
+                    lock.unlock();
+
+                    processTiles();
+
+                    lock.lock();
+                    if (--activeWorkers == 0)
+                    {
+                        lock.unlock();
+                        doneCondition.notify_all();
+                    }
+                }
+            }
+
+            void Rasterizer::processTiles()
+            {
+                const uint32_t tileCount = tilesX * tilesY;
+
+                for (;;)
+                {
+                    const uint32_t tile = nextTile++;
+                    if (tile >= tileCount) break;
+                    if (!bins[tile].empty()) processTile(tile);
+                }
+            }
+
+            void Rasterizer::processTile(uint32_t tile)
+            {
+                const int32_t tileMinX = static_cast<int32_t>(tile % tilesX) * TILE_SIZE;
+                const int32_t tileMinY = static_cast<int32_t>(tile / tilesX) * TILE_SIZE;
+                const int32_t tileMaxX = std::min(tileMinX + TILE_SIZE, static_cast<int32_t>(target.width));
+                const int32_t tileMaxY = std::min(tileMinY + TILE_SIZE, static_cast<int32_t>(target.height));
+
+                for (const uint32_t index : bins[tile])
+                {
+                    const Primitive& primitive = primitives[index];
+
+                    const int32_t rect[4] = {
+                        std::max(primitive.minX, tileMinX),
+                        std::max(primitive.minY, tileMinY),
+                        std::min(primitive.maxX, tileMaxX),
+                        std::min(primitive.maxY, tileMaxY)
+                    };
+
+                    if (rect[0] >= rect[2] || rect[1] >= rect[3]) continue;
+
+                    switch (primitive.type)
+                    {
+                        case Primitive::Type::Point: rasterizePoint(primitive, rect); break;
+                        case Primitive::Type::Line: rasterizeLine(primitive, rect); break;
+                        case Primitive::Type::Triangle: rasterizeTriangle(primitive, rect); break;
+                    }
+                }
+            }
+
+            void Rasterizer::rasterizePoint(const Primitive& primitive, const int32_t rect[4])
+            {
+                shadePixel(states[primitive.state], primitive.frontFacing,
+                           rect[0], rect[1], primitive.vertices[0].values);
+            }
+
+            void Rasterizer::rasterizeLine(const Primitive& primitive, const int32_t rect[4])
+            {
+                const ScreenVertex& start = primitive.vertices[0];
+                const ScreenVertex& end = primitive.vertices[1];
+                const float dx = end.x - start.x;
+                const float dy = end.y - start.y;
+
+                // the last pixel is not drawn, so that the joints of line strips are not drawn twice
+                const auto steps = static_cast<int32_t>(std::ceil(std::max(std::fabs(dx), std::fabs(dy))));
+                if (steps <= 0) return;
+
+                const float invSteps = 1.0F / static_cast<float>(steps);
+                float values[VALUE_COUNT];
+                int32_t previousX = -1;
+                int32_t previousY = -1;
+
+                for (int32_t step = 0; step < steps; ++step)
+                {
+                    const float t = step * invSteps;
+                    const auto x = static_cast<int32_t>(std::floor(start.x + dx * t));
+                    const auto y = static_cast<int32_t>(std::floor(start.y + dy * t));
+
+                    if (x == previousX && y == previousY) continue;
+                    previousX = x;
+                    previousY = y;
+
+                    if (x < rect[0] || x >= rect[2] || y < rect[1] || y >= rect[3]) continue;
+
+                    for (size_t i = 0; i < VALUE_COUNT; ++i)
+                        values[i] = start.values[i] + (end.values[i] - start.values[i]) * t;
+
+                    shadePixel(states[primitive.state], primitive.frontFacing, x, y, values);
+                }
+            }
+
+            void Rasterizer::rasterizeTriangle(const Primitive& primitive, const int32_t rect[4])
+            {
+                const State& state = states[primitive.state];
+                float values[VALUE_COUNT];
+
+#if defined(__SSE2__)
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 offsets = _mm_set_ps(3.5F, 2.5F, 1.5F, 0.5F);
+                __m128 edgeA[3];
+                __m128 topLeft[3];
+                for (size_t edge = 0; edge < 3; ++edge)
+                {
+                    edgeA[edge] = _mm_set1_ps(primitive.edgeA[edge]);
+                    topLeft[edge] = _mm_castsi128_ps(_mm_set1_epi32(primitive.topLeft[edge] ? -1 : 0));
+                }
+
+                for (int32_t y = rect[1]; y < rect[3]; ++y)
+                {
+                    const float centerY = static_cast<float>(y) + 0.5F;
+
+                    __m128 rowValues[3];
+                    for (size_t edge = 0; edge < 3; ++edge)
+                        rowValues[edge] = _mm_set1_ps(primitive.edgeB[edge] * centerY + primitive.edgeC[edge]);
+
+                    // four pixels of the row at a time
+                    for (int32_t x = rect[0]; x < rect[2]; x += 4)
+                    {
+                        const __m128 positionX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+                        __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                        for (size_t edge = 0; edge < 3; ++edge)
+                        {
+                            const __m128 edgeValue = _mm_add_ps(_mm_mul_ps(edgeA[edge], positionX), rowValues[edge]);
+                            const __m128 inside = _mm_or_ps(_mm_cmpgt_ps(edgeValue, zero),
+                                                            _mm_and_ps(_mm_cmpeq_ps(edgeValue, zero), topLeft[edge]));
+                            mask = _mm_and_ps(mask, inside);
+                        }
+
+                        int coverage = _mm_movemask_ps(mask);
+                        if (rect[2] - x < 4) coverage &= (1 << (rect[2] - x)) - 1;
+
+                        for (int32_t i = 0; coverage; ++i, coverage >>= 1)
+                        {
+                            if (!(coverage & 1)) continue;
+
+                            evaluatePlanes(primitive.planeA, primitive.planeB, primitive.planeC,
+                                           static_cast<float>(x + i) + 0.5F, centerY, values, VALUE_COUNT);
+                            shadePixel(state, primitive.frontFacing, x + i, y, values);
+                        }
+                    }
+                }
+#else
+                for (int32_t y = rect[1]; y < rect[3]; ++y)
+                {
+                    const float centerY = static_cast<float>(y) + 0.5F;
+
+                    for (int32_t x = rect[0]; x < rect[2]; ++x)
+                    {
+                        const float centerX = static_cast<float>(x) + 0.5F;
+
+                        bool inside = true;
+                        for (size_t edge = 0; edge < 3 && inside; ++edge)
+                        {
+                            const float edgeValue = primitive.edgeA[edge] * centerX + primitive.edgeB[edge] * centerY + primitive.edgeC[edge];
+                            inside = edgeValue > 0.0F || (edgeValue == 0.0F && primitive.topLeft[edge]);
+                        }
+
+                        if (!inside) continue;
+
+                        evaluatePlanes(primitive.planeA, primitive.planeB, primitive.planeC,
+                                       centerX, centerY, values, VALUE_COUNT);
+                        shadePixel(state, primitive.frontFacing, x, y, values);
+                    }
+                }
+#endif
+            }
+
+            void Rasterizer::shadePixel(const State& pixelState, bool frontFacing,
+                                        int32_t x, int32_t y, const float values[VALUE_COUNT])
+            {
+                const size_t index = static_cast<size_t>(y) * target.width + static_cast<size_t>(x);
+                const float depth = clamp(values[0], 0.0F, 1.0F);
+
+                const bool stencilTest = pixelState.stencilTest && target.stencil;
+                uint8_t* stencil = stencilTest ? &target.stencil[index] : nullptr;
+
+                if (stencilTest)
+                {
+                    const CompareFunction stencilFunction = frontFacing ? pixelState.frontFaceFunction : pixelState.backFaceFunction;
+
+                    if (!compare(stencilFunction,
+                                 static_cast<float>(pixelState.stencilReference & pixelState.stencilReadMask),
+                                 static_cast<float>(*stencil & pixelState.stencilReadMask)))
+                    {
+                        *stencil = applyStencilOperation(frontFacing ? pixelState.frontFaceFail : pixelState.backFaceFail,
+                                                         *stencil, pixelState.stencilReference, pixelState.stencilWriteMask);
+                        return;
+                    }
+                }
+
+                if (pixelState.depthTest && target.depth)
+                {
+                    if (!compare(pixelState.depthFunction, depth, target.depth[index]))
+                    {
+                        if (stencilTest)
+                            *stencil = applyStencilOperation(frontFacing ? pixelState.frontFaceDepthFail : pixelState.backFaceDepthFail,
+                                                             *stencil, pixelState.stencilReference, pixelState.stencilWriteMask);
+                        return;
+                    }
+
+                    if (pixelState.depthWrite) target.depth[index] = depth;
+                }
+
+                if (stencilTest)
+                    *stencil = applyStencilOperation(frontFacing ? pixelState.frontFacePass : pixelState.backFacePass,
+                                                     *stencil, pixelState.stencilReference, pixelState.stencilWriteMask);
+
+                if (!target.color || !pixelState.colorMask) return;
+
+                // undo the perspective division of the attributes
+                const float w = 1.0F / values[1];
+
+                float fragment[4] = {
+                    values[2] * w * pixelState.color[0],
+                    values[3] * w * pixelState.color[1],
+                    values[4] * w * pixelState.color[2],
+                    values[5] * w * pixelState.color[3]
+                };
+
+                if (pixelState.texture)
+                {
+                    float texel[4];
+                    pixelState.texture->sample(values[6] * w, values[7] * w, texel);
+                    for (size_t i = 0; i < 4; ++i) fragment[i] *= texel[i];
+                }
+
+                writeColor(pixelState, &target.color[index * 4], fragment);
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
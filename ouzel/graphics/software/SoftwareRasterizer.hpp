@@ -0,0 +1,196 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
+#define OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "graphics/BlendFactor.hpp"
+#include "graphics/BlendOperation.hpp"
+#include "graphics/CompareFunction.hpp"
+#include "graphics/RasterizerState.hpp"
+#include "graphics/StencilOperation.hpp"
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class Texture;
+
+            // Clips and sets up primitives on the calling thread and bins them into screen tiles,
+            // the tiles are shaded in parallel on a pool of worker threads when the rasterizer is flushed.
+            // Queued primitives reference the target and the textures of their state, so the rasterizer
+            // must be flushed before any of them is modified or deleted.
+            class Rasterizer final
+            {
+            public:
+                static constexpr int32_t TILE_SIZE = 64;
+                static constexpr size_t ATTRIBUTE_COUNT = 6; // color RGBA and texture coordinates
+
+                struct Target final
+                {
+                    uint8_t* color = nullptr; // RGBA8
+                    float* depth = nullptr;
+                    uint8_t* stencil = nullptr;
+                    uint32_t width = 0;
+                    uint32_t height = 0;
+                };
+
+                struct State final
+                {
+                    float viewport[4] = {0.0F, 0.0F, 0.0F, 0.0F}; // x, y, width, height
+                    int32_t clipRect[4] = {0, 0, 0, 0}; // min x, min y, max x, max y (exclusive)
+                    CullMode cullMode = CullMode::NoCull;
+                    FillMode fillMode = FillMode::Solid;
+
+                    bool blendEnabled = false;
+                    BlendFactor colorBlendSource = BlendFactor::One;
+                    BlendFactor colorBlendDest = BlendFactor::Zero;
+                    BlendOperation colorOperation = BlendOperation::Add;
+                    BlendFactor alphaBlendSource = BlendFactor::One;
+                    BlendFactor alphaBlendDest = BlendFactor::Zero;
+                    BlendOperation alphaOperation = BlendOperation::Add;
+                    uint8_t colorMask = 0x0F;
+
+                    bool depthTest = false;
+                    bool depthWrite = false;
+                    CompareFunction depthFunction = CompareFunction::AlwaysPass;
+
+                    bool stencilTest = false;
+                    uint8_t stencilReadMask = 0xFF;
+                    uint8_t stencilWriteMask = 0xFF;
+                    uint8_t stencilReference = 0;
+                    StencilOperation frontFaceFail = StencilOperation::Keep;
+                    StencilOperation frontFaceDepthFail = StencilOperation::Keep;
+                    StencilOperation frontFacePass = StencilOperation::Keep;
+                    CompareFunction frontFaceFunction = CompareFunction::AlwaysPass;
+                    StencilOperation backFaceFail = StencilOperation::Keep;
+                    StencilOperation backFaceDepthFail = StencilOperation::Keep;
+                    StencilOperation backFacePass = StencilOperation::Keep;
+                    CompareFunction backFaceFunction = CompareFunction::AlwaysPass;
+
+                    const Texture* texture = nullptr;
+                    float color[4] = {1.0F, 1.0F, 1.0F, 1.0F};
+                };
+
+                // clip space vertex
+                struct Vertex final
+                {
+                    float position[4];
+                    float attributes[ATTRIBUTE_COUNT];
+                };
+
+                explicit Rasterizer(uint32_t workerCount);
+                ~Rasterizer();
+
+                Rasterizer(const Rasterizer&) = delete;
+                Rasterizer& operator=(const Rasterizer&) = delete;
+
+                Rasterizer(Rasterizer&&) = delete;
+                Rasterizer& operator=(Rasterizer&&) = delete;
+
+                void setTarget(const Target& newTarget);
+                inline auto& getTarget() const noexcept { return target; }
+
+                // all the primitives drawn after this call use the given state
+                void setState(const State& newState);
+
+                void drawPoint(const Vertex& vertex);
+                void drawLine(const Vertex& vertex0, const Vertex& vertex1);
+                void drawTriangle(const Vertex& vertex0, const Vertex& vertex1, const Vertex& vertex2);
+
+                void flush();
+
+                inline auto getWorkerCount() const noexcept { return static_cast<uint32_t>(workers.size()); }
+
+            private:
+                // depth, 1/w and the attributes divided by w, all of them are linear in screen space
+                static constexpr size_t VALUE_COUNT = 8;
+
+                struct ScreenVertex final
+                {
+                    float x;
+                    float y;
+                    float values[VALUE_COUNT];
+                };
+
+                struct Primitive final
+                {
+                    enum class Type
+                    {
+                        Point,
+                        Line,
+                        Triangle
+                    };
+
+                    Type type;
+                    uint32_t state;
+                    bool frontFacing;
+                    int32_t minX;
+                    int32_t minY;
+                    int32_t maxX; // exclusive
+                    int32_t maxY; // exclusive
+
+                    // points and lines
+                    ScreenVertex vertices[2];
+
+                    // triangles, value = a * x + b * y + c
+                    float edgeA[3];
+                    float edgeB[3];
+                    float edgeC[3];
+                    bool topLeft[3];
+                    float planeA[VALUE_COUNT];
+                    float planeB[VALUE_COUNT];
+                    float planeC[VALUE_COUNT];
+                };
+
+                ScreenVertex project(const Vertex& vertex) const noexcept;
+                void addPoint(const ScreenVertex& vertex);
+                void addLine(const ScreenVertex& vertex0, const ScreenVertex& vertex1);
+                void addPolygon(const Vertex* polygon, size_t count);
+                void addPrimitive(const Primitive& primitive);
+
+                void processTiles();
+                void processTile(uint32_t tile);
+                void rasterizePoint(const Primitive& primitive, const int32_t rect[4]);
+                void rasterizeLine(const Primitive& primitive, const int32_t rect[4]);
+                void rasterizeTriangle(const Primitive& primitive, const int32_t rect[4]);
+                void shadePixel(const State& pixelState, bool frontFacing,
+                                int32_t x, int32_t y, const float values[VALUE_COUNT]);
+
+                void workerMain();
+
+                Target target;
+                uint32_t tilesX = 0;
+                uint32_t tilesY = 0;
+
+                std::vector<State> states;
+                std::vector<Primitive> primitives;
+                std::vector<std::vector<uint32_t>> bins;
+
+                std::vector<Thread> workers;
+                std::mutex jobMutex;
+                std::condition_variable jobCondition;
+                std::condition_variable doneCondition;
+                uint64_t jobGeneration = 0;
+                uint32_t activeWorkers = 0;
+                bool running = true;
+                std::atomic<uint32_t> nextTile{0};
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARERASTERIZER_HPP
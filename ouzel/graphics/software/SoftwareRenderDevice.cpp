@@ -0,0 +1,777 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#if defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include "SoftwareRenderDevice.hpp"
+#include "SoftwareBlendState.hpp"
+#include "SoftwareBuffer.hpp"
+#include "SoftwareDepthStencilState.hpp"
+#include "SoftwareRenderTarget.hpp"
+#include "SoftwareShader.hpp"
+#include "SoftwareTexture.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+#include "stb_image_write.h"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            namespace
+            {
+                inline void transformPosition(const float* matrix, const Vector3F& position, float* result) noexcept
+                {
+#if defined(__SSE__)
+                    // column-major matrix, result = column0 * x + column1 * y + column2 * z + column3
+                    const __m128 x = _mm_mul_ps(_mm_loadu_ps(&matrix[0]), _mm_set1_ps(position.v[0]));
+                    const __m128 y = _mm_mul_ps(_mm_loadu_ps(&matrix[4]), _mm_set1_ps(position.v[1]));
+                    const __m128 z = _mm_mul_ps(_mm_loadu_ps(&matrix[8]), _mm_set1_ps(position.v[2]));
+                    _mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, _mm_loadu_ps(&matrix[12]))));
+#else
+                    for (size_t i = 0; i < 4; ++i)
+                        result[i] = matrix[i] * position.v[0] + matrix[4 + i] * position.v[1] + matrix[8 + i] * position.v[2] + matrix[12 + i];
+#endif
+                }
+            }
+
+            RenderDevice::RenderDevice(const std::function<void(const Event&)>& initCallback):
+                graphics::RenderDevice(Driver::Software, initCallback)
+            {
+            }
+
+            RenderDevice::~RenderDevice()
+            {
+                running = false;
+                CommandBuffer commandBuffer;
+                commandBuffer.pushCommand<PresentCommand>();
+                submitCommandBuffer(std::move(commandBuffer));
+
+                if (renderThread.isJoinable()) renderThread.join();
+            }
+
+            void RenderDevice::init(Window* newWindow,
+                                    const Size2U& newSize,
+                                    uint32_t newSampleCount,
+                                    SamplerFilter newTextureFilter,
+                                    uint32_t newMaxAnisotropy,
+                                    bool newSrgb,
+                                    bool newVerticalSync,
+                                    bool newDepth,
+                                    bool newStencil,
+                                    bool newDebugRenderer)
+            {
+                graphics::RenderDevice::init(newWindow,
+                                             newSize,
+                                             newSampleCount,
+                                             newTextureFilter,
+                                             newMaxAnisotropy,
+                                             newSrgb,
+                                             newVerticalSync,
+                                             newDepth,
+                                             newStencil,
+                                             newDebugRenderer);
+
+                apiMajorVersion = 1;
+                apiMinorVersion = 0;
+
+                // multisampling is not implemented
+                sampleCount = 1;
+
+                npotTexturesSupported = true;
+                renderTargetsSupported = true;
+                clampToBorderSupported = true;
+
+                resizeFrameBuffer(newSize);
+
+                // the render thread shades tiles too
+                const uint32_t cpuCount = std::thread::hardware_concurrency();
+                rasterizer = std::make_unique<Rasterizer>(cpuCount > 1 ? cpuCount - 1 : 0);
+
+                running = true;
+                renderThread = Thread(&RenderDevice::renderMain, this);
+            }
+
+            void RenderDevice::process()
+            {
+                graphics::RenderDevice::process();
+                executeAll();
+
+                for (;;)
+                {
+                    CommandBuffer commandBuffer = popCommandBuffer();
+
+                    while (!commandBuffer.isEmpty())
+                    {
+                        const Command* command = commandBuffer.popCommand();
+
+                        switch (command->type)
+                        {
+                            case Command::Type::Stop:
+                                break;
+
+                            case Command::Type::Resize:
+                            {
+                                auto resizeCommand = static_cast<const ResizeCommand*>(command);
+                                resizeFrameBuffer(resizeCommand->size);
+                                break;
+                            }
+
+                            case Command::Type::Present:
+                            {
+                                rasterizer->flush();
+                                break;
+                            }
+
+                            case Command::Type::DeleteResource:
+                            {
+                                auto deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
+
+                                // queued primitives can reference the resource
+                                rasterizer->flush();
+
+                                RenderResource* resource = resources[deleteResourceCommand->resource - 1].get();
+
+                                if (resource == currentRenderTarget)
+                                {
+                                    currentRenderTarget = nullptr;
+                                    updateTarget();
+                                }
+                                if (resource == currentBlendState) currentBlendState = nullptr;
+                                if (resource == currentShader) currentShader = nullptr;
+                                if (resource == currentDepthStencilState) currentDepthStencilState = nullptr;
+                                std::replace(currentTextures.begin(), currentTextures.end(),
+                                             static_cast<Texture*>(resource), static_cast<Texture*>(nullptr));
+
+                                resources[deleteResourceCommand->resource - 1].reset();
+                                break;
+                            }
+
+                            case Command::Type::InitRenderTarget:
+                            {
+                                auto initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
+
+                                std::set<Texture*> colorTextures;
+                                for (const uintptr_t colorTextureId : initRenderTargetCommand->colorTextures)
+                                    colorTextures.insert(getResource<Texture>(colorTextureId));
+
+                                auto renderTarget = std::make_unique<RenderTarget>(*this,
+                                                                                   colorTextures,
+                                                                                   getResource<Texture>(initRenderTargetCommand->depthTexture));
+
+                                if (initRenderTargetCommand->renderTarget > resources.size())
+                                    resources.resize(initRenderTargetCommand->renderTarget);
+                                resources[initRenderTargetCommand->renderTarget - 1] = std::move(renderTarget);
+                                break;
+                            }
+
+                            case Command::Type::SetRenderTarget:
+                            {
+                                auto setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
+
+                                currentRenderTarget = getResource<RenderTarget>(setRenderTargetCommand->renderTarget);
+                                updateTarget();
+                                break;
+                            }
+
+                            case Command::Type::ClearRenderTarget:
+                            {
+                                auto clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
+                                clear(*clearCommand);
+                                break;
+                            }
+
+                            case Command::Type::Blit:
+                            {
+                                auto blitCommand = static_cast<const BlitCommand*>(command);
+                                blit(*blitCommand);
+                                break;
+                            }
+
+                            case Command::Type::Compute:
+                            {
+                                throw std::runtime_error("Compute is not supported");
+                            }
+
+                            case Command::Type::SetScissorTest:
+                            {
+                                auto setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
+                                scissorTestEnabled = setScissorTestCommand->enabled;
+                                scissorRect = setScissorTestCommand->rectangle;
+                                break;
+                            }
+
+                            case Command::Type::SetViewport:
+                            {
+                                auto setViewportCommand = static_cast<const SetViewportCommand*>(command);
+                                viewport = setViewportCommand->viewport;
+                                break;
+                            }
+
+                            case Command::Type::InitDepthStencilState:
+                            {
+                                auto initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
+                                auto depthStencilState = std::make_unique<DepthStencilState>(*this,
+                                                                                             initDepthStencilStateCommand->depthTest,
+                                                                                             initDepthStencilStateCommand->depthWrite,
+                                                                                             initDepthStencilStateCommand->compareFunction,
+                                                                                             initDepthStencilStateCommand->stencilEnabled,
+                                                                                             initDepthStencilStateCommand->stencilReadMask,
+                                                                                             initDepthStencilStateCommand->stencilWriteMask,
+                                                                                             initDepthStencilStateCommand->frontFaceStencilFailureOperation,
+                                                                                             initDepthStencilStateCommand->frontFaceStencilDepthFailureOperation,
+                                                                                             initDepthStencilStateCommand->frontFaceStencilPassOperation,
+                                                                                             initDepthStencilStateCommand->frontFaceStencilCompareFunction,
+                                                                                             initDepthStencilStateCommand->backFaceStencilFailureOperation,
+                                                                                             initDepthStencilStateCommand->backFaceStencilDepthFailureOperation,
+                                                                                             initDepthStencilStateCommand->backFaceStencilPassOperation,
+                                                                                             initDepthStencilStateCommand->backFaceStencilCompareFunction);
+
+                                if (initDepthStencilStateCommand->depthStencilState > resources.size())
+                                    resources.resize(initDepthStencilStateCommand->depthStencilState);
+                                resources[initDepthStencilStateCommand->depthStencilState - 1] = std::move(depthStencilState);
+                                break;
+                            }
+
+                            case Command::Type::SetDepthStencilState:
+                            {
+                                auto setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
+
+                                currentDepthStencilState = getResource<DepthStencilState>(setDepthStencilStateCommand->depthStencilState);
+                                stencilReferenceValue = setDepthStencilStateCommand->stencilReferenceValue;
+                                break;
+                            }
+
+                            case Command::Type::SetPipelineState:
+                            {
+                                auto setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
+
+                                currentBlendState = getResource<BlendState>(setPipelineStateCommand->blendState);
+                                currentShader = getResource<Shader>(setPipelineStateCommand->shader);
+                                cullMode = setPipelineStateCommand->cullMode;
+                                fillMode = setPipelineStateCommand->fillMode;
+                                break;
+                            }
+
+                            case Command::Type::Draw:
+                            {
+                                auto drawCommand = static_cast<const DrawCommand*>(command);
+                                ++currentDrawCallCount;
+
+                                draw(*drawCommand);
+                                break;
+                            }
+
+                            case Command::Type::PushDebugMarker:
+                            case Command::Type::PopDebugMarker:
+                                break;
+
+                            case Command::Type::InitBlendState:
+                            {
+                                auto initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
+
+                                auto blendState = std::make_unique<BlendState>(*this,
+                                                                               initBlendStateCommand->enableBlending,
+                                                                               initBlendStateCommand->colorBlendSource,
+                                                                               initBlendStateCommand->colorBlendDest,
+                                                                               initBlendStateCommand->colorOperation,
+                                                                               initBlendStateCommand->alphaBlendSource,
+                                                                               initBlendStateCommand->alphaBlendDest,
+                                                                               initBlendStateCommand->alphaOperation,
+                                                                               initBlendStateCommand->colorMask);
+
+                                if (initBlendStateCommand->blendState > resources.size())
+                                    resources.resize(initBlendStateCommand->blendState);
+                                resources[initBlendStateCommand->blendState - 1] = std::move(blendState);
+                                break;
+                            }
+
+                            case Command::Type::InitBuffer:
+                            {
+                                auto initBufferCommand = static_cast<const InitBufferCommand*>(command);
+
+                                auto buffer = std::make_unique<Buffer>(*this,
+                                                                       initBufferCommand->bufferType,
+                                                                       initBufferCommand->flags,
+                                                                       initBufferCommand->data,
+                                                                       initBufferCommand->size);
+
+                                if (initBufferCommand->buffer > resources.size())
+                                    resources.resize(initBufferCommand->buffer);
+                                resources[initBufferCommand->buffer - 1] = std::move(buffer);
+                                break;
+                            }
+
+                            case Command::Type::SetBufferData:
+                            {
+                                // vertices are transformed when the draw command is processed,
+                                // so queued primitives don't reference the buffer
+                                auto setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
+
+                                Buffer* buffer = getResource<Buffer>(setBufferDataCommand->buffer);
+                                buffer->setData(setBufferDataCommand->data);
+                                break;
+                            }
+
+                            case Command::Type::InitShader:
+                            {
+                                auto initShaderCommand = static_cast<const InitShaderCommand*>(command);
+
+                                auto shader = std::make_unique<Shader>(*this,
+                                                                       initShaderCommand->vertexAttributes,
+                                                                       initShaderCommand->fragmentShaderConstantInfo,
+                                                                       initShaderCommand->vertexShaderConstantInfo);
+
+                                if (initShaderCommand->shader > resources.size())
+                                    resources.resize(initShaderCommand->shader);
+                                resources[initShaderCommand->shader - 1] = std::move(shader);
+                                break;
+                            }
+
+                            case Command::Type::SetShaderConstants:
+                            {
+                                auto setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
+
+                                if (!currentShader)
+                                    throw std::runtime_error("No shader set");
+
+                                // the command data is released with the command buffer, keep a copy
+                                fragmentShaderConstants.resize(setShaderConstantsCommand->fragmentShaderConstants.size());
+                                for (size_t i = 0; i < fragmentShaderConstants.size(); ++i)
+                                    fragmentShaderConstants[i].assign(setShaderConstantsCommand->fragmentShaderConstants[i].begin(),
+                                                                      setShaderConstantsCommand->fragmentShaderConstants[i].end());
+
+                                vertexShaderConstants.resize(setShaderConstantsCommand->vertexShaderConstants.size());
+                                for (size_t i = 0; i < vertexShaderConstants.size(); ++i)
+                                    vertexShaderConstants[i].assign(setShaderConstantsCommand->vertexShaderConstants[i].begin(),
+                                                                    setShaderConstantsCommand->vertexShaderConstants[i].end());
+                                break;
+                            }
+
+                            case Command::Type::InitTexture:
+                            {
+                                auto initTextureCommand = static_cast<const InitTextureCommand*>(command);
+
+                                auto texture = std::make_unique<Texture>(*this,
+                                                                         initTextureCommand->levels,
+                                                                         initTextureCommand->textureType,
+                                                                         initTextureCommand->flags,
+                                                                         initTextureCommand->sampleCount,
+                                                                         initTextureCommand->pixelFormat);
+
+                                if (initTextureCommand->texture > resources.size())
+                                    resources.resize(initTextureCommand->texture);
+                                resources[initTextureCommand->texture - 1] = std::move(texture);
+                                break;
+                            }
+
+                            case Command::Type::SetTextureData:
+                            {
+                                auto setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
+
+                                // queued primitives can sample the texture or render to it
+                                rasterizer->flush();
+
+                                Texture* texture = getResource<Texture>(setTextureDataCommand->texture);
+                                texture->setData(setTextureDataCommand->levels);
+                                updateTarget();
+                                break;
+                            }
+
+                            case Command::Type::SetTextureParameters:
+                            {
+                                auto setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
+
+                                rasterizer->flush();
+
+                                Texture* texture = getResource<Texture>(setTextureParametersCommand->texture);
+                                texture->setFilter(setTextureParametersCommand->filter == SamplerFilter::Default ? textureFilter : setTextureParametersCommand->filter);
+                                texture->setAddressX(setTextureParametersCommand->addressX);
+                                texture->setAddressY(setTextureParametersCommand->addressY);
+                                texture->setAddressZ(setTextureParametersCommand->addressZ);
+                                texture->setBorderColor(setTextureParametersCommand->borderColor);
+                                texture->setMaxAnisotropy(setTextureParametersCommand->maxAnisotropy == 0 ? maxAnisotropy : setTextureParametersCommand->maxAnisotropy);
+                                break;
+                            }
+
+                            case Command::Type::SetTextures:
+                            {
+                                auto setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
+
+                                currentTextures.resize(setTexturesCommand->textures.size());
+                                for (size_t layer = 0; layer < currentTextures.size(); ++layer)
+                                    currentTextures[layer] = getResource<Texture>(setTexturesCommand->textures[layer]);
+                                break;
+                            }
+
+                            default:
+                                throw std::runtime_error("Invalid command");
+                        }
+
+                        if (command->type == Command::Type::Present)
+                        {
+                            recycleCommandBuffer(std::move(commandBuffer));
+                            return;
+                        }
+                    }
+
+                    recycleCommandBuffer(std::move(commandBuffer));
+                }
+            }
+
+            void RenderDevice::generateScreenshot(const std::string& filename)
+            {
+                rasterizer->flush();
+
+                const int width = static_cast<int>(frameBufferSize.v[0]);
+                const int height = static_cast<int>(frameBufferSize.v[1]);
+
+                if (!stbi_write_png(filename.c_str(), width, height, 4, frameBufferColor.data(), width * 4))
+                    throw std::runtime_error("Failed to save image to file");
+            }
+
+            void RenderDevice::resizeFrameBuffer(const Size2U& newSize)
+            {
+                if (rasterizer) rasterizer->flush();
+
+                frameBufferSize = newSize;
+
+                const size_t pixelCount = static_cast<size_t>(newSize.v[0]) * newSize.v[1];
+                frameBufferColor.assign(pixelCount * 4, 0);
+                frameBufferDepth.assign(depth ? pixelCount : 0, 1.0F);
+                frameBufferStencil.assign(stencil ? pixelCount : 0, 0);
+
+                if (rasterizer) updateTarget();
+            }
+
+            void RenderDevice::updateTarget()
+            {
+                Rasterizer::Target target;
+
+                if (currentRenderTarget)
+                {
+                    Texture* colorTexture = currentRenderTarget->getColorTexture();
+                    Texture* depthTexture = currentRenderTarget->getDepthTexture();
+
+                    if (colorTexture)
+                    {
+                        target.color = colorTexture->getColorData();
+                        target.width = colorTexture->getWidth();
+                        target.height = colorTexture->getHeight();
+                    }
+
+                    if (depthTexture)
+                    {
+                        if (!colorTexture)
+                        {
+                            target.width = depthTexture->getWidth();
+                            target.height = depthTexture->getHeight();
+                        }
+
+                        // depth and color are addressed with the same pixel index
+                        if (depthTexture->getWidth() == target.width &&
+                            depthTexture->getHeight() == target.height)
+                        {
+                            target.depth = depthTexture->getDepthData();
+                            if (depthTexture->getPixelFormat() == PixelFormat::DepthStencil)
+                                target.stencil = depthTexture->getStencilData();
+                        }
+                    }
+                }
+                else
+                {
+                    target.color = frameBufferColor.data();
+                    target.depth = frameBufferDepth.empty() ? nullptr : frameBufferDepth.data();
+                    target.stencil = frameBufferStencil.empty() ? nullptr : frameBufferStencil.data();
+                    target.width = frameBufferSize.v[0];
+                    target.height = frameBufferSize.v[1];
+                }
+
+                rasterizer->setTarget(target);
+            }
+
+            void RenderDevice::clear(const ClearRenderTargetCommand& clearCommand)
+            {
+                rasterizer->flush();
+
+                const Rasterizer::Target& target = rasterizer->getTarget();
+                const size_t pixelCount = static_cast<size_t>(target.width) * target.height;
+
+                // the scissor test is ignored, the entire render target is cleared
+                if (clearCommand.clearColorBuffer && target.color)
+                {
+                    uint32_t color;
+                    std::memcpy(&color, clearCommand.clearColor.v, sizeof(color));
+
+                    if (color == 0)
+                        std::fill(target.color, target.color + pixelCount * 4, static_cast<uint8_t>(0));
+                    else
+                        for (size_t i = 0; i < pixelCount; ++i)
+                            std::memcpy(&target.color[i * 4], &color, sizeof(color));
+                }
+
+                if (clearCommand.clearDepthBuffer && target.depth)
+                    std::fill(target.depth, target.depth + pixelCount, clearCommand.clearDepth);
+
+                if (clearCommand.clearStencilBuffer && target.stencil)
+                    std::fill(target.stencil, target.stencil + pixelCount, static_cast<uint8_t>(clearCommand.clearStencil));
+            }
+
+            void RenderDevice::blit(const BlitCommand& blitCommand)
+            {
+                rasterizer->flush();
+
+                Texture* sourceTexture = getResource<Texture>(blitCommand.sourceTexture);
+                Texture* destinationTexture = getResource<Texture>(blitCommand.destinationTexture);
+
+                if (!sourceTexture || !destinationTexture)
+                    throw std::runtime_error("Invalid blit texture");
+
+                if (sourceTexture->isDepth() || destinationTexture->isDepth())
+                    throw std::runtime_error("Blitting depth textures is not supported");
+
+                if (blitCommand.sourceLevel >= sourceTexture->getLevelCount() ||
+                    blitCommand.destinationLevel >= destinationTexture->getLevelCount())
+                    throw std::runtime_error("Invalid blit level");
+
+                const Size2U& sourceSize = sourceTexture->getLevelSize(blitCommand.sourceLevel);
+                const Size2U& destinationSize = destinationTexture->getLevelSize(blitCommand.destinationLevel);
+
+                if (blitCommand.sourceX >= sourceSize.v[0] || blitCommand.sourceY >= sourceSize.v[1] ||
+                    blitCommand.destinationX >= destinationSize.v[0] || blitCommand.destinationY >= destinationSize.v[1])
+                    return;
+
+                const uint32_t width = std::min({blitCommand.sourceWidth,
+                                                 sourceSize.v[0] - blitCommand.sourceX,
+                                                 destinationSize.v[0] - blitCommand.destinationX});
+                const uint32_t height = std::min({blitCommand.sourceHeight,
+                                                  sourceSize.v[1] - blitCommand.sourceY,
+                                                  destinationSize.v[1] - blitCommand.destinationY});
+
+                const uint8_t* sourceData = sourceTexture->getColorData(blitCommand.sourceLevel);
+                uint8_t* destinationData = destinationTexture->getColorData(blitCommand.destinationLevel);
+
+                for (uint32_t row = 0; row < height; ++row)
+                    std::memmove(&destinationData[((blitCommand.destinationY + row) * destinationSize.v[0] + blitCommand.destinationX) * 4],
+                                 &sourceData[((blitCommand.sourceY + row) * sourceSize.v[0] + blitCommand.sourceX) * 4],
+                                 width * 4);
+            }
+
+            void RenderDevice::draw(const DrawCommand& drawCommand)
+            {
+                Buffer* indexBuffer = getResource<Buffer>(drawCommand.indexBuffer);
+                Buffer* vertexBuffer = getResource<Buffer>(drawCommand.vertexBuffer);
+
+                assert(indexBuffer);
+                assert(vertexBuffer);
+
+                if (!currentShader)
+                    throw std::runtime_error("No shader set");
+
+                if (drawCommand.indexSize != 2 && drawCommand.indexSize != 4)
+                    throw std::runtime_error("Invalid index size");
+
+                const auto& indexData = indexBuffer->getData();
+                const auto& vertexData = vertexBuffer->getData();
+
+                if ((static_cast<size_t>(drawCommand.startIndex) + drawCommand.indexCount) * drawCommand.indexSize > indexData.size())
+                    throw std::runtime_error("Index out of range");
+
+                const size_t vertexCount = vertexData.size() / sizeof(Vertex);
+
+                // read the indices and find the range of the used vertices
+                indices.resize(drawCommand.indexCount);
+                uint32_t minIndex = std::numeric_limits<uint32_t>::max();
+                uint32_t maxIndex = 0;
+
+                for (uint32_t i = 0; i < drawCommand.indexCount; ++i)
+                {
+                    const size_t offset = (static_cast<size_t>(drawCommand.startIndex) + i) * drawCommand.indexSize;
+
+                    if (drawCommand.indexSize == 2)
+                    {
+                        uint16_t index;
+                        std::memcpy(&index, &indexData[offset], sizeof(index));
+                        indices[i] = index;
+                    }
+                    else
+                        std::memcpy(&indices[i], &indexData[offset], sizeof(uint32_t));
+
+                    if (indices[i] >= vertexCount)
+                        throw std::runtime_error("Vertex out of range");
+
+                    minIndex = std::min(minIndex, indices[i]);
+                    maxIndex = std::max(maxIndex, indices[i]);
+                }
+
+                if (indices.empty()) return;
+
+                // vertex stage
+                float modelViewProj[16] = {
+                    1.0F, 0.0F, 0.0F, 0.0F,
+                    0.0F, 1.0F, 0.0F, 0.0F,
+                    0.0F, 0.0F, 1.0F, 0.0F,
+                    0.0F, 0.0F, 0.0F, 1.0F
+                };
+
+                const size_t modelViewProjConstant = currentShader->getModelViewProjConstant();
+                if (modelViewProjConstant < vertexShaderConstants.size() &&
+                    vertexShaderConstants[modelViewProjConstant].size() >= 16)
+                    std::copy(vertexShaderConstants[modelViewProjConstant].begin(),
+                              vertexShaderConstants[modelViewProjConstant].begin() + 16,
+                              modelViewProj);
+
+                vertices.resize(maxIndex - minIndex + 1);
+
+                for (uint32_t index = minIndex; index <= maxIndex; ++index)
+                {
+                    Vertex vertex;
+                    std::memcpy(&vertex, &vertexData[index * sizeof(Vertex)], sizeof(Vertex));
+
+                    Rasterizer::Vertex& result = vertices[index - minIndex];
+                    transformPosition(modelViewProj, vertex.position, result.position);
+                    result.attributes[0] = vertex.color.normR();
+                    result.attributes[1] = vertex.color.normG();
+                    result.attributes[2] = vertex.color.normB();
+                    result.attributes[3] = vertex.color.normA();
+                    result.attributes[4] = vertex.texCoords[0].v[0];
+                    result.attributes[5] = vertex.texCoords[0].v[1];
+                }
+
+                // pipeline state
+                Rasterizer::State state;
+                state.viewport[0] = viewport.position.v[0];
+                state.viewport[1] = viewport.position.v[1];
+                state.viewport[2] = viewport.size.v[0];
+                state.viewport[3] = viewport.size.v[1];
+
+                state.clipRect[0] = static_cast<int32_t>(std::floor(viewport.position.v[0]));
+                state.clipRect[1] = static_cast<int32_t>(std::floor(viewport.position.v[1]));
+                state.clipRect[2] = static_cast<int32_t>(std::ceil(viewport.position.v[0] + viewport.size.v[0]));
+                state.clipRect[3] = static_cast<int32_t>(std::ceil(viewport.position.v[1] + viewport.size.v[1]));
+
+                if (scissorTestEnabled)
+                {
+                    state.clipRect[0] = std::max(state.clipRect[0], static_cast<int32_t>(scissorRect.position.v[0]));
+                    state.clipRect[1] = std::max(state.clipRect[1], static_cast<int32_t>(scissorRect.position.v[1]));
+                    state.clipRect[2] = std::min(state.clipRect[2], static_cast<int32_t>(scissorRect.position.v[0] + scissorRect.size.v[0]));
+                    state.clipRect[3] = std::min(state.clipRect[3], static_cast<int32_t>(scissorRect.position.v[1] + scissorRect.size.v[1]));
+                }
+
+                state.cullMode = cullMode;
+                state.fillMode = fillMode;
+
+                if (currentBlendState)
+                {
+                    state.blendEnabled = currentBlendState->isBlendEnabled();
+                    state.colorBlendSource = currentBlendState->getColorBlendSource();
+                    state.colorBlendDest = currentBlendState->getColorBlendDest();
+                    state.colorOperation = currentBlendState->getColorOperation();
+                    state.alphaBlendSource = currentBlendState->getAlphaBlendSource();
+                    state.alphaBlendDest = currentBlendState->getAlphaBlendDest();
+                    state.alphaOperation = currentBlendState->getAlphaOperation();
+                    state.colorMask = currentBlendState->getColorMask();
+                }
+
+                if (currentDepthStencilState)
+                {
+                    state.depthTest = currentDepthStencilState->getDepthTest();
+                    state.depthWrite = currentDepthStencilState->getDepthWrite();
+                    state.depthFunction = currentDepthStencilState->getCompareFunction();
+                    state.stencilTest = currentDepthStencilState->getStencilTest();
+                    state.stencilReadMask = currentDepthStencilState->getStencilReadMask();
+                    state.stencilWriteMask = currentDepthStencilState->getStencilWriteMask();
+                    state.stencilReference = static_cast<uint8_t>(stencilReferenceValue);
+                    state.frontFaceFail = currentDepthStencilState->getFrontFaceFail();
+                    state.frontFaceDepthFail = currentDepthStencilState->getFrontFaceDepthFail();
+                    state.frontFacePass = currentDepthStencilState->getFrontFacePass();
+                    state.frontFaceFunction = currentDepthStencilState->getFrontFaceFunction();
+                    state.backFaceFail = currentDepthStencilState->getBackFaceFail();
+                    state.backFaceDepthFail = currentDepthStencilState->getBackFaceDepthFail();
+                    state.backFacePass = currentDepthStencilState->getBackFacePass();
+                    state.backFaceFunction = currentDepthStencilState->getBackFaceFunction();
+                }
+
+                if (currentShader->isTextured() && !currentTextures.empty())
+                    state.texture = currentTextures.front();
+
+                const size_t colorConstant = currentShader->getColorConstant();
+                if (colorConstant < fragmentShaderConstants.size() &&
+                    fragmentShaderConstants[colorConstant].size() >= 4)
+                    std::copy(fragmentShaderConstants[colorConstant].begin(),
+                              fragmentShaderConstants[colorConstant].begin() + 4,
+                              state.color);
+
+                rasterizer->setState(state);
+
+                // primitive assembly
+                auto getVertex = [this, minIndex](uint32_t i) -> const Rasterizer::Vertex& {
+                    return vertices[indices[i] - minIndex];
+                };
+
+                const auto indexCount = static_cast<uint32_t>(indices.size());
+
+                switch (drawCommand.drawMode)
+                {
+                    case DrawMode::PointList:
+                        for (uint32_t i = 0; i < indexCount; ++i)
+                            rasterizer->drawPoint(getVertex(i));
+                        break;
+                    case DrawMode::LineList:
+                        for (uint32_t i = 0; i + 1 < indexCount; i += 2)
+                            rasterizer->drawLine(getVertex(i), getVertex(i + 1));
+                        break;
+                    case DrawMode::LineStrip:
+                        for (uint32_t i = 0; i + 1 < indexCount; ++i)
+                            rasterizer->drawLine(getVertex(i), getVertex(i + 1));
+                        break;
+                    case DrawMode::TriangleList:
+                        for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+                            rasterizer->drawTriangle(getVertex(i), getVertex(i + 1), getVertex(i + 2));
+                        break;
+                    case DrawMode::TriangleStrip:
+                        // every other triangle is flipped to keep the winding of the strip
+                        for (uint32_t i = 0; i + 2 < indexCount; ++i)
+                            if (i % 2)
+                                rasterizer->drawTriangle(getVertex(i + 1), getVertex(i), getVertex(i + 2));
+                            else
+                                rasterizer->drawTriangle(getVertex(i), getVertex(i + 1), getVertex(i + 2));
+                        break;
+                    default:
+                        throw std::runtime_error("Invalid draw mode");
+                }
+            }
+
+            void RenderDevice::renderMain()
+            {
+                Thread::setCurrentThreadName("Render");
+
+                while (running)
+                {
+                    try
+                    {
+                        process();
+                    }
+                    catch (const std::exception& e)
+                    {
+                        engine->log(Log::Level::Error) << e.what();
+                    }
+                }
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
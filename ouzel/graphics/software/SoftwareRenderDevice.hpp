@@ -0,0 +1,106 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "graphics/RenderDevice.hpp"
+#include "graphics/software/SoftwareRasterizer.hpp"
+#include "graphics/software/SoftwareRenderResource.hpp"
+#include "math/Rect.hpp"
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class BlendState;
+            class DepthStencilState;
+            class RenderTarget;
+            class Shader;
+            class Texture;
+
+            // Renders on the CPU into a memory frame buffer, does not need a GPU or a window system
+            class RenderDevice final: public graphics::RenderDevice
+            {
+                friend Renderer;
+            public:
+                explicit RenderDevice(const std::function<void(const Event&)>& initCallback);
+                ~RenderDevice();
+
+                template <class T>
+                inline auto getResource(uintptr_t id) const
+                {
+                    return id ? static_cast<T*>(resources[id - 1].get()) : nullptr;
+                }
+
+                inline auto getWorkerCount() const noexcept { return rasterizer ? rasterizer->getWorkerCount() : 0; }
+
+            private:
+                void init(Window* newWindow,
+                          const Size2U& newSize,
+                          uint32_t newSampleCount,
+                          SamplerFilter newTextureFilter,
+                          uint32_t newMaxAnisotropy,
+                          bool newSrgb,
+                          bool newVerticalSync,
+                          bool newDepth,
+                          bool newStencil,
+                          bool newDebugRenderer) final;
+
+                void process() final;
+                void generateScreenshot(const std::string& filename) final;
+
+                void resizeFrameBuffer(const Size2U& newSize);
+                void updateTarget();
+                void clear(const ClearRenderTargetCommand& clearCommand);
+                void blit(const BlitCommand& blitCommand);
+                void draw(const DrawCommand& drawCommand);
+
+                void renderMain();
+
+                Size2U frameBufferSize;
+                std::vector<uint8_t> frameBufferColor;
+                std::vector<float> frameBufferDepth;
+                std::vector<uint8_t> frameBufferStencil;
+
+                std::unique_ptr<Rasterizer> rasterizer;
+
+                RenderTarget* currentRenderTarget = nullptr;
+                BlendState* currentBlendState = nullptr;
+                Shader* currentShader = nullptr;
+                DepthStencilState* currentDepthStencilState = nullptr;
+                uint32_t stencilReferenceValue = 0;
+                CullMode cullMode = CullMode::NoCull;
+                FillMode fillMode = FillMode::Solid;
+                RectF viewport;
+                bool scissorTestEnabled = false;
+                RectF scissorRect;
+                std::vector<std::vector<float>> fragmentShaderConstants;
+                std::vector<std::vector<float>> vertexShaderConstants;
+                std::vector<Texture*> currentTextures;
+
+                // reused between draw calls
+                std::vector<uint32_t> indices;
+                std::vector<Rasterizer::Vertex> vertices;
+
+                std::vector<std::unique_ptr<RenderResource>> resources;
+
+                std::atomic_bool running{false};
+                Thread renderThread;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERDEVICE_HPP
@@ -0,0 +1,42 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+
+            class RenderResource
+            {
+            public:
+                explicit RenderResource(RenderDevice& initRenderDevice):
+                    renderDevice(initRenderDevice)
+                {
+                }
+                virtual ~RenderResource() = default;
+
+                RenderResource(const RenderResource&) = delete;
+                RenderResource& operator=(const RenderResource&) = delete;
+
+                RenderResource(RenderResource&&) = delete;
+                RenderResource& operator=(RenderResource&&) = delete;
+
+            protected:
+                RenderDevice& renderDevice;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERRESOURCE_HPP
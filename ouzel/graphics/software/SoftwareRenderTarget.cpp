@@ -0,0 +1,38 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <stdexcept>
+#include "SoftwareRenderTarget.hpp"
+#include "SoftwareRenderDevice.hpp"
+#include "SoftwareTexture.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            RenderTarget::RenderTarget(RenderDevice& initRenderDevice,
+                                       const std::set<Texture*>& initColorTextures,
+                                       Texture* initDepthTexture):
+                RenderResource(initRenderDevice),
+                colorTextures(initColorTextures),
+                depthTexture(initDepthTexture)
+            {
+                colorTextures.erase(nullptr);
+
+                for (Texture* colorTexture : colorTextures)
+                    if (colorTexture && colorTexture->isDepth())
+                        throw std::runtime_error("Invalid color texture");
+
+                if (depthTexture && !depthTexture->isDepth())
+                    throw std::runtime_error("Invalid depth texture");
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
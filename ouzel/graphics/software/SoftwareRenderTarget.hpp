@@ -0,0 +1,48 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
+#define OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <set>
+#include "graphics/software/SoftwareRenderResource.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+            class Texture;
+
+            class RenderTarget final: public RenderResource
+            {
+            public:
+                RenderTarget(RenderDevice& initRenderDevice,
+                             const std::set<Texture*>& initColorTextures,
+                             Texture* initDepthTexture);
+
+                inline auto& getColorTextures() const noexcept { return colorTextures; }
+                inline auto getDepthTexture() const noexcept { return depthTexture; }
+
+                // the built-in shaders have a single output, so only the first color texture is written
+                inline Texture* getColorTexture() const noexcept
+                {
+                    return colorTextures.empty() ? nullptr : *colorTextures.begin();
+                }
+
+            private:
+                std::set<Texture*> colorTextures;
+                Texture* depthTexture = nullptr;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARERENDERTARGET_HPP
@@ -0,0 +1,40 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include "SoftwareShader.hpp"
+#include "SoftwareRenderDevice.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            constexpr size_t Shader::NO_CONSTANT;
+
+            Shader::Shader(RenderDevice& initRenderDevice,
+                           const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
+                           const std::vector<std::pair<std::string, DataType>>& initFragmentShaderConstantInfo,
+                           const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo):
+                RenderResource(initRenderDevice),
+                vertexAttributes(initVertexAttributes),
+                textured(initVertexAttributes.find(Vertex::Attribute::Usage::TextureCoordinates0) != initVertexAttributes.end())
+            {
+                for (size_t i = 0; i < initFragmentShaderConstantInfo.size(); ++i)
+                    if (initFragmentShaderConstantInfo[i].first == "color" &&
+                        initFragmentShaderConstantInfo[i].second == DataType::FloatVector4)
+                        colorConstant = i;
+
+                for (size_t i = 0; i < initVertexShaderConstantInfo.size(); ++i)
+                    if (initVertexShaderConstantInfo[i].first == "modelViewProj" &&
+                        initVertexShaderConstantInfo[i].second == DataType::FloatMatrix4)
+                        modelViewProjConstant = i;
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
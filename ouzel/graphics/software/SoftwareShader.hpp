@@ -0,0 +1,60 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARESHADER_HPP
+#define OUZEL_GRAPHICS_SOFTWARESHADER_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graphics/software/SoftwareRenderResource.hpp"
+#include "graphics/DataType.hpp"
+#include "graphics/Vertex.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+
+            // There is no shader compiler on the CPU, so the shader is executed as a fixed-function
+            // program that matches the built-in color and texture shaders: the position is multiplied
+            // by the "modelViewProj" constant and the output color is the interpolated vertex color
+            // modulated by the "color" constant and, if the shader takes texture coordinates,
+            // by the texture on the first layer
+            class Shader final: public RenderResource
+            {
+            public:
+                static constexpr size_t NO_CONSTANT = static_cast<size_t>(-1);
+
+                Shader(RenderDevice& initRenderDevice,
+                       const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
+                       const std::vector<std::pair<std::string, DataType>>& initFragmentShaderConstantInfo,
+                       const std::vector<std::pair<std::string, DataType>>& initVertexShaderConstantInfo);
+
+                inline auto& getVertexAttributes() const noexcept { return vertexAttributes; }
+
+                inline auto isTextured() const noexcept { return textured; }
+                inline auto getColorConstant() const noexcept { return colorConstant; }
+                inline auto getModelViewProjConstant() const noexcept { return modelViewProjConstant; }
+
+            private:
+                std::set<Vertex::Attribute::Usage> vertexAttributes;
+
+                bool textured = false;
+                size_t colorConstant = NO_CONSTANT;
+                size_t modelViewProjConstant = NO_CONSTANT;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARESHADER_HPP
@@ -0,0 +1,276 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "SoftwareTexture.hpp"
+#include "SoftwareRenderDevice.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            namespace
+            {
+                std::vector<uint8_t> convertToRgba(const Size2U& size,
+                                                   const std::vector<uint8_t>& data,
+                                                   PixelFormat pixelFormat)
+                {
+                    const size_t pixelCount = static_cast<size_t>(size.v[0]) * size.v[1];
+                    std::vector<uint8_t> result(pixelCount * 4);
+
+                    if (data.empty()) return result;
+
+                    if (data.size() < pixelCount * getPixelSize(pixelFormat))
+                        throw std::runtime_error("Invalid texture data size");
+
+                    switch (pixelFormat)
+                    {
+                        case PixelFormat::Default:
+                        case PixelFormat::RGBA8UNorm:
+                        case PixelFormat::RGBA8UNormSRGB:
+                        case PixelFormat::RGBA8UInt:
+                            std::copy(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(pixelCount * 4), result.begin());
+                            break;
+                        case PixelFormat::A8UNorm:
+                            for (size_t i = 0; i < pixelCount; ++i)
+                            {
+                                result[i * 4 + 0] = 0;
+                                result[i * 4 + 1] = 0;
+                                result[i * 4 + 2] = 0;
+                                result[i * 4 + 3] = data[i];
+                            }
+                            break;
+                        case PixelFormat::R8UNorm:
+                        case PixelFormat::R8UInt:
+                            for (size_t i = 0; i < pixelCount; ++i)
+                            {
+                                result[i * 4 + 0] = data[i];
+                                result[i * 4 + 1] = 0;
+                                result[i * 4 + 2] = 0;
+                                result[i * 4 + 3] = 255;
+                            }
+                            break;
+                        case PixelFormat::RG8UNorm:
+                        case PixelFormat::RG8UInt:
+                            for (size_t i = 0; i < pixelCount; ++i)
+                            {
+                                result[i * 4 + 0] = data[i * 2 + 0];
+                                result[i * 4 + 1] = data[i * 2 + 1];
+                                result[i * 4 + 2] = 0;
+                                result[i * 4 + 3] = 255;
+                            }
+                            break;
+                        case PixelFormat::R32Float:
+                            for (size_t i = 0; i < pixelCount; ++i)
+                            {
+                                float value;
+                                std::memcpy(&value, &data[i * 4], sizeof(value));
+                                result[i * 4 + 0] = static_cast<uint8_t>(clamp(value, 0.0F, 1.0F) * 255.0F + 0.5F);
+                                result[i * 4 + 1] = 0;
+                                result[i * 4 + 2] = 0;
+                                result[i * 4 + 3] = 255;
+                            }
+                            break;
+                        case PixelFormat::RGBA32Float:
+                            for (size_t i = 0; i < pixelCount * 4; ++i)
+                            {
+                                float value;
+                                std::memcpy(&value, &data[i * 4], sizeof(value));
+                                result[i] = static_cast<uint8_t>(clamp(value, 0.0F, 1.0F) * 255.0F + 0.5F);
+                            }
+                            break;
+                        default:
+                            throw std::runtime_error("Unsupported pixel format");
+                    }
+
+                    return result;
+                }
+
+                inline int32_t applyAddressMode(int32_t coordinate, int32_t size, SamplerAddressMode addressMode) noexcept
+                {
+                    switch (addressMode)
+                    {
+                        case SamplerAddressMode::Repeat:
+                        {
+                            const int32_t result = coordinate % size;
+                            return (result < 0) ? result + size : result;
+                        }
+                        case SamplerAddressMode::MirrorRepeat:
+                        {
+                            int32_t result = coordinate % (size * 2);
+                            if (result < 0) result += size * 2;
+                            return (result < size) ? result : size * 2 - 1 - result;
+                        }
+                        case SamplerAddressMode::ClampToBorder:
+                            return (coordinate < 0 || coordinate >= size) ? -1 : coordinate;
+                        case SamplerAddressMode::ClampToEdge:
+                        default:
+                            return clamp(coordinate, 0, size - 1);
+                    }
+                }
+            }
+
+            Texture::Texture(RenderDevice& initRenderDevice,
+                             const std::vector<std::pair<Size2U, std::vector<uint8_t>>>& initLevels,
+                             TextureType initType,
+                             uint32_t initFlags,
+                             uint32_t initSampleCount,
+                             PixelFormat initPixelFormat):
+                RenderResource(initRenderDevice),
+                type(initType),
+                flags(initFlags),
+                sampleCount(initSampleCount),
+                pixelFormat(initPixelFormat)
+            {
+                if (type != TextureType::TwoDimensional)
+                    throw std::runtime_error("Unsupported texture type");
+
+                if (initLevels.empty())
+                    throw std::runtime_error("Texture has no levels");
+
+                width = initLevels.front().first.v[0];
+                height = initLevels.front().first.v[1];
+
+                if (isDepth())
+                {
+                    const size_t pixelCount = static_cast<size_t>(width) * height;
+                    depthData.resize(pixelCount, 1.0F);
+                    stencilData.resize(pixelCount, 0);
+                }
+                else
+                    setData(initLevels);
+
+                setFilter(SamplerFilter::Default);
+            }
+
+            void Texture::setData(const std::vector<std::pair<Size2U, std::vector<uint8_t>>>& newLevels)
+            {
+                if (isDepth())
+                    throw std::runtime_error("Can not set data of a depth texture");
+
+                levels.resize(newLevels.size());
+
+                for (size_t level = 0; level < newLevels.size(); ++level)
+                {
+                    levels[level].size = newLevels[level].first;
+                    levels[level].data = convertToRgba(newLevels[level].first, newLevels[level].second, pixelFormat);
+                }
+            }
+
+            void Texture::setFilter(SamplerFilter newFilter)
+            {
+                filter = newFilter;
+
+                const SamplerFilter finalFilter = (filter == SamplerFilter::Default) ? renderDevice.getTextureFilter() : filter;
+                linear = (finalFilter != SamplerFilter::Point);
+            }
+
+            void Texture::setAddressX(SamplerAddressMode newAddressX)
+            {
+                addressX = newAddressX;
+            }
+
+            void Texture::setAddressY(SamplerAddressMode newAddressY)
+            {
+                addressY = newAddressY;
+            }
+
+            void Texture::setAddressZ(SamplerAddressMode newAddressZ)
+            {
+                addressZ = newAddressZ;
+            }
+
+            void Texture::setBorderColor(Color color)
+            {
+                borderColor[0] = color.normR();
+                borderColor[1] = color.normG();
+                borderColor[2] = color.normB();
+                borderColor[3] = color.normA();
+            }
+
+            void Texture::setMaxAnisotropy(uint32_t newMaxAnisotropy)
+            {
+                maxAnisotropy = newMaxAnisotropy;
+            }
+
+            void Texture::fetch(int32_t x, int32_t y, float result[4]) const noexcept
+            {
+                const auto& level = levels.front();
+                const int32_t levelWidth = static_cast<int32_t>(level.size.v[0]);
+                const int32_t levelHeight = static_cast<int32_t>(level.size.v[1]);
+
+                x = applyAddressMode(x, levelWidth, addressX);
+                y = applyAddressMode(y, levelHeight, addressY);
+
+                if (x < 0 || y < 0)
+                {
+                    std::copy(std::begin(borderColor), std::end(borderColor), result);
+                    return;
+                }
+
+                const uint8_t* pixel = &level.data[(static_cast<size_t>(y) * level.size.v[0] + static_cast<size_t>(x)) * 4];
+                result[0] = pixel[0] / 255.0F;
+                result[1] = pixel[1] / 255.0F;
+                result[2] = pixel[2] / 255.0F;
+                result[3] = pixel[3] / 255.0F;
+            }
+
+            void Texture::sample(float u, float v, float result[4]) const noexcept
+            {
+                if (levels.empty() || levels.front().data.empty())
+                {
+                    result[0] = result[1] = result[2] = result[3] = 0.0F;
+                    return;
+                }
+
+                const auto& size = levels.front().size;
+                // keep the coordinates in the range where they can be converted to integers
+                constexpr float maxCoordinate = 16777216.0F;
+                const float x = clamp(u * size.v[0], -maxCoordinate, maxCoordinate);
+                const float y = clamp(v * size.v[1], -maxCoordinate, maxCoordinate);
+
+                if (!linear)
+                {
+                    fetch(static_cast<int32_t>(std::floor(x)), static_cast<int32_t>(std::floor(y)), result);
+                    return;
+                }
+
+                const float sampleX = x - 0.5F;
+                const float sampleY = y - 0.5F;
+                const float floorX = std::floor(sampleX);
+                const float floorY = std::floor(sampleY);
+                const float fractionX = sampleX - floorX;
+                const float fractionY = sampleY - floorY;
+                const auto x0 = static_cast<int32_t>(floorX);
+                const auto y0 = static_cast<int32_t>(floorY);
+
+                float topLeft[4];
+                float topRight[4];
+                float bottomLeft[4];
+                float bottomRight[4];
+                fetch(x0, y0, topLeft);
+                fetch(x0 + 1, y0, topRight);
+                fetch(x0, y0 + 1, bottomLeft);
+                fetch(x0 + 1, y0 + 1, bottomRight);
+
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    const float top = topLeft[i] + (topRight[i] - topLeft[i]) * fractionX;
+                    const float bottom = bottomLeft[i] + (bottomRight[i] - bottomLeft[i]) * fractionX;
+                    result[i] = top + (bottom - top) * fractionY;
+                }
+            }
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
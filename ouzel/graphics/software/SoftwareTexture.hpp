@@ -0,0 +1,105 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
+#define OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
+
+#include "core/Setup.h"
+
+#if OUZEL_COMPILE_SOFTWARE
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "graphics/software/SoftwareRenderResource.hpp"
+#include "graphics/PixelFormat.hpp"
+#include "graphics/SamplerAddressMode.hpp"
+#include "graphics/SamplerFilter.hpp"
+#include "graphics/TextureType.hpp"
+#include "math/Color.hpp"
+#include "math/Size.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        namespace software
+        {
+            class RenderDevice;
+
+            // Color textures are stored as RGBA8 regardless of the requested pixel format,
+            // depth textures as a 32-bit float depth plane and an 8-bit stencil plane
+            class Texture final: public RenderResource
+            {
+            public:
+                Texture(RenderDevice& initRenderDevice,
+                        const std::vector<std::pair<Size2U, std::vector<uint8_t>>>& initLevels,
+                        TextureType initType,
+                        uint32_t initFlags,
+                        uint32_t initSampleCount,
+                        PixelFormat initPixelFormat);
+
+                void setData(const std::vector<std::pair<Size2U, std::vector<uint8_t>>>& newLevels);
+                void setFilter(SamplerFilter filter);
+                void setAddressX(SamplerAddressMode addressX);
+                void setAddressY(SamplerAddressMode addressY);
+                void setAddressZ(SamplerAddressMode addressZ);
+                void setBorderColor(Color color);
+                void setMaxAnisotropy(uint32_t maxAnisotropy);
+
+                inline auto getFlags() const noexcept { return flags; }
+                inline auto getPixelFormat() const noexcept { return pixelFormat; }
+                inline auto getSampleCount() const noexcept { return sampleCount; }
+
+                inline auto isDepth() const noexcept
+                {
+                    return pixelFormat == PixelFormat::Depth || pixelFormat == PixelFormat::DepthStencil;
+                }
+
+                inline auto getWidth() const noexcept { return width; }
+                inline auto getHeight() const noexcept { return height; }
+
+                inline auto getLevelCount() const noexcept { return static_cast<uint32_t>(levels.size()); }
+                inline auto& getLevelSize(uint32_t level) const { return levels[level].size; }
+                inline auto getColorData(uint32_t level = 0) noexcept { return levels[level].data.data(); }
+                inline auto getColorData(uint32_t level = 0) const noexcept { return levels[level].data.data(); }
+                inline auto getDepthData() noexcept { return depthData.data(); }
+                inline auto getStencilData() noexcept { return stencilData.data(); }
+
+                // samples the base level, writes normalized RGBA to result
+                void sample(float u, float v, float result[4]) const noexcept;
+
+            private:
+                struct Level final
+                {
+                    Size2U size;
+                    std::vector<uint8_t> data;
+                };
+
+                void fetch(int32_t x, int32_t y, float result[4]) const noexcept;
+
+                TextureType type = TextureType::TwoDimensional;
+                uint32_t flags = 0;
+                uint32_t sampleCount = 1;
+                PixelFormat pixelFormat = PixelFormat::RGBA8UNorm;
+                uint32_t width = 0;
+                uint32_t height = 0;
+
+                std::vector<Level> levels;
+                std::vector<float> depthData;
+                std::vector<uint8_t> stencilData;
+
+                SamplerFilter filter = SamplerFilter::Default;
+                SamplerAddressMode addressX = SamplerAddressMode::ClampToEdge;
+                SamplerAddressMode addressY = SamplerAddressMode::ClampToEdge;
+                SamplerAddressMode addressZ = SamplerAddressMode::ClampToEdge;
+                float borderColor[4] = {0.0F, 0.0F, 0.0F, 0.0F};
+                uint32_t maxAnisotropy = 0;
+                bool linear = false;
+            };
+        } // namespace software
+    } // namespace graphics
+} // namespace ouzel
+
+#endif
+
+#endif // OUZEL_GRAPHICS_SOFTWARETEXTURE_HPP
@@ -4,6 +4,7 @@
 #define OUZEL_GUI_BMFONT_HPP
 
 #include "Font.hpp"
+#include "storage/FileData.hpp"
 
 namespace ouzel
 {
@@ -13,7 +14,7 @@ namespace ouzel
         {
         public:
             BMFont() = default;
-            explicit BMFont(const std::vector<uint8_t>& data);
+            explicit BMFont(const storage::FileData& data);
 
             RenderData getRenderData(const std::string& text,
                                      Color color,
@@ -1,6 +1,8 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <stdexcept>
 #include "TTFont.hpp"
 #include "core/Engine.hpp"
@@ -28,7 +30,7 @@ namespace ouzel
 {
     namespace gui
     {
-        TTFont::TTFont(const std::vector<uint8_t>& initData, bool initMipmaps):
+        TTFont::TTFont(const storage::FileData& initData, bool initMipmaps):
             data(initData),
             mipmaps(initMipmaps)
         {
@@ -43,6 +45,14 @@ namespace ouzel
                 throw std::runtime_error("Failed to load font");
         }
 
+        constexpr uint32_t TTFont::ATLAS_SIZE;
+        constexpr size_t TTFont::MAX_ATLASES;
+
+        namespace
+        {
+            constexpr uint32_t PADDING = 1; // transparent border around the glyphs, so that the filtering doesn't bleed
+        }
+
         Font::RenderData TTFont::getRenderData(const std::string& text,
                                                Color color,
                                                float fontSize,
@@ -51,111 +61,63 @@ namespace ouzel
             if (!font)
                 throw std::runtime_error("Font not loaded");
 
-            constexpr uint32_t SPACING = 2;
-
-            struct CharDescriptor final
-            {
-                uint16_t x = 0;
-                uint16_t y = 0;
-                uint16_t width = 0;
-                uint16_t height = 0;
-                Vector2F offset;
-                float advance = 0;
-                std::vector<uint8_t> bitmap;
-            };
-
-            std::unordered_map<uint32_t, CharDescriptor> chars;
-
             const float s = stbtt_ScaleForPixelHeight(font.get(), fontSize);
 
             const std::u32string utf32Text = utf8::toUtf32(text);
 
-            std::set<char32_t> glyphs;
-            for (const char32_t i : utf32Text)
-                glyphs.insert(i);
-
-            uint16_t width = 0;
-            uint16_t height = 0;
-
             int ascent;
             int descent;
             int lineGap;
             stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
 
-            for (const char32_t c : glyphs)
+            Atlas& atlas = getAtlas(fontSize);
+
+            for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
             {
-                int w;
-                int h;
-                int xoff;
-                int yoff;
+                if (atlas.glyphs.find(*i) != atlas.glyphs.end()) continue;
 
-                if (const int index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c)))
+                if (!addGlyph(atlas, *i))
                 {
-                    int advance;
-                    int leftBearing;
-                    stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
+                    // start a new texture with only the glyphs of this text, the texts that use
+                    // the old texture keep it alive, and grow it until the glyphs fit
+                    Size2U newSize(ATLAS_SIZE, ATLAS_SIZE);
 
-                    CharDescriptor charDesc;
-
-                    if (unsigned char* bitmap = stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
+                    for (;;)
                     {
-                        charDesc.width = static_cast<uint16_t>(w);
-                        charDesc.height = static_cast<uint16_t>(h);
-                        charDesc.offset.v[0] = static_cast<float>(leftBearing * s);
-                        charDesc.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
-                        charDesc.bitmap = std::vector<uint8_t>(bitmap, bitmap + h * w);
-                        charDesc.x = width;
-
-                        width += static_cast<uint16_t>(w);
-                        height = height > static_cast<uint16_t>(h) ? height : static_cast<uint16_t>(h);
+                        resetAtlas(atlas, newSize);
 
-                        stbtt_FreeBitmap(bitmap, nullptr);
-                    }
+                        bool fits = true;
+                        for (const char32_t c : utf32Text)
+                            if (atlas.glyphs.find(c) == atlas.glyphs.end() && !addGlyph(atlas, c))
+                            {
+                                fits = false;
+                                break;
+                            }
 
-                    charDesc.advance = static_cast<float>(advance * s);
+                        if (fits) break;
 
-                    if (!chars.empty())
-                        width += SPACING;
+                        newSize = Size2U(newSize.v[0] * 2, newSize.v[1] * 2);
+                    }
 
-                    chars[c] = charDesc;
+                    break;
                 }
             }
 
-            std::vector<uint8_t> textureData(width * height * 4);
+            // only texts with new glyphs upload the atlas, dynamic textures can't have mip levels in Direct3D 11,
+            // so an atlas with mipmaps gets a new texture instead and the texts that use the old one keep it
+            if (!atlas.texture || (atlas.dirty && mipmaps))
+                atlas.texture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
+                                                                    atlas.data,
+                                                                    atlas.size,
+                                                                    mipmaps ? 0 : graphics::Flags::Dynamic,
+                                                                    mipmaps ? 0 : 1);
+            else if (atlas.dirty)
+                atlas.texture->setData(atlas.data);
 
-            for (uint16_t posX = 0; posX < width; ++posX)
-            {
-                for (uint16_t posY = 0; posY < height; ++posY)
-                {
-                    textureData[(posY * width + posX) * 4 + 0] = 255;
-                    textureData[(posY * width + posX) * 4 + 1] = 255;
-                    textureData[(posY * width + posX) * 4 + 2] = 255;
-                    textureData[(posY * width + posX) * 4 + 3] = 0;
-                }
-            }
+            atlas.dirty = false;
 
-            for (const auto& c : chars)
-            {
-                const CharDescriptor& charDesc = c.second;
-
-                for (uint16_t posX = 0; posX < charDesc.width; ++posX)
-                {
-                    for (uint16_t posY = 0; posY < charDesc.height; ++posY)
-                    {
-                        textureData[(posY * width + posX + charDesc.x) * 4 + 0] = 255;
-                        textureData[(posY * width + posX + charDesc.x) * 4 + 1] = 255;
-                        textureData[(posY * width + posX + charDesc.x) * 4 + 2] = 255;
-                        textureData[(posY * width + posX + charDesc.x) * 4 + 3] = charDesc.bitmap[posY * charDesc.width + posX];
-                    }
-                }
-            }
-
-            RenderData result;
-
-            auto texture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
-                                                               textureData,
-                                                               Size2U(width, height), 0,
-                                                               mipmaps ? 0 : 1);
+            const auto width = static_cast<float>(atlas.size.v[0]);
+            const auto height = static_cast<float>(atlas.size.v[1]);
 
             Vector2F position;
 
@@ -170,11 +132,11 @@ namespace ouzel
 
             for (auto i = utf32Text.begin(); i != utf32Text.end(); ++i)
             {
-                auto iter = chars.find(*i);
+                auto iter = atlas.glyphs.find(*i);
 
-                if (iter != chars.end())
+                if (iter != atlas.glyphs.end() && iter->second.found)
                 {
-                    const CharDescriptor& f = iter->second;
+                    const Glyph& f = iter->second;
 
                     auto startIndex = static_cast<uint16_t>(vertices.size());
                     indices.push_back(startIndex + 0);
@@ -185,11 +147,11 @@ namespace ouzel
                     indices.push_back(startIndex + 3);
                     indices.push_back(startIndex + 2);
 
-                    Vector2F leftTop(f.x / static_cast<float>(width),
-                                     f.y / static_cast<float>(height));
+                    Vector2F leftTop(f.x / width,
+                                     f.y / height);
 
-                    Vector2F rightBottom((f.x + f.width) / static_cast<float>(width),
-                                         (f.y + f.height) / static_cast<float>(height));
+                    Vector2F rightBottom((f.x + f.width) / width,
+                                         (f.y + f.height) / height);
 
                     textCoords[0] = Vector2F(leftTop.v[0], rightBottom.v[1]);
                     textCoords[1] = Vector2F(rightBottom.v[0], rightBottom.v[1]);
@@ -235,7 +197,181 @@ namespace ouzel
             for (graphics::Vertex& vertex : vertices)
                 vertex.position.v[1] += textHeight * (1.0F - anchor.v[1]);
 
-            return std::make_tuple(std::move(indices), std::move(vertices), std::move(texture));
+            return std::make_tuple(std::move(indices), std::move(vertices), atlas.texture);
+        }
+
+        TTFont::Atlas& TTFont::getAtlas(float fontSize) const
+        {
+            auto i = std::find_if(atlases.begin(), atlases.end(), [fontSize](const Atlas& atlas) noexcept {
+                return atlas.fontSize == fontSize;
+            });
+
+            if (i == atlases.end())
+            {
+                if (atlases.size() < MAX_ATLASES)
+                    i = atlases.insert(atlases.end(), Atlas());
+                else // evict the least recently used font size
+                    i = std::min_element(atlases.begin(), atlases.end(), [](const Atlas& a, const Atlas& b) noexcept {
+                        return a.lastUse < b.lastUse;
+                    });
+
+                i->fontSize = fontSize;
+                resetAtlas(*i, Size2U(ATLAS_SIZE, ATLAS_SIZE));
+            }
+
+            i->lastUse = ++useCounter;
+            return *i;
+        }
+
+        void TTFont::resetAtlas(Atlas& atlas, const Size2U& newSize)
+        {
+            atlas.size = newSize;
+            atlas.data.resize(newSize.v[0] * newSize.v[1] * 4);
+
+            // white pixels with zero alpha
+            for (size_t i = 0; i < atlas.data.size(); i += 4)
+            {
+                atlas.data[i + 0] = 255;
+                atlas.data[i + 1] = 255;
+                atlas.data[i + 2] = 255;
+                atlas.data[i + 3] = 0;
+            }
+
+            atlas.skyline.assign(1, SkylineNode{0, 0, newSize.v[0]});
+            atlas.glyphs.clear();
+            atlas.texture.reset();
+            atlas.dirty = true;
+        }
+
+        // bottom-left skyline packing, returns false if the rectangle doesn't fit
+        bool TTFont::packGlyph(Atlas& atlas, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+        {
+            size_t bestNode = atlas.skyline.size();
+            uint32_t bestTop = std::numeric_limits<uint32_t>::max();
+            uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+
+            for (size_t node = 0; node < atlas.skyline.size(); ++node)
+            {
+                const uint32_t left = atlas.skyline[node].x;
+                if (left + width > atlas.size.v[0]) break;
+
+                // the rectangle rests on the highest node that it spans
+                uint32_t top = 0;
+                uint32_t spanned = 0;
+                for (size_t i = node; spanned < width; ++i)
+                {
+                    top = std::max(top, atlas.skyline[i].y);
+                    spanned += atlas.skyline[i].width;
+                }
+
+                if (top + height > atlas.size.v[1]) continue;
+
+                if (top + height < bestTop ||
+                    (top + height == bestTop && atlas.skyline[node].width < bestWidth))
+                {
+                    bestNode = node;
+                    bestTop = top + height;
+                    bestWidth = atlas.skyline[node].width;
+                    x = left;
+                    y = top;
+                }
+            }
+
+            if (bestNode == atlas.skyline.size()) return false;
+
+            atlas.skyline.insert(atlas.skyline.begin() + static_cast<std::ptrdiff_t>(bestNode), SkylineNode{x, y + height, width});
+
+            // shrink or remove the nodes that are covered by the new one
+            for (size_t i = bestNode + 1; i < atlas.skyline.size();)
+            {
+                SkylineNode& node = atlas.skyline[i];
+                const uint32_t right = x + width;
+
+                if (node.x >= right) break;
+
+                const uint32_t shrink = right - node.x;
+                if (node.width <= shrink)
+                    atlas.skyline.erase(atlas.skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                else
+                {
+                    node.x += shrink;
+                    node.width -= shrink;
+                    break;
+                }
+            }
+
+            // merge the neighbors at the same height
+            for (size_t i = 0; i + 1 < atlas.skyline.size();)
+            {
+                if (atlas.skyline[i].y == atlas.skyline[i + 1].y)
+                {
+                    atlas.skyline[i].width += atlas.skyline[i + 1].width;
+                    atlas.skyline.erase(atlas.skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+                }
+                else
+                    ++i;
+            }
+
+            return true;
+        }
+
+        bool TTFont::addGlyph(Atlas& atlas, char32_t c) const
+        {
+            Glyph glyph;
+
+            const int index = stbtt_FindGlyphIndex(font.get(), static_cast<int>(c));
+            if (!index)
+            {
+                // characters that the font doesn't have are skipped
+                glyph.found = false;
+                atlas.glyphs[c] = glyph;
+                return true;
+            }
+
+            const float s = stbtt_ScaleForPixelHeight(font.get(), atlas.fontSize);
+
+            int ascent;
+            int descent;
+            int lineGap;
+            stbtt_GetFontVMetrics(font.get(), &ascent, &descent, &lineGap);
+
+            int advance;
+            int leftBearing;
+            stbtt_GetGlyphHMetrics(font.get(), index, &advance, &leftBearing);
+            glyph.advance = static_cast<float>(advance * s);
+
+            int w;
+            int h;
+            int xoff;
+            int yoff;
+
+            if (unsigned char* bitmap = stbtt_GetGlyphBitmapSubpixel(font.get(), s, s, 0.0F, 0.0F, index, &w, &h, &xoff, &yoff))
+            {
+                uint32_t x;
+                uint32_t y;
+                if (!packGlyph(atlas, static_cast<uint32_t>(w) + PADDING * 2, static_cast<uint32_t>(h) + PADDING * 2, x, y))
+                {
+                    stbtt_FreeBitmap(bitmap, nullptr);
+                    return false;
+                }
+
+                glyph.x = static_cast<uint16_t>(x + PADDING);
+                glyph.y = static_cast<uint16_t>(y + PADDING);
+                glyph.width = static_cast<uint16_t>(w);
+                glyph.height = static_cast<uint16_t>(h);
+                glyph.offset.v[0] = static_cast<float>(leftBearing * s);
+                glyph.offset.v[1] = static_cast<float>(yoff + (ascent - descent) * s);
+
+                for (uint32_t posY = 0; posY < glyph.height; ++posY)
+                    for (uint32_t posX = 0; posX < glyph.width; ++posX)
+                        atlas.data[((glyph.y + posY) * atlas.size.v[0] + glyph.x + posX) * 4 + 3] = bitmap[posY * glyph.width + posX];
+
+                stbtt_FreeBitmap(bitmap, nullptr);
+                atlas.dirty = true;
+            }
+
+            atlas.glyphs[c] = glyph;
+            return true;
         }
     } // namespace gui
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #define OUZEL_GUI_TTFONT_HPP
 
 #include "gui/Font.hpp"
+#include "storage/FileData.hpp"
 
 struct stbtt_fontinfo;
 
@@ -15,7 +16,7 @@ namespace ouzel
         {
         public:
             TTFont() = default;
-            TTFont(const std::vector<uint8_t>& newData, bool newMipmaps = true);
+            TTFont(const storage::FileData& initData, bool initMipmaps = true);
 
             RenderData getRenderData(const std::string& text,
                                      Color color,
@@ -24,10 +25,54 @@ namespace ouzel
 
             float getStringWidth(const std::string& text);
 
+            static constexpr uint32_t ATLAS_SIZE = 512;
+            static constexpr size_t MAX_ATLASES = 8; // font sizes kept in the glyph cache
+
         private:
+            struct Glyph final
+            {
+                uint16_t x = 0;
+                uint16_t y = 0;
+                uint16_t width = 0;
+                uint16_t height = 0;
+                Vector2F offset;
+                float advance = 0.0F;
+                bool found = true;
+            };
+
+            struct SkylineNode final
+            {
+                uint32_t x;
+                uint32_t y;
+                uint32_t width;
+            };
+
+            // Glyphs of one font size rasterized into a texture that is shared by all the texts of that size.
+            // Glyph rectangles never move, so the texture is replaced instead of being repacked when it is full.
+            struct Atlas final
+            {
+                float fontSize = 0.0F;
+                Size2U size;
+                std::vector<uint8_t> data;
+                std::vector<SkylineNode> skyline;
+                std::unordered_map<char32_t, Glyph> glyphs;
+                std::shared_ptr<graphics::Texture> texture;
+                uint64_t lastUse = 0;
+                bool dirty = false;
+            };
+
+            Atlas& getAtlas(float fontSize) const;
+            static void resetAtlas(Atlas& atlas, const Size2U& newSize);
+            static bool packGlyph(Atlas& atlas, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+            bool addGlyph(Atlas& atlas, char32_t c) const;
+
             std::unique_ptr<stbtt_fontinfo> font;
-            std::vector<uint8_t> data;
+            storage::FileData data; // stb_truetype reads the glyphs from the file data
             bool mipmaps = true;
+
+            // the cache is filled while the render data is being built
+            mutable std::vector<Atlas> atlases;
+            mutable uint64_t useCounter = 0;
         };
     } // namespace gui
 } // namespace ouzel
@@ -60,7 +60,7 @@ namespace ouzel
             stbi_uc* tempData = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &comp, STBI_default);
 
             if (!tempData)
-                throw std::runtime_error("Failed to load texture, reason: " + std::string(stbi_failure_reason()));
+                throw std::runtime_error("Failed to decode cursor image");
 
             size_t pixelSize;
             graphics::PixelFormat pixelFormat;
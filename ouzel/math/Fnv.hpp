@@ -23,6 +23,16 @@ namespace ouzel
         {
             return (i < sizeof(Value)) ? hash<Result>(value, i + 1, (result * prime<Result>) ^ ((value >> (i * 8)) & 0xFF)) : result;
         }
+
+        // FNV-1 hash of the bytes in [begin, end)
+        template <typename Result>
+        constexpr Result hash(const uint8_t* begin, const uint8_t* end) noexcept
+        {
+            Result result = offsetBasis<Result>;
+            for (const uint8_t* i = begin; i != end; ++i)
+                result = (result * prime<Result>) ^ *i;
+            return result;
+        }
     } // namespace fnv
 } // namespace ouzel
 
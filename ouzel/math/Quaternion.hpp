@@ -183,7 +183,7 @@ namespace ouzel
 
         inline auto getNorm() const noexcept
         {
-            constexpr T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T n = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (n == T(1)) // already normalized
                 return 1;
 
@@ -192,7 +192,7 @@ namespace ouzel
 
         void normalize() noexcept
         {
-            constexpr T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
+            const T squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3];
             if (squared == T(1)) // already normalized
                 return;
 
@@ -311,7 +311,7 @@ namespace ouzel
 
         inline Vector<3, T> rotateVector(const Vector<3, T>& vector) const noexcept
         {
-            constexpr Vector<3, T> q(v[0], v[1], v[2]);
+            const Vector<3, T> q(v[0], v[1], v[2]);
             const Vector<3, T> t = T(2) * q.cross(vector);
             return vector + (v[3] * t) + q.cross(t);
         }
@@ -6,6 +6,7 @@
 #include "assets/Bundle.hpp"
 #include "assets/Cache.hpp"
 #include "assets/Loader.hpp"
+#include "assets/LoadTask.hpp"
 #include "assets/BmfLoader.hpp"
 #include "assets/ColladaLoader.hpp"
 #include "assets/GltfLoader.hpp"
@@ -23,6 +24,7 @@
 #include "audio/Containers.hpp"
 #include "audio/Cue.hpp"
 #include "audio/Driver.hpp"
+#include "audio/Dsp.hpp"
 #include "audio/Effect.hpp"
 #include "audio/Effects.hpp"
 #include "audio/Listener.hpp"
@@ -105,6 +107,7 @@
 #include "scene/Actor.hpp"
 #include "scene/Animator.hpp"
 #include "scene/Animators.hpp"
+#include "scene/Batcher.hpp"
 #include "scene/Camera.hpp"
 #include "scene/Component.hpp"
 #include "scene/Layer.hpp"
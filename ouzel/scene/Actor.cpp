@@ -122,6 +122,7 @@ namespace ouzel
             {
                 if (entered) actor->leave();
                 actor->parent = nullptr;
+                actor->setLayer(nullptr);
             }
 
             children.clear();
@@ -186,21 +187,18 @@ namespace ouzel
                         actorContainers.push(actor);
 
                         if (actor->isPickable() && actor->pointOn(position))
-                        {
-                            auto result = std::make_pair(actor, actor->convertWorldToLocal(Vector3F(position)));
-
-                            auto upperBound = std::upper_bound(actors.begin(), actors.end(), result,
-                                                               [](const std::pair<Actor*, Vector3F>& a,
-                                                                  const std::pair<Actor*, Vector3F>& b) noexcept {
-                                                                   return a.first->worldOrder < b.first->worldOrder;
-                                                               });
-
-                            actors.insert(upperBound, result);
-                        }
+                            actors.emplace_back(actor, actor->convertWorldToLocal(Vector3F(position)));
                     }
                 }
             }
 
+            // actors with the same world order keep the order they were found in
+            std::stable_sort(actors.begin(), actors.end(),
+                             [](const std::pair<Actor*, Vector3F>& a,
+                                const std::pair<Actor*, Vector3F>& b) noexcept {
+                                 return a.first->worldOrder < b.first->worldOrder;
+                             });
+
             return actors;
         }
 
@@ -225,18 +223,17 @@ namespace ouzel
                         actorContainers.push(actor);
 
                         if (actor->isPickable() && actor->shapeOverlaps(edges))
-                        {
-                            auto upperBound = std::upper_bound(actors.begin(), actors.end(), actor,
-                                                               [](Actor* a, Actor* b) noexcept {
-                                                                   return a->worldOrder < b->worldOrder;
-                                                               });
-
-                            actors.insert(upperBound, actor);
-                        }
+                            actors.push_back(actor);
                     }
                 }
             }
 
+            // actors with the same world order keep the order they were found in
+            std::stable_sort(actors.begin(), actors.end(),
+                             [](const Actor* a, const Actor* b) noexcept {
+                                 return a->worldOrder < b->worldOrder;
+                             });
+
             return actors;
         }
 
@@ -248,36 +245,20 @@ namespace ouzel
                 component->setActor(nullptr);
         }
 
-        void Actor::visit(std::vector<Actor*>& drawQueue,
+        void Actor::visit(std::vector<Actor*>& drawCandidates,
+                          std::vector<Actor*>& movedActors,
                           const Matrix4F& newParentTransform,
                           bool parentTransformDirty,
-                          Camera* camera,
                           Order parentOrder,
                           bool parentHidden)
         {
-            worldOrder = parentOrder + order;
-            worldHidden = parentHidden || hidden;
-
-            if (parentTransformDirty) updateTransform(newParentTransform);
-            if (transformDirty) calculateTransform();
+            if (updateWorldState(newParentTransform, parentTransformDirty, parentOrder, parentHidden))
+                movedActors.push_back(this);
 
-            if (!worldHidden)
-            {
-                const Box3F boundingBox = getBoundingBox();
-
-                if (cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox)))
-                {
-                    auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                       [](Actor* a, Actor* b) noexcept {
-                                                           return a->worldOrder > b->worldOrder;
-                                                       });
-
-                    drawQueue.insert(upperBound, this);
-                }
-            }
+            if (!worldHidden) drawCandidates.push_back(this);
 
             for (Actor* actor : children)
-                actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
+                actor->visit(drawCandidates, movedActors, transform, updateChildrenTransform, worldOrder, worldHidden);
 
             updateChildrenTransform = false;
         }
@@ -289,10 +270,24 @@ namespace ouzel
 
             for (Component* component : components)
                 if (!component->isHidden())
+                {
+                    if (layer && layer->batching)
+                    {
+                        if (component->batch(layer->batcher,
+                                             transform,
+                                             opacity,
+                                             camera->getRenderViewProjection(),
+                                             wireframe))
+                            continue;
+
+                        layer->batcher.flush();
+                    }
+
                     component->draw(transform,
                                     opacity,
                                     camera->getRenderViewProjection(),
                                     wireframe);
+                }
         }
 
         void Actor::addChild(Actor* actor)
@@ -431,10 +426,35 @@ namespace ouzel
         {
             parentTransform = newParentTransform;
             transformDirty = inverseTransformDirty = true;
+            updateComponentTransforms();
+        }
+
+        void Actor::updateComponentTransforms()
+        {
             for (Component* component : components)
                 component->updateTransform();
         }
 
+        bool Actor::updateWorldState(const Matrix4F& newParentTransform,
+                                     bool parentTransformDirty,
+                                     Order parentOrder,
+                                     bool parentHidden)
+        {
+            worldOrder = parentOrder + order;
+            worldHidden = parentHidden || hidden;
+
+            // components are not notified here, because this can run on a worker thread
+            if (parentTransformDirty)
+            {
+                parentTransform = newParentTransform;
+                transformDirty = inverseTransformDirty = true;
+            }
+
+            if (transformDirty) calculateTransform();
+
+            return parentTransformDirty;
+        }
+
         Vector3F Actor::getWorldPosition() const
         {
             Vector3F result = position;
@@ -490,6 +510,7 @@ namespace ouzel
             transformDirty = false;
 
             updateChildrenTransform = true;
+            worldBoundingBoxDirty = true;
         }
 
         void Actor::calculateInverseTransform() const
@@ -554,6 +575,8 @@ namespace ouzel
 
         void Actor::setLayer(Layer* newLayer)
         {
+            if (spatialIndexNode != SpatialIndex::NULL_NODE && layer != newLayer) layer->removeFromSpatialIndex(this);
+
             ActorContainer::setLayer(newLayer);
 
             for (Component* component : components)
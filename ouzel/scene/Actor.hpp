@@ -11,6 +11,7 @@
 #include "math/Quaternion.hpp"
 #include "math/Vector.hpp"
 #include "events/EventHandler.hpp"
+#include "scene/SpatialIndex.hpp"
 
 namespace ouzel
 {
@@ -46,8 +47,8 @@ namespace ouzel
 
             inline auto getLayer() const noexcept { return layer; }
 
-            std::vector<std::pair<Actor*, Vector3F>> findActors(const Vector2F& position) const;
-            std::vector<Actor*> findActors(const std::vector<Vector2F>& edges) const;
+            virtual std::vector<std::pair<Actor*, Vector3F>> findActors(const Vector2F& position) const;
+            virtual std::vector<Actor*> findActors(const std::vector<Vector2F>& edges) const;
 
         protected:
             virtual void setLayer(Layer* newLayer);
@@ -72,10 +73,13 @@ namespace ouzel
             Actor() = default;
             ~Actor() override;
 
-            virtual void visit(std::vector<Actor*>& drawQueue,
+            // updates the world state of the actor and its children, appends the actors that are not hidden
+            // to drawCandidates and the actors whose parent transform changed to movedActors in depth-first order,
+            // the components of the moved actors have to be notified with updateComponentTransforms afterwards
+            virtual void visit(std::vector<Actor*>& drawCandidates,
+                               std::vector<Actor*>& movedActors,
                                const Matrix4F& newParentTransform,
                                bool parentTransformDirty,
-                               Camera* camera,
                                Order parentOrder,
                                bool parentHidden);
             virtual void draw(Camera* camera, bool wireframe);
@@ -164,6 +168,13 @@ namespace ouzel
 
             void updateLocalTransform();
             void updateTransform(const Matrix4F& newParentTransform);
+            void updateComponentTransforms();
+
+            // returns true if the parent transform was changed
+            bool updateWorldState(const Matrix4F& newParentTransform,
+                                  bool parentTransformDirty,
+                                  Order parentOrder,
+                                  bool parentHidden);
 
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
@@ -179,6 +190,7 @@ namespace ouzel
             mutable bool inverseTransformDirty = true;
             mutable bool localTransformDirty = true;
             mutable bool updateChildrenTransform = true;
+            mutable bool worldBoundingBoxDirty = true;
 
             bool flipX = false;
             bool flipY = false;
@@ -196,6 +208,7 @@ namespace ouzel
             Order worldOrder = 0;
 
             ActorContainer* parent = nullptr;
+            int32_t spatialIndexNode = SpatialIndex::NULL_NODE; // node in the spatial index of the layer
 
             std::vector<Component*> components;
             std::vector<std::unique_ptr<Component>> ownedComponents;
@@ -0,0 +1,145 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <limits>
+#include "Batcher.hpp"
+#include "core/Engine.hpp"
+#include "graphics/Renderer.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        bool Batcher::State::operator==(const State& other) const noexcept
+        {
+            return blendState == other.blendState &&
+                shader == other.shader &&
+                std::equal(std::begin(textures), std::end(textures), std::begin(other.textures)) &&
+                cullMode == other.cullMode &&
+                fillMode == other.fillMode &&
+                renderViewProjection == other.renderViewProjection;
+        }
+
+        void Batcher::reset()
+        {
+            items.clear();
+            indexCount = 0;
+            vertexCount = 0;
+            usedBuffers = 0;
+            batchCount = 0;
+            componentCount = 0;
+        }
+
+        void Batcher::draw(const graphics::Material& material,
+                           graphics::CullMode cullMode,
+                           bool wireframe,
+                           const Matrix4F& renderViewProjection,
+                           const Matrix4F& transformMatrix,
+                           float opacity,
+                           const std::vector<uint16_t>& newIndices,
+                           const std::vector<graphics::Vertex>& newVertices)
+        {
+            State newState;
+            newState.blendState = material.blendState ? material.blendState->getResource() : 0;
+            newState.shader = material.shader ? material.shader->getResource() : 0;
+            for (uint32_t layer = 0; layer < graphics::Material::TEXTURE_LAYERS; ++layer)
+                newState.textures[layer] = material.textures[layer] ? material.textures[layer]->getResource() : 0;
+            newState.cullMode = cullMode;
+            newState.fillMode = wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid;
+            newState.renderViewProjection = renderViewProjection;
+
+            if (!(newState == state) ||
+                vertexCount + newVertices.size() > std::numeric_limits<uint16_t>::max())
+                flush();
+
+            if (items.empty()) state = newState;
+
+            items.push_back(Item{
+                &newIndices,
+                &newVertices,
+                transformMatrix,
+                {
+                    material.diffuseColor.normR(),
+                    material.diffuseColor.normG(),
+                    material.diffuseColor.normB(),
+                    material.diffuseColor.normA() * opacity * material.opacity
+                }
+            });
+
+            indexCount += newIndices.size();
+            vertexCount += newVertices.size();
+
+            ++componentCount;
+        }
+
+        void Batcher::flush()
+        {
+            if (!indexCount || !vertexCount)
+            {
+                items.clear();
+                indexCount = 0;
+                vertexCount = 0;
+                return;
+            }
+
+            if (usedBuffers >= buffers.size())
+                buffers.push_back(Buffers{
+                    graphics::Buffer(*engine->getRenderer(),
+                                     graphics::BufferType::Index,
+                                     graphics::Flags::Dynamic | graphics::Flags::Streaming),
+                    graphics::Buffer(*engine->getRenderer(),
+                                     graphics::BufferType::Vertex,
+                                     graphics::Flags::Dynamic | graphics::Flags::Streaming)
+                });
+
+            Buffers& currentBuffers = buffers[usedBuffers++];
+            uint16_t* indices = currentBuffers.indexBuffer.map<uint16_t>(indexCount);
+            graphics::Vertex* vertices = currentBuffers.vertexBuffer.map<graphics::Vertex>(vertexCount);
+
+            uint16_t startVertex = 0;
+
+            for (const Item& item : items)
+            {
+                for (const graphics::Vertex& vertex : *item.vertices)
+                {
+                    graphics::Vertex transformedVertex = vertex;
+                    item.transformMatrix.transformPoint(transformedVertex.position);
+                    item.transformMatrix.transformVector(transformedVertex.normal);
+                    transformedVertex.normal.normalize();
+
+                    for (size_t component = 0; component < 4; ++component)
+                        transformedVertex.color.v[component] = static_cast<uint8_t>(vertex.color.v[component] * item.colorVector[component]);
+
+                    *vertices++ = transformedVertex;
+                }
+
+                for (const uint16_t index : *item.indices)
+                    *indices++ = static_cast<uint16_t>(startVertex + index);
+
+                startVertex = static_cast<uint16_t>(startVertex + item.vertices->size());
+            }
+
+            // vertices are already in world space and have the material color applied
+            const float colorVector[] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+            engine->getRenderer()->setPipelineState(state.blendState,
+                                                    state.shader,
+                                                    state.cullMode,
+                                                    state.fillMode);
+            engine->getRenderer()->setShaderConstants({colorVector}, {state.renderViewProjection.m});
+            engine->getRenderer()->setTextures(state.textures);
+            engine->getRenderer()->draw(currentBuffers.indexBuffer.getResource(),
+                                        static_cast<uint32_t>(indexCount),
+                                        sizeof(uint16_t),
+                                        currentBuffers.vertexBuffer.getResource(),
+                                        graphics::DrawMode::TriangleList,
+                                        0);
+
+            ++batchCount;
+
+            items.clear();
+            indexCount = 0;
+            vertexCount = 0;
+        }
+    } // namespace scene
+} // namespace ouzel
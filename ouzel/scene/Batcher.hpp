@@ -0,0 +1,94 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_BATCHER_HPP
+#define OUZEL_SCENE_BATCHER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "graphics/Buffer.hpp"
+#include "graphics/Material.hpp"
+#include "graphics/RasterizerState.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Merges consecutive draws that share the pipeline state and textures
+        // into a single pre-transformed vertex stream and a single draw call,
+        // the vertices are transformed straight into the mapped buffer memory on flush
+        class Batcher final
+        {
+        public:
+            Batcher() = default;
+
+            Batcher(const Batcher&) = delete;
+            Batcher& operator=(const Batcher&) = delete;
+
+            Batcher(Batcher&&) = delete;
+            Batcher& operator=(Batcher&&) = delete;
+
+            void reset();
+
+            void draw(const graphics::Material& material,
+                      graphics::CullMode cullMode,
+                      bool wireframe,
+                      const Matrix4F& renderViewProjection,
+                      const Matrix4F& transformMatrix,
+                      float opacity,
+                      const std::vector<uint16_t>& newIndices,
+                      const std::vector<graphics::Vertex>& newVertices);
+
+            void flush();
+
+            inline auto getBatchCount() const noexcept { return batchCount; }
+            inline auto getComponentCount() const noexcept { return componentCount; }
+
+        private:
+            struct State final
+            {
+                uintptr_t blendState = 0;
+                uintptr_t shader = 0;
+                uintptr_t textures[graphics::Material::TEXTURE_LAYERS]{};
+                graphics::CullMode cullMode = graphics::CullMode::NoCull;
+                graphics::FillMode fillMode = graphics::FillMode::Solid;
+                Matrix4F renderViewProjection;
+
+                bool operator==(const State& other) const noexcept;
+            };
+
+            struct Buffers final
+            {
+                graphics::Buffer indexBuffer;
+                graphics::Buffer vertexBuffer;
+            };
+
+            struct Item final
+            {
+                const std::vector<uint16_t>* indices;
+                const std::vector<graphics::Vertex>* vertices;
+                Matrix4F transformMatrix;
+                float colorVector[4];
+            };
+
+            State state;
+
+            // the geometry of the components is only referenced until the flush
+            std::vector<Item> items;
+            size_t indexCount = 0;
+            size_t vertexCount = 0;
+
+            // every flush in a frame gets its own buffers, so that backends that
+            // write straight into mapped memory don't overwrite the data of a
+            // previous batch before it is drawn
+            std::vector<Buffers> buffers;
+            size_t usedBuffers = 0;
+
+            uint32_t batchCount = 0;
+            uint32_t componentCount = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_BATCHER_HPP
@@ -20,6 +20,15 @@ namespace ouzel
         {
         }
 
+        bool Component::batch(Batcher&,
+                              const Matrix4F&,
+                              float,
+                              const Matrix4F&,
+                              bool)
+        {
+            return false;
+        }
+
         bool Component::pointOn(const Vector2F& position) const
         {
             return boundingBox.containsPoint(Vector3F(position));
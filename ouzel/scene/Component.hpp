@@ -16,6 +16,7 @@ namespace ouzel
     namespace scene
     {
         class Actor;
+        class Batcher;
         class Layer;
 
         class Component
@@ -36,6 +37,13 @@ namespace ouzel
                               const Matrix4F& renderViewProjection,
                               bool wireframe);
 
+            // returns false if the component can not be batched and must be drawn with draw
+            virtual bool batch(Batcher& batcher,
+                               const Matrix4F& transformMatrix,
+                               float opacity,
+                               const Matrix4F& renderViewProjection,
+                               bool wireframe);
+
             virtual const Box3F& getBoundingBox() const noexcept { return boundingBox; }
             virtual void setBoundingBox(const Box3F& newBoundingBox) { boundingBox = newBoundingBox; }
 
@@ -10,6 +10,7 @@
 #include "Scene.hpp"
 #include "math/Matrix.hpp"
 #include "Component.hpp"
+#include "RadixSort.hpp"
 
 namespace ouzel
 {
@@ -23,24 +24,320 @@ namespace ouzel
         Layer::~Layer()
         {
             if (scene) scene->removeLayer(this);
+
+            // the children are detached only after the spatial index is destroyed
+            setSpatialIndexEnabled(false);
         }
 
-        void Layer::draw()
+        namespace
         {
-            for (Camera* camera : cameras)
+            constexpr size_t PARALLEL_ACTOR_COUNT = 1024; // smaller scenes are traversed on the calling thread
+            constexpr size_t JOBS_PER_THREAD = 4;
+            constexpr size_t MAX_SPLIT_DEPTH = 4;
+            constexpr size_t MIN_CULL_JOB_SIZE = 256;
+
+            // bounding box of the transformed box projected onto the XY plane
+            Box2F getWorldBox(const Matrix4F& transform, const Box3F& box)
             {
-                std::vector<Actor*> drawQueue;
+                Box2F result;
 
-                for (Actor* actor : children)
-                    actor->visit(drawQueue, Matrix4F::identity(), false, camera, 0, false);
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    Vector3F corner((i & 1) ? box.max.v[0] : box.min.v[0],
+                                    (i & 2) ? box.max.v[1] : box.min.v[1],
+                                    (i & 4) ? box.max.v[2] : box.min.v[2]);
+                    transform.transformPoint(corner);
+                    result.insertPoint(Vector2F(corner));
+                }
+
+                return result;
+            }
+
+            // the lowest world order first and the actors with the same world order in the reverse drawing order
+            void sortForPicking(std::vector<const SpatialIndex::Proxy*>& proxies)
+            {
+                std::sort(proxies.begin(), proxies.end(),
+                          [](const SpatialIndex::Proxy* a, const SpatialIndex::Proxy* b) noexcept {
+                              return (a->actor->getWorldOrder() == b->actor->getWorldOrder()) ?
+                                  a->drawIndex > b->drawIndex :
+                                  a->actor->getWorldOrder() < b->actor->getWorldOrder();
+                          });
+            }
+        }
+
+        void Layer::draw()
+        {
+            batcher.reset();
+
+            if (cameras.empty()) return;
+
+            updateActors();
+            if (spatialIndexEnabled) updateSpatialIndex();
+            cullActors();
+
+            for (size_t i = 0; i < cameras.size(); ++i)
+            {
+                Camera* camera = cameras[i];
 
                 engine->getRenderer()->setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
                 engine->getRenderer()->setViewport(camera->getRenderViewport());
                 engine->getRenderer()->setDepthStencilState(camera->getDepthStencilState() ? camera->getDepthStencilState()->getResource() : 0,
                                                             camera->getStencilReferenceValue());
 
-                for (Actor* actor : drawQueue)
-                    actor->draw(camera, camera->getWireframe());
+                for (const DrawEntry& entry : drawQueues[i].entries)
+                    entry.actor->draw(camera, camera->getWireframe());
+
+                if (batching) batcher.flush();
+            }
+        }
+
+        void Layer::updateActors()
+        {
+            ThreadPool* threadPool = engine->getThreadPool();
+            const size_t threadCount = threadPool->getWorkerCount() + 1;
+            const size_t jobCount = (drawCandidates.size() >= PARALLEL_ACTOR_COUNT) ? threadCount * JOBS_PER_THREAD : 1;
+
+            traversalTasks.clear();
+            splitActors.clear();
+
+            for (Actor* actor : children)
+                traversalTasks.push_back(TraversalTask{actor, true});
+
+            // split the subtrees until there are enough tasks for all the jobs,
+            // the actors at the split points are updated on this thread before their children
+            for (size_t depth = 0; depth < MAX_SPLIT_DEPTH && traversalTasks.size() < jobCount; ++depth)
+            {
+                splitTasks.clear();
+
+                for (const TraversalTask& task : traversalTasks)
+                {
+                    Actor* actor = task.actor;
+
+                    if (task.subtree && !actor->children.empty())
+                    {
+                        const bool moved = (actor->parent == this) ?
+                            actor->updateWorldState(Matrix4F::identity(), false, 0, false) :
+                            actor->updateWorldState(static_cast<Actor*>(actor->parent)->transform,
+                                                    static_cast<Actor*>(actor->parent)->updateChildrenTransform,
+                                                    static_cast<Actor*>(actor->parent)->worldOrder,
+                                                    static_cast<Actor*>(actor->parent)->worldHidden);
+                        if (moved) actor->updateComponentTransforms();
+
+                        splitTasks.push_back(TraversalTask{actor, false});
+                        splitActors.push_back(actor);
+
+                        for (Actor* child : actor->children)
+                            splitTasks.push_back(TraversalTask{child, true});
+                    }
+                    else
+                        splitTasks.push_back(task);
+                }
+
+                if (splitTasks.size() == traversalTasks.size()) break; // nothing left to split
+
+                std::swap(traversalTasks, splitTasks);
+            }
+
+            const size_t batchCount = std::min(jobCount, traversalTasks.size());
+            if (traversalBatches.size() < batchCount) traversalBatches.resize(batchCount);
+
+            for (size_t i = 0; i < batchCount; ++i)
+            {
+                TraversalBatch& batch = traversalBatches[i];
+                batch.start = traversalTasks.size() * i / batchCount;
+                batch.end = traversalTasks.size() * (i + 1) / batchCount;
+                batch.drawCandidates.clear();
+                batch.movedActors.clear();
+            }
+
+            threadPool->run(batchCount, [this](size_t index) {
+                TraversalBatch& batch = traversalBatches[index];
+
+                for (size_t i = batch.start; i < batch.end; ++i)
+                {
+                    Actor* actor = traversalTasks[i].actor;
+
+                    if (!traversalTasks[i].subtree)
+                    {
+                        if (!actor->worldHidden) batch.drawCandidates.push_back(actor);
+                    }
+                    else if (actor->parent == this)
+                        actor->visit(batch.drawCandidates, batch.movedActors, Matrix4F::identity(), false, 0, false);
+                    else
+                    {
+                        const Actor* parent = static_cast<Actor*>(actor->parent);
+                        actor->visit(batch.drawCandidates, batch.movedActors,
+                                     parent->transform, parent->updateChildrenTransform,
+                                     parent->worldOrder, parent->worldHidden);
+                    }
+                }
+            });
+
+            drawCandidates.clear();
+
+            for (size_t i = 0; i < batchCount; ++i)
+            {
+                const TraversalBatch& batch = traversalBatches[i];
+                drawCandidates.insert(drawCandidates.end(), batch.drawCandidates.begin(), batch.drawCandidates.end());
+
+                // components are not thread safe, so they are notified here in the traversal order
+                for (Actor* actor : batch.movedActors)
+                    actor->updateComponentTransforms();
+            }
+
+            for (Actor* actor : splitActors)
+                actor->updateChildrenTransform = false;
+        }
+
+        void Layer::cullActors()
+        {
+            ThreadPool* threadPool = engine->getThreadPool();
+            const size_t threadCount = threadPool->getWorkerCount() + 1;
+            const size_t jobsPerCamera = std::max(static_cast<size_t>(1),
+                                                  std::min(threadCount * JOBS_PER_THREAD,
+                                                           drawCandidates.size() / MIN_CULL_JOB_SIZE));
+
+            // the view projection is calculated lazily, so it must be up to date before the jobs read it
+            for (Camera* camera : cameras)
+            {
+                camera->getViewProjection();
+                camera->getInverseViewProjection();
+            }
+
+            drawQueues.resize(cameras.size());
+            for (DrawQueue& drawQueue : drawQueues)
+            {
+                if (drawQueue.jobEntries.size() < jobsPerCamera) drawQueue.jobEntries.resize(jobsPerCamera);
+                drawQueue.coarseCulled = false;
+            }
+
+            // only the actors whose boxes overlap the view volume of orthographic cameras are tested,
+            // the perspective cameras test all the actors
+            if (spatialIndexEnabled)
+                threadPool->run(cameras.size(), [this](size_t index) {
+                    const Camera* camera = cameras[index];
+                    if (camera->getProjectionMode() != Camera::ProjectionMode::Orthographic) return;
+
+                    const Box3F clipBox(Vector3F(-1.0F, -1.0F, -1.0F), Vector3F(1.0F, 1.0F, 1.0F));
+                    const Box2F visibleBox = getWorldBox(camera->getInverseViewProjection(), clipBox);
+
+                    DrawQueue& drawQueue = drawQueues[index];
+                    drawQueue.candidateIndices = cullDisabledIndices;
+
+                    spatialIndex.query(visibleBox, [&drawQueue](const SpatialIndex::Proxy& proxy) {
+                        if (!proxy.actor->cullDisabled) drawQueue.candidateIndices.push_back(proxy.drawIndex);
+                    });
+
+                    // back to the traversal order
+                    std::sort(drawQueue.candidateIndices.begin(), drawQueue.candidateIndices.end());
+                    drawQueue.coarseCulled = true;
+                });
+
+            threadPool->run(cameras.size() * jobsPerCamera, [this, jobsPerCamera](size_t index) {
+                const size_t job = index % jobsPerCamera;
+                const Camera* camera = cameras[index / jobsPerCamera];
+                DrawQueue& drawQueue = drawQueues[index / jobsPerCamera];
+                std::vector<DrawEntry>& entries = drawQueue.jobEntries[job];
+                entries.clear();
+
+                const size_t candidateCount = drawQueue.coarseCulled ? drawQueue.candidateIndices.size() : drawCandidates.size();
+                const size_t start = candidateCount * job / jobsPerCamera;
+                const size_t end = candidateCount * (job + 1) / jobsPerCamera;
+
+                for (size_t i = start; i < end; ++i)
+                {
+                    Actor* actor = drawQueue.coarseCulled ? drawCandidates[drawQueue.candidateIndices[i]] : drawCandidates[i];
+                    const Box3F boundingBox = actor->getBoundingBox();
+
+                    // actors with higher world order are drawn first
+                    if (actor->cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(actor->transform, boundingBox)))
+                        entries.push_back(DrawEntry{getDrawKey(actor->worldOrder), actor});
+                }
+            });
+
+            // the job ranges are in the traversal order and the sort is stable,
+            // so the actors with the same world order keep the traversal order
+            threadPool->run(cameras.size(), [this, jobsPerCamera](size_t index) {
+                DrawQueue& drawQueue = drawQueues[index];
+
+                drawQueue.entries.clear();
+                for (size_t job = 0; job < jobsPerCamera; ++job)
+                    drawQueue.entries.insert(drawQueue.entries.end(),
+                                             drawQueue.jobEntries[job].begin(),
+                                             drawQueue.jobEntries[job].end());
+
+                sortByKey(drawQueue.entries, drawQueue.sortBuffer);
+            });
+        }
+
+        void Layer::updateSpatialIndex()
+        {
+            ++spatialIndexStamp;
+            cullDisabledIndices.clear();
+
+            for (size_t i = 0; i < drawCandidates.size(); ++i)
+            {
+                Actor* actor = drawCandidates[i];
+                const auto drawIndex = static_cast<uint32_t>(i);
+
+                if (actor->cullDisabled) cullDisabledIndices.push_back(drawIndex);
+
+                // actors without a bounding box can't be picked or culled, their proxies are removed below
+                const Box3F boundingBox = actor->getBoundingBox();
+                if (boundingBox.isEmpty()) continue;
+
+                if (actor->spatialIndexNode == SpatialIndex::NULL_NODE)
+                    actor->spatialIndexNode = spatialIndex.createProxy(SpatialIndex::Proxy{actor, boundingBox, drawIndex, spatialIndexStamp},
+                                                                       getWorldBox(actor->transform, boundingBox));
+                else
+                {
+                    SpatialIndex::Proxy& proxy = spatialIndex.getProxy(actor->spatialIndexNode);
+
+                    if (actor->worldBoundingBoxDirty ||
+                        proxy.boundingBox.min != boundingBox.min ||
+                        proxy.boundingBox.max != boundingBox.max)
+                    {
+                        proxy.boundingBox = boundingBox;
+                        spatialIndex.moveProxy(actor->spatialIndexNode, getWorldBox(actor->transform, boundingBox));
+                    }
+
+                    proxy.drawIndex = drawIndex;
+                    proxy.stamp = spatialIndexStamp;
+                }
+
+                actor->worldBoundingBoxDirty = false;
+            }
+
+            // hidden actors are not among the draw candidates
+            spatialIndex.destroyProxies([this](SpatialIndex::Proxy& proxy) noexcept {
+                if (proxy.stamp == spatialIndexStamp) return false;
+
+                proxy.actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+                return true;
+            });
+        }
+
+        void Layer::removeFromSpatialIndex(Actor* actor)
+        {
+            if (actor->spatialIndexNode != SpatialIndex::NULL_NODE)
+            {
+                spatialIndex.destroyProxy(actor->spatialIndexNode);
+                actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+            }
+        }
+
+        void Layer::setSpatialIndexEnabled(bool newSpatialIndexEnabled)
+        {
+            spatialIndexEnabled = newSpatialIndexEnabled;
+
+            if (!spatialIndexEnabled)
+            {
+                spatialIndex.destroyProxies([](SpatialIndex::Proxy& proxy) noexcept {
+                    proxy.actor->spatialIndexNode = SpatialIndex::NULL_NODE;
+                    return true;
+                });
+
+                cullDisabledIndices.clear();
             }
         }
 
@@ -144,6 +441,50 @@ namespace ouzel
             return result;
         }
 
+        std::vector<std::pair<Actor*, Vector3F>> Layer::findActors(const Vector2F& position) const
+        {
+            if (!spatialIndexEnabled) return ActorContainer::findActors(position);
+
+            std::vector<const SpatialIndex::Proxy*> proxies;
+            spatialIndex.query(Box2F(position, position), [&proxies](const SpatialIndex::Proxy& proxy) {
+                if (proxy.actor->isPickable() && !proxy.actor->isHidden()) proxies.push_back(&proxy);
+            });
+
+            sortForPicking(proxies);
+
+            std::vector<std::pair<Actor*, Vector3F>> actors;
+
+            for (const SpatialIndex::Proxy* proxy : proxies)
+                if (proxy->actor->pointOn(position))
+                    actors.emplace_back(proxy->actor, proxy->actor->convertWorldToLocal(Vector3F(position)));
+
+            return actors;
+        }
+
+        std::vector<Actor*> Layer::findActors(const std::vector<Vector2F>& edges) const
+        {
+            if (!spatialIndexEnabled) return ActorContainer::findActors(edges);
+
+            Box2F box;
+            for (const Vector2F& edge : edges)
+                box.insertPoint(edge);
+
+            std::vector<const SpatialIndex::Proxy*> proxies;
+            spatialIndex.query(box, [&proxies](const SpatialIndex::Proxy& proxy) {
+                if (proxy.actor->isPickable() && !proxy.actor->isHidden()) proxies.push_back(&proxy);
+            });
+
+            sortForPicking(proxies);
+
+            std::vector<Actor*> actors;
+
+            for (const SpatialIndex::Proxy* proxy : proxies)
+                if (proxy->actor->shapeOverlaps(edges))
+                    actors.push_back(proxy->actor);
+
+            return actors;
+        }
+
         void Layer::setOrder(int32_t newOrder)
         {
             order = newOrder;
@@ -6,6 +6,8 @@
 #include <cstdint>
 #include <vector>
 #include "scene/Actor.hpp"
+#include "scene/Batcher.hpp"
+#include "scene/SpatialIndex.hpp"
 #include "math/Vector.hpp"
 
 namespace ouzel
@@ -19,6 +21,7 @@ namespace ouzel
         class Layer: public ActorContainer
         {
             friend Scene;
+            friend Actor;
             friend Camera;
             friend Light;
         public:
@@ -37,12 +40,27 @@ namespace ouzel
             std::vector<std::pair<Actor*, Vector3F>> pickActors(const Vector2F& position, bool renderTargets = false) const;
             std::vector<Actor*> pickActors(const std::vector<Vector2F>& edges, bool renderTargets = false) const;
 
+            std::vector<std::pair<Actor*, Vector3F>> findActors(const Vector2F& position) const override;
+            std::vector<Actor*> findActors(const std::vector<Vector2F>& edges) const override;
+
             inline auto getOrder() const noexcept { return order; }
             void setOrder(Order newOrder);
 
             inline auto getScene() const noexcept { return scene; }
             void removeFromScene();
 
+            inline auto isBatchingEnabled() const noexcept { return batching; }
+            inline void setBatchingEnabled(bool newBatching) { batching = newBatching; }
+
+            // number of draw calls and batched components of the last frame
+            inline auto getBatchCount() const noexcept { return batcher.getBatchCount(); }
+            inline auto getBatchedComponentCount() const noexcept { return batcher.getComponentCount(); }
+
+            // picking and culling query the bounding boxes of the actors that were visible in the last frame
+            // from a spatial index instead of testing every actor
+            inline auto isSpatialIndexEnabled() const noexcept { return spatialIndexEnabled; }
+            void setSpatialIndexEnabled(bool newSpatialIndexEnabled);
+
         protected:
             void addCamera(Camera* camera);
             void removeCamera(Camera* camera);
@@ -53,12 +71,71 @@ namespace ouzel
             virtual void recalculateProjection();
             void enter() override;
 
+            // updates the world state of all the actors, runs on the thread pool for large scenes
+            void updateActors();
+            // fills the draw queue of every camera with its visible actors sorted by world order
+            void cullActors();
+            // updates the boxes of the moved actors and removes the actors that are no longer drawn
+            void updateSpatialIndex();
+            void removeFromSpatialIndex(Actor* actor);
+
             Scene* scene = nullptr;
 
             std::vector<Camera*> cameras;
             std::vector<Light*> lights;
 
             Order order = 0;
+
+            bool batching = false;
+            Batcher batcher;
+
+            bool spatialIndexEnabled = false;
+            SpatialIndex spatialIndex;
+
+        private:
+            struct TraversalTask final
+            {
+                Actor* actor;
+                bool subtree; // false if only the actor itself was updated while splitting the tree
+            };
+
+            struct TraversalBatch final
+            {
+                size_t start;
+                size_t end;
+                std::vector<Actor*> drawCandidates;
+                std::vector<Actor*> movedActors;
+            };
+
+            // depth-first order of the tasks matches the order of a serial traversal
+            std::vector<TraversalTask> traversalTasks;
+            std::vector<TraversalTask> splitTasks;
+            std::vector<Actor*> splitActors;
+            std::vector<TraversalBatch> traversalBatches;
+            std::vector<Actor*> drawCandidates;
+
+            uint32_t spatialIndexStamp = 0;
+            std::vector<uint32_t> cullDisabledIndices; // indices of the draw candidates that are never culled
+
+            struct DrawEntry final
+            {
+                uint32_t key; // world order mapped to unsigned in reverse
+                Actor* actor;
+            };
+
+            // kept between frames, so that building the draw queues doesn't allocate
+            struct DrawQueue final
+            {
+                std::vector<std::vector<DrawEntry>> jobEntries;
+                std::vector<DrawEntry> entries;
+                std::vector<DrawEntry> sortBuffer;
+
+                // indices of the draw candidates that passed the culling against the spatial index
+                std::vector<uint32_t> candidateIndices;
+                bool coarseCulled = false;
+            };
+
+            std::vector<DrawQueue> drawQueues; // per camera
         };
     } // namespace scene
 } // namespace ouzel
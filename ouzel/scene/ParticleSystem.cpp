@@ -1,5 +1,10 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
@@ -21,18 +26,452 @@ namespace ouzel
         namespace
         {
             constexpr float UPDATE_STEP = 1.0F / 60.0F;
+
+            enum class Attribute
+            {
+                Life,
+                PositionX,
+                PositionY,
+                ColorRed,
+                ColorGreen,
+                ColorBlue,
+                ColorAlpha,
+                DeltaColorRed,
+                DeltaColorGreen,
+                DeltaColorBlue,
+                DeltaColorAlpha,
+                Size,
+                DeltaSize,
+                Rotation,
+                DeltaRotation,
+
+                // gravity emitter
+                DirectionX,
+                DirectionY,
+                RadialAcceleration,
+                TangentialAcceleration,
+
+                // radius emitter
+                Angle,
+                DegreesPerSecond,
+                Radius,
+                DeltaRadius,
+
+                Count
+            };
+
+            class ParticleArrays final
+            {
+            public:
+                ParticleArrays(std::vector<float>& attributes, uint32_t maxParticles) noexcept:
+                    data(attributes.data()), stride(maxParticles)
+                {
+                }
+
+                inline float* operator[](Attribute attribute) const noexcept
+                {
+                    return data + static_cast<size_t>(attribute) * stride;
+                }
+
+                // moves the particle from the given index to the index of a dead particle
+                void move(size_t from, size_t to) const noexcept
+                {
+                    for (size_t attribute = 0; attribute < static_cast<size_t>(Attribute::Count); ++attribute)
+                        data[attribute * stride + to] = data[attribute * stride + from];
+                }
+
+            private:
+                float* data;
+                size_t stride;
+            };
+
+            // the kernels below are instantiated with float for single particles and with Float4 for four particles
+            inline void store(float* data, float value) noexcept { *data = value; }
+            inline float select(bool mask, float a, float b) noexcept { return mask ? a : b; }
+            inline bool isEqual(float a, float b) noexcept { return a == b; }
+            inline bool isGreater(float a, float b) noexcept { return a > b; }
+            inline bool either(bool a, bool b) noexcept { return a || b; }
+            inline float reciprocalSqrt(float value) noexcept { return 1.0F / std::sqrt(value); }
+            inline float minimum(float a, float b) noexcept { return std::min(a, b); }
+            inline float maximum(float a, float b) noexcept { return std::max(a, b); }
+
+            inline void sinCos(float value, float& sine, float& cosine) noexcept
+            {
+                sine = std::sin(value);
+                cosine = std::cos(value);
+            }
+
+#if defined(__ARM_NEON__) || defined(__SSE2__)
+            // cephes single precision sine and cosine coefficients
+            constexpr float FOUR_OVER_PI = 1.27323954473516F;
+            constexpr float MINUS_DP1 = -0.78515625F;
+            constexpr float MINUS_DP2 = -2.4187564849853515625e-4F;
+            constexpr float MINUS_DP3 = -3.77489497744594108e-8F;
+            constexpr float SINE_P0 = -1.9515295891E-4F;
+            constexpr float SINE_P1 = 8.3321608736E-3F;
+            constexpr float SINE_P2 = -1.6666654611E-1F;
+            constexpr float COSINE_P0 = 2.443315711809948E-005F;
+            constexpr float COSINE_P1 = -1.388731625493765E-003F;
+            constexpr float COSINE_P2 = 4.166664568298827E-002F;
+#endif
+
+#if defined(__ARM_NEON__)
+            struct Float4 final
+            {
+                Float4() noexcept = default;
+                Float4(float32x4_t initV) noexcept: v(initV) {}
+                explicit Float4(float value) noexcept: v(vdupq_n_f32(value)) {}
+
+                float32x4_t v;
+            };
+
+            struct Mask4 final
+            {
+                uint32x4_t v;
+            };
+
+            inline Float4 operator+(Float4 a, Float4 b) noexcept { return vaddq_f32(a.v, b.v); }
+            inline Float4 operator-(Float4 a, Float4 b) noexcept { return vsubq_f32(a.v, b.v); }
+            inline Float4 operator*(Float4 a, Float4 b) noexcept { return vmulq_f32(a.v, b.v); }
+            inline Float4 operator-(Float4 a) noexcept { return vnegq_f32(a.v); }
+
+            inline Float4 load(const float* data, Float4) noexcept { return vld1q_f32(data); }
+            inline void store(float* data, Float4 value) noexcept { vst1q_f32(data, value.v); }
+            inline Float4 select(Mask4 mask, Float4 a, Float4 b) noexcept { return vbslq_f32(mask.v, a.v, b.v); }
+            inline Mask4 isEqual(Float4 a, Float4 b) noexcept { return Mask4{vceqq_f32(a.v, b.v)}; }
+            inline Mask4 isGreater(Float4 a, Float4 b) noexcept { return Mask4{vcgtq_f32(a.v, b.v)}; }
+            inline Mask4 either(Mask4 a, Mask4 b) noexcept { return Mask4{vorrq_u32(a.v, b.v)}; }
+            inline Float4 minimum(Float4 a, Float4 b) noexcept { return vminq_f32(a.v, b.v); }
+            inline Float4 maximum(Float4 a, Float4 b) noexcept { return vmaxq_f32(a.v, b.v); }
+
+            inline Float4 reciprocalSqrt(Float4 value) noexcept
+            {
+                // estimate refined with two Newton-Raphson steps
+                float32x4_t result = vrsqrteq_f32(value.v);
+                result = vmulq_f32(result, vrsqrtsq_f32(vmulq_f32(value.v, result), result));
+                result = vmulq_f32(result, vrsqrtsq_f32(vmulq_f32(value.v, result), result));
+                return result;
+            }
+
+            inline void sinCos(Float4 value, Float4& sine, Float4& cosine) noexcept
+            {
+                uint32x4_t sineSign = vcltq_f32(value.v, vdupq_n_f32(0.0F));
+                float32x4_t x = vabsq_f32(value.v);
+
+                // octant of the angle, rounded to an even number
+                uint32x4_t octant = vcvtq_u32_f32(vmulq_n_f32(x, FOUR_OVER_PI));
+                octant = vandq_u32(vaddq_u32(octant, vdupq_n_u32(1)), vdupq_n_u32(~1U));
+                const float32x4_t y = vcvtq_f32_u32(octant);
+
+                // extended precision modular arithmetic
+                x = vaddq_f32(x, vmulq_n_f32(y, MINUS_DP1));
+                x = vaddq_f32(x, vmulq_n_f32(y, MINUS_DP2));
+                x = vaddq_f32(x, vmulq_n_f32(y, MINUS_DP3));
+
+                const uint32x4_t polynomialMask = vtstq_u32(octant, vdupq_n_u32(2));
+                sineSign = veorq_u32(sineSign, vtstq_u32(octant, vdupq_n_u32(4)));
+                const uint32x4_t cosineSign = vtstq_u32(vsubq_u32(octant, vdupq_n_u32(2)), vdupq_n_u32(4));
+
+                const float32x4_t z = vmulq_f32(x, x);
+
+                float32x4_t cosinePolynomial = vaddq_f32(vmulq_n_f32(z, COSINE_P0), vdupq_n_f32(COSINE_P1));
+                cosinePolynomial = vaddq_f32(vmulq_f32(cosinePolynomial, z), vdupq_n_f32(COSINE_P2));
+                cosinePolynomial = vmulq_f32(vmulq_f32(cosinePolynomial, z), z);
+                cosinePolynomial = vaddq_f32(vsubq_f32(cosinePolynomial, vmulq_n_f32(z, 0.5F)), vdupq_n_f32(1.0F));
+
+                float32x4_t sinePolynomial = vaddq_f32(vmulq_n_f32(z, SINE_P0), vdupq_n_f32(SINE_P1));
+                sinePolynomial = vaddq_f32(vmulq_f32(sinePolynomial, z), vdupq_n_f32(SINE_P2));
+                sinePolynomial = vaddq_f32(vmulq_f32(vmulq_f32(sinePolynomial, z), x), x);
+
+                const float32x4_t sineResult = vbslq_f32(polynomialMask, cosinePolynomial, sinePolynomial);
+                const float32x4_t cosineResult = vbslq_f32(polynomialMask, sinePolynomial, cosinePolynomial);
+
+                sine = vbslq_f32(sineSign, vnegq_f32(sineResult), sineResult);
+                cosine = vbslq_f32(cosineSign, cosineResult, vnegq_f32(cosineResult));
+            }
+
+            inline void extract(Float4 value, float* values) noexcept { vst1q_f32(values, value.v); }
+#elif defined(__SSE2__)
+            struct Float4 final
+            {
+                Float4() noexcept = default;
+                Float4(__m128 initV) noexcept: v(initV) {}
+                explicit Float4(float value) noexcept: v(_mm_set1_ps(value)) {}
+
+                __m128 v;
+            };
+
+            struct Mask4 final
+            {
+                __m128 v;
+            };
+
+            inline Float4 operator+(Float4 a, Float4 b) noexcept { return _mm_add_ps(a.v, b.v); }
+            inline Float4 operator-(Float4 a, Float4 b) noexcept { return _mm_sub_ps(a.v, b.v); }
+            inline Float4 operator*(Float4 a, Float4 b) noexcept { return _mm_mul_ps(a.v, b.v); }
+            inline Float4 operator-(Float4 a) noexcept { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0F)); }
+
+            inline Float4 load(const float* data, Float4) noexcept { return _mm_loadu_ps(data); }
+            inline void store(float* data, Float4 value) noexcept { _mm_storeu_ps(data, value.v); }
+            inline Float4 select(Mask4 mask, Float4 a, Float4 b) noexcept { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+            inline Mask4 isEqual(Float4 a, Float4 b) noexcept { return Mask4{_mm_cmpeq_ps(a.v, b.v)}; }
+            inline Mask4 isGreater(Float4 a, Float4 b) noexcept { return Mask4{_mm_cmpgt_ps(a.v, b.v)}; }
+            inline Mask4 either(Mask4 a, Mask4 b) noexcept { return Mask4{_mm_or_ps(a.v, b.v)}; }
+            inline Float4 minimum(Float4 a, Float4 b) noexcept { return _mm_min_ps(a.v, b.v); }
+            inline Float4 maximum(Float4 a, Float4 b) noexcept { return _mm_max_ps(a.v, b.v); }
+            inline Float4 reciprocalSqrt(Float4 value) noexcept { return _mm_div_ps(_mm_set1_ps(1.0F), _mm_sqrt_ps(value.v)); }
+
+            inline void sinCos(Float4 value, Float4& sine, Float4& cosine) noexcept
+            {
+                const __m128 signMask = _mm_set1_ps(-0.0F);
+                __m128 sineSign = _mm_and_ps(value.v, signMask);
+                __m128 x = _mm_andnot_ps(signMask, value.v);
+
+                // octant of the angle, rounded to an even number
+                __m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(FOUR_OVER_PI)));
+                octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+                const __m128 y = _mm_cvtepi32_ps(octant);
+
+                // extended precision modular arithmetic
+                x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(MINUS_DP1)));
+                x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(MINUS_DP2)));
+                x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(MINUS_DP3)));
+
+                const __m128 polynomialMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+                sineSign = _mm_xor_ps(sineSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)));
+                const __m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+
+                const __m128 z = _mm_mul_ps(x, x);
+
+                __m128 cosinePolynomial = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(COSINE_P0)), _mm_set1_ps(COSINE_P1));
+                cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(COSINE_P2));
+                cosinePolynomial = _mm_mul_ps(_mm_mul_ps(cosinePolynomial, z), z);
+                cosinePolynomial = _mm_add_ps(_mm_sub_ps(cosinePolynomial, _mm_mul_ps(z, _mm_set1_ps(0.5F))), _mm_set1_ps(1.0F));
+
+                __m128 sinePolynomial = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(SINE_P0)), _mm_set1_ps(SINE_P1));
+                sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(SINE_P2));
+                sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinePolynomial, z), x), x);
+
+                const __m128 sineResult = _mm_or_ps(_mm_and_ps(polynomialMask, sinePolynomial), _mm_andnot_ps(polynomialMask, cosinePolynomial));
+                const __m128 cosineResult = _mm_or_ps(_mm_and_ps(polynomialMask, cosinePolynomial), _mm_andnot_ps(polynomialMask, sinePolynomial));
+
+                sine = _mm_xor_ps(sineResult, sineSign);
+                cosine = _mm_xor_ps(cosineResult, cosineSign);
+            }
+
+            inline void extract(Float4 value, float* values) noexcept { _mm_storeu_ps(values, value.v); }
+#endif
+
+            inline float load(const float* data, float) noexcept { return *data; }
+            inline void extract(float value, float* values) noexcept { *values = value; }
+
+            template <class T>
+            struct Lanes final
+            {
+                static constexpr size_t count = sizeof(T) / sizeof(float);
+            };
+
+            template <class T>
+            inline T loadAttribute(const ParticleArrays& particles, Attribute attribute, size_t index) noexcept
+            {
+                return load(particles[attribute] + index, T());
+            }
+
+            template <class T>
+            void updateCommon(const ParticleArrays& particles, size_t index) noexcept
+            {
+                const T step(UPDATE_STEP);
+
+                store(particles[Attribute::Life] + index, loadAttribute<T>(particles, Attribute::Life, index) - step);
+
+                // color r,g,b,a
+                store(particles[Attribute::ColorRed] + index, loadAttribute<T>(particles, Attribute::ColorRed, index) +
+                      loadAttribute<T>(particles, Attribute::DeltaColorRed, index) * step);
+                store(particles[Attribute::ColorGreen] + index, loadAttribute<T>(particles, Attribute::ColorGreen, index) +
+                      loadAttribute<T>(particles, Attribute::DeltaColorGreen, index) * step);
+                store(particles[Attribute::ColorBlue] + index, loadAttribute<T>(particles, Attribute::ColorBlue, index) +
+                      loadAttribute<T>(particles, Attribute::DeltaColorBlue, index) * step);
+                store(particles[Attribute::ColorAlpha] + index, loadAttribute<T>(particles, Attribute::ColorAlpha, index) +
+                      loadAttribute<T>(particles, Attribute::DeltaColorAlpha, index) * step);
+
+                // size
+                store(particles[Attribute::Size] + index, maximum(T(0.0F), loadAttribute<T>(particles, Attribute::Size, index) +
+                                                                   loadAttribute<T>(particles, Attribute::DeltaSize, index) * step));
+
+                // angle
+                store(particles[Attribute::Rotation] + index, loadAttribute<T>(particles, Attribute::Rotation, index) +
+                      loadAttribute<T>(particles, Attribute::DeltaRotation, index) * step);
+            }
+
+            template <class T>
+            void updateGravity(const ParticleArrays& particles, size_t index,
+                               const Vector2F& gravity, float positionStep) noexcept
+            {
+                const T step(UPDATE_STEP);
+                const T positionX = loadAttribute<T>(particles, Attribute::PositionX, index);
+                const T positionY = loadAttribute<T>(particles, Attribute::PositionY, index);
+
+                // radial acceleration, the vectors that are too close to zero are not normalized
+                const T squared = positionX * positionX + positionY * positionY;
+                const T multiplier = select(isGreater(squared, T(0.0F)), reciprocalSqrt(squared), T(1.0F));
+                const auto radialMask = either(isEqual(positionX, T(0.0F)), isEqual(positionY, T(0.0F)));
+                const T radialX = select(radialMask, positionX * multiplier, T(0.0F));
+                const T radialY = select(radialMask, positionY * multiplier, T(0.0F));
+
+                const T radialAcceleration = loadAttribute<T>(particles, Attribute::RadialAcceleration, index);
+                const T tangentialAcceleration = loadAttribute<T>(particles, Attribute::TangentialAcceleration, index);
+
+                // (gravity + radial + tangential) * UPDATE_STEP
+                const T directionX = loadAttribute<T>(particles, Attribute::DirectionX, index) +
+                    (radialX * radialAcceleration - radialY * tangentialAcceleration + T(gravity.v[0])) * step;
+                const T directionY = loadAttribute<T>(particles, Attribute::DirectionY, index) +
+                    (radialY * radialAcceleration + radialX * tangentialAcceleration + T(gravity.v[1])) * step;
+
+                store(particles[Attribute::DirectionX] + index, directionX);
+                store(particles[Attribute::DirectionY] + index, directionY);
+                store(particles[Attribute::PositionX] + index, positionX + directionX * T(positionStep));
+                store(particles[Attribute::PositionY] + index, positionY + directionY * T(positionStep));
+
+                updateCommon<T>(particles, index);
+            }
+
+            template <class T>
+            void updateRadius(const ParticleArrays& particles, size_t index, float flip) noexcept
+            {
+                const T step(UPDATE_STEP);
+
+                const T angle = loadAttribute<T>(particles, Attribute::Angle, index) +
+                    loadAttribute<T>(particles, Attribute::DegreesPerSecond, index) * step;
+                const T radius = loadAttribute<T>(particles, Attribute::Radius, index) +
+                    loadAttribute<T>(particles, Attribute::DeltaRadius, index) * step;
+
+                T sine;
+                T cosine;
+                sinCos(angle, sine, cosine);
+
+                store(particles[Attribute::Angle] + index, angle);
+                store(particles[Attribute::Radius] + index, radius);
+                store(particles[Attribute::PositionX] + index, -cosine * radius);
+                store(particles[Attribute::PositionY] + index, -sine * radius * T(flip));
+
+                updateCommon<T>(particles, index);
+            }
+
+            struct MeshParameters final
+            {
+                float positionScale; // 0 if the particles are drawn at the origin
+                Vector2F offset;
+                Matrix4F boundingBoxTransform;
+            };
+
+            template <class T>
+            struct BoundingBoxAccumulator final
+            {
+                T minX{std::numeric_limits<float>::max()};
+                T minY{std::numeric_limits<float>::max()};
+                T minZ{std::numeric_limits<float>::max()};
+                T maxX{std::numeric_limits<float>::lowest()};
+                T maxY{std::numeric_limits<float>::lowest()};
+                T maxZ{std::numeric_limits<float>::lowest()};
+            };
+
+            inline uint8_t toColorComponent(float value) noexcept
+            {
+                return static_cast<uint8_t>(clamp(value, 0.0F, 1.0F) * 255.0F);
+            }
+
+            template <class T>
+            void generateVertices(const ParticleArrays& particles, size_t index,
+                                  const MeshParameters& parameters,
+                                  BoundingBoxAccumulator<T>& boundingBox,
+                                  graphics::Vertex* vertices) noexcept
+            {
+                const T positionX = loadAttribute<T>(particles, Attribute::PositionX, index);
+                const T positionY = loadAttribute<T>(particles, Attribute::PositionY, index);
+
+                // bounding box of the particle positions in the space of the actor
+                const Matrix4F& m = parameters.boundingBoxTransform;
+                const T x = positionX * T(m.m[0]) + positionY * T(m.m[4]) + T(m.m[12]);
+                const T y = positionX * T(m.m[1]) + positionY * T(m.m[5]) + T(m.m[13]);
+                const T z = positionX * T(m.m[2]) + positionY * T(m.m[6]) + T(m.m[14]);
+                boundingBox.minX = minimum(boundingBox.minX, x);
+                boundingBox.minY = minimum(boundingBox.minY, y);
+                boundingBox.minZ = minimum(boundingBox.minZ, z);
+                boundingBox.maxX = maximum(boundingBox.maxX, x);
+                boundingBox.maxY = maximum(boundingBox.maxY, y);
+                boundingBox.maxZ = maximum(boundingBox.maxZ, z);
+
+                const T centerX = positionX * T(parameters.positionScale) + T(parameters.offset.v[0]);
+                const T centerY = positionY * T(parameters.positionScale) + T(parameters.offset.v[1]);
+
+                const T halfSize = loadAttribute<T>(particles, Attribute::Size, index) * T(0.5F);
+
+                T sine;
+                T cosine;
+                sinCos(loadAttribute<T>(particles, Attribute::Rotation, index) * T(-degToRad(1.0F)), sine, cosine);
+
+                const T halfCosine = halfSize * cosine;
+                const T halfSine = halfSize * sine;
+
+                // corners of the quad rotated around its center
+                constexpr size_t laneCount = Lanes<T>::count;
+                float corners[8][laneCount];
+                extract(centerX - halfCosine + halfSine, corners[0]);
+                extract(centerY - halfSine - halfCosine, corners[1]);
+                extract(centerX + halfCosine + halfSine, corners[2]);
+                extract(centerY + halfSine - halfCosine, corners[3]);
+                extract(centerX - halfCosine - halfSine, corners[4]);
+                extract(centerY - halfSine + halfCosine, corners[5]);
+                extract(centerX + halfCosine - halfSine, corners[6]);
+                extract(centerY + halfSine + halfCosine, corners[7]);
+
+                float colors[4][laneCount];
+                extract(loadAttribute<T>(particles, Attribute::ColorRed, index), colors[0]);
+                extract(loadAttribute<T>(particles, Attribute::ColorGreen, index), colors[1]);
+                extract(loadAttribute<T>(particles, Attribute::ColorBlue, index), colors[2]);
+                extract(loadAttribute<T>(particles, Attribute::ColorAlpha, index), colors[3]);
+
+                for (size_t lane = 0; lane < laneCount; ++lane)
+                {
+                    const Color color(toColorComponent(colors[0][lane]),
+                                      toColorComponent(colors[1][lane]),
+                                      toColorComponent(colors[2][lane]),
+                                      toColorComponent(colors[3][lane]));
+
+                    graphics::Vertex* vertex = vertices + (index + lane) * 4;
+
+                    for (size_t corner = 0; corner < 4; ++corner)
+                    {
+                        vertex[corner].position = Vector3F(corners[corner * 2][lane], corners[corner * 2 + 1][lane], 0.0F);
+                        vertex[corner].color = color;
+                    }
+                }
+            }
+
+            template <class T>
+            void createIndices(uint32_t maxParticles, std::vector<uint8_t>& data)
+            {
+                data.resize(maxParticles * 6 * sizeof(T));
+                T* indices = reinterpret_cast<T*>(data.data());
+
+                for (uint32_t i = 0; i < maxParticles; ++i)
+                {
+                    indices[i * 6 + 0] = static_cast<T>(i * 4 + 0);
+                    indices[i * 6 + 1] = static_cast<T>(i * 4 + 1);
+                    indices[i * 6 + 2] = static_cast<T>(i * 4 + 2);
+                    indices[i * 6 + 3] = static_cast<T>(i * 4 + 1);
+                    indices[i * 6 + 4] = static_cast<T>(i * 4 + 3);
+                    indices[i * 6 + 5] = static_cast<T>(i * 4 + 2);
+                }
+            }
         }
 
         ParticleSystem::ParticleSystem():
             shader(engine->getCache().getShader(SHADER_TEXTURE)),
-            blendState(engine->getCache().getBlendState(BLEND_ALPHA))
+            blendState(engine->getCache().getBlendState(BLEND_ALPHA)),
+            randomGenerator(randomEngine())
         {
             whitePixelTexture = engine->getCache().getTexture(TEXTURE_WHITE_PIXEL);
-
-            updateHandler.updateHandler = [this](const UpdateEvent& event) {
-                update(event.delta);
-                return false;
-            };
         }
 
         ParticleSystem::ParticleSystem(const ParticleSystemData& initParticleSystemData):
@@ -41,6 +480,11 @@ namespace ouzel
             init(initParticleSystemData);
         }
 
+        ParticleSystem::~ParticleSystem()
+        {
+            engine->getSceneManager().removeParticleSystem(this);
+        }
+
         void ParticleSystem::draw(const Matrix4F& transformMatrix,
                                   float opacity,
                                   const Matrix4F& renderViewProjection,
@@ -55,7 +499,7 @@ namespace ouzel
             {
                 if (needsMeshUpdate)
                 {
-                    updateParticleMesh();
+                    vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(particleCount * 4 * sizeof(graphics::Vertex)));
                     needsMeshUpdate = false;
                 }
 
@@ -69,28 +513,32 @@ namespace ouzel
 
                 const float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
+                const uintptr_t textures[] = {wireframe ? whitePixelTexture->getResource() : texture->getResource()};
 
                 engine->getRenderer()->setPipelineState(blendState->getResource(),
                                                         shader->getResource(),
                                                         graphics::CullMode::NoCull,
                                                         wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
-                engine->getRenderer()->setShaderConstants(pixelShaderConstants,
-                                                          vertexShaderConstants);
-                engine->getRenderer()->setTextures({wireframe ? whitePixelTexture->getResource() : texture->getResource()});
+                engine->getRenderer()->setShaderConstants({colorVector}, {transform.m});
+                engine->getRenderer()->setTextures(textures);
                 engine->getRenderer()->draw(indexBuffer->getResource(),
                                             particleCount * 6,
-                                            sizeof(uint16_t),
+                                            indexSize,
                                             vertexBuffer->getResource(),
                                             graphics::DrawMode::TriangleList,
                                             0);
             }
         }
 
+        void ParticleSystem::prepareUpdate()
+        {
+            if (actor)
+            {
+                actor->getTransform();
+                actor->getInverseTransform();
+            }
+        }
+
         void ParticleSystem::update(float delta)
         {
             timeSinceUpdate += delta;
@@ -127,116 +575,66 @@ namespace ouzel
                 }
                 else if (active && !particleCount)
                 {
+                    // the scene manager dispatches the finish event after all the jobs have finished
                     active = false;
-                    updateHandler.remove();
-
-                    auto finishEvent = std::make_unique<AnimationEvent>();
-                    finishEvent->type = Event::Type::AnimationFinish;
-                    finishEvent->component = this;
-                    engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
-
                     return;
                 }
 
                 if (active)
                 {
-                    for (uint32_t counter = particleCount; counter > 0; --counter)
+                    const ParticleArrays particles(particleAttributes, particleSystemData.maxParticles);
+                    const float flip = particleSystemData.yCoordFlipped ? 1.0F : 0.0F;
+                    size_t i = 0;
+
+                    // the emitter type is checked once per step instead of once per particle
+                    if (particleSystemData.emitterType == ParticleSystemData::EmitterType::Gravity)
+                    {
+#if defined(__ARM_NEON__) || defined(__SSE2__)
+                        if (isSimdAvailable)
+                            for (; i + 4 <= particleCount; i += 4)
+                                updateGravity<Float4>(particles, i, particleSystemData.gravity, UPDATE_STEP * flip);
+#endif
+                        for (; i < particleCount; ++i)
+                            updateGravity<float>(particles, i, particleSystemData.gravity, UPDATE_STEP * flip);
+                    }
+                    else
                     {
-                        const size_t i = counter - 1;
+#if defined(__ARM_NEON__) || defined(__SSE2__)
+                        if (isSimdAvailable)
+                            for (; i + 4 <= particleCount; i += 4)
+                                updateRadius<Float4>(particles, i, flip);
+#endif
+                        for (; i < particleCount; ++i)
+                            updateRadius<float>(particles, i, flip);
+                    }
 
-                        particles[i].life -= UPDATE_STEP;
+                    // replace the dead particles with the last ones
+                    const float* life = particles[Attribute::Life];
+                    for (uint32_t counter = particleCount; counter > 0; --counter)
+                    {
+                        const size_t index = counter - 1;
 
-                        if (particles[i].life >= 0.0F)
-                        {
-                            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::Gravity)
-                            {
-                                Vector2F tmp;
-                                Vector2F radial;
-                                Vector2F tangential;
-
-                                // radial acceleration
-                                if (particles[i].position.v[0] == 0.0F || particles[i].position.v[1] == 0.0F)
-                                    radial = particles[i].position.normalized();
-
-                                tangential = radial;
-                                radial *= particles[i].radialAcceleration;
-
-                                // tangential acceleration
-                                std::swap(tangential.v[0], tangential.v[1]);
-                                tangential.v[0] *= - particles[i].tangentialAcceleration;
-                                tangential.v[1] *= particles[i].tangentialAcceleration;
-
-                                // (gravity + radial + tangential) * UPDATE_STEP
-                                tmp.v[0] = radial.v[0] + tangential.v[0] + particleSystemData.gravity.v[0];
-                                tmp.v[1] = radial.v[1] + tangential.v[1] + particleSystemData.gravity.v[1];
-                                tmp *= UPDATE_STEP;
-
-                                particles[i].direction.v[0] += tmp.v[0];
-                                particles[i].direction.v[1] += tmp.v[1];
-                                tmp.v[0] = particles[i].direction.v[0] * UPDATE_STEP * (particleSystemData.yCoordFlipped ? 1.0F : 0.0F);
-                                tmp.v[1] = particles[i].direction.v[1] * UPDATE_STEP * (particleSystemData.yCoordFlipped ? 1.0F : 0.0F);
-                                particles[i].position.v[0] += tmp.v[0];
-                                particles[i].position.v[1] += tmp.v[1];
-                            }
-                            else
-                            {
-                                particles[i].angle += particles[i].degreesPerSecond * UPDATE_STEP;
-                                particles[i].radius += particles[i].deltaRadius * UPDATE_STEP;
-                                particles[i].position.v[0] = -std::cos(particles[i].angle) * particles[i].radius;
-                                particles[i].position.v[1] = -std::sin(particles[i].angle) * particles[i].radius * (particleSystemData.yCoordFlipped ? 1.0F : 0.0F);
-                            }
-
-                            // color r,g,b,a
-                            particles[i].colorRed += particles[i].deltaColorRed * UPDATE_STEP;
-                            particles[i].colorGreen += particles[i].deltaColorGreen * UPDATE_STEP;
-                            particles[i].colorBlue += particles[i].deltaColorBlue * UPDATE_STEP;
-                            particles[i].colorAlpha += particles[i].deltaColorAlpha * UPDATE_STEP;
-
-                            // size
-                            particles[i].size += (particles[i].deltaSize * UPDATE_STEP);
-                            particles[i].size = std::max(0.0F, particles[i].size);
-
-                            // angle
-                            particles[i].rotation += particles[i].deltaRotation * UPDATE_STEP;
-                        }
-                        else
+                        if (life[index] < 0.0F)
                         {
-                            particles[i] = particles[particleCount - 1];
+                            particles.move(particleCount - 1, index);
                             --particleCount;
                         }
                     }
 
-                    needsMeshUpdate = true;
                     needsBoundingBoxUpdate = true;
                 }
             }
 
             if (needsBoundingBoxUpdate)
-            {
-                // Update bounding box
-                boundingBox.reset();
-
-                if (particleSystemData.positionType == ParticleSystemData::PositionType::Free ||
-                    particleSystemData.positionType == ParticleSystemData::PositionType::Parent)
-                {
-                    if (actor)
-                    {
-                        const Matrix4F& inverseTransform = actor->getInverseTransform();
+                updateParticleMesh();
+        }
 
-                        for (uint32_t i = 0; i < particleCount; ++i)
-                        {
-                            auto position = Vector3F(particles[i].position);
-                            inverseTransform.transformPoint(position);
-                            boundingBox.insertPoint(position);
-                        }
-                    }
-                }
-                else if (particleSystemData.positionType == ParticleSystemData::PositionType::Grouped)
-                {
-                    for (uint32_t i = 0; i < particleCount; ++i)
-                        boundingBox.insertPoint(Vector3F(particles[i].position));
-                }
-            }
+        void ParticleSystem::dispatchFinishEvent()
+        {
+            auto finishEvent = std::make_unique<AnimationEvent>();
+            finishEvent->type = Event::Type::AnimationFinish;
+            finishEvent->component = this;
+            engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
         }
 
         void ParticleSystem::init(const ParticleSystemData& newParticleSystemData)
@@ -262,7 +660,7 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    engine->getEventDispatcher().addEventHandler(updateHandler);
+                    engine->getSceneManager().addParticleSystem(this);
                 }
 
                 if (particleCount == 0)
@@ -291,18 +689,20 @@ namespace ouzel
 
         void ParticleSystem::createParticleMesh()
         {
-            indices.reserve(particleSystemData.maxParticles * 6);
+            // 16-bit indices can address up to 16384 particles
+            indexSize = (particleSystemData.maxParticles * 4 > 65536) ? sizeof(uint32_t) : sizeof(uint16_t);
+
+            std::vector<uint8_t> indexData;
+            if (indexSize == sizeof(uint32_t))
+                createIndices<uint32_t>(particleSystemData.maxParticles, indexData);
+            else
+                createIndices<uint16_t>(particleSystemData.maxParticles, indexData);
+
+            vertices.clear();
             vertices.reserve(particleSystemData.maxParticles * 4);
 
-            for (uint16_t i = 0; i < particleSystemData.maxParticles; ++i)
+            for (uint32_t i = 0; i < particleSystemData.maxParticles; ++i)
             {
-                indices.push_back(i * 4 + 0);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 2);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 3);
-                indices.push_back(i * 4 + 2);
-
                 vertices.emplace_back(Vector3F{-1.0F, -1.0F, 0.0F}, Color::white(),
                                       Vector2F{0.0F, 1.0F}, Vector3F{0.0F, 0.0F, -1.0F});
                 vertices.emplace_back(Vector3F{1.0F, -1.0F, 0.0F}, Color::white(),
@@ -315,66 +715,84 @@ namespace ouzel
 
             indexBuffer = std::make_unique<graphics::Buffer>(*engine->getRenderer(),
                                                              graphics::BufferType::Index, 0,
-                                                             indices.data(),
-                                                             static_cast<uint32_t>(getVectorSize(indices)));
+                                                             indexData,
+                                                             static_cast<uint32_t>(indexData.size()));
 
             vertexBuffer = std::make_unique<graphics::Buffer>(*engine->getRenderer(),
                                                               graphics::BufferType::Vertex,
-                                                              graphics::Flags::Dynamic,
+                                                              graphics::Flags::Dynamic | graphics::Flags::Streaming,
                                                               vertices.data(),
                                                               static_cast<uint32_t>(getVectorSize(vertices)));
 
-            particles.resize(particleSystemData.maxParticles);
+            particleAttributes.resize(static_cast<size_t>(Attribute::Count) * particleSystemData.maxParticles);
         }
 
         void ParticleSystem::updateParticleMesh()
         {
+            boundingBox.reset();
+
             if (actor)
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
+                MeshParameters parameters;
+
+                switch (particleSystemData.positionType)
                 {
-                    const size_t i = counter - 1;
-
-                    const Vector2F position = (particleSystemData.positionType == ParticleSystemData::PositionType::Free) ?
-                        particles[i].position :
-                        (particleSystemData.positionType == ParticleSystemData::PositionType::Parent) ?
-                        Vector2F(actor->getPosition()) + particles[i].position :
-                        (particleSystemData.positionType == ParticleSystemData::PositionType::Grouped) ?
-                        Vector2F() :
+                    case ParticleSystemData::PositionType::Free:
+                        parameters.positionScale = 1.0F;
+                        parameters.boundingBoxTransform = actor->getInverseTransform();
+                        break;
+                    case ParticleSystemData::PositionType::Parent:
+                        parameters.positionScale = 1.0F;
+                        parameters.offset = Vector2F(actor->getPosition());
+                        parameters.boundingBoxTransform = actor->getInverseTransform();
+                        break;
+                    case ParticleSystemData::PositionType::Grouped:
+                        parameters.positionScale = 0.0F;
+                        parameters.boundingBoxTransform = Matrix4F::identity();
+                        break;
+                    default:
                         throw std::runtime_error("Invalid position type");
+                }
 
-                    const float halfSize = particles[i].size / 2.0F;
-                    Vector2F v1(-halfSize, -halfSize);
-                    Vector2F v2(halfSize, halfSize);
+                const ParticleArrays particles(particleAttributes, particleSystemData.maxParticles);
+                size_t i = 0;
 
-                    const float r = -degToRad(particles[i].rotation);
-                    const float cr = std::cos(r);
-                    const float sr = std::sin(r);
+#if defined(__ARM_NEON__) || defined(__SSE2__)
+                if (isSimdAvailable && particleCount >= 4)
+                {
+                    BoundingBoxAccumulator<Float4> accumulator;
 
-                    const Vector2F a(v1.v[0] * cr - v1.v[1] * sr, v1.v[0] * sr + v1.v[1] * cr);
-                    const Vector2F b(v2.v[0] * cr - v1.v[1] * sr, v2.v[0] * sr + v1.v[1] * cr);
-                    const Vector2F c(v2.v[0] * cr - v2.v[1] * sr, v2.v[0] * sr + v2.v[1] * cr);
-                    const Vector2F d(v1.v[0] * cr - v2.v[1] * sr, v1.v[0] * sr + v2.v[1] * cr);
+                    for (; i + 4 <= particleCount; i += 4)
+                        generateVertices<Float4>(particles, i, parameters, accumulator, vertices.data());
 
-                    const Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                      static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                      static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                      static_cast<uint8_t>(particles[i].colorAlpha * 255));
+                    float values[6][4];
+                    extract(accumulator.minX, values[0]);
+                    extract(accumulator.minY, values[1]);
+                    extract(accumulator.minZ, values[2]);
+                    extract(accumulator.maxX, values[3]);
+                    extract(accumulator.maxY, values[4]);
+                    extract(accumulator.maxZ, values[5]);
 
-                    vertices[i * 4 + 0].position = Vector3F(a + position);
-                    vertices[i * 4 + 0].color = color;
+                    for (size_t lane = 0; lane < 4; ++lane)
+                    {
+                        boundingBox.insertPoint(Vector3F(values[0][lane], values[1][lane], values[2][lane]));
+                        boundingBox.insertPoint(Vector3F(values[3][lane], values[4][lane], values[5][lane]));
+                    }
+                }
+#endif
 
-                    vertices[i * 4 + 1].position = Vector3F(b + position);
-                    vertices[i * 4 + 1].color = color;
+                BoundingBoxAccumulator<float> accumulator;
 
-                    vertices[i * 4 + 2].position = Vector3F(d + position);
-                    vertices[i * 4 + 2].color = color;
+                for (; i < particleCount; ++i)
+                    generateVertices<float>(particles, i, parameters, accumulator, vertices.data());
 
-                    vertices[i * 4 + 3].position = Vector3F(c + position);
-                    vertices[i * 4 + 3].color = color;
+                if (accumulator.minX <= accumulator.maxX)
+                {
+                    boundingBox.insertPoint(Vector3F(accumulator.minX, accumulator.minY, accumulator.minZ));
+                    boundingBox.insertPoint(Vector3F(accumulator.maxX, accumulator.maxY, accumulator.maxZ));
                 }
 
-                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+                needsMeshUpdate = true;
             }
         }
 
@@ -393,70 +811,74 @@ namespace ouzel
                     Vector2F() :
                     throw std::runtime_error("Invalid position type");
 
+                const auto randomVariance = [this]() {
+                    return std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomGenerator);
+                };
+
+                const ParticleArrays particles(particleAttributes, particleSystemData.maxParticles);
+
                 for (uint32_t i = particleCount; i < particleCount + count; ++i)
                 {
+                    const float life = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * randomVariance(), 0.0F);
+                    particles[Attribute::Life][i] = life;
+
+                    particles[Attribute::PositionX][i] = particleSystemData.sourcePosition.v[0] + position.v[0] + particleSystemData.sourcePositionVariance.v[0] * randomVariance();
+                    particles[Attribute::PositionY][i] = particleSystemData.sourcePosition.v[1] + position.v[1] + particleSystemData.sourcePositionVariance.v[1] * randomVariance();
+
+                    const float size = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * randomVariance(), 0.0F);
+                    const float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * randomVariance(), 0.0F);
+                    particles[Attribute::Size][i] = size;
+                    particles[Attribute::DeltaSize][i] = (finishSize - size) / life;
+
+                    const float colorRed = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * randomVariance(), 0.0F, 1.0F);
+                    const float colorGreen = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * randomVariance(), 0.0F, 1.0F);
+                    const float colorBlue = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * randomVariance(), 0.0F, 1.0F);
+                    const float colorAlpha = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * randomVariance(), 0.0F, 1.0F);
+
+                    const float finishColorRed = clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * randomVariance(), 0.0F, 1.0F);
+                    const float finishColorGreen = clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * randomVariance(), 0.0F, 1.0F);
+                    const float finishColorBlue = clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * randomVariance(), 0.0F, 1.0F);
+                    const float finishColorAlpha = clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * randomVariance(), 0.0F, 1.0F);
+
+                    particles[Attribute::ColorRed][i] = colorRed;
+                    particles[Attribute::ColorGreen][i] = colorGreen;
+                    particles[Attribute::ColorBlue][i] = colorBlue;
+                    particles[Attribute::ColorAlpha][i] = colorAlpha;
+                    particles[Attribute::DeltaColorRed][i] = (finishColorRed - colorRed) / life;
+                    particles[Attribute::DeltaColorGreen][i] = (finishColorGreen - colorGreen) / life;
+                    particles[Attribute::DeltaColorBlue][i] = (finishColorBlue - colorBlue) / life;
+                    particles[Attribute::DeltaColorAlpha][i] = (finishColorAlpha - colorAlpha) / life;
+
+                    float rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * randomVariance();
+                    const float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * randomVariance();
+                    particles[Attribute::DeltaRotation][i] = (finishRotation - rotation) / life;
+
                     if (particleSystemData.emitterType == ParticleSystemData::EmitterType::Gravity)
                     {
-                        particles[i].life = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-
-                        particles[i].position = particleSystemData.sourcePosition + position + Vector2F(particleSystemData.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
-                                                                                                        particleSystemData.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-
-                        particles[i].size = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-
-                        const float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-                        particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
-
-                        particles[i].colorRed = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorGreen = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorBlue = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorAlpha = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        particles[Attribute::RadialAcceleration][i] = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * randomVariance();
+                        particles[Attribute::TangentialAcceleration][i] = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * randomVariance();
 
-                        const float finishColorRed = clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        const float finishColorGreen = clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        const float finishColorBlue = clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        const float finishColorAlpha = clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-
-                        particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                        particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                        particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                        particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
-
-                        particles[i].rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-
-                        const float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
-
-                        particles[i].radialAcceleration = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].tangentialAcceleration = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        const float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * randomVariance());
+                        const Vector2F v(std::cos(a), std::sin(a));
+                        const float s = particleSystemData.speed + particleSystemData.speedVariance * randomVariance();
+                        const Vector2F direction = v * s;
+                        particles[Attribute::DirectionX][i] = direction.v[0];
+                        particles[Attribute::DirectionY][i] = direction.v[1];
 
                         if (particleSystemData.rotationIsDir)
-                        {
-                            const float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                            const Vector2F v(std::cos(a), std::sin(a));
-                            const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                            const Vector2F dir = v * s;
-                            particles[i].direction = dir;
-                            particles[i].rotation = -radToDeg(dir.getAngle());
-                        }
-                        else
-                        {
-                            const float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                            const Vector2F v(std::cos(a), std::sin(a));
-                            const float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                            const Vector2F dir = v * s;
-                            particles[i].direction = dir;
-                        }
+                            rotation = -radToDeg(direction.getAngle());
                     }
                     else
                     {
-                        particles[i].radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].angle = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                        particles[i].degreesPerSecond = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-
-                        const float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
+                        const float radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * randomVariance();
+                        const float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * randomVariance();
+                        particles[Attribute::Radius][i] = radius;
+                        particles[Attribute::DeltaRadius][i] = (endRadius - radius) / life;
+                        particles[Attribute::Angle][i] = degToRad(particleSystemData.angle + particleSystemData.angleVariance * randomVariance());
+                        particles[Attribute::DegreesPerSecond][i] = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * randomVariance());
                     }
+
+                    particles[Attribute::Rotation][i] = rotation;
                 }
 
                 particleCount += count;
@@ -3,13 +3,13 @@
 #ifndef OUZEL_SCENE_PARTICLESYSTEM_HPP
 #define OUZEL_SCENE_PARTICLESYSTEM_HPP
 
+#include <random>
 #include <string>
 #include <vector>
 #include <functional>
 #include "scene/Component.hpp"
 #include "math/Color.hpp"
 #include "math/Vector.hpp"
-#include "events/EventHandler.hpp"
 #include "graphics/Vertex.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
@@ -115,11 +115,15 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
         };
 
+        class SceneManager;
+
         class ParticleSystem: public Component
         {
+            friend SceneManager;
         public:
             ParticleSystem();
             explicit ParticleSystem(const ParticleSystemData& initParticleSystemData);
+            ~ParticleSystem() override;
 
             void draw(const Matrix4F& transformMatrix,
                       float opacity,
@@ -146,9 +150,14 @@ namespace ouzel
             }
 
         private:
+            // called on the update thread before the update jobs are run
+            void prepareUpdate();
+            // runs as a job on the thread pool, so it must not touch anything outside the particle system
             void update(float delta);
+            void dispatchFinishEvent();
 
             void createParticleMesh();
+            // generates the vertices and calculates the bounding box in a single pass
             void updateParticleMesh();
 
             void emitParticles(uint32_t count);
@@ -160,46 +169,14 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle final
-            {
-                float life = 0.0F;
-
-                Vector2F position;
-
-                float colorRed = 0.0F;
-                float colorGreen = 0.0F;
-                float colorBlue = 0.0F;
-                float colorAlpha = 0.0F;
-
-                float deltaColorRed = 0.0F;
-                float deltaColorGreen = 0.0F;
-                float deltaColorBlue = 0.0F;
-                float deltaColorAlpha = 0.0F;
-
-                float angle = 0.0F;
-                float speed = 0.0F;
-
-                float size = 0.0F;
-                float deltaSize = 0.0F;
-
-                float rotation = 0.0F;
-                float deltaRotation = 0.0F;
-
-                float radialAcceleration = 0.0F;
-                float tangentialAcceleration = 0.0F;
-
-                Vector2F direction;
-                float radius = 0.0F;
-                float degreesPerSecond = 0.0F;
-                float deltaRadius = 0.0F;
-            };
-
-            std::vector<Particle> particles;
+            // every attribute of the particles is stored in a separate array of maxParticles values,
+            // so that the update can process several particles with the same SIMD instructions
+            std::vector<float> particleAttributes;
 
             std::unique_ptr<graphics::Buffer> indexBuffer;
             std::unique_ptr<graphics::Buffer> vertexBuffer;
 
-            std::vector<uint16_t> indices;
+            uint32_t indexSize = sizeof(uint16_t);
             std::vector<graphics::Vertex> vertices;
 
             uint32_t particleCount = 0;
@@ -213,7 +190,8 @@ namespace ouzel
 
             bool needsMeshUpdate = false;
 
-            EventHandler updateHandler;
+            // the global random engine can't be used from several jobs at once
+            std::mt19937 randomGenerator;
         };
     } // namespace scene
 } // namespace ouzel
@@ -0,0 +1,59 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_RADIXSORT_HPP
+#define OUZEL_SCENE_RADIXSORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace scene
+    {
+        inline namespace detail
+        {
+            // stable LSD radix sort in ascending order of the uint32_t key member of the entries,
+            // buffer is scratch memory that is kept between the sorts
+            template <class T>
+            void sortByKey(std::vector<T>& entries, std::vector<T>& buffer)
+            {
+                if (entries.size() < 2) return;
+
+                buffer.resize(entries.size());
+
+                for (uint32_t shift = 0; shift < 32; shift += 8)
+                {
+                    size_t counts[256] = {};
+                    for (const T& entry : entries)
+                        ++counts[(entry.key >> shift) & 0xFF];
+
+                    // skip the pass if all the keys have the same digit (e.g. all the actors have the same order)
+                    if (counts[(entries.front().key >> shift) & 0xFF] == entries.size())
+                        continue;
+
+                    size_t offset = 0;
+                    for (size_t& count : counts)
+                    {
+                        const size_t digitCount = count;
+                        count = offset;
+                        offset += digitCount;
+                    }
+
+                    for (const T& entry : entries)
+                        buffer[counts[(entry.key >> shift) & 0xFF]++] = entry;
+
+                    entries.swap(buffer);
+                }
+            }
+
+            // maps the order so that the actors with higher order come first in the ascending order of the keys
+            constexpr uint32_t getDrawKey(int32_t order) noexcept
+            {
+                return ~(static_cast<uint32_t>(order) ^ 0x80000000U);
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_RADIXSORT_HPP
@@ -5,6 +5,8 @@
 #include "SceneManager.hpp"
 #include "Scene.hpp"
 #include "Actor.hpp"
+#include "ParticleSystem.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -57,6 +59,54 @@ namespace ouzel
             return result;
         }
 
+        void SceneManager::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            assert(particleSystem);
+
+            if (std::find(particleSystems.begin(), particleSystems.end(), particleSystem) == particleSystems.end())
+                particleSystems.push_back(particleSystem);
+        }
+
+        void SceneManager::removeParticleSystem(const ParticleSystem* particleSystem)
+        {
+            auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+            if (i != particleSystems.end()) particleSystems.erase(i);
+
+            // a finish event handler can delete the systems that have not been notified yet
+            for (ParticleSystem*& finishedParticleSystem : finishedParticleSystems)
+                if (finishedParticleSystem == particleSystem) finishedParticleSystem = nullptr;
+        }
+
+        void SceneManager::update(float delta)
+        {
+            if (particleSystems.empty()) return;
+
+            // actor transforms are calculated lazily, so they are prepared before the jobs read them
+            for (ParticleSystem* particleSystem : particleSystems)
+                particleSystem->prepareUpdate();
+
+            engine->getThreadPool()->run(particleSystems.size(), [this, delta](size_t index) {
+                particleSystems[index]->update(delta);
+            });
+
+            for (ParticleSystem* particleSystem : particleSystems)
+                if (!particleSystem->isActive())
+                    finishedParticleSystems.push_back(particleSystem);
+
+            if (finishedParticleSystems.empty()) return;
+
+            particleSystems.erase(std::remove_if(particleSystems.begin(), particleSystems.end(), [](const ParticleSystem* particleSystem) noexcept {
+                return !particleSystem->isActive();
+            }), particleSystems.end());
+
+            // the finish events are dispatched after the join, because a handler can resume or delete the systems
+            for (size_t i = 0; i < finishedParticleSystems.size(); ++i)
+                if (ParticleSystem* particleSystem = finishedParticleSystems[i])
+                    particleSystem->dispatchFinishEvent();
+
+            finishedParticleSystems.clear();
+        }
+
         void SceneManager::draw()
         {
             while (scenes.size() > 1)
@@ -14,6 +14,7 @@ namespace ouzel
 {
     namespace scene
     {
+        class ParticleSystem;
         class Scene;
 
         class SceneManager final
@@ -28,6 +29,8 @@ namespace ouzel
             SceneManager(SceneManager&&) = delete;
             SceneManager& operator=(SceneManager&&) = delete;
 
+            // steps the active particle systems as parallel jobs, must be called before draw
+            void update(float delta);
             void draw();
 
             void setScene(Scene* scene);
@@ -42,7 +45,12 @@ namespace ouzel
 
             inline auto getScene() const noexcept { return scenes.empty() ? nullptr : scenes.back(); }
 
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(const ParticleSystem* particleSystem);
+
         private:
+            std::vector<ParticleSystem*> particleSystems;
+            std::vector<ParticleSystem*> finishedParticleSystems;
             std::vector<Scene*> scenes;
             std::vector<std::unique_ptr<Scene>> ownedScenes;
         };
@@ -46,18 +46,11 @@ namespace ouzel
 
             for (const DrawCommand& drawCommand : drawCommands)
             {
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
                 engine->getRenderer()->setPipelineState(blendState->getResource(),
                                                         shader->getResource(),
                                                         graphics::CullMode::NoCull,
                                                         wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants({colorVector}, {modelViewProj.m});
                 engine->getRenderer()->draw(indexBuffer.getResource(),
                                             drawCommand.indexCount,
                                             sizeof(uint16_t),
@@ -0,0 +1,315 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "SpatialIndex.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        constexpr int32_t SpatialIndex::NULL_NODE;
+        constexpr size_t SpatialIndex::MAX_DEPTH;
+
+        namespace
+        {
+            constexpr float MARGIN = 0.1F; // of the box size on every side
+
+            inline Box2F combine(const Box2F& a, const Box2F& b) noexcept
+            {
+                Box2F result = a;
+                result.merge(b);
+                return result;
+            }
+
+            inline float getPerimeter(const Box2F& box) noexcept
+            {
+                return 2.0F * ((box.max.v[0] - box.min.v[0]) + (box.max.v[1] - box.min.v[1]));
+            }
+
+            inline bool contains(const Box2F& outer, const Box2F& inner) noexcept
+            {
+                return outer.min.v[0] <= inner.min.v[0] && outer.min.v[1] <= inner.min.v[1] &&
+                    outer.max.v[0] >= inner.max.v[0] && outer.max.v[1] >= inner.max.v[1];
+            }
+
+            inline Box2F getFatBox(const Box2F& box) noexcept
+            {
+                const Vector2F margin((box.max.v[0] - box.min.v[0]) * MARGIN,
+                                      (box.max.v[1] - box.min.v[1]) * MARGIN);
+                return Box2F(box.min - margin, box.max + margin);
+            }
+        }
+
+        int32_t SpatialIndex::createProxy(const Proxy& proxy, const Box2F& box)
+        {
+            const int32_t leaf = allocateNode();
+            nodes[leaf].box = getFatBox(box);
+            nodes[leaf].proxy = proxy;
+
+            insertLeaf(leaf);
+            ++proxyCount;
+
+            return leaf;
+        }
+
+        void SpatialIndex::destroyProxy(int32_t node)
+        {
+            assert(node >= 0 && static_cast<size_t>(node) < nodes.size() && nodes[node].height == 0);
+
+            removeLeaf(node);
+            freeNode(node);
+            --proxyCount;
+        }
+
+        bool SpatialIndex::moveProxy(int32_t node, const Box2F& box)
+        {
+            assert(node >= 0 && static_cast<size_t>(node) < nodes.size() && nodes[node].height == 0);
+
+            if (contains(nodes[node].box, box)) return false;
+
+            removeLeaf(node);
+            nodes[node].box = getFatBox(box);
+            insertLeaf(node);
+
+            return true;
+        }
+
+        void SpatialIndex::clear()
+        {
+            nodes.clear();
+            root = NULL_NODE;
+            freeList = NULL_NODE;
+            proxyCount = 0;
+        }
+
+        int32_t SpatialIndex::allocateNode()
+        {
+            if (freeList == NULL_NODE)
+            {
+                nodes.emplace_back();
+                return static_cast<int32_t>(nodes.size() - 1);
+            }
+
+            const int32_t node = freeList;
+            freeList = nodes[node].parent;
+            nodes[node] = Node();
+
+            return node;
+        }
+
+        void SpatialIndex::freeNode(int32_t node)
+        {
+            nodes[node].parent = freeList;
+            nodes[node].height = -1;
+            nodes[node].proxy.actor = nullptr;
+            freeList = node;
+        }
+
+        void SpatialIndex::insertLeaf(int32_t leaf)
+        {
+            if (root == NULL_NODE)
+            {
+                root = leaf;
+                nodes[root].parent = NULL_NODE;
+                return;
+            }
+
+            // find the sibling that results in the smallest increase of the total perimeter
+            const Box2F leafBox = nodes[leaf].box;
+            int32_t index = root;
+
+            while (nodes[index].height > 0)
+            {
+                const Node& node = nodes[index];
+
+                const float perimeter = getPerimeter(node.box);
+                const float combinedPerimeter = getPerimeter(combine(node.box, leafBox));
+
+                // cost of creating a new parent for this node and the leaf
+                const float cost = 2.0F * combinedPerimeter;
+                // minimum cost of pushing the leaf further down the tree
+                const float inheritanceCost = 2.0F * (combinedPerimeter - perimeter);
+
+                const auto getCost = [this, &leafBox, inheritanceCost](int32_t child) noexcept {
+                    const Node& childNode = nodes[child];
+                    const float childPerimeter = getPerimeter(combine(childNode.box, leafBox));
+                    return (childNode.height == 0) ?
+                        childPerimeter + inheritanceCost :
+                        childPerimeter - getPerimeter(childNode.box) + inheritanceCost;
+                };
+
+                const float leftCost = getCost(node.left);
+                const float rightCost = getCost(node.right);
+
+                if (cost < leftCost && cost < rightCost) break;
+
+                index = (leftCost < rightCost) ? node.left : node.right;
+            }
+
+            const int32_t sibling = index;
+            const int32_t oldParent = nodes[sibling].parent;
+            const int32_t newParent = allocateNode();
+
+            nodes[newParent].parent = oldParent;
+            nodes[newParent].box = combine(leafBox, nodes[sibling].box);
+            nodes[newParent].height = nodes[sibling].height + 1;
+            nodes[newParent].left = sibling;
+            nodes[newParent].right = leaf;
+            nodes[sibling].parent = newParent;
+            nodes[leaf].parent = newParent;
+
+            if (oldParent == NULL_NODE)
+                root = newParent;
+            else if (nodes[oldParent].left == sibling)
+                nodes[oldParent].left = newParent;
+            else
+                nodes[oldParent].right = newParent;
+
+            // refit the ancestors
+            for (index = nodes[leaf].parent; index != NULL_NODE; index = nodes[index].parent)
+            {
+                index = balance(index);
+
+                Node& node = nodes[index];
+                node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+                node.box = combine(nodes[node.left].box, nodes[node.right].box);
+            }
+        }
+
+        void SpatialIndex::removeLeaf(int32_t leaf)
+        {
+            if (leaf == root)
+            {
+                root = NULL_NODE;
+                return;
+            }
+
+            const int32_t parent = nodes[leaf].parent;
+            const int32_t grandParent = nodes[parent].parent;
+            const int32_t sibling = (nodes[parent].left == leaf) ? nodes[parent].right : nodes[parent].left;
+
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            if (grandParent == NULL_NODE)
+            {
+                root = sibling;
+                return;
+            }
+
+            if (nodes[grandParent].left == parent)
+                nodes[grandParent].left = sibling;
+            else
+                nodes[grandParent].right = sibling;
+
+            for (int32_t index = grandParent; index != NULL_NODE; index = nodes[index].parent)
+            {
+                index = balance(index);
+
+                Node& node = nodes[index];
+                node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+                node.box = combine(nodes[node.left].box, nodes[node.right].box);
+            }
+        }
+
+        // rotates the higher child up if the node is imbalanced, returns the node that took its place
+        int32_t SpatialIndex::balance(int32_t a)
+        {
+            Node& nodeA = nodes[a];
+            if (nodeA.height < 2) return a;
+
+            const int32_t b = nodeA.left;
+            const int32_t c = nodeA.right;
+            Node& nodeB = nodes[b];
+            Node& nodeC = nodes[c];
+
+            const int32_t difference = nodeC.height - nodeB.height;
+
+            if (difference > 1)
+            {
+                const int32_t f = nodeC.left;
+                const int32_t g = nodeC.right;
+                Node& nodeF = nodes[f];
+                Node& nodeG = nodes[g];
+
+                nodeC.left = a;
+                nodeC.parent = nodeA.parent;
+                nodeA.parent = c;
+
+                if (nodeC.parent == NULL_NODE)
+                    root = c;
+                else if (nodes[nodeC.parent].left == a)
+                    nodes[nodeC.parent].left = c;
+                else
+                    nodes[nodeC.parent].right = c;
+
+                if (nodeF.height > nodeG.height)
+                {
+                    nodeC.right = f;
+                    nodeA.right = g;
+                    nodeG.parent = a;
+                    nodeA.box = combine(nodeB.box, nodeG.box);
+                    nodeC.box = combine(nodeA.box, nodeF.box);
+                    nodeA.height = 1 + std::max(nodeB.height, nodeG.height);
+                    nodeC.height = 1 + std::max(nodeA.height, nodeF.height);
+                }
+                else
+                {
+                    nodeC.right = g;
+                    nodeA.right = f;
+                    nodeF.parent = a;
+                    nodeA.box = combine(nodeB.box, nodeF.box);
+                    nodeC.box = combine(nodeA.box, nodeG.box);
+                    nodeA.height = 1 + std::max(nodeB.height, nodeF.height);
+                    nodeC.height = 1 + std::max(nodeA.height, nodeG.height);
+                }
+
+                return c;
+            }
+
+            if (difference < -1)
+            {
+                const int32_t d = nodeB.left;
+                const int32_t e = nodeB.right;
+                Node& nodeD = nodes[d];
+                Node& nodeE = nodes[e];
+
+                nodeB.left = a;
+                nodeB.parent = nodeA.parent;
+                nodeA.parent = b;
+
+                if (nodeB.parent == NULL_NODE)
+                    root = b;
+                else if (nodes[nodeB.parent].left == a)
+                    nodes[nodeB.parent].left = b;
+                else
+                    nodes[nodeB.parent].right = b;
+
+                if (nodeD.height > nodeE.height)
+                {
+                    nodeB.right = d;
+                    nodeA.left = e;
+                    nodeE.parent = a;
+                    nodeA.box = combine(nodeC.box, nodeE.box);
+                    nodeB.box = combine(nodeA.box, nodeD.box);
+                    nodeA.height = 1 + std::max(nodeC.height, nodeE.height);
+                    nodeB.height = 1 + std::max(nodeA.height, nodeD.height);
+                }
+                else
+                {
+                    nodeB.right = e;
+                    nodeA.left = d;
+                    nodeD.parent = a;
+                    nodeA.box = combine(nodeC.box, nodeD.box);
+                    nodeB.box = combine(nodeA.box, nodeE.box);
+                    nodeA.height = 1 + std::max(nodeC.height, nodeD.height);
+                    nodeB.height = 1 + std::max(nodeA.height, nodeE.height);
+                }
+
+                return b;
+            }
+
+            return a;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,127 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_SPATIALINDEX_HPP
+#define OUZEL_SCENE_SPATIALINDEX_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include "math/Box.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+
+        // Dynamic AABB tree of the actor bounding boxes projected onto the XY plane,
+        // leaves are stored with a margin, so that small movements don't restructure the tree
+        class SpatialIndex final
+        {
+        public:
+            static constexpr int32_t NULL_NODE = -1;
+
+            struct Proxy final
+            {
+                Actor* actor;
+                Box3F boundingBox; // local bounding box of the actor
+                uint32_t drawIndex; // position of the actor in the traversal order
+                uint32_t stamp;
+            };
+
+            SpatialIndex() = default;
+
+            SpatialIndex(const SpatialIndex&) = delete;
+            SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+            SpatialIndex(SpatialIndex&&) = delete;
+            SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+            int32_t createProxy(const Proxy& proxy, const Box2F& box);
+            void destroyProxy(int32_t node);
+            // returns true if the leaf had to be reinserted
+            bool moveProxy(int32_t node, const Box2F& box);
+
+            inline Proxy& getProxy(int32_t node) noexcept
+            {
+                assert(node >= 0 && static_cast<size_t>(node) < nodes.size() && nodes[node].height == 0);
+                return nodes[node].proxy;
+            }
+
+            // calls callback with every proxy whose box overlaps the given box
+            template <class F>
+            void query(const Box2F& box, F callback) const
+            {
+                if (root == NULL_NODE) return;
+
+                int32_t stack[MAX_DEPTH];
+                size_t stackSize = 0;
+                stack[stackSize++] = root;
+
+                while (stackSize)
+                {
+                    const Node& node = nodes[stack[--stackSize]];
+
+                    if (!overlaps(node.box, box)) continue;
+
+                    if (node.height == 0)
+                        callback(node.proxy);
+                    else
+                    {
+                        assert(stackSize + 2 <= MAX_DEPTH);
+                        stack[stackSize++] = node.right;
+                        stack[stackSize++] = node.left;
+                    }
+                }
+            }
+
+            // destroys all the proxies for which predicate returns true
+            template <class F>
+            void destroyProxies(F predicate)
+            {
+                // leaves don't change their index when other nodes are removed
+                for (size_t i = 0; i < nodes.size(); ++i)
+                    if (nodes[i].height == 0 && predicate(nodes[i].proxy))
+                        destroyProxy(static_cast<int32_t>(i));
+            }
+
+            void clear();
+
+            inline auto getProxyCount() const noexcept { return proxyCount; }
+
+        private:
+            // the tree is balanced, so its height is logarithmic to the number of leaves
+            static constexpr size_t MAX_DEPTH = 64;
+
+            struct Node final
+            {
+                Box2F box;
+                int32_t parent = NULL_NODE; // next free node for the nodes in the free list
+                int32_t left = NULL_NODE;
+                int32_t right = NULL_NODE;
+                int32_t height = 0; // 0 for leaves, -1 for free nodes
+                Proxy proxy{nullptr, Box3F(), 0, 0};
+            };
+
+            static inline bool overlaps(const Box2F& a, const Box2F& b) noexcept
+            {
+                return a.min.v[0] <= b.max.v[0] && a.max.v[0] >= b.min.v[0] &&
+                    a.min.v[1] <= b.max.v[1] && a.max.v[1] >= b.min.v[1];
+            }
+
+            int32_t allocateNode();
+            void freeNode(int32_t node);
+
+            void insertLeaf(int32_t leaf);
+            void removeLeaf(int32_t leaf);
+            int32_t balance(int32_t node);
+
+            std::vector<Node> nodes;
+            int32_t root = NULL_NODE;
+            int32_t freeList = NULL_NODE;
+            size_t proxyCount = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_SPATIALINDEX_HPP
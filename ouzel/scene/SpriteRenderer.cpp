@@ -1,6 +1,7 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include "SpriteRenderer.hpp"
+#include "Batcher.hpp"
 #include "core/Engine.hpp"
 #include "graphics/Renderer.hpp"
 #include "Camera.hpp"
@@ -23,7 +24,7 @@ namespace ouzel
                                  const Vector2F& pivot):
             name(frameName)
         {
-            const std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+            indices = {0, 1, 2, 1, 3, 2};
             indexCount = static_cast<uint32_t>(indices.size());
 
             Vector2F textCoords[4];
@@ -57,7 +58,7 @@ namespace ouzel
                 textCoords[3] = Vector2F(rightBottom.v[0], rightBottom.v[1]);
             }
 
-            const std::vector<graphics::Vertex> vertices{
+            vertices = {
                 graphics::Vertex(Vector3F{finalOffset.v[0], finalOffset.v[1], 0.0F}, Color::white(),
                                  textCoords[0], Vector3F{0.0F, 0.0F, -1.0F}),
                 graphics::Vertex(Vector3F{finalOffset.v[0] + frameRectangle.size.v[0], finalOffset.v[1], 0.0F}, Color::white(),
@@ -83,9 +84,11 @@ namespace ouzel
         }
 
         SpriteData::Frame::Frame(const std::string& frameName,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::Vertex>& vertices):
-            name(frameName)
+                                 const std::vector<uint16_t>& initIndices,
+                                 const std::vector<graphics::Vertex>& initVertices):
+            name(frameName),
+            indices(initIndices),
+            vertices(initVertices)
         {
             indexCount = static_cast<uint32_t>(indices.size());
 
@@ -104,13 +107,15 @@ namespace ouzel
         }
 
         SpriteData::Frame::Frame(const std::string& frameName,
-                                 const std::vector<uint16_t>& indices,
-                                 const std::vector<graphics::Vertex>& vertices,
+                                 const std::vector<uint16_t>& initIndices,
+                                 const std::vector<graphics::Vertex>& initVertices,
                                  const RectF& frameRectangle,
                                  const Size2F& sourceSize,
                                  const Vector2F& sourceOffset,
                                  const Vector2F& pivot):
-            name(frameName)
+            name(frameName),
+            indices(initIndices),
+            vertices(initVertices)
         {
             indexCount = static_cast<uint32_t>(indices.size());
 
@@ -345,23 +350,15 @@ namespace ouzel
                     material->diffuseColor.normA() * opacity * material->opacity
                 };
 
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
-                std::vector<uintptr_t> textures;
-                textures.reserve(graphics::Material::TEXTURE_LAYERS);
-                for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-                    textures.push_back(texture ? texture->getResource() : 0);
+                uintptr_t textures[graphics::Material::TEXTURE_LAYERS];
+                for (uint32_t i = 0; i < graphics::Material::TEXTURE_LAYERS; ++i)
+                    textures[i] = material->textures[i] ? material->textures[i]->getResource() : 0;
 
                 engine->getRenderer()->setPipelineState(material->blendState->getResource(),
                                                         material->shader->getResource(),
                                                         graphics::CullMode::NoCull,
                                                         wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants({colorVector}, {modelViewProj.m});
                 engine->getRenderer()->setTextures(textures);
 
                 const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
@@ -375,6 +372,35 @@ namespace ouzel
             }
         }
 
+        bool SpriteRenderer::batch(Batcher& batcher,
+                                   const Matrix4F& transformMatrix,
+                                   float opacity,
+                                   const Matrix4F& renderViewProjection,
+                                   bool wireframe)
+        {
+            if (currentAnimation != animationQueue.end() &&
+                currentAnimation->animation->frameInterval > 0.0F &&
+                !currentAnimation->animation->frames.empty() &&
+                material)
+            {
+                auto currentFrame = static_cast<size_t>(currentTime / currentAnimation->animation->frameInterval);
+                if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+
+                const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
+
+                batcher.draw(*material,
+                             graphics::CullMode::NoCull,
+                             wireframe,
+                             renderViewProjection,
+                             transformMatrix * offsetMatrix,
+                             opacity,
+                             frame.getIndices(),
+                             frame.getVertices());
+            }
+
+            return true;
+        }
+
         void SpriteRenderer::setOffset(const Vector2F& newOffset)
         {
             offset = newOffset;
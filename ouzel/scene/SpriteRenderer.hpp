@@ -39,12 +39,12 @@ namespace ouzel
                       const Vector2F& pivot);
 
                 Frame(const std::string& frameName,
-                      const std::vector<uint16_t>& indices,
-                      const std::vector<graphics::Vertex>& vertices);
+                      const std::vector<uint16_t>& initIndices,
+                      const std::vector<graphics::Vertex>& initVertices);
 
                 Frame(const std::string& frameName,
-                      const std::vector<uint16_t>& indices,
-                      const std::vector<graphics::Vertex>& vertices,
+                      const std::vector<uint16_t>& initIndices,
+                      const std::vector<graphics::Vertex>& initVertices,
                       const RectF& frameRectangle,
                       const Size2F& sourceSize,
                       const Vector2F& sourceOffset,
@@ -56,11 +56,15 @@ namespace ouzel
                 inline auto getIndexCount() const noexcept { return indexCount; }
                 inline auto& getIndexBuffer() const noexcept { return indexBuffer; }
                 inline auto& getVertexBuffer() const noexcept { return vertexBuffer; }
+                inline auto& getIndices() const noexcept { return indices; }
+                inline auto& getVertices() const noexcept { return vertices; }
 
             private:
                 std::string name;
                 Box2F boundingBox;
                 uint32_t indexCount = 0;
+                std::vector<uint16_t> indices;
+                std::vector<graphics::Vertex> vertices;
                 std::shared_ptr<graphics::Buffer> indexBuffer;
                 std::shared_ptr<graphics::Buffer> vertexBuffer;
             };
@@ -101,6 +105,12 @@ namespace ouzel
                       const Matrix4F& renderViewProjection,
                       bool wireframe) override;
 
+            bool batch(Batcher& batcher,
+                       const Matrix4F& transformMatrix,
+                       float opacity,
+                       const Matrix4F& renderViewProjection,
+                       bool wireframe) override;
+
             inline auto& getMaterial() const noexcept { return material; }
             inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
@@ -85,22 +85,15 @@ namespace ouzel
                 material->diffuseColor.normA() * opacity * material->opacity
             };
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
-            std::vector<uintptr_t> textures;
-            for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
-                textures.push_back(texture ? texture->getResource() : 0);
+            uintptr_t textures[graphics::Material::TEXTURE_LAYERS];
+            for (uint32_t i = 0; i < graphics::Material::TEXTURE_LAYERS; ++i)
+                textures[i] = material->textures[i] ? material->textures[i]->getResource() : 0;
 
             engine->getRenderer()->setPipelineState(material->blendState->getResource(),
                                                     material->shader->getResource(),
                                                     material->cullMode,
                                                     wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
+            engine->getRenderer()->setShaderConstants({colorVector}, {modelViewProj.m});
             engine->getRenderer()->setTextures(textures);
             engine->getRenderer()->draw(indexBuffer->getResource(),
                                         indexCount,
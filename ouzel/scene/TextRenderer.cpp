@@ -78,19 +78,14 @@ namespace ouzel
             const Matrix4F modelViewProj = renderViewProjection * transformMatrix;
             const float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
+            const uintptr_t textures[] = {wireframe ? whitePixelTexture->getResource() : texture->getResource()};
 
             engine->getRenderer()->setPipelineState(blendState->getResource(),
                                                     shader->getResource(),
                                                     graphics::CullMode::NoCull,
                                                     wireframe ? graphics::FillMode::Wireframe : graphics::FillMode::Solid);
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
-            engine->getRenderer()->setTextures({wireframe ? whitePixelTexture->getResource() : texture->getResource()});
+            engine->getRenderer()->setShaderConstants({colorVector}, {modelViewProj.m});
+            engine->getRenderer()->setTextures(textures);
             engine->getRenderer()->draw(indexBuffer.getResource(),
                                         static_cast<uint32_t>(indices.size()),
                                         sizeof(uint16_t),
@@ -3,104 +3,201 @@
 #ifndef OUZEL_STORAGE_ARCHIVE_HPP
 #define OUZEL_STORAGE_ARCHIVE_HPP
 
+#include <algorithm>
 #include <cstdint>
-#include <map>
+#include <memory>
 #include <stdexcept>
+#include <system_error>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "storage/File.hpp"
+#include "storage/FileData.hpp"
+#include "storage/Inflate.hpp"
 #include "utils/Utils.hpp"
 
 namespace ouzel
 {
     namespace storage
     {
+        // ZIP archive with stored and deflated entries, the entries are found through the central directory at the end of the archive
         class Archive final
         {
         public:
+            enum class Compression: uint16_t
+            {
+                Stored = 0,
+                Deflated = 8
+            };
+
+            // The bytes of a file as they are stored in the archive, they are decompressed with readStoredFile or mapStoredFile
+            class StoredFile final
+            {
+            public:
+                Compression compression = Compression::Stored;
+                uint32_t size = 0; // size of the decompressed file
+                FileData data;
+            };
+
+            struct Entry final
+            {
+                Compression compression;
+                uint32_t headerOffset;
+                uint32_t compressedSize;
+                uint32_t size;
+            };
+
             Archive() = default;
 
             explicit Archive(const std::string& path):
                 file{File(path, File::Mode::Read)}
             {
+                constexpr uint32_t END_OF_CENTRAL_DIRECTORY = 0x06054B50;
                 constexpr uint32_t CENTRAL_DIRECTORY = 0x02014B50;
-                constexpr uint32_t HEADER_SIGNATURE = 0x04034B50;
+                constexpr uint32_t END_RECORD_SIZE = 22;
+                constexpr uint32_t CENTRAL_HEADER_SIZE = 46;
 
-                for (;;)
+#if !defined(__EMSCRIPTEN__)
+                try
+                {
+                    mappedFile = std::make_shared<const MappedFile>(path);
+                }
+                catch (const std::system_error&)
                 {
-                    uint32_t signature;
+                    // the entries are read from the file instead
+                }
+#endif
 
-                    file.read(&signature, sizeof(signature), true);
+                const uint64_t fileSize = mappedFile ? mappedFile->getSize() : file.getSize();
 
-                    if (decodeLittleEndian<uint32_t>(&signature) == CENTRAL_DIRECTORY)
-                        break;
+                if (fileSize < END_RECORD_SIZE)
+                    throw std::runtime_error("Archive is too small");
 
-                    if (decodeLittleEndian<uint32_t>(&signature) != HEADER_SIGNATURE)
-                        throw std::runtime_error("Bad signature");
+                // the end record is followed by a comment of up to 65535 bytes
+                const auto tailSize = static_cast<uint32_t>(std::min(fileSize, static_cast<uint64_t>(END_RECORD_SIZE + 0xFFFF)));
+                const FileData tail = readRange(static_cast<uint32_t>(fileSize - tailSize), tailSize);
 
-                    uint8_t version[2];
+                const uint8_t* endRecord = nullptr;
+                for (uint32_t i = tailSize - END_RECORD_SIZE + 1; i-- > 0;)
+                    if (decodeLittleEndian<uint32_t>(tail.data() + i) == END_OF_CENTRAL_DIRECTORY)
+                    {
+                        endRecord = tail.data() + i;
+                        break;
+                    }
 
-                    file.read(version, sizeof(version), true);
+                if (!endRecord)
+                    throw std::runtime_error("Central directory not found");
 
-                    uint16_t flags;
+                const auto entryCount = decodeLittleEndian<uint16_t>(endRecord + 10);
+                const auto directorySize = decodeLittleEndian<uint32_t>(endRecord + 12);
+                const auto directoryOffset = decodeLittleEndian<uint32_t>(endRecord + 16);
 
-                    file.read(&flags, sizeof(flags), true);
+                // ZIP64 archives store the fields that don't fit in the end record in a separate record
+                if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+                    throw std::runtime_error("ZIP64 archives are not supported");
 
-                    uint16_t compression;
-                    file.read(&compression, sizeof(compression), true);
+                if (directoryOffset > fileSize || directorySize > fileSize - directoryOffset)
+                    throw std::runtime_error("Invalid central directory");
 
-                    if (compression != 0x00)
-                        throw std::runtime_error("Unsupported compression");
+                // the whole directory is read at once, the local headers are read only when the file is opened
+                const FileData directory = readRange(directoryOffset, directorySize);
+                entries.reserve(entryCount);
 
-                    file.seek(4, File::Seek::Current); // skip modification time
-                    file.seek(4, File::Seek::Current); // skip CRC-32
+                const uint8_t* header = directory.begin();
 
-                    uint32_t compressedSize;
-                    file.read(&compressedSize, sizeof(compressedSize), true);
+                for (uint16_t i = 0; i < entryCount; ++i)
+                {
+                    if (static_cast<size_t>(directory.end() - header) < CENTRAL_HEADER_SIZE ||
+                        decodeLittleEndian<uint32_t>(header) != CENTRAL_DIRECTORY)
+                        throw std::runtime_error("Bad signature");
 
-                    uint32_t uncompressedSize;
-                    file.read(&uncompressedSize, sizeof(uncompressedSize), true);
+                    const auto flags = decodeLittleEndian<uint16_t>(header + 8);
+                    const auto compression = decodeLittleEndian<uint16_t>(header + 10);
+                    const auto fileNameLength = decodeLittleEndian<uint16_t>(header + 28);
+                    const auto extraFieldLength = decodeLittleEndian<uint16_t>(header + 30);
+                    const auto commentLength = decodeLittleEndian<uint16_t>(header + 32);
 
-                    uint16_t fileNameLength;
-                    file.read(&fileNameLength, sizeof(fileNameLength), true);
+                    if (flags & 0x01)
+                        throw std::runtime_error("Encrypted files are not supported");
 
-                    uint16_t extraFieldLength;
-                    file.read(&extraFieldLength, sizeof(extraFieldLength), true);
+                    if (compression != static_cast<uint16_t>(Compression::Stored) &&
+                        compression != static_cast<uint16_t>(Compression::Deflated))
+                        throw std::runtime_error("Unsupported compression");
 
-                    std::vector<char> name(decodeLittleEndian<uint16_t>(&fileNameLength) + 1);
+                    const size_t headerSize = CENTRAL_HEADER_SIZE + fileNameLength + extraFieldLength + commentLength;
+                    if (static_cast<size_t>(directory.end() - header) < headerSize)
+                        throw std::runtime_error("Invalid central directory");
 
-                    file.read(name.data(), decodeLittleEndian<uint16_t>(&fileNameLength), true);
+                    Entry& entry = entries[std::string(reinterpret_cast<const char*>(header + CENTRAL_HEADER_SIZE), fileNameLength)];
+                    entry.compression = static_cast<Compression>(compression);
+                    entry.compressedSize = decodeLittleEndian<uint32_t>(header + 20);
+                    entry.size = decodeLittleEndian<uint32_t>(header + 24);
+                    entry.headerOffset = decodeLittleEndian<uint32_t>(header + 42);
 
-                    name[decodeLittleEndian<uint16_t>(&fileNameLength)] = '\0';
+                    header += headerSize;
+                }
+            }
 
-                    Entry& entry = entries[name.data()];
-                    entry.size = decodeLittleEndian<uint32_t>(&uncompressedSize);
+            std::vector<uint8_t> readFile(const std::string& filename) const
+            {
+                return readStoredFile(getStoredFile(filename));
+            }
 
-                    file.seek(decodeLittleEndian<uint16_t>(&extraFieldLength), File::Seek::Current); // skip extra field
+            // a view of the mapped archive for the stored files, the files are read if the archive could not be mapped
+            FileData mapFile(const std::string& filename) const
+            {
+                return mapStoredFile(getStoredFile(filename));
+            }
 
-                    entry.offset = file.getOffset();
+            // readStoredFile and mapStoredFile don't use the archive, so the files can be decompressed
+            // without holding the lock of the archive
+            static std::vector<uint8_t> readStoredFile(const StoredFile& storedFile)
+            {
+                if (storedFile.compression == Compression::Stored)
+                    return std::vector<uint8_t>(storedFile.data.begin(), storedFile.data.end());
 
-                    file.seek(static_cast<int32_t>(decodeLittleEndian<uint32_t>(&uncompressedSize)),
-                              File::Seek::Current); // skip uncompressed size
-                }
+                return decompress(storedFile);
             }
 
-            std::vector<uint8_t> readFile(const std::string& filename) const
+            static FileData mapStoredFile(const StoredFile& storedFile)
             {
-                std::vector<uint8_t> data;
+                if (storedFile.compression == Compression::Stored)
+                    return storedFile.data;
 
+                return FileData(decompress(storedFile));
+            }
+
+            StoredFile getStoredFile(const std::string& filename) const
+            {
                 auto i = entries.find(filename);
 
                 if (i == entries.end())
                     throw std::runtime_error("File " + filename + " does not exist");
 
-                file.seek(static_cast<int32_t>(i->second.offset), File::Seek::Begin);
+                return getStoredFile(i->second);
+            }
 
-                data.resize(i->second.size);
+            // the entry has to be one of the entries of this archive
+            StoredFile getStoredFile(const Entry& entry) const
+            {
+                constexpr uint32_t HEADER_SIGNATURE = 0x04034B50;
+                constexpr uint32_t LOCAL_HEADER_SIZE = 30;
 
-                file.read(data.data(), i->second.size, true);
+                // the extra field of the local header can differ from the one in the central directory
+                const FileData header = readRange(entry.headerOffset, LOCAL_HEADER_SIZE);
 
-                return data;
+                if (decodeLittleEndian<uint32_t>(header.data()) != HEADER_SIGNATURE)
+                    throw std::runtime_error("Bad signature");
+
+                const uint32_t offset = entry.headerOffset + LOCAL_HEADER_SIZE +
+                    decodeLittleEndian<uint16_t>(header.data() + 26) +
+                    decodeLittleEndian<uint16_t>(header.data() + 28);
+
+                StoredFile storedFile;
+                storedFile.compression = entry.compression;
+                storedFile.size = entry.size;
+                storedFile.data = readRange(offset, entry.compression == Compression::Stored ? entry.size : entry.compressedSize);
+                return storedFile;
             }
 
             bool fileExists(const std::string& filename) const
@@ -108,16 +205,32 @@ namespace ouzel
                 return entries.find(filename) != entries.end();
             }
 
+            // the entries don't move while the archive exists
+            inline auto& getEntries() const noexcept { return entries; }
+
         private:
-            File file;
+            static std::vector<uint8_t> decompress(const StoredFile& storedFile)
+            {
+                std::vector<uint8_t> data(storedFile.size);
+                inflate(storedFile.data.data(), storedFile.data.size(), data.data(), data.size());
+                return data;
+            }
 
-            struct Entry final
+            FileData readRange(uint32_t offset, uint32_t size) const
             {
-                uint32_t offset;
-                uint32_t size;
-            };
+                if (mappedFile)
+                    return FileData(mappedFile, offset, size);
+
+                std::vector<uint8_t> data(size);
+                file.seek(static_cast<int32_t>(offset), File::Seek::Begin);
+                if (file.read(data.data(), size, true) != size)
+                    throw std::runtime_error("Failed to read archive");
+                return FileData(std::move(data));
+            }
 
-            std::map<std::string, Entry> entries;
+            File file;
+            std::shared_ptr<const MappedFile> mappedFile;
+            std::unordered_map<std::string, Entry> entries;
         };
     } // namespace storage
 } // namespace ouzel
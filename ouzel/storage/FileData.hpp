@@ -0,0 +1,142 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_FILEDATA_HPP
+#define OUZEL_STORAGE_FILEDATA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "storage/File.hpp"
+#include "utils/Span.hpp"
+
+#if !defined(_WIN32)
+#  include <sys/mman.h>
+#endif
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // The whole file mapped to memory for reading, the pages are loaded when they are first accessed
+        class MappedFile final
+        {
+        public:
+            explicit MappedFile(const std::string& filename)
+            {
+                const File file(filename, File::Mode::Read);
+                const uint64_t fileSize = file.getSize();
+
+                if (fileSize > std::numeric_limits<size_t>::max())
+                    throw std::runtime_error("File is too big to be mapped");
+
+                size = static_cast<size_t>(fileSize);
+
+                // empty files can not be mapped
+                if (!size) return;
+
+#if defined(_WIN32)
+                mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping)
+                    throw std::system_error(GetLastError(), std::system_category(), "Failed to create file mapping");
+
+                const void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (!address)
+                {
+                    const DWORD error = GetLastError();
+                    CloseHandle(mapping);
+                    throw std::system_error(error, std::system_category(), "Failed to map file");
+                }
+#else
+                const void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (address == MAP_FAILED)
+                    throw std::system_error(errno, std::system_category(), "Failed to map file");
+#endif
+
+                data = static_cast<const uint8_t*>(address);
+            }
+
+            ~MappedFile()
+            {
+                if (data)
+                {
+#if defined(_WIN32)
+                    UnmapViewOfFile(data);
+                    CloseHandle(mapping);
+#else
+                    munmap(const_cast<uint8_t*>(data), size);
+#endif
+                }
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&&) = delete;
+            MappedFile& operator=(MappedFile&&) = delete;
+
+            inline auto getData() const noexcept { return data; }
+            inline auto getSize() const noexcept { return size; }
+
+        private:
+#if defined(_WIN32)
+            HANDLE mapping = nullptr;
+#endif
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+        };
+
+        // Read-only contents of a file, either a range of a mapped file or a buffer that the file was read into.
+        // Copies share the bytes, which stay valid as long as any of the copies exists.
+        class FileData final
+        {
+        public:
+            FileData() noexcept = default;
+
+            explicit FileData(std::vector<uint8_t> buffer)
+            {
+                auto vector = std::make_shared<const std::vector<uint8_t>>(std::move(buffer));
+                bytes = vector->data();
+                count = vector->size();
+                owner = std::move(vector);
+            }
+
+            explicit FileData(const std::shared_ptr<const MappedFile>& mappedFile):
+                owner(mappedFile), bytes(mappedFile->getData()), count(mappedFile->getSize())
+            {
+            }
+
+            FileData(const std::shared_ptr<const MappedFile>& mappedFile, size_t offset, size_t size):
+                owner(mappedFile)
+            {
+                if (offset > mappedFile->getSize() || size > mappedFile->getSize() - offset)
+                    throw std::out_of_range("Range is outside of the mapped file");
+
+                bytes = mappedFile->getData() + offset;
+                count = size;
+            }
+
+            inline const uint8_t* data() const noexcept { return bytes; }
+            inline size_t size() const noexcept { return count; }
+            inline bool empty() const noexcept { return count == 0; }
+
+            inline const uint8_t* begin() const noexcept { return bytes; }
+            inline const uint8_t* end() const noexcept { return bytes + count; }
+
+            inline const uint8_t& operator[](size_t index) const noexcept { return bytes[index]; }
+
+            inline operator Span<uint8_t>() const noexcept { return Span<uint8_t>(bytes, count); }
+
+        private:
+            std::shared_ptr<const void> owner;
+            const uint8_t* bytes = nullptr;
+            size_t count = 0;
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_FILEDATA_HPP
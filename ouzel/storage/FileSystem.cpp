@@ -51,6 +51,22 @@ namespace ouzel
 {
     namespace storage
     {
+        namespace
+        {
+            // the names in ZIP archives use forward slashes and don't start with "./"
+            std::string getArchivePath(const std::string& filename)
+            {
+                std::string result = filename;
+                std::replace(result.begin(), result.end(), '\\', '/');
+
+                size_t start = 0;
+                while (result.compare(start, 2, "./") == 0) start += 2;
+
+                result.erase(0, start);
+                return result;
+            }
+        }
+
 #if defined(_WIN32)
         const std::string FileSystem::DIRECTORY_SEPARATOR = "\\";
 #else
@@ -329,12 +345,13 @@ namespace ouzel
         std::vector<uint8_t> FileSystem::readFile(const std::string& filename, const bool searchResources) const
         {
             if (searchResources)
-                for (const auto& archive : archives)
-                    if (archive.second.fileExists(filename))
-                        return archive.second.readFile(filename);
+            {
+                Archive::StoredFile storedFile;
+                if (getStoredFile(filename, storedFile))
+                    return Archive::readStoredFile(storedFile);
+            }
 
             std::vector<uint8_t> data;
-            char buffer[1024];
 
 #if defined(__ANDROID__)
             if (pathIsRelative(filename))
@@ -346,13 +363,21 @@ namespace ouzel
                 if (!asset)
                     throw std::runtime_error("Failed to open file " + filename);
 
-                int bytesRead = 0;
+                data.resize(static_cast<size_t>(AAsset_getLength(asset)));
 
-                while ((bytesRead = AAsset_read(asset, buffer, sizeof(buffer))) > 0)
-                    data.insert(data.end(), reinterpret_cast<uint8_t*>(buffer), reinterpret_cast<uint8_t*>(buffer + bytesRead));
+                size_t offset = 0;
+                while (offset < data.size())
+                {
+                    const int bytesRead = AAsset_read(asset, data.data() + offset, data.size() - offset);
+                    if (bytesRead <= 0) break;
+                    offset += static_cast<size_t>(bytesRead);
+                }
 
                 AAsset_close(asset);
 
+                if (offset != data.size())
+                    throw std::runtime_error("Failed to read file " + filename);
+
                 return data;
             }
 #endif
@@ -365,12 +390,50 @@ namespace ouzel
 
             File file(path, File::Mode::Read);
 
-            while (const uint32_t size = file.read(buffer, sizeof(buffer)))
-                data.insert(data.end(), buffer, buffer + size);
+            // the whole file is read at once instead of growing the buffer
+            data.resize(static_cast<size_t>(file.getSize()));
+
+            if (!data.empty() && file.read(data.data(), static_cast<uint32_t>(data.size()), true) != data.size())
+                throw std::runtime_error("Failed to read file " + filename);
 
             return data;
         }
 
+        FileData FileSystem::mapFile(const std::string& filename, const bool searchResources) const
+        {
+            if (searchResources)
+            {
+                Archive::StoredFile storedFile;
+                if (getStoredFile(filename, storedFile))
+                    return Archive::mapStoredFile(storedFile);
+            }
+
+#if defined(__ANDROID__)
+            // the assets are in the APK
+            if (pathIsRelative(filename))
+                return FileData(readFile(filename, false));
+#endif
+
+            const auto path = getPath(filename, searchResources);
+
+            // file does not exist
+            if (path.empty())
+                throw std::runtime_error("Failed to find file " + filename);
+
+#if !defined(__EMSCRIPTEN__)
+            try
+            {
+                return FileData(std::make_shared<const MappedFile>(path));
+            }
+            catch (const std::system_error&)
+            {
+                // the file system does not support mapping, so the file is read instead
+            }
+#endif
+
+            return FileData(readFile(path, false));
+        }
+
         void FileSystem::writeFile(const std::string& filename, const std::vector<uint8_t>& data) const
         {
             File file(filename, File::Mode::Write | File::Mode::Create | File::Mode::Truncate);
@@ -384,8 +447,31 @@ namespace ouzel
             }
         }
 
+        bool FileSystem::getStoredFile(const std::string& filename, Archive::StoredFile& storedFile) const
+        {
+            const std::string path = getArchivePath(filename);
+
+            // reading from an archive that could not be mapped moves the position of its file, so the loading threads take turns
+            std::lock_guard<std::mutex> lock(archiveMutex);
+
+            auto i = resourceIndex.find(path);
+            if (i == resourceIndex.end())
+                return false;
+
+            storedFile = i->second.archive->getStoredFile(*i->second.entry);
+            return true;
+        }
+
         bool FileSystem::resourceFileExists(const std::string& filename) const
         {
+            {
+                const std::string path = getArchivePath(filename);
+
+                std::lock_guard<std::mutex> lock(archiveMutex);
+                if (resourceIndex.find(path) != resourceIndex.end())
+                    return true;
+            }
+
             if (!pathIsRelative(filename))
                 return fileExists(filename);
             else
@@ -540,14 +626,48 @@ namespace ouzel
 
         void FileSystem::addArchive(const std::string& name, Archive&& archive)
         {
-            archives.emplace_back(name, std::move(archive));
+            std::lock_guard<std::mutex> lock(archiveMutex);
+            archives.emplace_back(name, std::make_unique<Archive>(std::move(archive)));
+
+            const Archive* addedArchive = archives.back().second.get();
+            const auto& entries = addedArchive->getEntries();
+            resourceIndex.reserve(resourceIndex.size() + entries.size());
+
+            // the files that are already in the index stay in the archives that were added before
+            for (const auto& entry : entries)
+                resourceIndex.emplace(entry.first, ResourceEntry{addedArchive, &entry.second});
         }
 
         void FileSystem::removeArchive(const std::string& name)
         {
+            std::lock_guard<std::mutex> lock(archiveMutex);
+
             for (auto i = archives.begin(); i != archives.end();)
                 if (i->first == name)
+                {
+                    const std::unique_ptr<Archive> removedArchive = std::move(i->second);
                     i = archives.erase(i);
+
+                    // only the files of the removed archive are looked up in the remaining archives
+                    for (const auto& entry : removedArchive->getEntries())
+                    {
+                        auto indexEntry = resourceIndex.find(entry.first);
+                        if (indexEntry == resourceIndex.end() || indexEntry->second.archive != removedArchive.get())
+                            continue;
+
+                        resourceIndex.erase(indexEntry);
+
+                        for (const auto& archive : archives)
+                        {
+                            auto archiveEntry = archive.second->getEntries().find(entry.first);
+                            if (archiveEntry != archive.second->getEntries().end())
+                            {
+                                resourceIndex.emplace(entry.first, ResourceEntry{archive.second.get(), &archiveEntry->second});
+                                break;
+                            }
+                        }
+                    }
+                }
                 else
                     ++i;
         }
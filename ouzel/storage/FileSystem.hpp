@@ -3,10 +3,15 @@
 #ifndef OUZEL_STORAGE_FILESYSTEM_HPP
 #define OUZEL_STORAGE_FILESYSTEM_HPP
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 #include "Archive.hpp"
+#include "FileData.hpp"
+#include "math/Fnv.hpp"
 
 namespace ouzel
 {
@@ -25,6 +30,8 @@ namespace ouzel
             std::string getTempDirectory() const;
 
             std::vector<uint8_t> readFile(const std::string& filename, const bool searchResources = true) const;
+            // maps the file to memory if possible instead of copying it
+            FileData mapFile(const std::string& filename, const bool searchResources = true) const;
             void writeFile(const std::string& filename, const std::vector<uint8_t>& data) const;
 
             bool resourceFileExists(const std::string& filename) const;
@@ -43,10 +50,32 @@ namespace ouzel
             bool fileExists(const std::string& filename) const;
 
         private:
+            class PathHash final
+            {
+            public:
+                size_t operator()(const std::string& path) const noexcept
+                {
+                    const auto data = reinterpret_cast<const uint8_t*>(path.data());
+                    return static_cast<size_t>(fnv::hash<uint64_t>(data, data + path.size()));
+                }
+            };
+
+            struct ResourceEntry final
+            {
+                const Archive* archive;
+                const Archive::Entry* entry;
+            };
+
+            // finds the file in the archives, the file is decompressed after the lock of the archives is released
+            bool getStoredFile(const std::string& filename, Archive::StoredFile& storedFile) const;
+
             Engine& engine;
             std::string appPath;
             std::vector<std::string> resourcePaths;
-            std::vector<std::pair<std::string, Archive>> archives;
+            std::vector<std::pair<std::string, std::unique_ptr<Archive>>> archives;
+            // the files of all the archives, a file is read from the archive that was added first
+            std::unordered_map<std::string, ResourceEntry, PathHash> resourceIndex;
+            mutable std::mutex archiveMutex; // readFile is called from the loading threads
         };
     } // namespace storage
 } // namespace ouzel
@@ -0,0 +1,376 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include "Inflate.hpp"
+
+namespace ouzel
+{
+    namespace storage
+    {
+        namespace
+        {
+            constexpr uint32_t MAX_BITS = 15;
+            constexpr uint32_t FAST_BITS = 10; // codes up to this length are decoded with a single table lookup
+            constexpr uint32_t FAST_MASK = (1U << FAST_BITS) - 1;
+
+            constexpr uint16_t LENGTH_BASE[29] = {
+                3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+            };
+            constexpr uint8_t LENGTH_EXTRA[29] = {
+                0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+            };
+            constexpr uint16_t DISTANCE_BASE[30] = {
+                1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+            };
+            constexpr uint8_t DISTANCE_EXTRA[30] = {
+                0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+            };
+            // the order in which the lengths of the code length code are stored
+            constexpr uint8_t CODE_LENGTH_ORDER[19] = {
+                16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+            };
+
+            // Canonical Huffman code. The fast table is indexed by the next FAST_BITS bits of the stream
+            // and holds the symbol shifted left by four and the length of its code, zero for the longer codes.
+            class Huffman final
+            {
+            public:
+                Huffman(const uint8_t* lengths, uint32_t count)
+                {
+                    for (uint32_t symbol = 0; symbol < count; ++symbol)
+                        ++counts[lengths[symbol]];
+
+                    counts[0] = 0;
+
+                    int32_t left = 1;
+                    for (uint32_t length = 1; length <= MAX_BITS; ++length)
+                    {
+                        left <<= 1;
+                        left -= counts[length];
+                        if (left < 0)
+                            throw std::runtime_error("Invalid Huffman code");
+                    }
+
+                    uint16_t offsets[MAX_BITS + 1];
+                    offsets[1] = 0;
+                    for (uint32_t length = 1; length < MAX_BITS; ++length)
+                        offsets[length + 1] = static_cast<uint16_t>(offsets[length] + counts[length]);
+
+                    for (uint32_t symbol = 0; symbol < count; ++symbol)
+                        if (lengths[symbol])
+                            symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+
+                    uint32_t code = 0;
+                    uint32_t index = 0;
+                    for (uint32_t length = 1; length <= FAST_BITS; ++length)
+                    {
+                        for (uint32_t i = 0; i < counts[length]; ++i, ++code, ++index)
+                        {
+                            // the codes are stored starting from the most significant bit
+                            uint32_t reversed = 0;
+                            for (uint32_t bit = 0; bit < length; ++bit)
+                                reversed |= ((code >> bit) & 1U) << (length - 1 - bit);
+
+                            const auto entry = static_cast<uint16_t>((symbols[index] << 4) | length);
+                            for (uint32_t j = reversed; j <= FAST_MASK; j += 1U << length)
+                                fast[j] = entry;
+                        }
+
+                        code <<= 1;
+                    }
+                }
+
+                uint16_t counts[MAX_BITS + 1] = {};
+                uint16_t symbols[288] = {};
+                uint16_t fast[FAST_MASK + 1] = {};
+            };
+
+            class Inflater final
+            {
+            public:
+                Inflater(const uint8_t* initInput, size_t initInputSize, uint8_t* initOutput, size_t initOutputSize):
+                    input(initInput), inputSize(initInputSize), output(initOutput), outputSize(initOutputSize)
+                {
+                }
+
+                void run()
+                {
+                    bool last;
+
+                    do
+                    {
+                        last = getBits(1) != 0;
+
+                        switch (getBits(2))
+                        {
+                            case 0:
+                                copyStored();
+                                break;
+                            case 1:
+                            {
+                                static const Huffman fixedLiteralCode = createFixedLiteralCode();
+                                static const Huffman fixedDistanceCode = createFixedDistanceCode();
+                                decodeBlock(fixedLiteralCode, fixedDistanceCode);
+                                break;
+                            }
+                            case 2:
+                                decodeDynamicBlock();
+                                break;
+                            default:
+                                throw std::runtime_error("Invalid block type");
+                        }
+                    }
+                    while (!last);
+
+                    if (outputPosition != outputSize)
+                        throw std::runtime_error("Decompressed data is shorter than expected");
+                }
+
+            private:
+                static Huffman createFixedLiteralCode()
+                {
+                    uint8_t lengths[288];
+                    std::fill(lengths, lengths + 144, static_cast<uint8_t>(8));
+                    std::fill(lengths + 144, lengths + 256, static_cast<uint8_t>(9));
+                    std::fill(lengths + 256, lengths + 280, static_cast<uint8_t>(7));
+                    std::fill(lengths + 280, lengths + 288, static_cast<uint8_t>(8));
+                    return Huffman(lengths, 288);
+                }
+
+                static Huffman createFixedDistanceCode()
+                {
+                    uint8_t lengths[30];
+                    std::fill(std::begin(lengths), std::end(lengths), static_cast<uint8_t>(5));
+                    return Huffman(lengths, 30);
+                }
+
+                inline void refill() noexcept
+                {
+                    while (bitCount <= 56 && inputPosition < inputSize)
+                    {
+                        bitBuffer |= static_cast<uint64_t>(input[inputPosition++]) << bitCount;
+                        bitCount += 8;
+                    }
+                }
+
+                inline void consume(uint32_t count) noexcept
+                {
+                    bitBuffer >>= count;
+                    bitCount -= count;
+                }
+
+                inline uint32_t getBits(uint32_t count)
+                {
+                    if (bitCount < count)
+                    {
+                        refill();
+                        if (bitCount < count)
+                            throw std::runtime_error("Unexpected end of compressed data");
+                    }
+
+                    const auto result = static_cast<uint32_t>(bitBuffer & ((1U << count) - 1));
+                    consume(count);
+                    return result;
+                }
+
+                uint32_t decode(const Huffman& huffman)
+                {
+                    if (bitCount < MAX_BITS) refill();
+
+                    const uint16_t entry = huffman.fast[bitBuffer & FAST_MASK];
+                    if (entry)
+                    {
+                        const uint32_t length = entry & 0x0F;
+                        if (length > bitCount)
+                            throw std::runtime_error("Unexpected end of compressed data");
+
+                        consume(length);
+                        return entry >> 4;
+                    }
+
+                    // codes longer than FAST_BITS are decoded one bit at a time
+                    int32_t code = 0;
+                    int32_t first = 0;
+                    int32_t index = 0;
+
+                    for (uint32_t length = 1; length <= MAX_BITS && length <= bitCount; ++length)
+                    {
+                        code |= static_cast<int32_t>((bitBuffer >> (length - 1)) & 1U);
+                        const int32_t count = huffman.counts[length];
+
+                        if (code - count < first)
+                        {
+                            consume(length);
+                            return huffman.symbols[index + (code - first)];
+                        }
+
+                        index += count;
+                        first = (first + count) << 1;
+                        code <<= 1;
+                    }
+
+                    throw std::runtime_error("Invalid Huffman code");
+                }
+
+                void copyStored()
+                {
+                    consume(bitCount % 8);
+
+                    const uint32_t length = getBits(16);
+                    const uint32_t lengthComplement = getBits(16);
+
+                    if (length != (~lengthComplement & 0xFFFF))
+                        throw std::runtime_error("Invalid stored block length");
+
+                    if (length > outputSize - outputPosition)
+                        throw std::runtime_error("Decompressed data is longer than expected");
+
+                    // the bytes that are already in the bit buffer
+                    uint32_t remaining = length;
+                    for (; remaining && bitCount; --remaining)
+                        output[outputPosition++] = static_cast<uint8_t>(getBits(8));
+
+                    if (remaining > inputSize - inputPosition)
+                        throw std::runtime_error("Unexpected end of compressed data");
+
+                    std::memcpy(output + outputPosition, input + inputPosition, remaining);
+                    outputPosition += remaining;
+                    inputPosition += remaining;
+                }
+
+                void decodeDynamicBlock()
+                {
+                    const uint32_t literalCount = getBits(5) + 257;
+                    const uint32_t distanceCount = getBits(5) + 1;
+                    const uint32_t codeLengthCount = getBits(4) + 4;
+
+                    if (literalCount > 286 || distanceCount > 30)
+                        throw std::runtime_error("Invalid code counts");
+
+                    uint8_t codeLengths[19] = {};
+                    for (uint32_t i = 0; i < codeLengthCount; ++i)
+                        codeLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(getBits(3));
+
+                    const Huffman codeLengthCode(codeLengths, 19);
+
+                    uint8_t lengths[286 + 30] = {};
+                    const uint32_t count = literalCount + distanceCount;
+
+                    for (uint32_t index = 0; index < count;)
+                    {
+                        const uint32_t symbol = decode(codeLengthCode);
+
+                        if (symbol < 16)
+                            lengths[index++] = static_cast<uint8_t>(symbol);
+                        else
+                        {
+                            uint8_t value = 0;
+                            uint32_t repeat;
+
+                            if (symbol == 16)
+                            {
+                                if (index == 0)
+                                    throw std::runtime_error("No length to repeat");
+
+                                value = lengths[index - 1];
+                                repeat = 3 + getBits(2);
+                            }
+                            else if (symbol == 17)
+                                repeat = 3 + getBits(3);
+                            else
+                                repeat = 11 + getBits(7);
+
+                            if (repeat > count - index)
+                                throw std::runtime_error("Too many code lengths");
+
+                            std::fill(lengths + index, lengths + index + repeat, value);
+                            index += repeat;
+                        }
+                    }
+
+                    if (!lengths[256])
+                        throw std::runtime_error("Missing end of block code");
+
+                    const Huffman literalCode(lengths, literalCount);
+                    const Huffman distanceCode(lengths + literalCount, distanceCount);
+                    decodeBlock(literalCode, distanceCode);
+                }
+
+                void decodeBlock(const Huffman& literalCode, const Huffman& distanceCode)
+                {
+                    for (;;)
+                    {
+                        uint32_t symbol = decode(literalCode);
+
+                        if (symbol < 256)
+                        {
+                            if (outputPosition == outputSize)
+                                throw std::runtime_error("Decompressed data is longer than expected");
+
+                            output[outputPosition++] = static_cast<uint8_t>(symbol);
+                        }
+                        else if (symbol == 256)
+                            return;
+                        else
+                        {
+                            symbol -= 257;
+                            if (symbol >= 29)
+                                throw std::runtime_error("Invalid length code");
+
+                            const size_t length = LENGTH_BASE[symbol] + getBits(LENGTH_EXTRA[symbol]);
+
+                            const uint32_t distanceSymbol = decode(distanceCode);
+                            if (distanceSymbol >= 30)
+                                throw std::runtime_error("Invalid distance code");
+
+                            const size_t distance = DISTANCE_BASE[distanceSymbol] + getBits(DISTANCE_EXTRA[distanceSymbol]);
+
+                            if (distance > outputPosition)
+                                throw std::runtime_error("Distance is too far back");
+
+                            if (length > outputSize - outputPosition)
+                                throw std::runtime_error("Decompressed data is longer than expected");
+
+                            const uint8_t* from = output + outputPosition - distance;
+                            uint8_t* to = output + outputPosition;
+
+                            // overlapping copies repeat the last distance bytes, so they are copied distance bytes at a time
+                            if (distance >= length)
+                                std::memcpy(to, from, length);
+                            else if (distance == 1)
+                                std::memset(to, *from, length);
+                            else
+                                for (size_t copied = 0; copied < length; copied += distance)
+                                    std::memcpy(to + copied, from + copied, std::min(distance, length - copied));
+
+                            outputPosition += length;
+                        }
+                    }
+                }
+
+                const uint8_t* input;
+                size_t inputSize;
+                size_t inputPosition = 0;
+                uint8_t* output;
+                size_t outputSize;
+                size_t outputPosition = 0;
+
+                uint64_t bitBuffer = 0;
+                uint32_t bitCount = 0;
+            };
+        }
+
+        void inflate(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize)
+        {
+            Inflater inflater(input, inputSize, output, outputSize);
+            inflater.run();
+        }
+    } // namespace storage
+} // namespace ouzel
@@ -0,0 +1,19 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_INFLATE_HPP
+#define OUZEL_STORAGE_INFLATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // Decompresses raw DEFLATE data (RFC 1951) into the output, which has to be exactly the size of the decompressed data.
+        // Throws if the data is corrupt or if it does not fill the output.
+        void inflate(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_INFLATE_HPP
@@ -0,0 +1,49 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_SPAN_HPP
+#define OUZEL_UTILS_SPAN_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ouzel
+{
+    // Non-owning view of a contiguous read-only sequence, must not outlive the viewed data
+    template <class T>
+    class Span final
+    {
+    public:
+        constexpr Span() noexcept = default;
+
+        constexpr Span(const T* initData, size_t initSize) noexcept:
+            elements(initData), count(initSize)
+        {
+        }
+
+        template <size_t N>
+        constexpr Span(const T (&array)[N]) noexcept:
+            elements(array), count(N)
+        {
+        }
+
+        Span(const std::vector<T>& vec) noexcept:
+            elements(vec.data()), count(vec.size())
+        {
+        }
+
+        constexpr const T* data() const noexcept { return elements; }
+        constexpr size_t size() const noexcept { return count; }
+        constexpr bool empty() const noexcept { return count == 0; }
+
+        constexpr const T* begin() const noexcept { return elements; }
+        constexpr const T* end() const noexcept { return elements + count; }
+
+        constexpr const T& operator[](size_t index) const noexcept { return elements[index]; }
+
+    private:
+        const T* elements = nullptr;
+        size_t count = 0;
+    };
+}
+
+#endif // OUZEL_UTILS_SPAN_HPP
@@ -0,0 +1,67 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_SPSCQUEUE_HPP
+#define OUZEL_UTILS_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ouzel
+{
+    // Fixed-capacity wait-free queue for exactly one producer thread and one consumer thread,
+    // the slots are allocated up front so push and pop never allocate
+    template <class T>
+    class SpscQueue final
+    {
+    public:
+        explicit SpscQueue(size_t capacity):
+            slots(capacity + 1)
+        {
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        SpscQueue(SpscQueue&&) = delete;
+        SpscQueue& operator=(SpscQueue&&) = delete;
+
+        inline auto getCapacity() const noexcept { return slots.size() - 1; }
+
+        // must be called only by the producer, returns false if the queue is full
+        bool push(T&& value)
+        {
+            const size_t tail = writeIndex.load(std::memory_order_relaxed);
+            const size_t next = (tail + 1 == slots.size()) ? 0 : tail + 1;
+
+            if (next == readIndex.load(std::memory_order_acquire))
+                return false;
+
+            slots[tail] = std::move(value);
+            writeIndex.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // must be called only by the consumer, returns false if the queue is empty
+        bool pop(T& value)
+        {
+            const size_t head = readIndex.load(std::memory_order_relaxed);
+
+            if (head == writeIndex.load(std::memory_order_acquire))
+                return false;
+
+            value = std::move(slots[head]);
+            readIndex.store((head + 1 == slots.size()) ? 0 : head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<T> slots;
+        // the padding keeps the indices on separate cache lines, so that the producer and the consumer don't share one
+        std::atomic<size_t> readIndex{0};
+        char padding[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> writeIndex{0};
+    };
+}
+
+#endif // OUZEL_UTILS_SPSCQUEUE_HPP
@@ -0,0 +1,120 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "ThreadPool.hpp"
+
+namespace ouzel
+{
+    namespace
+    {
+        // the pool whose jobs the current thread is running
+        thread_local const ThreadPool* currentPool = nullptr;
+    }
+
+    ThreadPool::ThreadPool(uint32_t workerCount)
+    {
+        for (uint32_t i = 0; i < workerCount; ++i)
+            workers.emplace_back(&ThreadPool::workerMain, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        std::unique_lock<std::mutex> lock(jobMutex);
+        running = false;
+        lock.unlock();
+        jobCondition.notify_all();
+
+        for (Thread& worker : workers)
+            if (worker.isJoinable()) worker.join();
+    }
+
+    void ThreadPool::run(size_t count, const std::function<void(size_t)>& job)
+    {
+        if (!count) return;
+
+        // not worth waking up the workers for a single job, and a job that runs a batch on its
+        // own pool runs it inline, because the workers are busy with the outer batch
+        if (workers.empty() || count == 1 || currentPool == this)
+        {
+            for (size_t i = 0; i < count; ++i) job(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(runMutex);
+
+        std::unique_lock<std::mutex> lock(jobMutex);
+        currentJob = &job;
+        jobCount = count;
+        nextJob = 0;
+        exception = nullptr;
+        activeWorkers = static_cast<uint32_t>(workers.size());
+        ++jobGeneration;
+        lock.unlock();
+        jobCondition.notify_all();
+
+        processJobs();
+
+        lock.lock();
+        while (activeWorkers) doneCondition.wait(lock);
+        currentJob = nullptr;
+
+        if (exception)
+        {
+            std::exception_ptr jobException = exception;
+            exception = nullptr;
+            lock.unlock();
+            std::rethrow_exception(jobException);
+        }
+    }
+
+    void ThreadPool::processJobs()
+    {
+        const ThreadPool* previousPool = currentPool;
+        currentPool = this;
+
+        for (;;)
+        {
+            const size_t index = nextJob++;
+            if (index >= jobCount) break;
+
+            try
+            {
+                (*currentJob)(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(jobMutex);
+                if (!exception) exception = std::current_exception();
+
+                // skip the rest of the jobs
+                nextJob = jobCount;
+            }
+        }
+
+        currentPool = previousPool;
+    }
+
+    void ThreadPool::workerMain()
+    {
+        Thread::setCurrentThreadName("Worker");
+
+        uint64_t generation = 0;
+
+        for (;;)
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            while (running && jobGeneration == generation) jobCondition.wait(lock);
+            if (!running) break;
+            generation = jobGeneration;
+            lock.unlock();
+
+            processJobs();
+
+            lock.lock();
+            if (--activeWorkers == 0)
+            {
+                lock.unlock();
+                doneCondition.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_THREADPOOL_HPP
+#define OUZEL_UTILS_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "utils/Thread.hpp"
+
+namespace ouzel
+{
+    // Runs batches of independent jobs on a fixed set of worker threads,
+    // the calling thread takes part in the work and returns once all the jobs have finished
+    class ThreadPool final
+    {
+    public:
+        explicit ThreadPool(uint32_t workerCount);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        inline auto getWorkerCount() const noexcept { return static_cast<uint32_t>(workers.size()); }
+
+        // calls job with every index in [0, count), the first exception thrown by a job is rethrown,
+        // a job can call run on the same pool, the nested batch is then run on the thread of the job
+        void run(size_t count, const std::function<void(size_t)>& job);
+
+    private:
+        void processJobs();
+        void workerMain();
+
+        std::vector<Thread> workers;
+        std::mutex runMutex; // only one batch runs at a time
+
+        std::mutex jobMutex;
+        std::condition_variable jobCondition;
+        std::condition_variable doneCondition;
+        uint64_t jobGeneration = 0;
+        uint32_t activeWorkers = 0;
+        bool running = true;
+
+        const std::function<void(size_t)>* currentJob = nullptr;
+        size_t jobCount = 0;
+        std::atomic<size_t> nextJob{0};
+        std::exception_ptr exception;
+    };
+}
+
+#endif // OUZEL_UTILS_THREADPOOL_HPP
@@ -3,6 +3,7 @@
 #ifndef OUZEL_UTILS_XML_HPP
 #define OUZEL_UTILS_XML_HPP
 
+#include <iterator>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -642,20 +643,21 @@ namespace ouzel
         public:
             Data() = default;
 
-            Data(const std::vector<uint8_t>& data,
-                 bool preserveWhitespaces = false,
-                 bool preserveComments = false,
-                 bool preserveProcessingInstructions = false)
+            template <class T>
+            explicit Data(const T& data,
+                          bool preserveWhitespaces = false,
+                          bool preserveComments = false,
+                          bool preserveProcessingInstructions = false)
             {
                 std::u32string str;
 
                 // BOM
-                if (data.size() >= 3 &&
-                    std::equal(data.begin(), data.begin() + 3,
+                if (std::distance(std::begin(data), std::end(data)) >= 3 &&
+                    std::equal(std::begin(data), std::begin(data) + 3,
                                std::begin(UTF8_BOM), std::end(UTF8_BOM)))
                 {
                     bom = true;
-                    str = utf8::toUtf32(data.begin() + 3, data.end());
+                    str = utf8::toUtf32(std::begin(data) + 3, std::end(data));
                 }
                 else
                 {
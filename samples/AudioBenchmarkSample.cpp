@@ -0,0 +1,330 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "AudioBenchmarkSample.hpp"
+#include "MainMenu.hpp"
+#include "benchmark/AudioGraphs.hpp"
+#include "audio/mixer/Resampler.hpp"
+
+using namespace ouzel;
+using namespace input;
+
+namespace
+{
+    constexpr uint32_t SAMPLE_RATE = 48000;
+    constexpr uint32_t ITERATIONS = 20;
+
+    template <class F>
+    int64_t measure(F function)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < ITERATIONS; ++i)
+            function();
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() / ITERATIONS;
+    }
+
+    // times one second of audio through every kernel and through the equivalent scalar loops
+    std::string measureLayout(uint32_t channels)
+    {
+        const uint32_t frames = SAMPLE_RATE;
+        const uint32_t downmixChannels = (channels == 2) ? 1 : 2;
+        const float* matrix = audio::dsp::getChannelMatrix(channels, downmixChannels);
+
+        std::mt19937 randomEngine(channels);
+        std::uniform_real_distribution<float> distribution(-1.5F, 1.5F);
+
+        std::vector<float> input(frames * channels);
+        for (float& sample : input) sample = distribution(randomEngine);
+
+        std::vector<float> output(frames * channels);
+        std::vector<int16_t> int16Output(frames * channels);
+
+        const int64_t accumulateTime = measure([&]() {
+            audio::dsp::accumulate(input.data(), input.size(), 0.5F, output.data());
+        });
+        const int64_t scalarAccumulateTime = measure([&]() {
+            for (size_t i = 0; i < input.size(); ++i)
+                output[i] += input[i] * 0.5F;
+        });
+
+        const int64_t interleaveTime = measure([&]() {
+            audio::dsp::interleave(input.data(), channels, frames, output.data());
+        });
+        const int64_t scalarInterleaveTime = measure([&]() {
+            for (uint32_t channel = 0; channel < channels; ++channel)
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                    output[frame * channels + channel] = input[channel * frames + frame];
+        });
+
+        const int64_t int16Time = measure([&]() {
+            audio::dsp::floatToInt16(input.data(), input.size(), int16Output.data());
+        });
+        const int64_t scalarInt16Time = measure([&]() {
+            for (size_t i = 0; i < input.size(); ++i)
+                int16Output[i] = static_cast<int16_t>(clamp(input[i], -1.0F, 1.0F) * 32767.0F);
+        });
+
+        const int64_t downmixTime = measure([&]() {
+            audio::dsp::mixChannels(input.data(), channels, frames, matrix, downmixChannels, output.data());
+        });
+        const int64_t scalarDownmixTime = measure([&]() {
+            for (uint32_t frame = 0; frame < frames; ++frame)
+                for (uint32_t channel = 0; channel < downmixChannels; ++channel)
+                {
+                    float sample = 0.0F;
+                    for (uint32_t sourceChannel = 0; sourceChannel < channels; ++sourceChannel)
+                        sample += matrix[channel * channels + sourceChannel] * input[sourceChannel * frames + frame];
+                    output[channel * frames + frame] = sample;
+                }
+        });
+
+        return std::to_string(channels) + " ch: mix " + std::to_string(accumulateTime) + "/" + std::to_string(scalarAccumulateTime) +
+            ", interleave " + std::to_string(interleaveTime) + "/" + std::to_string(scalarInterleaveTime) +
+            ", int16 " + std::to_string(int16Time) + "/" + std::to_string(scalarInt16Time) +
+            ", downmix " + std::to_string(downmixTime) + "/" + std::to_string(scalarDownmixTime);
+    }
+
+    constexpr uint32_t RESAMPLED_STREAMS = 64;
+    constexpr uint32_t RESAMPLED_CHANNELS = 2;
+    constexpr uint32_t RESAMPLED_BUFFER_SIZE = 512;
+
+    // the stateless linear interpolation of every block that the buses did before the polyphase resampler
+    void resampleLinear(uint32_t channels, uint32_t sourceFrames, const std::vector<float>& sourceSamples,
+                        uint32_t frames, std::vector<float>& samples)
+    {
+        const float sourceIncrement = static_cast<float>(sourceFrames - 1) / static_cast<float>(frames - 1);
+        float sourcePosition = 0.0F;
+
+        samples.resize(frames * channels);
+
+        for (uint32_t frame = 0; frame < frames - 1; ++frame)
+        {
+            const auto sourceFrame = static_cast<uint32_t>(sourcePosition);
+            const float fraction = sourcePosition - static_cast<float>(sourceFrame);
+
+            for (uint32_t channel = 0; channel < channels; ++channel)
+                samples[channel * frames + frame] = lerp(sourceSamples[channel * sourceFrames + sourceFrame],
+                                                         sourceSamples[channel * sourceFrames + sourceFrame + 1],
+                                                         fraction);
+
+            sourcePosition += sourceIncrement;
+        }
+
+        for (uint32_t channel = 0; channel < channels; ++channel)
+            samples[channel * frames + frames - 1] = sourceSamples[channel * sourceFrames + sourceFrames - 1];
+    }
+
+    // times one second of the streams resampled to 48 kHz with both resampler qualities and with the old interpolation,
+    // the linear quality must not cost more than the old interpolation, which it replaces without drifting or clicking
+    // at the block boundaries, the 16-tap polyphase filter is allowed about three times as much for not aliasing,
+    // almost all of which goes to the filter taps
+    std::string measureResampler(uint32_t sourceSampleRate)
+    {
+        const uint32_t blocks = SAMPLE_RATE / RESAMPLED_BUFFER_SIZE;
+        const uint32_t maxSourceFrames = RESAMPLED_BUFFER_SIZE * sourceSampleRate / SAMPLE_RATE + 1;
+
+        std::mt19937 randomEngine(sourceSampleRate);
+        std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+
+        std::vector<float> sourceSamples(maxSourceFrames * RESAMPLED_CHANNELS);
+        for (float& sample : sourceSamples) sample = distribution(randomEngine);
+
+        std::vector<float> samples;
+
+        auto measureQuality = [&](audio::mixer::Resampler::Quality quality) {
+            std::vector<std::unique_ptr<audio::mixer::Resampler>> resamplers;
+            for (uint32_t stream = 0; stream < RESAMPLED_STREAMS; ++stream)
+                resamplers.push_back(std::make_unique<audio::mixer::Resampler>(sourceSampleRate, SAMPLE_RATE, RESAMPLED_CHANNELS, quality));
+
+            return measure([&]() {
+                for (uint32_t block = 0; block < blocks; ++block)
+                    for (const auto& resampler : resamplers)
+                        resampler->process(sourceSamples, resampler->getSourceFrames(RESAMPLED_BUFFER_SIZE),
+                                           RESAMPLED_BUFFER_SIZE, samples);
+            });
+        };
+
+        const int64_t polyphaseTime = measureQuality(audio::mixer::Resampler::Quality::Polyphase);
+        const int64_t linearTime = measureQuality(audio::mixer::Resampler::Quality::Linear);
+
+        const int64_t oldLinearTime = measure([&]() {
+            for (uint32_t block = 0; block < blocks; ++block)
+                for (uint32_t stream = 0; stream < RESAMPLED_STREAMS; ++stream)
+                    resampleLinear(RESAMPLED_CHANNELS, (RESAMPLED_BUFFER_SIZE * sourceSampleRate + SAMPLE_RATE - 1) / SAMPLE_RATE,
+                                   sourceSamples, RESAMPLED_BUFFER_SIZE, samples);
+        });
+
+        return std::to_string(sourceSampleRate) + " Hz " + std::to_string(polyphaseTime) + "/" + std::to_string(linearTime) +
+            "/" + std::to_string(oldLinearTime);
+    }
+}
+
+AudioBenchmarkSample::AudioBenchmarkSample():
+    titleLabel("Microseconds per second of 48 kHz audio, kernel/scalar", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    stereoLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    surround51Label("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    surround71Label("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    resamplerLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    histogramLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    kernelsButton("button.png", "button_selected.png", "button_down.png", "", "DSP kernels", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    histogramButton("button.png", "button_selected.png", "button_down.png", "", "Mix times", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    graphsButton("button.png", "button_selected.png", "button_down.png", "", "Mixer graphs", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    backButton("button.png", "button_selected.png", "button_down.png", "", "Back", "Arial", 1.0F, Color::black(), Color::black(), Color::black())
+{
+    handler.gamepadHandler = [](const GamepadEvent& event) {
+        if (event.type == Event::Type::GamepadButtonChange)
+        {
+            if (event.pressed &&
+                event.button == Gamepad::Button::FaceRight)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+        }
+
+        return false;
+    };
+
+    handler.uiHandler = [this](const UIEvent& event) {
+        if (event.type == Event::Type::ActorClick)
+        {
+            if (event.actor == &backButton)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+            else if (event.actor == &kernelsButton)
+                measureKernels();
+            else if (event.actor == &histogramButton)
+                showRenderHistogram();
+            else if (event.actor == &graphsButton)
+                measureGraphs();
+        }
+
+        return false;
+    };
+
+    handler.keyboardHandler = [](const KeyboardEvent& event) {
+        if (event.type == Event::Type::KeyboardKeyPress)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+                    return true;
+                default:
+                    break;
+            }
+        }
+        else if (event.type == Event::Type::KeyboardKeyRelease)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    return true;
+                default:
+                    break;
+            }
+        }
+
+        return false;
+    };
+
+    engine->getEventDispatcher().addEventHandler(handler);
+
+    guiCamera.setClearColorBuffer(true);
+    guiCamera.setClearColor(ouzel::Color(64, 64, 64));
+    guiCamera.setScaleMode(scene::Camera::ScaleMode::ShowAll);
+    guiCamera.setTargetContentSize(Size2F(800.0F, 600.0F));
+    guiCameraActor.addComponent(&guiCamera);
+    guiLayer.addChild(&guiCameraActor);
+    addLayer(&guiLayer);
+
+    titleLabel.setPosition(Vector2F(-380.0F, 280.0F));
+    guiLayer.addChild(&titleLabel);
+
+    stereoLabel.setPosition(Vector2F(-380.0F, 250.0F));
+    guiLayer.addChild(&stereoLabel);
+
+    surround51Label.setPosition(Vector2F(-380.0F, 220.0F));
+    guiLayer.addChild(&surround51Label);
+
+    surround71Label.setPosition(Vector2F(-380.0F, 190.0F));
+    guiLayer.addChild(&surround71Label);
+
+    resamplerLabel.setPosition(Vector2F(-380.0F, 160.0F));
+    guiLayer.addChild(&resamplerLabel);
+
+    histogramLabel.setPosition(Vector2F(-380.0F, 130.0F));
+    guiLayer.addChild(&histogramLabel);
+
+    guiLayer.addChild(&menu);
+
+    kernelsButton.setPosition(Vector2F(-200.0F, 100.0F));
+    menu.addWidget(&kernelsButton);
+
+    histogramButton.setPosition(Vector2F(-200.0F, 60.0F));
+    menu.addWidget(&histogramButton);
+
+    graphsButton.setPosition(Vector2F(-200.0F, 20.0F));
+    menu.addWidget(&graphsButton);
+
+    backButton.setPosition(Vector2F(-200.0F, -200.0F));
+    menu.addWidget(&backButton);
+}
+
+void AudioBenchmarkSample::measureKernels()
+{
+    stereoLabel.setText(measureLayout(2));
+    surround51Label.setText(measureLayout(6));
+    surround71Label.setText(measureLayout(8));
+    resamplerLabel.setText(std::to_string(RESAMPLED_STREAMS) + " streams resampled, polyphase/linear/old: " +
+                           measureResampler(22050) + ", " + measureResampler(44100));
+
+    engine->log(Log::Level::Info) << "DSP kernels, microseconds per second of audio (kernel/scalar): " <<
+        stereoLabel.getText() << "; " << surround51Label.getText() << "; " << surround71Label.getText() << "; " <<
+        resamplerLabel.getText();
+}
+
+void AudioBenchmarkSample::showRenderHistogram()
+{
+    const audio::mixer::Mixer& mixer = engine->getAudio()->getMixer();
+    const std::vector<uint32_t> histogram = mixer.getRenderHistogram();
+
+    std::string text = "Mix us:";
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+        if (histogram[bucket])
+            text += " " + std::to_string(bucket ? (1U << bucket) : 0U) + "+:" + std::to_string(histogram[bucket]);
+
+    text += ", voices " + std::to_string(mixer.getVoiceManager().getRealVoiceCount()) +
+        " real, " + std::to_string(mixer.getVoiceManager().getVirtualVoiceCount()) + " virtual";
+
+    histogramLabel.setText(text);
+
+    engine->log(Log::Level::Info) << "Mixer render times in microseconds (lower bound:count): " << text;
+}
+
+void AudioBenchmarkSample::measureGraphs()
+{
+    const std::string filename = engine->getFileSystem().getStorageDirectory() +
+        storage::FileSystem::DIRECTORY_SEPARATOR + "audio_benchmark.wav";
+
+    graphLabels.clear();
+
+    for (const benchmark::Graph& graph : benchmark::GRAPHS)
+    {
+        // the output of the largest graph is kept for listening
+        const std::string text = benchmark::describe(benchmark::measureGraph(graph, (&graph == std::end(benchmark::GRAPHS) - 1) ? filename : std::string()));
+
+        auto label = std::make_unique<gui::Label>(text, "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F));
+        label->setPosition(Vector2F(-380.0F, -20.0F - 30.0F * graphLabels.size()));
+        guiLayer.addChild(label.get());
+        graphLabels.push_back(std::move(label));
+
+        engine->log(Log::Level::Info) << "Mixer graph: " << text;
+    }
+
+    engine->log(Log::Level::Info) << "Rendered the largest mixer graph to " << filename;
+}
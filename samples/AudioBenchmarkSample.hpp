@@ -0,0 +1,37 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef AUDIOBENCHMARKSAMPLE_HPP
+#define AUDIOBENCHMARKSAMPLE_HPP
+
+#include "ouzel.hpp"
+
+class AudioBenchmarkSample: public ouzel::scene::Scene
+{
+public:
+    AudioBenchmarkSample();
+
+private:
+    void measureKernels();
+    void showRenderHistogram();
+    void measureGraphs();
+
+    ouzel::EventHandler handler;
+
+    ouzel::scene::Layer guiLayer;
+    ouzel::scene::Camera guiCamera;
+    ouzel::scene::Actor guiCameraActor;
+    ouzel::gui::Label titleLabel;
+    ouzel::gui::Label stereoLabel;
+    ouzel::gui::Label surround51Label;
+    ouzel::gui::Label surround71Label;
+    ouzel::gui::Label resamplerLabel;
+    ouzel::gui::Label histogramLabel;
+    std::vector<std::unique_ptr<ouzel::gui::Label>> graphLabels;
+    ouzel::gui::Menu menu;
+    ouzel::gui::Button kernelsButton;
+    ouzel::gui::Button histogramButton;
+    ouzel::gui::Button graphsButton;
+    ouzel::gui::Button backButton;
+};
+
+#endif // AUDIOBENCHMARKSAMPLE_HPP
@@ -0,0 +1,134 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "BenchmarkSample.hpp"
+#include "MainMenu.hpp"
+
+using namespace ouzel;
+using namespace input;
+
+namespace
+{
+    constexpr uint32_t SPRITE_COLUMNS = 25;
+    constexpr uint32_t SPRITE_ROWS = 16;
+}
+
+BenchmarkSample::BenchmarkSample():
+    fpsLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    drawCallsLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    backButton("button.png", "button_selected.png", "button_down.png", "", "Back", "Arial", 1.0F, Color::black(), Color::black(), Color::black())
+{
+    handler.gamepadHandler = [](const GamepadEvent& event) {
+        if (event.type == Event::Type::GamepadButtonChange)
+        {
+            if (event.pressed &&
+                event.button == Gamepad::Button::FaceRight)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+        }
+
+        return false;
+    };
+
+    handler.uiHandler = [this](const UIEvent& event) {
+        if (event.type == Event::Type::ActorClick)
+        {
+            if (event.actor == &backButton)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+        }
+
+        return false;
+    };
+
+    handler.keyboardHandler = [](const KeyboardEvent& event) {
+        if (event.type == Event::Type::KeyboardKeyPress)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+                    return true;
+                default:
+                    break;
+            }
+        }
+        else if (event.type == Event::Type::KeyboardKeyRelease)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    return true;
+                default:
+                    break;
+            }
+        }
+
+        return false;
+    };
+
+    // the allocations of the command buffer are counted by the headless benchmark in the benchmark directory
+    handler.updateHandler = [this](const UpdateEvent& event) {
+        timeSinceReport += event.delta;
+
+        if (timeSinceReport >= 1.0F)
+        {
+            const graphics::RenderDevice* renderDevice = engine->getRenderer()->getDevice();
+
+            fpsLabel.setText("FPS: " + std::to_string(static_cast<uint32_t>(renderDevice->getAccumulatedFPS())));
+            drawCallsLabel.setText("Draw calls: " + std::to_string(renderDevice->getDrawCallCount()));
+
+            timeSinceReport = 0.0F;
+        }
+
+        return false;
+    };
+
+    engine->getEventDispatcher().addEventHandler(handler);
+
+    camera.setClearColorBuffer(true);
+    camera.setClearColor(ouzel::Color(64, 64, 64));
+    camera.setScaleMode(scene::Camera::ScaleMode::ShowAll);
+    camera.setTargetContentSize(Size2F(800.0F, 600.0F));
+    cameraActor.addComponent(&camera);
+    layer.addChild(&cameraActor);
+    addLayer(&layer);
+
+    // a sprite per draw call
+    for (uint32_t row = 0; row < SPRITE_ROWS; ++row)
+    {
+        for (uint32_t column = 0; column < SPRITE_COLUMNS; ++column)
+        {
+            auto sprite = std::make_unique<scene::SpriteRenderer>();
+            sprite->init("triangle.json");
+
+            auto actor = std::make_unique<scene::Actor>();
+            actor->addComponent(sprite.get());
+            actor->setScale(Vector3F(0.25F, 0.25F, 1.0F));
+            actor->setPosition(Vector2F(-384.0F + static_cast<float>(column) * 32.0F,
+                                        -240.0F + static_cast<float>(row) * 32.0F));
+            layer.addChild(actor.get());
+
+            sprites.push_back(std::move(sprite));
+            actors.push_back(std::move(actor));
+        }
+    }
+
+    guiCamera.setScaleMode(scene::Camera::ScaleMode::ShowAll);
+    guiCamera.setTargetContentSize(Size2F(800.0F, 600.0F));
+    guiCameraActor.addComponent(&guiCamera);
+    guiLayer.addChild(&guiCameraActor);
+    addLayer(&guiLayer);
+
+    fpsLabel.setPosition(Vector2F(-380.0F, 280.0F));
+    guiLayer.addChild(&fpsLabel);
+
+    drawCallsLabel.setPosition(Vector2F(-380.0F, 250.0F));
+    guiLayer.addChild(&drawCallsLabel);
+
+    guiLayer.addChild(&menu);
+
+    backButton.setPosition(Vector2F(-200.0F, -200.0F));
+    menu.addWidget(&backButton);
+}
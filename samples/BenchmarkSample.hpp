@@ -0,0 +1,34 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef BENCHMARKSAMPLE_HPP
+#define BENCHMARKSAMPLE_HPP
+
+#include "ouzel.hpp"
+
+class BenchmarkSample: public ouzel::scene::Scene
+{
+public:
+    BenchmarkSample();
+
+private:
+    ouzel::scene::Layer layer;
+    ouzel::scene::Camera camera;
+    ouzel::scene::Actor cameraActor;
+
+    std::vector<std::unique_ptr<ouzel::scene::SpriteRenderer>> sprites;
+    std::vector<std::unique_ptr<ouzel::scene::Actor>> actors;
+
+    float timeSinceReport = 0.0F;
+
+    ouzel::EventHandler handler;
+
+    ouzel::scene::Layer guiLayer;
+    ouzel::scene::Camera guiCamera;
+    ouzel::scene::Actor guiCameraActor;
+    ouzel::gui::Label fpsLabel;
+    ouzel::gui::Label drawCallsLabel;
+    ouzel::gui::Menu menu;
+    ouzel::gui::Button backButton;
+};
+
+#endif // BENCHMARKSAMPLE_HPP
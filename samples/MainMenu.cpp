@@ -8,6 +8,9 @@
 #include "InputSample.hpp"
 #include "SoundSample.hpp"
 #include "PerspectiveSample.hpp"
+#include "BenchmarkSample.hpp"
+#include "SceneBenchmarkSample.hpp"
+#include "AudioBenchmarkSample.hpp"
 
 using namespace ouzel;
 using namespace input;
@@ -20,7 +23,10 @@ MainMenu::MainMenu():
     animationsButton("button.png", "button_selected.png", "button_down.png", "", "Animations", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
     inputButton("button.png", "button_selected.png", "button_down.png", "", "Input", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
     soundButton("button.png", "button_selected.png", "button_down.png", "", "Sound", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
-    perspectiveButton("button.png", "button_selected.png", "button_down.png", "", "Perspective", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black())
+    perspectiveButton("button.png", "button_selected.png", "button_down.png", "", "Perspective", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
+    benchmarkButton("button.png", "button_selected.png", "button_down.png", "", "Benchmark", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
+    sceneBenchmarkButton("button.png", "button_selected.png", "button_down.png", "", "Scene benchmark", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black()),
+    audioBenchmarkButton("button.png", "button_selected.png", "button_down.png", "", "Audio benchmark", "Arial", 1.0F, Color(20, 0, 0, 255), Color::black(), Color::black())
 {
     handler.uiHandler = [this](const UIEvent& event) {
         if (event.type == Event::Type::ActorClick)
@@ -41,6 +47,12 @@ MainMenu::MainMenu():
                 engine->getSceneManager().setScene(std::make_unique<SoundSample>());
             else if (event.actor == &perspectiveButton)
                 engine->getSceneManager().setScene(std::make_unique<PerspectiveSample>());
+            else if (event.actor == &benchmarkButton)
+                engine->getSceneManager().setScene(std::make_unique<BenchmarkSample>());
+            else if (event.actor == &sceneBenchmarkButton)
+                engine->getSceneManager().setScene(std::make_unique<SceneBenchmarkSample>());
+            else if (event.actor == &audioBenchmarkButton)
+                engine->getSceneManager().setScene(std::make_unique<AudioBenchmarkSample>());
         }
 
         return false;
@@ -113,4 +125,13 @@ MainMenu::MainMenu():
 
     perspectiveButton.setPosition(Vector2F(0.0F, -160.0F));
     menu.addWidget(&perspectiveButton);
+
+    benchmarkButton.setPosition(Vector2F(0.0F, -200.0F));
+    menu.addWidget(&benchmarkButton);
+
+    sceneBenchmarkButton.setPosition(Vector2F(0.0F, -240.0F));
+    menu.addWidget(&sceneBenchmarkButton);
+
+    audioBenchmarkButton.setPosition(Vector2F(0.0F, -280.0F));
+    menu.addWidget(&audioBenchmarkButton);
 }
@@ -26,6 +26,9 @@ private:
     ouzel::gui::Button inputButton;
     ouzel::gui::Button soundButton;
     ouzel::gui::Button perspectiveButton;
+    ouzel::gui::Button benchmarkButton;
+    ouzel::gui::Button sceneBenchmarkButton;
+    ouzel::gui::Button audioBenchmarkButton;
 };
 
 #endif // MAINMENU_HPP
@@ -0,0 +1,243 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <random>
+#include "SceneBenchmarkSample.hpp"
+#include "MainMenu.hpp"
+#include "scene/RadixSort.hpp"
+
+using namespace ouzel;
+using namespace input;
+
+namespace
+{
+    constexpr uint32_t GROUP_COUNT = 16;
+    constexpr int32_t MAX_ORDER = 8; // actors get a random order in [-MAX_ORDER, MAX_ORDER]
+
+    struct DrawEntry final
+    {
+        uint32_t key;
+        scene::Actor* actor;
+    };
+}
+
+SceneBenchmarkSample::SceneBenchmarkSample():
+    frameLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    drawQueueLabel("", "Arial", 1.0F, Color::white(), Vector2F(0.0F, 0.5F)),
+    actors1000Button("button.png", "button_selected.png", "button_down.png", "", "1000", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    actors10000Button("button.png", "button_selected.png", "button_down.png", "", "10000", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    actors50000Button("button.png", "button_selected.png", "button_down.png", "", "50000", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    spatialIndexButton("button.png", "button_selected.png", "button_down.png", "", "Index off", "Arial", 1.0F, Color::black(), Color::black(), Color::black()),
+    backButton("button.png", "button_selected.png", "button_down.png", "", "Back", "Arial", 1.0F, Color::black(), Color::black(), Color::black())
+{
+    handler.gamepadHandler = [](const GamepadEvent& event) {
+        if (event.type == Event::Type::GamepadButtonChange)
+        {
+            if (event.pressed &&
+                event.button == Gamepad::Button::FaceRight)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+        }
+
+        return false;
+    };
+
+    handler.uiHandler = [this](const UIEvent& event) {
+        if (event.type == Event::Type::ActorClick)
+        {
+            if (event.actor == &backButton)
+                engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+            else if (event.actor == &actors1000Button)
+                setActorCount(1000);
+            else if (event.actor == &actors10000Button)
+                setActorCount(10000);
+            else if (event.actor == &actors50000Button)
+                setActorCount(50000);
+            else if (event.actor == &spatialIndexButton)
+            {
+                layer.setSpatialIndexEnabled(!layer.isSpatialIndexEnabled());
+                spatialIndexButton.getLabelDrawable()->setText(layer.isSpatialIndexEnabled() ? "Index on" : "Index off");
+            }
+        }
+
+        return false;
+    };
+
+    handler.keyboardHandler = [](const KeyboardEvent& event) {
+        if (event.type == Event::Type::KeyboardKeyPress)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    engine->getSceneManager().setScene(std::make_unique<MainMenu>());
+                    return true;
+                default:
+                    break;
+            }
+        }
+        else if (event.type == Event::Type::KeyboardKeyRelease)
+        {
+            switch (event.key)
+            {
+                case Keyboard::Key::Escape:
+                case Keyboard::Key::Menu:
+                case Keyboard::Key::Back:
+                    return true;
+                default:
+                    break;
+            }
+        }
+
+        return false;
+    };
+
+    handler.updateHandler = [this](const UpdateEvent& event) {
+        ++frameCount;
+        frameTime += event.delta;
+
+        // picking in the center of the screen, as hovering would do every frame
+        const auto startTime = std::chrono::steady_clock::now();
+        layer.pickActors(Vector2F(0.5F, 0.5F));
+        pickTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+        if (frameTime >= 1.0F)
+        {
+            frameLabel.setText("Actors: " + std::to_string(actorCount) +
+                               ", frame time: " + std::to_string(frameTime * 1000.0F / static_cast<float>(frameCount)) + " ms" +
+                               ", pick time: " + std::to_string(pickTime.count() / frameCount) + " us");
+
+            frameCount = 0;
+            frameTime = 0.0F;
+            pickTime = std::chrono::microseconds(0);
+        }
+
+        return false;
+    };
+
+    engine->getEventDispatcher().addEventHandler(handler);
+
+    camera.setClearColorBuffer(true);
+    camera.setClearColor(ouzel::Color(64, 64, 64));
+    camera.setScaleMode(scene::Camera::ScaleMode::ShowAll);
+    camera.setTargetContentSize(Size2F(800.0F, 600.0F));
+    cameraActor.addComponent(&camera);
+    layer.addChild(&cameraActor);
+    layer.setBatchingEnabled(true);
+    addLayer(&layer);
+
+    guiCamera.setScaleMode(scene::Camera::ScaleMode::ShowAll);
+    guiCamera.setTargetContentSize(Size2F(800.0F, 600.0F));
+    guiCameraActor.addComponent(&guiCamera);
+    guiLayer.addChild(&guiCameraActor);
+    addLayer(&guiLayer);
+
+    frameLabel.setPosition(Vector2F(-380.0F, 280.0F));
+    guiLayer.addChild(&frameLabel);
+
+    drawQueueLabel.setPosition(Vector2F(-380.0F, 250.0F));
+    guiLayer.addChild(&drawQueueLabel);
+
+    guiLayer.addChild(&menu);
+
+    actors1000Button.setPosition(Vector2F(-200.0F, 200.0F));
+    menu.addWidget(&actors1000Button);
+
+    actors10000Button.setPosition(Vector2F(-200.0F, 160.0F));
+    menu.addWidget(&actors10000Button);
+
+    actors50000Button.setPosition(Vector2F(-200.0F, 120.0F));
+    menu.addWidget(&actors50000Button);
+
+    spatialIndexButton.setPosition(Vector2F(-200.0F, 80.0F));
+    menu.addWidget(&spatialIndexButton);
+
+    backButton.setPosition(Vector2F(-200.0F, -200.0F));
+    menu.addWidget(&backButton);
+
+    setActorCount(1000);
+}
+
+void SceneBenchmarkSample::setActorCount(uint32_t count)
+{
+    groups.clear();
+    actors.clear();
+    sprites.clear();
+    actorCount = count / GROUP_COUNT * GROUP_COUNT;
+
+    std::mt19937 randomEngine(count);
+    std::uniform_real_distribution<float> xDistribution(-400.0F, 400.0F);
+    std::uniform_real_distribution<float> yDistribution(-300.0F, 300.0F);
+    std::uniform_int_distribution<int32_t> orderDistribution(-MAX_ORDER, MAX_ORDER);
+
+    for (uint32_t i = 0; i < GROUP_COUNT; ++i)
+    {
+        auto group = std::make_unique<scene::Actor>();
+
+        for (uint32_t j = 0; j < count / GROUP_COUNT; ++j)
+        {
+            auto sprite = std::make_unique<scene::SpriteRenderer>();
+            sprite->init("triangle.json");
+
+            auto actor = std::make_unique<scene::Actor>();
+            actor->addComponent(sprite.get());
+            actor->setScale(Vector3F(0.1F, 0.1F, 1.0F));
+            actor->setPosition(Vector2F(xDistribution(randomEngine), yDistribution(randomEngine)));
+            actor->setOrder(orderDistribution(randomEngine));
+            actor->setPickable(true);
+            group->addChild(actor.get());
+
+            sprites.push_back(std::move(sprite));
+            actors.push_back(std::move(actor));
+        }
+
+        layer.addChild(group.get());
+        groups.push_back(std::move(group));
+    }
+
+    measureDrawQueue();
+}
+
+// compares building a draw queue of all the actors with sorted insertion, with a stable sort and with the radix sort of the layer
+void SceneBenchmarkSample::measureDrawQueue()
+{
+    std::vector<scene::Actor*> drawCandidates;
+    for (const auto& group : groups)
+        drawCandidates.insert(drawCandidates.end(), group->getChildren().begin(), group->getChildren().end());
+
+    const auto compare = [](const scene::Actor* a, const scene::Actor* b) noexcept {
+        return a->getOrder() > b->getOrder();
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<scene::Actor*> insertionQueue;
+    for (scene::Actor* actor : drawCandidates)
+        insertionQueue.insert(std::upper_bound(insertionQueue.begin(), insertionQueue.end(), actor, compare), actor);
+
+    const auto insertionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    startTime = std::chrono::steady_clock::now();
+
+    std::vector<scene::Actor*> sortQueue = drawCandidates;
+    std::stable_sort(sortQueue.begin(), sortQueue.end(), compare);
+
+    const auto sortTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    startTime = std::chrono::steady_clock::now();
+
+    std::vector<DrawEntry> radixQueue;
+    std::vector<DrawEntry> sortBuffer;
+    radixQueue.reserve(drawCandidates.size());
+    for (scene::Actor* actor : drawCandidates)
+        radixQueue.push_back(DrawEntry{scene::getDrawKey(actor->getOrder()), actor});
+    scene::sortByKey(radixQueue, sortBuffer);
+
+    const auto radixTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    drawQueueLabel.setText("Draw queue: insertion " + std::to_string(insertionTime.count()) + " us, sort " +
+                           std::to_string(sortTime.count()) + " us, radix " + std::to_string(radixTime.count()) + " us");
+
+    engine->log(Log::Level::Info) << "Draw queue of " << drawCandidates.size() << " actors: insertion " <<
+        insertionTime.count() << " us, sort " << sortTime.count() << " us, radix " << radixTime.count() << " us";
+}
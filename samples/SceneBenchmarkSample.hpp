@@ -0,0 +1,46 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef SCENEBENCHMARKSAMPLE_HPP
+#define SCENEBENCHMARKSAMPLE_HPP
+
+#include <chrono>
+#include "ouzel.hpp"
+
+class SceneBenchmarkSample: public ouzel::scene::Scene
+{
+public:
+    SceneBenchmarkSample();
+
+private:
+    void setActorCount(uint32_t count);
+    void measureDrawQueue();
+
+    ouzel::scene::Layer layer;
+    ouzel::scene::Camera camera;
+    ouzel::scene::Actor cameraActor;
+
+    std::vector<std::unique_ptr<ouzel::scene::SpriteRenderer>> sprites;
+    std::vector<std::unique_ptr<ouzel::scene::Actor>> actors;
+    std::vector<std::unique_ptr<ouzel::scene::Actor>> groups;
+    uint32_t actorCount = 0;
+
+    uint32_t frameCount = 0;
+    float frameTime = 0.0F;
+    std::chrono::microseconds pickTime{0};
+
+    ouzel::EventHandler handler;
+
+    ouzel::scene::Layer guiLayer;
+    ouzel::scene::Camera guiCamera;
+    ouzel::scene::Actor guiCameraActor;
+    ouzel::gui::Label frameLabel;
+    ouzel::gui::Label drawQueueLabel;
+    ouzel::gui::Menu menu;
+    ouzel::gui::Button actors1000Button;
+    ouzel::gui::Button actors10000Button;
+    ouzel::gui::Button actors50000Button;
+    ouzel::gui::Button spatialIndexButton;
+    ouzel::gui::Button backButton;
+};
+
+#endif // SCENEBENCHMARKSAMPLE_HPP
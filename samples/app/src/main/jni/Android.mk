@@ -8,6 +8,9 @@ LOCAL_CPPFLAGS += -std=c++14 -fexceptions
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../../../../ouzel
 
 LOCAL_SRC_FILES := ../../../../AnimationsSample.cpp \
+    ../../../../AudioBenchmarkSample.cpp \
+    ../../../../SceneBenchmarkSample.cpp \
+    ../../../../BenchmarkSample.cpp \
     ../../../../GUISample.cpp \
     ../../../../GameSample.cpp \
     ../../../../InputSample.cpp \
@@ -0,0 +1,136 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef BENCHMARK_AUDIOGRAPHS_HPP
+#define BENCHMARK_AUDIOGRAPHS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "audio/Audio.hpp"
+#include "audio/Effects.hpp"
+#include "audio/PcmClip.hpp"
+#include "audio/Submix.hpp"
+#include "audio/Voice.hpp"
+#include "audio/offline/OfflineAudioDevice.hpp"
+
+// Mixer graphs rendered with the offline driver, shared by the audio benchmark sample and the headless benchmark
+namespace benchmark
+{
+    // a standard mixer graph: streams spread over the leaf buses of a binary tree of submixes,
+    // with the same effects on every bus
+    struct Graph
+    {
+        uint32_t streams;
+        uint32_t effects;
+        uint32_t depth;
+    };
+
+    const Graph GRAPHS[] = {
+        {32, 0, 0},
+        {64, 2, 1},
+        {128, 2, 2},
+        {256, 4, 3}
+    };
+
+    constexpr uint32_t GRAPH_SAMPLE_RATE = 48000; // of the clip, the device resamples it
+    constexpr uint32_t GRAPH_MIX_THREADS = 2;
+    constexpr uint32_t GRAPH_SECONDS = 2;
+
+    struct GraphResult
+    {
+        Graph graph;
+        size_t buses;
+        uint64_t framesPerSecond;
+        uint32_t sampleRate;
+        uint64_t maxCallbackTime; // microseconds
+        uint64_t bufferTime; // microseconds
+    };
+
+    // renders the graph with the offline driver as fast as possible and writes the result to the file if it's not empty
+    inline GraphResult measureGraph(const Graph& graph, const std::string& filename)
+    {
+        using namespace ouzel;
+
+        audio::Audio offlineAudio(audio::Driver::Offline, false, 0, 0, GRAPH_MIX_THREADS, 0, 0, audio::mixer::Resampler::Quality::Polyphase);
+        auto device = static_cast<audio::offline::AudioDevice*>(offlineAudio.getDevice());
+
+        // longer than the render, because the voices don't loop
+        std::mt19937 randomEngine(graph.streams);
+        std::uniform_real_distribution<float> distribution(-0.1F, 0.1F);
+        std::vector<float> samples(GRAPH_SAMPLE_RATE * (GRAPH_SECONDS + 1));
+        for (float& sample : samples) sample = distribution(randomEngine);
+        audio::PcmClip clip(offlineAudio, 1, GRAPH_SAMPLE_RATE, samples);
+
+        std::vector<std::unique_ptr<audio::Submix>> submixes;
+        std::vector<audio::Mix*> buses{&offlineAudio.getMasterMix()};
+        size_t levelStart = 0;
+
+        for (uint32_t level = 0; level < graph.depth; ++level)
+        {
+            const size_t levelEnd = buses.size();
+            for (size_t parent = levelStart; parent < levelEnd; ++parent)
+                for (uint32_t child = 0; child < 2; ++child)
+                {
+                    submixes.push_back(std::make_unique<audio::Submix>(offlineAudio));
+                    submixes.back()->setOutput(buses[parent]);
+                    buses.push_back(submixes.back().get());
+                }
+            levelStart = levelEnd;
+        }
+
+        std::vector<std::unique_ptr<audio::Effect>> effects;
+        for (audio::Mix* bus : buses)
+            for (uint32_t i = 0; i < graph.effects; ++i)
+            {
+                switch (i % 3)
+                {
+                    case 0: effects.push_back(std::make_unique<audio::Gain>(offlineAudio, -3.0F)); break;
+                    case 1: effects.push_back(std::make_unique<audio::Delay>(offlineAudio, 0.01F)); break;
+                    default: effects.push_back(std::make_unique<audio::Reverb>(offlineAudio)); break;
+                }
+                bus->addEffect(effects.back().get());
+            }
+
+        std::vector<std::unique_ptr<audio::Voice>> voices;
+        for (uint32_t i = 0; i < graph.streams; ++i)
+        {
+            voices.push_back(std::make_unique<audio::Voice>(offlineAudio, &clip));
+            voices.back()->setOutput(buses[levelStart + i % (buses.size() - levelStart)]);
+            voices.back()->play();
+        }
+
+        offlineAudio.update();
+
+        if (!filename.empty()) device->openFile(filename);
+        device->render(device->getSampleRate() * GRAPH_SECONDS);
+        device->closeFile();
+
+        GraphResult result;
+        result.graph = graph;
+        result.buses = buses.size();
+        result.framesPerSecond = device->getRenderTime() ?
+            device->getRenderedFrames() * 1000000 / device->getRenderTime() : 0;
+        result.sampleRate = device->getSampleRate();
+        result.maxCallbackTime = device->getMaxCallbackTime();
+        result.bufferTime = device->getBufferSize() * 1000000ULL / device->getSampleRate();
+        return result;
+    }
+
+    // a graph regresses if it can't be rendered in real time or if a callback takes longer than its buffer lasts
+    inline bool isRealTime(const GraphResult& result)
+    {
+        return result.framesPerSecond >= result.sampleRate && result.maxCallbackTime < result.bufferTime;
+    }
+
+    inline std::string describe(const GraphResult& result)
+    {
+        return std::to_string(result.graph.streams) + " streams, " + std::to_string(result.graph.effects) + " effects, " +
+            std::to_string(result.buses) + " buses: " + std::to_string(result.framesPerSecond) + " frames/s (" +
+            std::to_string(result.framesPerSecond / result.sampleRate) + "x real time), worst callback " +
+            std::to_string(result.maxCallbackTime) + " us of " + std::to_string(result.bufferTime);
+    }
+}
+
+#endif // BENCHMARK_AUDIOGRAPHS_HPP
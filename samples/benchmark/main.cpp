@@ -0,0 +1,399 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "AudioGraphs.hpp"
+#include "core/Engine.hpp"
+#include "audio/Effects.hpp"
+#include "audio/Oscillator.hpp"
+#include "audio/Voice.hpp"
+#include "audio/mixer/MixPool.hpp"
+#include "audio/offline/OfflineAudioDevice.hpp"
+#include "storage/Inflate.hpp"
+
+// Headless benchmarks and checks that run without a window on the empty render device and the offline audio device and exit with
+// EXIT_FAILURE when a result regresses, so that they can be run in CI. This is a separate executable,
+// because it replaces the global operator new to count the allocations.
+
+using namespace ouzel;
+
+namespace
+{
+    constexpr uint32_t WARMUP_FRAMES = 3; // fills the pool of the command buffers of the render device
+    constexpr uint32_t FRAME_COUNT = 1000;
+    constexpr uint32_t DRAW_COUNT = 1000; // draw calls in an encoded frame
+    constexpr uint32_t BUFFER_UPDATE_INTERVAL = 10; // every 10th draw updates its vertex buffer
+
+    constexpr uint32_t WARMUP_CALLBACKS = 4; // size the buffers of the mixer
+    constexpr uint32_t COMMAND_UPDATES = 10000; // audio updates by the flooding thread
+    constexpr uint32_t COMMANDS_PER_UPDATE = 64;
+
+    constexpr uint32_t MIX_POOL_WORKERS = 3;
+    constexpr uint32_t MIX_POOL_BATCHES = 100000;
+    constexpr size_t MIX_POOL_MAX_BATCH_SIZE = 16;
+
+    // raw DEFLATE streams made by zlib with a stored, a fixed Huffman and a dynamic Huffman block
+    const uint8_t INFLATE_STORED[] = {
+        0x01, 0x2D, 0x00, 0xD2, 0xFF, 0x54, 0x68, 0x65, 0x20, 0x71, 0x75, 0x69, 0x63, 0x6B, 0x20, 0x62,
+        0x72, 0x6F, 0x77, 0x6E, 0x20, 0x66, 0x6F, 0x78, 0x20, 0x6A, 0x75, 0x6D, 0x70, 0x73, 0x20, 0x6F,
+        0x76, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6C, 0x61, 0x7A, 0x79, 0x20, 0x64, 0x6F, 0x67,
+        0x2E, 0x20
+    };
+    const uint8_t INFLATE_FIXED[] = {
+        0x0B, 0xC9, 0x48, 0x55, 0x28, 0x2C, 0xCD, 0x4C, 0xCE, 0x56, 0x48, 0x2A, 0xCA, 0x2F, 0xCF, 0x53,
+        0x48, 0xCB, 0xAF, 0x50, 0xC8, 0x2A, 0xCD, 0x2D, 0x28, 0x56, 0xC8, 0x2F, 0x4B, 0x2D, 0x52, 0x28,
+        0x01, 0x4A, 0xE7, 0x24, 0x56, 0x55, 0x2A, 0xA4, 0xE4, 0xA7, 0xEB, 0x29, 0x84, 0x0C, 0x0E, 0xC5,
+        0x00
+    };
+    const uint8_t INFLATE_DYNAMIC[] = {
+        0x9D, 0xC7, 0xC7, 0x81, 0xC3, 0x30, 0x0C, 0x00, 0xB0, 0x59, 0x63, 0x5B, 0x95, 0x62, 0x53, 0x97,
+        0x93, 0xE1, 0x6F, 0x86, 0x23, 0x7E, 0xF8, 0x5C, 0x2E, 0x3F, 0x08, 0x80, 0x4F, 0x76, 0xD7, 0xE7,
+        0xFF, 0xB9, 0xAF, 0xDB, 0x83, 0xA3, 0x52, 0xC8, 0x81, 0x37, 0x24, 0x3C, 0xF7, 0x13, 0x8A, 0x67,
+        0x44, 0xF6, 0xC5, 0x10, 0x8C, 0xEE, 0x71, 0x11, 0x83, 0x10, 0x49, 0x30, 0x24, 0x52, 0xF2, 0xCE,
+        0x27, 0x8A, 0xCA, 0xAC, 0x86, 0xD4, 0xC4, 0x39, 0xF8, 0x90, 0x39, 0x55, 0x11, 0x43, 0xB4, 0x65,
+        0x81, 0x18, 0x22, 0x48, 0x6E, 0x6A, 0x48, 0xAD, 0x1D, 0xB4, 0xA4, 0x98, 0x8A, 0x42, 0x37, 0x64,
+        0xB4, 0x36, 0x4A, 0xC5, 0x9C, 0x32, 0xD6, 0x62, 0x08, 0xCE, 0xDE, 0x27, 0x36, 0x82, 0x0C, 0xD4,
+        0x0C, 0xE9, 0xB4, 0xC6, 0x58, 0xD4, 0xB9, 0x40, 0x61, 0x43, 0x64, 0xF0, 0x9E, 0x73, 0xF3, 0x10,
+        0x2C, 0x68, 0x08, 0xE9, 0x94, 0xB3, 0xD6, 0x91, 0xA9, 0x84, 0x86, 0x10, 0xD7, 0xA5, 0xEF, 0xDE,
+        0xAF, 0xAE, 0xCA, 0x86, 0x08, 0x4B, 0xDB, 0xF5, 0x7B, 0xCE, 0xB7, 0xEE, 0x66, 0x48, 0x57, 0xD1,
+        0x7E, 0xDA, 0xEF, 0x7D, 0x7F, 0xED, 0x18, 0xF2, 0x07
+    };
+
+    // heap allocations made by the current thread
+    thread_local uint64_t allocations = 0;
+
+    class BenchmarkEngine final: public Engine
+    {
+    public:
+        BenchmarkEngine()
+        {
+            renderer = std::make_unique<graphics::Renderer>(graphics::Driver::Empty,
+                                                            nullptr,
+                                                            Size2U(800, 600),
+                                                            1,
+                                                            graphics::SamplerFilter::Point,
+                                                            1,
+                                                            false,
+                                                            false,
+                                                            false,
+                                                            false,
+                                                            false);
+        }
+
+    private:
+        void runOnMainThread(const std::function<void()>& func) final
+        {
+            func();
+        }
+    };
+
+    // encodes a frame through the renderer and lets the render device consume and recycle it
+    void renderFrame(graphics::Renderer& renderer)
+    {
+        const float colorVector[] = {1.0F, 1.0F, 1.0F, 1.0F};
+        const uintptr_t textures[graphics::Material::TEXTURE_LAYERS] = {1, 0, 0, 0};
+        const graphics::Vertex vertices[4]{};
+        const Matrix4F transform = Matrix4F::identity();
+
+        renderer.pushDebugMarker("Benchmark");
+        renderer.setRenderTarget(0);
+        renderer.setViewport(RectF(0.0F, 0.0F, 800.0F, 600.0F));
+        renderer.clearRenderTarget(true, false, false, Color::black(), 1.0F, 0);
+
+        for (uint32_t i = 0; i < DRAW_COUNT; ++i)
+        {
+            renderer.setPipelineState(1, 1, graphics::CullMode::NoCull, graphics::FillMode::Solid);
+            renderer.setShaderConstants({Span<float>(colorVector, 4)},
+                                        {Span<float>(transform.m, 16)});
+            renderer.setTextures(Span<uintptr_t>(textures, graphics::Material::TEXTURE_LAYERS));
+
+            if (i % BUFFER_UPDATE_INTERVAL == 0)
+                renderer.addCommand<graphics::SetBufferDataCommand>(2, renderer.addData(reinterpret_cast<const uint8_t*>(vertices),
+                                                                                        sizeof(vertices)));
+
+            renderer.draw(3, 6, sizeof(uint16_t), 2, graphics::DrawMode::TriangleList, 0);
+        }
+
+        renderer.popDebugMarker();
+        renderer.present();
+
+        renderer.getDevice()->process();
+    }
+
+    bool benchmarkCommandBuffer(Engine& benchmarkEngine)
+    {
+        graphics::Renderer& renderer = *benchmarkEngine.getRenderer();
+
+        for (uint32_t frame = 0; frame < WARMUP_FRAMES; ++frame)
+            renderFrame(renderer);
+
+        uint64_t allocationCount = 0;
+        uint64_t maxAllocationCount = 0;
+        std::chrono::steady_clock::duration renderTime{0};
+
+        for (uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            const uint64_t startAllocations = allocations;
+            const auto startTime = std::chrono::steady_clock::now();
+
+            renderFrame(renderer);
+
+            renderTime += std::chrono::steady_clock::now() - startTime;
+
+            const uint64_t frameAllocations = allocations - startAllocations;
+            allocationCount += frameAllocations;
+            if (frameAllocations > maxAllocationCount) maxAllocationCount = frameAllocations;
+        }
+
+        const auto frameMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(renderTime).count() / FRAME_COUNT;
+
+        std::cout << "Command buffer: " << allocationCount << " allocations in " << FRAME_COUNT << " frames (max " <<
+            maxAllocationCount << " per frame), " << frameMicroseconds << " us per frame of " << DRAW_COUNT << " draws\n";
+
+        // a steady-state frame must not allocate
+        return allocationCount == 0;
+    }
+
+    // floods the mixer with processor updates from this thread while another thread renders, the rendering
+    // thread stands in for the audio thread, so it must not allocate while it processes the commands
+    bool benchmarkMixerCommands()
+    {
+        audio::Audio offlineAudio(audio::Driver::Offline, false, 0, 0, 0, 0, 0, audio::mixer::Resampler::Quality::Polyphase);
+        auto device = static_cast<audio::offline::AudioDevice*>(offlineAudio.getDevice());
+
+        audio::Oscillator oscillator(offlineAudio, 440.0F);
+        audio::Gain gain(offlineAudio);
+        offlineAudio.getMasterMix().addEffect(&gain);
+
+        audio::Voice voice(offlineAudio, &oscillator);
+        voice.setOutput(&offlineAudio.getMasterMix());
+        voice.play();
+        offlineAudio.update();
+
+        device->render(device->getBufferSize() * WARMUP_CALLBACKS);
+        device->resetStatistics();
+
+        std::atomic_bool flooding{true};
+        uint64_t audioThreadAllocations = 0;
+
+        Thread audioThread([device, &flooding, &audioThreadAllocations]() {
+            const uint64_t startAllocations = allocations;
+
+            while (flooding) device->render(device->getBufferSize());
+            device->render(device->getBufferSize()); // processes the last submitted commands
+
+            audioThreadAllocations = allocations - startAllocations;
+        });
+
+        for (uint32_t update = 0; update < COMMAND_UPDATES; ++update)
+        {
+            for (uint32_t command = 0; command < COMMANDS_PER_UPDATE; ++command)
+                gain.setGain(-static_cast<float>(command % 12));
+
+            offlineAudio.update();
+        }
+
+        flooding = false;
+        audioThread.join();
+
+        std::cout << "Mixer commands: " << COMMAND_UPDATES * COMMANDS_PER_UPDATE << " processor updates, " <<
+            device->getCallbackCount() << " callbacks, " << audioThreadAllocations << " allocations on the audio thread, worst callback " <<
+            device->getMaxCallbackTime() << " us\n";
+
+        // the audio thread must not allocate
+        return audioThreadAllocations == 0;
+    }
+
+    // renders the mixer graphs of the audio benchmark sample, every one of them has to stay real-time
+    bool benchmarkMixerGraphs()
+    {
+        bool passed = true;
+
+        for (const benchmark::Graph& graph : benchmark::GRAPHS)
+        {
+            const benchmark::GraphResult result = benchmark::measureGraph(graph, std::string());
+            std::cout << "Mixer graph: " << benchmark::describe(result) << '\n';
+            if (!benchmark::isRealTime(result)) passed = false;
+        }
+
+        return passed;
+    }
+
+    // runs back-to-back batches of different sizes with the same job, like the levels of the mixer,
+    // every index of a batch has to run exactly once and no job of a batch may run after it has returned
+    bool checkMixPool()
+    {
+        audio::mixer::MixPool mixPool(MIX_POOL_WORKERS);
+
+        std::vector<std::atomic<uint32_t>> runs(MIX_POOL_MAX_BATCH_SIZE);
+        std::atomic<uint32_t> strayRuns{0};
+        size_t batchSize = 0;
+
+        const std::function<void(size_t)> job = [&runs, &strayRuns, &batchSize](size_t index) {
+            if (index < batchSize)
+                runs[index].fetch_add(1, std::memory_order_relaxed);
+            else
+                strayRuns.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        uint32_t failedBatches = 0;
+
+        for (uint32_t batch = 0; batch < MIX_POOL_BATCHES; ++batch)
+        {
+            for (std::atomic<uint32_t>& count : runs) count.store(0, std::memory_order_relaxed);
+            batchSize = 2 + (batch * 7) % (MIX_POOL_MAX_BATCH_SIZE - 1);
+
+            mixPool.run(batchSize, job);
+
+            bool passed = strayRuns.exchange(0, std::memory_order_relaxed) == 0;
+            for (const std::atomic<uint32_t>& count : runs)
+                if (count.load(std::memory_order_relaxed) > 1) passed = false;
+            for (size_t index = 0; index < batchSize; ++index)
+                if (runs[index].load(std::memory_order_relaxed) != 1) passed = false;
+
+            if (!passed) ++failedBatches;
+        }
+
+        std::cout << "Mix pool: " << mixPool.getWorkerCount() << " workers, " << failedBatches << " of " <<
+            MIX_POOL_BATCHES << " batches ran a job other than once\n";
+
+        return failedBatches == 0;
+    }
+
+    // the streams of zlib have to decompress to their data, every truncated copy of them has to be rejected
+    bool checkInflate()
+    {
+        struct Stream
+        {
+            const char* name;
+            const uint8_t* data;
+            size_t size;
+            std::string expected;
+        };
+
+        const std::string text = "The quick brown fox jumps over the lazy dog. ";
+
+        std::string dynamicText(1024, '\0');
+        for (size_t i = 0; i < dynamicText.size(); ++i)
+            dynamicText[i] = static_cast<char>('a' + (i * i) % 13 + i / 64);
+
+        const Stream streams[] = {
+            {"stored", INFLATE_STORED, sizeof(INFLATE_STORED), text},
+            {"fixed", INFLATE_FIXED, sizeof(INFLATE_FIXED), text + text + text + text},
+            {"dynamic", INFLATE_DYNAMIC, sizeof(INFLATE_DYNAMIC), dynamicText}
+        };
+
+        bool passed = true;
+
+        for (const Stream& stream : streams)
+        {
+            std::vector<uint8_t> output(stream.expected.size());
+
+            try
+            {
+                storage::inflate(stream.data, stream.size, output.data(), output.size());
+
+                if (std::memcmp(output.data(), stream.expected.data(), output.size()) != 0)
+                {
+                    std::cout << "Inflate: " << stream.name << " block decompressed to wrong data\n";
+                    passed = false;
+                    continue;
+                }
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cout << "Inflate: " << stream.name << " block failed, " << e.what() << '\n';
+                passed = false;
+                continue;
+            }
+
+            size_t rejected = 0;
+            for (size_t size = 0; size < stream.size; ++size)
+            {
+                try
+                {
+                    storage::inflate(stream.data, size, output.data(), output.size());
+                }
+                catch (const std::runtime_error&)
+                {
+                    ++rejected;
+                }
+            }
+
+            std::cout << "Inflate: " << stream.name << " block, " << rejected << " of " << stream.size << " truncated copies rejected\n";
+            if (rejected != stream.size) passed = false;
+        }
+
+        return passed;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* result = std::malloc(size ? size : 1)) return result;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace ouzel
+{
+    // the engine is not started, so there is no application
+    std::unique_ptr<Application> main(const std::vector<std::string>&)
+    {
+        return nullptr;
+    }
+}
+
+int main()
+{
+    try
+    {
+        BenchmarkEngine benchmarkEngine;
+
+        bool passed = true;
+        if (!benchmarkCommandBuffer(benchmarkEngine)) passed = false;
+        if (!benchmarkMixerCommands()) passed = false;
+        if (!benchmarkMixerGraphs()) passed = false;
+        if (!checkMixPool()) passed = false;
+        if (!checkInflate()) passed = false;
+
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
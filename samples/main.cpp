@@ -9,6 +9,9 @@
 #include "InputSample.hpp"
 #include "SoundSample.hpp"
 #include "PerspectiveSample.hpp"
+#include "BenchmarkSample.hpp"
+#include "SceneBenchmarkSample.hpp"
+#include "AudioBenchmarkSample.hpp"
 
 using namespace ouzel;
 
@@ -62,6 +65,9 @@ public:
             else if (sample == "input") currentScene = std::make_unique<InputSample>();
             else if (sample == "sound") currentScene = std::make_unique<SoundSample>();
             else if (sample == "perspective") currentScene = std::make_unique<PerspectiveSample>();
+            else if (sample == "benchmark") currentScene = std::make_unique<BenchmarkSample>();
+            else if (sample == "scene_benchmark") currentScene = std::make_unique<SceneBenchmarkSample>();
+            else if (sample == "audio_benchmark") currentScene = std::make_unique<AudioBenchmarkSample>();
         }
 
         if (!currentScene) currentScene = std::make_unique<MainMenu>();